@@ -0,0 +1,90 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L // For "clock_gettime", "CLOCK_MONOTONIC" (monotonic clock)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include "group-count.h"
+#include "string-builder.h"
+#include "thread-pool.h"
+
+// Benchmarking snippet (not abstracted away for piece of code portability)
+double elapsed_seconds(struct timespec start, struct timespec stop) {
+    return (double) (stop.tv_sec - start.tv_sec) + (double) (stop.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Generates an access log, where the paths follow a skewed distribution (a few hot paths and a long tail)
+void generate_log(const char * path, size_t megabytes, size_t paths_amount) {
+    FILE * file = fopen(path, "w");
+    uint64_t random_state = 0x9e3779b97f4a7c15ULL;
+    size_t written_bytes = 0;
+    for (size_t i = 0; written_bytes < megabytes * 1000000; i++) {
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 7;
+        random_state ^= random_state << 17;
+        // The minimum of two uniform values is skewed towards the lowest paths
+        size_t first = random_state % paths_amount;
+        size_t second = (random_state >> 32) % paths_amount;
+        int length = fprintf(file, "2022-06-01T12:%02zu:%02zu.%03zuZ 10.0.%zu.%zu GET /api/v1/items/%zu 200 %zu\n",
+                             i / 60 % 60, i % 60, i % 1000, i % 256, i / 256 % 256, (first < second) ? first : second, random_state % 10000);
+        written_bytes += (size_t) length;
+    }
+    fclose(file);
+}
+
+// Benchmarks
+
+void group_count_scaling_benchmark(const char * path, size_t megabytes, size_t max_threads_amount) {
+    printf("%zu MB access log, counting the path field\n", megabytes);
+    printf("%8s %10s %10s %12s\n", "threads", "seconds", "GB/s", "keys");
+    for (size_t threads_amount = 1; threads_amount <= max_threads_amount; threads_amount *= 2) {
+        ThreadPoolOptions options = { threads_amount, THREAD_POOL_AFFINITY_NONE, NULL, 0 };
+        ThreadPool * pool = thread_pool_create(&options);
+        GroupCountOptions group_count_options = { ' ', 3, 0 };
+        struct timespec start, stop;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        GroupCount * group_count = group_count_file(path, &group_count_options, pool);
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        GroupCountStatistics statistics;
+        group_count_statistics(group_count, &statistics);
+        double seconds = elapsed_seconds(start, stop);
+        printf("%8zu %10.3f %10.2f %12zu\n", threads_amount, seconds, (double) megabytes / 1e3 / seconds, statistics.keys_amount);
+        if (threads_amount * 2 > max_threads_amount) {
+            StringBuilder * output = string_builder_create_default();
+            group_count_write(group_count, output, 5);
+            printf("Top paths:\n%s", string_builder_result(output));
+            string_builder_destroy(output);
+        }
+        group_count_destroy(group_count);
+        thread_pool_destroy(pool);
+    }
+}
+
+// Benchmarks runner (the arguments optionally override the log size in MB, the maximum amount of threads and the path)
+
+int main(int argc, char * argv[]) {
+    size_t megabytes = (argc > 1) ? strtoull(argv[1], NULL, 10) : 1000;
+    size_t max_threads_amount = (argc > 2) ? strtoull(argv[2], NULL, 10) : 16;
+    const char * path = (argc > 3) ? argv[3] : "/tmp/group-count-benchmark.log";
+    generate_log(path, megabytes, 100000);
+    // Warm up the page cache, so the first run is not measuring the disk
+    GroupCountOptions options = { ' ', 3, 0 };
+    ThreadPool * pool = thread_pool_create_default();
+    group_count_destroy(group_count_file(path, &options, pool));
+    thread_pool_destroy(pool);
+    group_count_scaling_benchmark(path, megabytes, max_threads_amount);
+    remove(path);
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "group-count.h"
+#include "string-builder.h"
+#include "thread-pool.h"
+#include "error-reporter.h"
+
+#define THREADS_AMOUNT 4
+
+// Assertion snippet (not abstracted away for piece of code portability)
+void assert(int condition, char message[]) {
+    if (condition != 1) {
+        printf("%s\n", message);
+        exit(1);
+    }
+}
+
+// Utilities
+
+bool has_count(GroupCount * group_count, const char * key, uint64_t expected) {
+    uint64_t count;
+    bool is_found = group_count_get(group_count, key, strlen(key), &count);
+    return (expected == 0) ? !is_found : is_found && count == expected;
+}
+
+// Unit testing
+
+void group_count_fields_test(ThreadPool * pool) {
+    printf("*** Running test '%s'\n", __func__);
+    const char * logs = "10:00 GET /home 200\n10:01 GET /cart 200\n\n10:02 POST /cart 201\r\n10:03 GET /home 304\nbroken\n10:04 GET /home 200";
+    GroupCountOptions options = { ' ', 2, 0 };
+    GroupCount * group_count = group_count_bytes(logs, strlen(logs), &options, pool);
+    assert(group_count != NULL, "Aggregation must be created");
+    assert(has_count(group_count, "/home", 3), "Key '/home' must be counted 3 times");
+    assert(has_count(group_count, "/cart", 2), "Key '/cart' must be counted 2 times");
+    assert(has_count(group_count, "/checkout", 0), "Missing key must not be found");
+    GroupCountStatistics statistics;
+    assert(group_count_statistics(group_count, &statistics), "Statistics must be obtained");
+    assert(statistics.lines_amount == 5, "Counted lines amount must be 5");
+    assert(statistics.skipped_lines_amount == 2, "Empty and broken lines must be skipped");
+    assert(statistics.keys_amount == 2, "Distinct keys amount must be 2");
+    group_count_destroy(group_count);
+    // The last field of a CRLF line must not contain the carriage return
+    options.key_field = 3;
+    group_count = group_count_bytes(logs, strlen(logs), &options, pool);
+    assert(has_count(group_count, "201", 1), "Key '201' must be counted without the carriage return");
+    assert(has_count(group_count, "200", 3), "Key '200' must be counted 3 times");
+    group_count_destroy(group_count);
+}
+
+void group_count_whole_line_test(ThreadPool * pool) {
+    printf("*** Running test '%s'\n", __func__);
+    const char * lines = "b\na\nb\n\nc\nb\n";
+    GroupCountOptions options = { 0, GROUP_COUNT_WHOLE_LINE, 0 };
+    GroupCount * group_count = group_count_bytes(lines, strlen(lines), &options, pool);
+    assert(has_count(group_count, "b", 3), "Line 'b' must be counted 3 times");
+    assert(has_count(group_count, "a", 1), "Line 'a' must be counted once");
+    assert(has_count(group_count, "", 0), "Empty lines must not be counted");
+    // The output is sorted by descending count, and then by ascending key
+    StringBuilder * output = string_builder_create_default();
+    assert(group_count_write(group_count, output, 0), "Aggregation must be written");
+    assert(strcmp(string_builder_result(output), "b\t3\na\t1\nc\t1\n") == 0, "Output must be sorted by count and key");
+    string_builder_destroy(output);
+    output = string_builder_create_default();
+    assert(group_count_write(group_count, output, 2), "Limited aggregation must be written");
+    assert(strcmp(string_builder_result(output), "b\t3\na\t1\n") == 0, "Output must be limited to the top keys");
+    string_builder_destroy(output);
+    group_count_destroy(group_count);
+}
+
+void group_count_empty_key_test(ThreadPool * pool) {
+    printf("*** Running test '%s'\n", __func__);
+    // Empty key fields are keys too (and are written as an empty key before the count)
+    const char * lines = ",x\n,y\n,z\nb,q\n";
+    GroupCountOptions options = { ',', 0, 0 };
+    GroupCount * group_count = group_count_bytes(lines, strlen(lines), &options, pool);
+    assert(has_count(group_count, "", 3), "Empty key must be counted 3 times");
+    assert(has_count(group_count, "b", 1), "Key 'b' must be counted once");
+    StringBuilder * output = string_builder_create_default();
+    assert(group_count_write(group_count, output, 0), "Aggregation with an empty key must be written");
+    assert(strcmp(string_builder_result(output), "\t3\nb\t1\n") == 0, "Empty key must be written before its count");
+    string_builder_destroy(output);
+    group_count_destroy(group_count);
+    // Keys containing 'NULL' bytes are written whole
+    const char bytes[] = "a\0b,x\na\0b,y\n";
+    group_count = group_count_bytes(bytes, sizeof(bytes) - 1, &options, pool);
+    output = string_builder_create_default();
+    assert(group_count_write(group_count, output, 0), "Aggregation with a 'NULL' byte key must be written");
+    assert(string_builder_size(output) == 6 && memcmp(string_builder_result(output), "a\0b\t2\n", 6) == 0, "Key must not be truncated at its 'NULL' byte");
+    string_builder_destroy(output);
+    group_count_destroy(group_count);
+}
+
+void group_count_chunks_test(ThreadPool * pool) {
+    printf("*** Running test '%s'\n", __func__);
+    // Tiny chunks, so most lines cross the chunk boundaries (and many chunks have no line start at all)
+    StringBuilder * builder = string_builder_create_default();
+    for (size_t i = 0; i < 20000; i++) {
+        char line[64];
+        snprintf(line, sizeof(line), "%zu,key-%zu,%s\n", i, i % 997, (i % 3 == 0) ? "some longer padding field" : "x");
+        string_builder_append_all(builder, line);
+    }
+    const char * bytes = string_builder_result(builder);
+    size_t chunk_sizes[] = { 1, 7, 64, 4096, 0 };
+    for (size_t i = 0; i < sizeof(chunk_sizes) / sizeof(size_t); i++) {
+        GroupCountOptions options = { ',', 1, chunk_sizes[i] };
+        GroupCount * group_count = group_count_bytes(bytes, strlen(bytes), &options, pool);
+        GroupCountStatistics statistics;
+        group_count_statistics(group_count, &statistics);
+        assert(statistics.lines_amount == 20000, "Every line must be counted exactly once");
+        assert(statistics.keys_amount == 997, "Distinct keys amount must be 997");
+        assert(has_count(group_count, "key-0", 21), "Key 'key-0' must be counted 21 times");
+        assert(has_count(group_count, "key-996", 20), "Key 'key-996' must be counted 20 times");
+        group_count_destroy(group_count);
+    }
+    string_builder_destroy(builder);
+}
+
+void group_count_file_test(ThreadPool * pool) {
+    printf("*** Running test '%s'\n", __func__);
+    char path[] = "/tmp/group-count-tests-XXXXXX";
+    int descriptor = mkstemp(path);
+    assert(descriptor >= 0, "Temporary file must be created");
+    const char * lines = "INFO started\nWARN slow\nINFO done\n";
+    assert(write(descriptor, lines, strlen(lines)) == (ssize_t) strlen(lines), "Temporary file must be written");
+    close(descriptor);
+    GroupCountOptions options = { ' ', 0, 0 };
+    GroupCount * group_count = group_count_file(path, &options, pool);
+    assert(group_count != NULL, "File aggregation must be created");
+    assert(has_count(group_count, "INFO", 2), "Key 'INFO' must be counted twice");
+    assert(has_count(group_count, "WARN", 1), "Key 'WARN' must be counted once");
+    group_count_destroy(group_count);
+    // An empty file has no lines
+    truncate(path, 0);
+    group_count = group_count_file(path, &options, pool);
+    GroupCountStatistics statistics;
+    assert(group_count_statistics(group_count, &statistics) && statistics.lines_amount == 0, "Empty file must have no lines");
+    group_count_destroy(group_count);
+    unlink(path);
+    assert(group_count_file(path, &options, pool) == NULL, "Missing file must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "Missing file error must be an invalid argument error");
+}
+
+void group_count_invalid_arguments_test(ThreadPool * pool) {
+    printf("*** Running test '%s'\n", __func__);
+    GroupCountOptions options = { ',', 0, 0 };
+    assert(group_count_bytes(NULL, 10, &options, pool) == NULL, "'NULL' bytes must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_NULL_ARGUMENT, "Error must be a 'NULL' argument error");
+    assert(group_count_bytes("a", 1, NULL, pool) == NULL, "'NULL' options must fail");
+    assert(group_count_bytes("a", 1, &options, NULL) == NULL, "'NULL' pool must fail");
+    options.delimiter = '\n';
+    assert(group_count_bytes("a", 1, &options, pool) == NULL, "New line delimiter must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "Error must be an invalid argument error");
+    uint64_t count;
+    assert(!group_count_get(NULL, "a", 1, &count), "'NULL' aggregation must not be looked up");
+}
+
+int main() {
+    fclose(stderr); // Prevent printing "expected" errors
+    ThreadPoolOptions options = { THREADS_AMOUNT, THREAD_POOL_AFFINITY_NONE, NULL, 0 };
+    ThreadPool * pool = thread_pool_create(&options);
+    group_count_fields_test(pool);
+    group_count_whole_line_test(pool);
+    group_count_empty_key_test(pool);
+    group_count_chunks_test(pool);
+    group_count_file_test(pool);
+    group_count_invalid_arguments_test(pool);
+    thread_pool_destroy(pool);
+}
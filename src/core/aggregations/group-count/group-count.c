@@ -0,0 +1,505 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * A Parallel Streaming Group-By Count Implementation (for newline-delimited logs).
+ *
+ * ### Explanation ###
+ *
+ * Counting the occurrences of a key field (i.e., the path of an access log, the level of an application log) is the
+ * most common log aggregation, and it is made of three steps: splitting the input in lines and fields (see
+ * "string-tokenizer.c"), hashing the key (see "fnv1a.c") and incrementing its counter in a hash table.
+ *
+ * ### Chunks ###
+ *
+ * The input is split in chunks of a fixed amount of bytes, and every chunk owns the lines starting inside it (so the
+ * chunk boundaries are moved forward to the next line start with a "memchr", and no line is split nor lost). The
+ * chunks are executed as a parallel for (see "thread_pool_parallel_for"), so the idle workers steal them.
+ *
+ * ### Partial aggregates ###
+ *
+ * Every worker counts into its own tables (addressed by "thread_pool_worker_index"), so the hot loop never locks nor
+ * shares a cache line. Every table copies its keys (once per distinct key) into its own compact bytes array, as
+ * comparing against the first occurrence of a key in the input would be a cache miss on every lookup.
+ *
+ * Every worker has one table per partition (chosen by the highest bits of the hash), so the merge step is a parallel
+ * for over the partitions as well: the partition "p" of the result is the merge of the partitions "p" of all the
+ * workers, without any synchronization (the lowest bits of the hash choose the slot, so both are independent).
+ *
+ * The tables use open addressing with linear probing, and the full hash is stored in every entry, so the keys are
+ * only compared when the hashes match, and growing never hashes a key again. The keys are looked up in batches, where
+ * the slot of every key is prefetched as soon as it is hashed, so the cache misses of a batch overlap each other.
+ *
+ * ### References ###
+ *
+ * - https://duckdb.org/2022/03/07/aggregate-hashtable.html
+ * - https://en.wikipedia.org/wiki/Linear_probing
+ */
+
+// Imports & Headers
+
+#include <stdlib.h>         // For "malloc", "calloc", "free", "qsort" (memory management & sorting the output)
+#include <stdio.h>          // For "snprintf" (formatting the counts)
+#include <string.h>         // For "memchr", "memcmp" (line boundaries & comparing keys)
+#include <stdatomic.h>      // For "atomic_bool" (failures of the parallel steps)
+#include <fcntl.h>          // For "open" (opening the input file)
+#include <unistd.h>         // For "close" (closing the input file)
+#include <sys/mman.h>       // For "mmap", "munmap", "madvise" (mapping the input file)
+#include <sys/stat.h>       // For "fstat" (input file size)
+#include "group-count.h"
+#include "string-tokenizer.h" // For "string_tokenizer_next" (splitting lines & fields)
+#include "fnv1a.h"          // For "hashes_fnv1a_hash64_bytes_into" (hashing keys)
+#include "vector.h"         // For "vector_push_many" (storing the keys of the result)
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+
+// Default implementation values
+
+#define DEFAULT_CHUNK_SIZE (4 * 1024 * 1024)
+#define PARTITION_BITS 6
+#define PARTITIONS_AMOUNT (1 << PARTITION_BITS)
+#define MIN_TABLE_CAPACITY 16
+#define BATCH_SIZE 16
+
+// Structures
+
+typedef struct group_entry {
+    uint64_t hash;                  // The full hash of the key
+    size_t key_offset;              // The offset of the key in the keys bytes of its table
+    size_t key_length;              // The amount of bytes of the key
+    uint64_t count;                 // The amount of occurrences of the key ('0' means the slot is empty)
+} GroupEntry;
+
+typedef struct group_table {
+    GroupEntry * entries;           // The slots (a power of two amount of them)
+    size_t capacity;                // The amount of slots ('0' until the first key is inserted)
+    size_t size;                    // The amount of used slots
+    Vector * keys_bytes;            // The 'NULL' terminated keys ('NULL' until the first key is inserted)
+} GroupTable;
+
+typedef struct worker_partials {
+    GroupTable tables[PARTITIONS_AMOUNT]; // The partial tables of every partition
+    uint64_t lines_amount;          // The amount of lines counted by the worker
+    uint64_t skipped_lines_amount;  // The amount of lines skipped by the worker
+} WorkerPartials;
+
+struct group_count {
+    GroupTable tables[PARTITIONS_AMOUNT]; // The result tables of every partition
+    uint64_t lines_amount;          // The amount of counted lines
+    uint64_t skipped_lines_amount;  // The amount of lines without the key field
+    size_t keys_amount;             // The amount of distinct keys
+};
+
+typedef struct aggregation {
+    const char * bytes;             // The aggregated input
+    size_t length;                  // The amount of bytes of the input
+    StringTokenizerMode mode;       // How the lines are tokenized (whole lines or fields)
+    char delimiter;                 // The fields delimiter
+    size_t key_field;               // The index of the key field of every line
+    size_t chunk_size;              // The amount of bytes per chunk
+    ThreadPool * pool;              // The pool executing the parallel steps
+    WorkerPartials * partials;      // The partials of every worker (plus one for a non-worker thread)
+    size_t partials_amount;         // The amount of partials
+    GroupCount * group_count;       // The merged result
+    atomic_bool has_failed;         // Whether any allocation of the parallel steps failed
+} Aggregation;
+
+typedef struct pending_key {
+    const char * start;             // The first byte of the key (in the input)
+    size_t length;                  // The amount of bytes of the key
+    uint64_t hash;                  // The hash of the key
+} PendingKey;
+
+typedef struct output_line {
+    const char * key;               // The 'NULL' terminated key
+    size_t key_length;              // The amount of bytes of the key
+    uint64_t count;                 // The amount of occurrences of the key
+} OutputLine;
+
+// Definition (to be able to use methods before declaring them, to follow up the top-bottom code style)
+
+void group_count_aggregate_chunks(size_t start, size_t stop, void * context);
+bool group_count_aggregate_range(Aggregation * aggregation, WorkerPartials * partials, size_t start, size_t stop);
+void group_count_merge_partitions(size_t start, size_t stop, void * context);
+bool group_count_merge_partition(Aggregation * aggregation, size_t partition);
+size_t group_count_line_start(Aggregation * aggregation, size_t position);
+bool group_count_table_upsert(GroupTable * table, uint64_t hash, const char * key, size_t key_length, GroupEntry ** entry);
+bool group_count_table_reserve(GroupTable * table, size_t size);
+void group_count_table_destroy(GroupTable * table);
+int group_count_compare_lines(const void * first, const void * second);
+
+// Implementation
+
+GroupCount * group_count_bytes(const char * bytes, size_t length, const GroupCountOptions * options, ThreadPool * pool) {
+    if ((bytes == NULL && length > 0) || options == NULL || pool == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to aggregate using 'NULL' arguments");
+        return NULL;
+    }
+    Aggregation aggregation;
+    aggregation.bytes = bytes;
+    aggregation.length = length;
+    aggregation.mode = (options->key_field == GROUP_COUNT_WHOLE_LINE) ? STRING_TOKENIZER_MODE_LINES : STRING_TOKENIZER_MODE_FIELDS;
+    aggregation.delimiter = options->delimiter;
+    aggregation.key_field = (options->key_field == GROUP_COUNT_WHOLE_LINE) ? 0 : options->key_field;
+    aggregation.chunk_size = (options->chunk_size == 0) ? DEFAULT_CHUNK_SIZE : options->chunk_size;
+    aggregation.pool = pool;
+    atomic_init(&aggregation.has_failed, false);
+    // The delimiter is validated by the tokenizer itself
+    StringTokenizer validation;
+    if (!string_tokenizer_init(&validation, bytes, 0, aggregation.mode, aggregation.delimiter)) return NULL;
+    GroupCount * group_count = calloc(1, sizeof(GroupCount));
+    if (group_count == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'group_count'");
+        return NULL;
+    }
+    aggregation.group_count = group_count;
+    aggregation.partials_amount = thread_pool_threads_amount(pool) + 1;
+    aggregation.partials = calloc(aggregation.partials_amount, sizeof(WorkerPartials));
+    if (aggregation.partials == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'partials'");
+        group_count_destroy(group_count);
+        return NULL;
+    }
+    // Step 1: aggregate the chunks into the partials of every worker
+    size_t chunks_amount = length / aggregation.chunk_size + (length % aggregation.chunk_size != 0);
+    bool is_done = thread_pool_parallel_for(pool, 0, chunks_amount, 1, group_count_aggregate_chunks, &aggregation);
+    // Step 2: merge the partials of every partition (the partial tables are freed while merging)
+    is_done = is_done && !atomic_load(&aggregation.has_failed);
+    is_done = is_done && thread_pool_parallel_for(pool, 0, PARTITIONS_AMOUNT, 1, group_count_merge_partitions, &aggregation);
+    is_done = is_done && !atomic_load(&aggregation.has_failed);
+    for (size_t i = 0; i < aggregation.partials_amount; i++) {
+        group_count->lines_amount += aggregation.partials[i].lines_amount;
+        group_count->skipped_lines_amount += aggregation.partials[i].skipped_lines_amount;
+        for (size_t j = 0; j < PARTITIONS_AMOUNT; j++) group_count_table_destroy(&aggregation.partials[i].tables[j]);
+    }
+    free(aggregation.partials);
+    if (!is_done) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for the aggregation");
+        group_count_destroy(group_count);
+        return NULL;
+    }
+    for (size_t i = 0; i < PARTITIONS_AMOUNT; i++) group_count->keys_amount += group_count->tables[i].size;
+    return group_count;
+}
+
+GroupCount * group_count_file(const char * path, const GroupCountOptions * options, ThreadPool * pool) {
+    if (path == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to aggregate a 'NULL' path");
+        return NULL;
+    }
+    int descriptor = open(path, O_RDONLY);
+    if (descriptor < 0) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "Unable to open the file");
+        return NULL;
+    }
+    struct stat file_status;
+    if (fstat(descriptor, &file_status) != 0) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "Unable to obtain the size of the file");
+        close(descriptor);
+        return NULL;
+    }
+    size_t length = (size_t) file_status.st_size;
+    // An empty file can't be mapped (and it has no lines anyway)
+    if (length == 0) {
+        close(descriptor);
+        return group_count_bytes(NULL, 0, options, pool);
+    }
+    char * bytes = mmap(NULL, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (bytes == MAP_FAILED) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to map the file");
+        return NULL;
+    }
+    // Every chunk is read sequentially, so a bigger read-ahead helps
+    madvise(bytes, length, MADV_SEQUENTIAL);
+    GroupCount * group_count = group_count_bytes(bytes, length, options, pool);
+    munmap(bytes, length);
+    return group_count;
+}
+
+void group_count_destroy(GroupCount * group_count) {
+    if (group_count == NULL) return;
+    for (size_t i = 0; i < PARTITIONS_AMOUNT; i++) group_count_table_destroy(&group_count->tables[i]);
+    free(group_count);
+}
+
+bool group_count_get(GroupCount * group_count, const char * key, size_t key_length, uint64_t * count) {
+    if (group_count == NULL || key == NULL || count == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to obtain a count using 'NULL' arguments");
+        return false;
+    }
+    * count = 0;
+    uint64_t hash;
+    hashes_fnv1a_hash64_bytes_into(key, key_length, &hash);
+    size_t partition = (size_t) (hash >> (64 - PARTITION_BITS));
+    GroupTable * table = &group_count->tables[partition];
+    if (table->capacity == 0) return false;
+    const char * base = vector_data(table->keys_bytes);
+    size_t mask = table->capacity - 1;
+    for (size_t slot = (size_t) hash & mask; table->entries[slot].count != 0; slot = (slot + 1) & mask) {
+        GroupEntry * entry = &table->entries[slot];
+        if (entry->hash == hash && entry->key_length == key_length && memcmp(base + entry->key_offset, key, key_length) == 0) {
+            * count = entry->count;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool group_count_statistics(GroupCount * group_count, GroupCountStatistics * statistics) {
+    if (group_count == NULL || statistics == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to obtain the statistics using 'NULL' arguments");
+        return false;
+    }
+    statistics->lines_amount = group_count->lines_amount;
+    statistics->skipped_lines_amount = group_count->skipped_lines_amount;
+    statistics->keys_amount = group_count->keys_amount;
+    return true;
+}
+
+bool group_count_write(GroupCount * group_count, StringBuilder * output, size_t limit) {
+    if (group_count == NULL || output == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to write using 'NULL' arguments");
+        return false;
+    }
+    // Step 1: collect and sort all the keys (the vector data is stable, as no more keys are inserted)
+    OutputLine * lines = malloc(sizeof(OutputLine) * (group_count->keys_amount + 1));
+    if (lines == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'lines'");
+        return false;
+    }
+    size_t lines_amount = 0;
+    for (size_t i = 0; i < PARTITIONS_AMOUNT; i++) {
+        GroupTable * table = &group_count->tables[i];
+        const char * base = vector_data(table->keys_bytes);
+        for (size_t j = 0; j < table->capacity; j++) {
+            if (table->entries[j].count == 0) continue;
+            lines[lines_amount].key = base + table->entries[j].key_offset;
+            lines[lines_amount].key_length = table->entries[j].key_length;
+            lines[lines_amount].count = table->entries[j].count;
+            lines_amount++;
+        }
+    }
+    qsort(lines, lines_amount, sizeof(OutputLine), group_count_compare_lines);
+    // Step 2: append the "key<TAB>count" lines
+    if (limit == 0 || limit > lines_amount) limit = lines_amount;
+    bool is_written = true;
+    for (size_t i = 0; i < limit && is_written; i++) {
+        char count[32];
+        snprintf(count, sizeof(count), "\t%llu\n", (unsigned long long) lines[i].count);
+        // The key is appended by its length (it might be empty, or contain 'NULL' bytes, so it is not a plain chain)
+        for (size_t j = 0; j < lines[i].key_length && is_written; j++) {
+            is_written = string_builder_append_one(output, lines[i].key[j]);
+        }
+        is_written = is_written && string_builder_append_all(output, count);
+    }
+    free(lines);
+    return is_written;
+}
+
+// Utilities
+
+/**
+ * Aggregates the given range of chunks into the partials of the calling worker.
+ */
+void group_count_aggregate_chunks(size_t start, size_t stop, void * context) {
+    Aggregation * aggregation = context;
+    size_t worker_index;
+    // The last partials belong to the calling thread (it runs the chunks itself if they could not be submitted)
+    if (!thread_pool_worker_index(aggregation->pool, &worker_index)) worker_index = aggregation->partials_amount - 1;
+    WorkerPartials * partials = &aggregation->partials[worker_index];
+    for (size_t chunk = start; chunk < stop; chunk++) {
+        size_t chunk_start = group_count_line_start(aggregation, chunk * aggregation->chunk_size);
+        size_t chunk_stop = group_count_line_start(aggregation, (chunk + 1) * aggregation->chunk_size);
+        if (!group_count_aggregate_range(aggregation, partials, chunk_start, chunk_stop)) {
+            atomic_store(&aggregation->has_failed, true);
+            return;
+        }
+    }
+}
+
+/**
+ * Counts the keys of the lines of the given byte range (which starts and stops at line boundaries).
+ */
+bool group_count_aggregate_range(Aggregation * aggregation, WorkerPartials * partials, size_t start, size_t stop) {
+    StringTokenizer tokenizer;
+    string_tokenizer_init(&tokenizer, aggregation->bytes + start, stop - start, aggregation->mode, aggregation->delimiter);
+    StringToken token;
+    StringToken key;
+    PendingKey pending[BATCH_SIZE];
+    size_t pending_amount = 0;
+    size_t field_index = 0;
+    bool has_key = false;
+    uint64_t lines_amount = 0;
+    uint64_t skipped_lines_amount = 0;
+    bool has_tokens = true;
+    while (has_tokens) {
+        has_tokens = string_tokenizer_next(&tokenizer, &token);
+        if (has_tokens) {
+            if (field_index == aggregation->key_field) {
+                key = token;
+                has_key = true;
+            }
+            field_index++;
+            if (!token.is_record_end) continue;
+            // The empty lines and the lines without the key field are skipped
+            bool is_empty_line = field_index == 1 && token.length == 0;
+            if (has_key && !is_empty_line) {
+                PendingKey * pending_key = &pending[pending_amount++];
+                pending_key->start = key.start;
+                pending_key->length = key.length;
+                hashes_fnv1a_hash64_bytes_into(key.start, key.length, &pending_key->hash);
+                GroupTable * table = &partials->tables[pending_key->hash >> (64 - PARTITION_BITS)];
+                if (table->capacity > 0) __builtin_prefetch(&table->entries[pending_key->hash & (table->capacity - 1)]);
+                lines_amount++;
+            } else {
+                skipped_lines_amount++;
+            }
+            field_index = 0;
+            has_key = false;
+            if (pending_amount < BATCH_SIZE) continue;
+        }
+        // The slots of the batch were prefetched while tokenizing it, so their cache misses overlap
+        for (size_t i = 0; i < pending_amount; i++) {
+            GroupEntry * entry;
+            GroupTable * table = &partials->tables[pending[i].hash >> (64 - PARTITION_BITS)];
+            if (!group_count_table_upsert(table, pending[i].hash, pending[i].start, pending[i].length, &entry)) return false;
+            entry->count++;
+        }
+        pending_amount = 0;
+    }
+    partials->lines_amount += lines_amount;
+    partials->skipped_lines_amount += skipped_lines_amount;
+    return true;
+}
+
+/**
+ * Merges the given range of partitions of all the workers into the result.
+ */
+void group_count_merge_partitions(size_t start, size_t stop, void * context) {
+    Aggregation * aggregation = context;
+    for (size_t partition = start; partition < stop; partition++) {
+        if (!group_count_merge_partition(aggregation, partition)) {
+            atomic_store(&aggregation->has_failed, true);
+            return;
+        }
+    }
+}
+
+bool group_count_merge_partition(Aggregation * aggregation, size_t partition) {
+    GroupTable * table = &aggregation->group_count->tables[partition];
+    // Step 1: reserve the slots for the worst case (no key is shared among workers), so the table never grows
+    size_t max_size = 0;
+    for (size_t i = 0; i < aggregation->partials_amount; i++) max_size += aggregation->partials[i].tables[partition].size;
+    if (!group_count_table_reserve(table, max_size)) return false;
+    // Step 2: add the counts of every worker (the partials are freed as soon as they are merged)
+    for (size_t i = 0; i < aggregation->partials_amount; i++) {
+        GroupTable * partial = &aggregation->partials[i].tables[partition];
+        const char * base = vector_data(partial->keys_bytes);
+        for (size_t j = 0; j < partial->capacity; j++) {
+            GroupEntry * partial_entry = &partial->entries[j];
+            if (partial_entry->count == 0) continue;
+            GroupEntry * entry;
+            if (!group_count_table_upsert(table, partial_entry->hash, base + partial_entry->key_offset, partial_entry->key_length, &entry)) return false;
+            entry->count += partial_entry->count;
+        }
+        group_count_table_destroy(partial);
+    }
+    return true;
+}
+
+/**
+ * Returns the first line start at (or after) the given position, or the length if there are none.
+ */
+size_t group_count_line_start(Aggregation * aggregation, size_t position) {
+    if (position >= aggregation->length) return aggregation->length;
+    if (position == 0 || aggregation->bytes[position - 1] == '\n') return position;
+    const char * new_line = memchr(aggregation->bytes + position, '\n', aggregation->length - position);
+    return (new_line == NULL) ? aggregation->length : (size_t) (new_line - aggregation->bytes) + 1;
+}
+
+/**
+ * Finds the entry of the given key, or inserts an empty one (with a '0' count, and a copy of the key), growing the
+ * table if needed.
+ */
+bool group_count_table_upsert(GroupTable * table, uint64_t hash, const char * key, size_t key_length, GroupEntry ** entry) {
+    if (!group_count_table_reserve(table, table->size + 1)) return false;
+    const char * base = vector_data(table->keys_bytes);
+    size_t mask = table->capacity - 1;
+    size_t slot = (size_t) hash & mask;
+    while (table->entries[slot].count != 0) {
+        GroupEntry * candidate = &table->entries[slot];
+        if (candidate->hash == hash && candidate->key_length == key_length && memcmp(base + candidate->key_offset, key, key_length) == 0) {
+            * entry = candidate;
+            return true;
+        }
+        slot = (slot + 1) & mask;
+    }
+    char terminator = '\0';
+    size_t key_offset = vector_size(table->keys_bytes);
+    if (!vector_push_many(table->keys_bytes, key, key_length) || !vector_push(table->keys_bytes, &terminator)) return false;
+    table->entries[slot].hash = hash;
+    table->entries[slot].key_offset = key_offset;
+    table->entries[slot].key_length = key_length;
+    table->size++;
+    * entry = &table->entries[slot];
+    return true;
+}
+
+/**
+ * Grows the table (doubling it) until the given amount of keys fits with a load factor of at most 3/4.
+ */
+bool group_count_table_reserve(GroupTable * table, size_t size) {
+    if (size * 4 <= table->capacity * 3) return true;
+    if (table->keys_bytes == NULL) {
+        table->keys_bytes = vector_create_default(sizeof(char));
+        if (table->keys_bytes == NULL) return false;
+    }
+    size_t new_capacity = (table->capacity == 0) ? MIN_TABLE_CAPACITY : table->capacity;
+    while (size * 4 > new_capacity * 3) new_capacity *= 2;
+    GroupEntry * entries = calloc(new_capacity, sizeof(GroupEntry));
+    if (entries == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'entries'");
+        return false;
+    }
+    // The stored hashes are reused, so no key is hashed (nor compared) again
+    size_t mask = new_capacity - 1;
+    for (size_t i = 0; i < table->capacity; i++) {
+        if (table->entries[i].count == 0) continue;
+        size_t slot = (size_t) table->entries[i].hash & mask;
+        while (entries[slot].count != 0) slot = (slot + 1) & mask;
+        entries[slot] = table->entries[i];
+    }
+    free(table->entries);
+    table->entries = entries;
+    table->capacity = new_capacity;
+    return true;
+}
+
+void group_count_table_destroy(GroupTable * table) {
+    free(table->entries);
+    vector_destroy(table->keys_bytes);
+    table->entries = NULL;
+    table->keys_bytes = NULL;
+    table->capacity = 0;
+    table->size = 0;
+}
+
+int group_count_compare_lines(const void * first, const void * second) {
+    const OutputLine * first_line = first;
+    const OutputLine * second_line = second;
+    if (first_line->count != second_line->count) return (first_line->count > second_line->count) ? -1 : 1;
+    size_t common_length = (first_line->key_length < second_line->key_length) ? first_line->key_length : second_line->key_length;
+    int comparison = memcmp(first_line->key, second_line->key, common_length);
+    if (comparison != 0) return comparison;
+    return (first_line->key_length > second_line->key_length) - (first_line->key_length < second_line->key_length);
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdbool.h>        // For "true", "false" (boolean constants)
+#include <stddef.h>         // For "size_t" (size type)
+#include <stdint.h>         // For "uint64_t", "SIZE_MAX" (counters & whole line key field)
+#include "string-builder.h"
+#include "thread-pool.h"
+
+/* group-count.h */
+#ifndef AGGREGATIONS_GROUP_COUNT_H
+#define AGGREGATIONS_GROUP_COUNT_H
+
+// The key field that uses the whole line as the key
+#define GROUP_COUNT_WHOLE_LINE SIZE_MAX
+
+typedef struct group_count GroupCount;
+
+/**
+ * The aggregation options.
+ */
+typedef struct group_count_options {
+    char delimiter;                 // The fields delimiter (ignored when the whole line is the key)
+    size_t key_field;               // The index of the key field of every line, or "GROUP_COUNT_WHOLE_LINE"
+    size_t chunk_size;              // The amount of input bytes per parallel task, or '0' to use the default (4 MiB)
+} GroupCountOptions;
+
+/**
+ * Amounts counted by an aggregation.
+ */
+typedef struct group_count_statistics {
+    uint64_t lines_amount;          // The amount of counted lines
+    uint64_t skipped_lines_amount;  // The amount of lines without the key field (not counted)
+    size_t keys_amount;             // The amount of distinct keys
+} GroupCountStatistics;
+
+/**
+ * Counts the occurrences of every key of the given newline-delimited bytes (one key per line).
+ *
+ * The bytes are split in chunks (at line boundaries) which are aggregated in parallel, where every worker counts into
+ * its own partial tables (so the workers never share any state), and the partial tables are then merged in parallel.
+ *
+ * The returned aggregation must be freed by the client after its usage (the bytes are not referenced anymore).
+ *
+ * @param bytes the newline-delimited bytes (might be {@code NULL} if the length is '0')
+ * @param length the amount of bytes
+ * @param options the aggregation options
+ * @param pool the thread pool where the chunks are aggregated
+ *
+ * @return a new aggregation, or {@code NULL} if an error occurred
+ */
+GroupCount * group_count_bytes(const char * bytes, size_t length, const GroupCountOptions * options, ThreadPool * pool);
+
+/**
+ * Counts the occurrences of every key of the given newline-delimited file (see "group_count_bytes").
+ *
+ * The file is mapped into memory (instead of being read), so the chunks are loaded on demand by the workers.
+ *
+ * The returned aggregation must be freed by the client after its usage.
+ *
+ * @param path the path of the file
+ * @param options the aggregation options
+ * @param pool the thread pool where the chunks are aggregated
+ *
+ * @return a new aggregation, or {@code NULL} if an error occurred
+ */
+GroupCount * group_count_file(const char * path, const GroupCountOptions * options, ThreadPool * pool);
+
+/**
+ * Frees the given aggregation.
+ *
+ * @param group_count the aggregation that is about to be freed
+ */
+void group_count_destroy(GroupCount * group_count);
+
+/**
+ * Obtains the count of the given key.
+ *
+ * @param group_count the aggregation where the key is looked up
+ * @param key the bytes of the key
+ * @param key_length the amount of bytes of the key
+ * @param count where the count is to be stored (it is '0' if the key was not found)
+ *
+ * @return {@code true} if the key was found, {@code false} otherwise
+ */
+bool group_count_get(GroupCount * group_count, const char * key, size_t key_length, uint64_t * count);
+
+/**
+ * Obtains the amounts counted by the given aggregation.
+ *
+ * @param group_count the aggregation whose amounts are to be obtained
+ * @param statistics where the amounts are to be stored
+ *
+ * @return {@code true} if the amounts were obtained, {@code false} otherwise
+ */
+bool group_count_statistics(GroupCount * group_count, GroupCountStatistics * statistics);
+
+/**
+ * Appends the counted keys to the given builder as "key<TAB>count" lines, sorted by descending count (and then by
+ * ascending key, so the output is deterministic).
+ *
+ * @param group_count the aggregation to be written
+ * @param output the builder where the lines are appended
+ * @param limit the maximum amount of lines (the keys with the highest counts), or '0' to write all of them
+ *
+ * @return {@code true} if the lines were appended, {@code false} otherwise
+ */
+bool group_count_write(GroupCount * group_count, StringBuilder * output, size_t limit);
+
+#endif /* AGGREGATIONS_GROUP_COUNT_H */
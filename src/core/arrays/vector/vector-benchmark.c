@@ -0,0 +1,105 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L // For "clock_gettime", "CLOCK_MONOTONIC" (monotonic clock)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include "vector.h"
+
+// Benchmarking snippet (not abstracted away for piece of code portability)
+double elapsed_seconds(struct timespec start, struct timespec stop) {
+    return (double) (stop.tv_sec - start.tv_sec) + (double) (stop.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+VECTOR_DEFINE_TYPED(u64_vector, uint64_t)
+
+#define CHUNK_SIZE 64
+
+// Benchmarks
+
+// Appends the elements one by one to a plain array doubling its capacity (the usual hand-written growth)
+uint64_t doubling_array_benchmark(size_t elements_amount) {
+    size_t capacity = 16, size = 0;
+    uint64_t * elements = malloc(sizeof(uint64_t) * capacity);
+    for (size_t i = 0; i < elements_amount; i++) {
+        if (size == capacity) elements = realloc(elements, sizeof(uint64_t) * (capacity *= 2));
+        elements[size++] = i;
+    }
+    uint64_t checksum = elements[size / 2];
+    free(elements);
+    return checksum;
+}
+
+uint64_t vector_push_benchmark(size_t elements_amount) {
+    Vector * vector = vector_create_default(sizeof(uint64_t));
+    for (uint64_t i = 0; i < elements_amount; i++) vector_push(vector, &i);
+    uint64_t checksum = u64_vector_get(vector, elements_amount / 2);
+    vector_destroy(vector);
+    return checksum;
+}
+
+uint64_t vector_typed_push_benchmark(size_t elements_amount) {
+    Vector * vector = u64_vector_create(16);
+    for (uint64_t i = 0; i < elements_amount; i++) u64_vector_push(vector, i);
+    uint64_t checksum = u64_vector_get(vector, elements_amount / 2);
+    vector_destroy(vector);
+    return checksum;
+}
+
+uint64_t vector_push_many_benchmark(size_t elements_amount) {
+    Vector * vector = vector_create_default(sizeof(uint64_t));
+    uint64_t chunk[CHUNK_SIZE];
+    for (size_t i = 0; i < elements_amount; i += CHUNK_SIZE) {
+        size_t amount = (elements_amount - i < CHUNK_SIZE) ? elements_amount - i : CHUNK_SIZE;
+        for (size_t j = 0; j < amount; j++) chunk[j] = i + j;
+        vector_push_many(vector, chunk, amount);
+    }
+    uint64_t checksum = u64_vector_get(vector, elements_amount / 2);
+    vector_destroy(vector);
+    return checksum;
+}
+
+uint64_t vector_reserved_push_benchmark(size_t elements_amount) {
+    Vector * vector = vector_create(sizeof(uint64_t), 0);
+    vector_reserve(vector, elements_amount);
+    for (uint64_t i = 0; i < elements_amount; i++) u64_vector_push(vector, i);
+    uint64_t checksum = u64_vector_get(vector, elements_amount / 2);
+    vector_destroy(vector);
+    return checksum;
+}
+
+void run_benchmark(const char * name, uint64_t (* benchmark)(size_t), size_t elements_amount, size_t repetitions) {
+    struct timespec start, stop;
+    uint64_t checksum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < repetitions; i++) checksum += benchmark(elements_amount);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    double seconds = elapsed_seconds(start, stop);
+    printf("%-24s %10.2f Melements/s (checksum %llu)\n", name, (double) (elements_amount * repetitions) / seconds / 1e6, (unsigned long long) checksum);
+}
+
+// Benchmarks runner (the arguments optionally override the amount of elements and the amount of repetitions)
+
+int main(int argc, char * argv[]) {
+    size_t elements_amount = (argc > 1) ? strtoull(argv[1], NULL, 10) : 10000000;
+    size_t repetitions = (argc > 2) ? strtoull(argv[2], NULL, 10) : 5;
+    if (elements_amount == 0) elements_amount = 1;
+    run_benchmark("doubling array", doubling_array_benchmark, elements_amount, repetitions);
+    run_benchmark("vector push", vector_push_benchmark, elements_amount, repetitions);
+    run_benchmark("vector typed push", vector_typed_push_benchmark, elements_amount, repetitions);
+    run_benchmark("vector push many", vector_push_many_benchmark, elements_amount, repetitions);
+    run_benchmark("vector reserved push", vector_reserved_push_benchmark, elements_amount, repetitions);
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdio.h>          // For "printf", "stderr" (printing errors)
+#include <stdlib.h>         // For "exit"
+#include "vector.h"
+#include "error-reporter.h"
+
+// Assertion snippet (not abstracted away for piece of code portability)
+void assert(int condition, char message[]) {
+    if (condition != 1) {
+        printf("%s\n", message);
+        exit(1);
+    }
+}
+
+typedef struct point {
+    int x;
+    int y;
+} Point;
+
+VECTOR_DEFINE_TYPED(int_vector, int)
+VECTOR_DEFINE_TYPED(point_vector, Point)
+
+// Unit testing
+
+void vector_push_pop_test() {
+    printf("*** Running test '%s'\n", __func__);
+    Vector * vector = vector_create_default(sizeof(Point));
+    assert(vector != NULL, "The 'vector' must not be null");
+    assert(vector_capacity(vector) == 16, "The default capacity must be '16'");
+    for (int i = 0; i < 1000; i++) {
+        Point point = { i, -i };
+        assert(vector_push(vector, &point), "The element must be pushed");
+    }
+    assert(vector_size(vector) == 1000, "The size must match the pushed elements");
+    assert(vector_capacity(vector) == 1064, "The capacity must follow the growth sequence");
+    Point * point = vector_at(vector, 500);
+    assert(point != NULL && point->x == 500 && point->y == -500, "The element must be found at its index");
+    assert(vector_at(vector, 1000) == NULL, "An out of bounds index must not be found");
+    Point last;
+    assert(vector_pop(vector, &last) && last.x == 999, "The last element must be popped");
+    assert(vector_pop(vector, NULL), "A popped element can be discarded");
+    assert(vector_size(vector) == 998, "The size must be decreased by the pops");
+    vector_destroy(vector);
+}
+
+void vector_push_many_test() {
+    printf("*** Running test '%s'\n", __func__);
+    Vector * vector = vector_create(sizeof(int), 0);
+    int values[100];
+    for (int i = 0; i < 100; i++) values[i] = i;
+    assert(vector_push_many(vector, values, 100), "The elements must be pushed");
+    assert(vector_capacity(vector) == 139, "Pushing many elements must grow at most once");
+    assert(vector_push_many(vector, values, 0), "Pushing no elements must succeed");
+    assert(vector_push_many(vector, NULL, 0), "Pushing no 'NULL' elements must succeed");
+    int * data = vector_data(vector);
+    for (int i = 0; i < 100; i++) assert(data[i] == i, "The pushed elements must keep their order");
+    vector_destroy(vector);
+}
+
+void vector_reserve_test() {
+    printf("*** Running test '%s'\n", __func__);
+    Vector * vector = vector_create(sizeof(int), 4);
+    assert(vector_reserve(vector, 500), "The capacity must be reserved");
+    assert(vector_capacity(vector) == 500, "The reserved capacity must be exact");
+    assert(vector_reserve(vector, 10), "Reserving less than the capacity must succeed");
+    assert(vector_capacity(vector) == 500, "Reserving less must not shrink the vector");
+    int value = 7;
+    for (int i = 0; i < 501; i++) vector_push(vector, &value);
+    assert(vector_capacity(vector) == 709, "The growth must continue the sequence from the reserved capacity");
+    vector_destroy(vector);
+}
+
+void vector_insert_erase_test() {
+    printf("*** Running test '%s'\n", __func__);
+    Vector * vector = vector_create(sizeof(int), 2);
+    int values[] = { 1, 2, 6, 7 };
+    int middle[] = { 3, 4, 5 };
+    int zero = 0;
+    vector_push_many(vector, values, 4);
+    assert(vector_insert(vector, 2, middle, 3), "The elements must be inserted in the middle");
+    assert(vector_insert(vector, 0, &zero, 1), "The element must be inserted at the front");
+    assert(!vector_insert(vector, 9, &zero, 1), "An insertion past the end must be rejected");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "The error must be an invalid argument");
+    int * data = vector_data(vector);
+    for (int i = 0; i < 8; i++) assert(data[i] == i, "The inserted elements must be in order");
+    assert(vector_erase(vector, 2, 4), "The elements must be erased");
+    int expected[] = { 0, 1, 5, 6, 7 };
+    data = vector_data(vector);
+    assert(vector_size(vector) == 5, "The size must be decreased by the erased elements");
+    for (int i = 0; i < 5; i++) assert(data[i] == expected[i], "The elements after the range must be shifted");
+    assert(vector_erase(vector, 4, 4), "The last element must be erased");
+    assert(!vector_erase(vector, 2, 4), "A range past the end must be rejected");
+    assert(!vector_erase(vector, 2, 1), "A reversed range must be rejected");
+    assert(vector_clear(vector) && vector_size(vector) == 0, "The vector must be cleared");
+    assert(!vector_pop(vector, NULL), "An empty vector must not be popped");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_STATE, "The error must be an invalid state");
+    vector_destroy(vector);
+}
+
+void vector_self_reference_test() {
+    printf("*** Running test '%s'\n", __func__);
+    // Pushing an element of a full vector (the buffer moves while growing, so the element is read from the new one)
+    Vector * vector = vector_create(sizeof(int), 4);
+    for (int i = 0; i < 4; i++) vector_push(vector, &i);
+    assert(vector_size(vector) == vector_capacity(vector), "The vector must be full");
+    assert(vector_push(vector, vector_at(vector, 2)), "An element of the vector must be pushed");
+    assert(vector_size(vector) == 5 && * (int *) vector_at(vector, 4) == 2, "The pushed element must be copied");
+    vector_destroy(vector);
+    // Inserting ranges of the vector itself (before, after and around the insertion index, with and without growing)
+    int values[] = { 0, 1, 2, 3, 4, 5 };
+    size_t capacities[] = { 6, 64 };
+    for (size_t i = 0; i < 2; i++) {
+        vector = vector_create(sizeof(int), capacities[i]);
+        vector_push_many(vector, values, 6);
+        assert(vector_insert(vector, 4, vector_at(vector, 0), 2), "A range left of the index must be inserted");
+        int expected_left[] = { 0, 1, 2, 3, 0, 1, 4, 5 };
+        for (int j = 0; j < 8; j++) assert(((int *) vector_data(vector))[j] == expected_left[j], "The left range must be copied");
+        vector_destroy(vector);
+        vector = vector_create(sizeof(int), capacities[i]);
+        vector_push_many(vector, values, 6);
+        assert(vector_insert(vector, 1, vector_at(vector, 3), 3), "A range right of the index must be inserted");
+        int expected_right[] = { 0, 3, 4, 5, 1, 2, 3, 4, 5 };
+        for (int j = 0; j < 9; j++) assert(((int *) vector_data(vector))[j] == expected_right[j], "The right range must be copied");
+        vector_destroy(vector);
+        vector = vector_create(sizeof(int), capacities[i]);
+        vector_push_many(vector, values, 6);
+        assert(vector_insert(vector, 3, vector_at(vector, 1), 4), "A range around the index must be inserted");
+        int expected_around[] = { 0, 1, 2, 1, 2, 3, 4, 3, 4, 5 };
+        for (int j = 0; j < 10; j++) assert(((int *) vector_data(vector))[j] == expected_around[j], "The range around must be copied");
+        assert(vector_push_many(vector, vector_data(vector), vector_size(vector)), "The whole vector must be appended to itself");
+        assert(vector_size(vector) == 20, "The size must be doubled");
+        for (int j = 0; j < 10; j++) assert(((int *) vector_data(vector))[10 + j] == expected_around[j], "The whole vector must be copied");
+        vector_destroy(vector);
+    }
+}
+
+void vector_typed_test() {
+    printf("*** Running test '%s'\n", __func__);
+    Vector * integers = int_vector_create(0);
+    for (int i = 0; i < 100; i++) int_vector_push(integers, i * i);
+    assert(int_vector_get(integers, 9) == 81, "The typed element must be read by value");
+    int_vector_set(integers, 9, -1);
+    assert(int_vector_data(integers)[9] == -1, "The typed element must be written by value");
+    int last;
+    assert(int_vector_pop(integers, &last) && last == 99 * 99, "The typed element must be popped");
+    Vector * points = point_vector_create(1);
+    point_vector_push(points, (Point) { 3, 4 });
+    assert(point_vector_get(points, 0).y == 4, "The typed structure must be copied");
+    vector_destroy(integers);
+    vector_destroy(points);
+}
+
+void vector_invalid_arguments_test() {
+    printf("*** Running test '%s'\n", __func__);
+    assert(vector_create(0, 16) == NULL, "A zero element size must be rejected");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "The error must be an invalid argument");
+    assert(vector_create(1024, (size_t) -1) == NULL, "An overflowing capacity must be rejected");
+    int value = 1;
+    assert(!vector_push(NULL, &value), "A 'NULL' vector must be rejected");
+    assert(error_reporter_last_code() == ERROR_CODE_NULL_ARGUMENT, "The error must be a null argument");
+    Vector * vector = vector_create_default(sizeof(int));
+    assert(!vector_push(vector, NULL), "A 'NULL' element must be rejected");
+    assert(!vector_insert(vector, 0, NULL, 2), "'NULL' elements must be rejected");
+    assert(!vector_push_many(vector, &value, (size_t) -1), "An overflowing amount must be rejected");
+    assert(vector_size(NULL) == 0 && vector_capacity(NULL) == 0 && vector_data(NULL) == NULL, "A 'NULL' vector must be empty");
+    vector_destroy(vector);
+    vector_destroy(NULL);
+}
+
+// Tests runner
+
+int main() {
+    fclose(stderr);
+    vector_push_pop_test();
+    vector_push_many_test();
+    vector_reserve_test();
+    vector_insert_erase_test();
+    vector_self_reference_test();
+    vector_typed_test();
+    vector_invalid_arguments_test();
+}
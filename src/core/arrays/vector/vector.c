@@ -0,0 +1,292 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * A Non Thread-Safe Generic Vector Implementation (with golden ratio as resize strategy).
+ *
+ * ### Explanation ###
+ *
+ * A "vector" (or dynamic array) is a contiguous array of elements which grows when it runs out of space, so appending
+ * is amortized O(1) while indexing stays as cheap as in a plain array.
+ *
+ * The elements are opaque blocks of a fixed size (given at creation), copied in and out with "memcpy", and the typed
+ * facades generated by "VECTOR_DEFINE_TYPED" restore the type checking (and let the compiler inline fixed size copies).
+ *
+ * ### Growth ###
+ *
+ * The vector shares the growth policy of the string builder (see "growth-policy.c"), so the capacities follow the
+ * golden ratio sequence, and the index of the next sequence value is kept next to the capacity. Appending many
+ * elements at once computes the final capacity first (so it grows at most once), and inserting or erasing in the
+ * middle shifts the tail of the array with a single "memmove".
+ *
+ * ### References ###
+ *
+ * - https://en.wikipedia.org/wiki/Dynamic_array
+ * - https://github.com/facebook/folly/blob/main/folly/docs/FBVector.md
+ */
+
+// Imports & Headers
+
+#include <stdlib.h>         // For "malloc", "realloc", "free" (memory management)
+#include <stdint.h>         // For "SIZE_MAX", "uintptr_t" (overflow checks and self references)
+#include <string.h>         // For "memcpy", "memmove" (copying and shifting elements)
+#include "vector.h"
+#include "growth-policy.h"  // For "growth_policy_sequence_index", "growth_policy_next_capacity" (resize strategy)
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+
+// Structures
+
+struct vector {
+    char * elements;                // The array of elements (including garbage values after the used ones)
+    size_t element_size;            // The size of every element (in bytes)
+    size_t size;                    // The amount of used elements
+    size_t capacity;                // The current maximum amount of elements
+    size_t sequence_index;          // The index of the next sequence value to which resize the array
+};
+
+// Definition (to be able to use methods before declaring them, to follow up the top-bottom code style)
+
+bool vector_ensure_capacity(Vector * vector, size_t elements_amount);
+bool vector_resize_buffer(Vector * vector, size_t new_capacity);
+bool vector_source_offset(Vector * vector, const void * source, size_t * offset);
+
+// Implementation
+
+Vector * vector_create_default(size_t element_size) {
+    return vector_create(element_size, GROWTH_POLICY_DEFAULT_CAPACITY);
+}
+
+Vector * vector_create(size_t element_size, size_t initial_capacity) {
+    if (element_size == 0) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'element_size' must be an integer bigger or equal to '1'");
+        return NULL;
+    }
+    if (initial_capacity > SIZE_MAX / element_size) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'initial_capacity' is too big for the 'element_size'");
+        return NULL;
+    }
+    Vector * vector = malloc(sizeof(Vector));
+    if (vector == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'vector'");
+        return NULL;
+    }
+    // An empty buffer is allocated lazily (on the first growth)
+    vector->elements = NULL;
+    if (initial_capacity > 0) {
+        vector->elements = malloc(element_size * initial_capacity);
+        if (vector->elements == NULL) {
+            free(vector);
+            error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'elements'");
+            return NULL;
+        }
+    }
+    vector->element_size = element_size;
+    vector->size = 0;
+    vector->capacity = initial_capacity;
+    vector->sequence_index = growth_policy_sequence_index(initial_capacity);
+    return vector;
+}
+
+void vector_destroy(Vector * vector) {
+    if (vector != NULL) {
+        free(vector->elements);
+        free(vector);
+    }
+}
+
+bool vector_reserve(Vector * vector, size_t capacity) {
+    if (vector == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to reserve the capacity of a 'NULL' vector");
+        return false;
+    }
+    if (capacity <= vector->capacity) return true;
+    if (!vector_resize_buffer(vector, capacity)) return false;
+    // Continue the growth sequence from the reserved capacity (so the next growth is relative to it)
+    vector->sequence_index = growth_policy_sequence_index(capacity);
+    return true;
+}
+
+bool vector_push(Vector * vector, const void * element) {
+    if (vector == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to push an element to a 'NULL' vector");
+        return false;
+    }
+    if (element == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to push a 'NULL' element to a vector");
+        return false;
+    }
+    // The element might be one of the vector itself, then it is read from its offset (growing might move the buffer)
+    size_t offset;
+    bool is_inside = vector_source_offset(vector, element, &offset);
+    if (vector->size == vector->capacity && !vector_ensure_capacity(vector, 1)) return false;
+    if (is_inside) element = vector->elements + offset;
+    memcpy(vector->elements + vector->size * vector->element_size, element, vector->element_size);
+    vector->size++;
+    return true;
+}
+
+bool vector_push_many(Vector * vector, const void * elements, size_t amount) {
+    if (vector == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to push elements to a 'NULL' vector");
+        return false;
+    }
+    return vector_insert(vector, vector->size, elements, amount);
+}
+
+bool vector_pop(Vector * vector, void * element) {
+    if (vector == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to pop an element from a 'NULL' vector");
+        return false;
+    }
+    if (vector->size == 0) {
+        error_reporter_report(ERROR_CODE_INVALID_STATE, __func__, "Trying to pop an element from an empty vector");
+        return false;
+    }
+    vector->size--;
+    if (element != NULL) memcpy(element, vector->elements + vector->size * vector->element_size, vector->element_size);
+    return true;
+}
+
+bool vector_insert(Vector * vector, size_t index, const void * elements, size_t amount) {
+    if (vector == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to insert elements into a 'NULL' vector");
+        return false;
+    }
+    if (elements == NULL && amount > 0) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to insert 'NULL' elements into a vector");
+        return false;
+    }
+    if (index > vector->size) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'index' must not be greater than the vector size");
+        return false;
+    }
+    if (amount == 0) return true;
+    // The elements might be a range of the vector itself (growing might move the buffer, and shifting moves them)
+    size_t source_offset;
+    bool is_inside = vector_source_offset(vector, elements, &source_offset);
+    // Ensure there is room for N more elements (growing at most once)
+    if (!vector_ensure_capacity(vector, amount)) return false;
+    char * position = vector->elements + index * vector->element_size;
+    // Shift the right side elements to the right (overlapping ranges, so "memmove" instead of "memcpy")
+    size_t bytes_to_move = (vector->size - index) * vector->element_size;
+    if (bytes_to_move > 0) memmove(position + amount * vector->element_size, position, bytes_to_move);
+    size_t bytes_to_copy = amount * vector->element_size;
+    if (!is_inside) {
+        memcpy(position, elements, bytes_to_copy);
+    } else {
+        // The part of the range left of the position stayed in place, while the rest was shifted by the inserted bytes
+        size_t position_offset = index * vector->element_size;
+        size_t left_bytes = (source_offset < position_offset) ? position_offset - source_offset : 0;
+        if (left_bytes > bytes_to_copy) left_bytes = bytes_to_copy;
+        memcpy(position, vector->elements + source_offset, left_bytes);
+        if (left_bytes < bytes_to_copy) {
+            memcpy(position + left_bytes, vector->elements + source_offset + left_bytes + bytes_to_copy, bytes_to_copy - left_bytes);
+        }
+    }
+    vector->size += amount;
+    return true;
+}
+
+bool vector_erase(Vector * vector, size_t start_index, size_t stop_index) {
+    if (vector == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to erase elements from a 'NULL' vector");
+        return false;
+    }
+    if (start_index > stop_index) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'start_index' must not be greater than the 'stop_index'");
+        return false;
+    }
+    if (stop_index >= vector->size) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'stop_index' must be less than the vector size");
+        return false;
+    }
+    // Shift the right side elements to the left (overlapping ranges, so "memmove" instead of "memcpy")
+    char * start = vector->elements + start_index * vector->element_size;
+    char * next = vector->elements + (stop_index + 1) * vector->element_size;
+    size_t bytes_to_move = (vector->size - (stop_index + 1)) * vector->element_size;
+    if (bytes_to_move > 0) memmove(start, next, bytes_to_move);
+    vector->size -= (stop_index - start_index) + 1;
+    return true;
+}
+
+bool vector_clear(Vector * vector) {
+    if (vector == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to clear a 'NULL' vector");
+        return false;
+    }
+    vector->size = 0;
+    return true;
+}
+
+void * vector_at(Vector * vector, size_t index) {
+    if (vector == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to index a 'NULL' vector");
+        return NULL;
+    }
+    if (index >= vector->size) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'index' must be less than the vector size");
+        return NULL;
+    }
+    return vector->elements + index * vector->element_size;
+}
+
+void * vector_data(Vector * vector) {
+    return (vector == NULL) ? NULL : vector->elements;
+}
+
+size_t vector_size(Vector * vector) {
+    return (vector == NULL) ? 0 : vector->size;
+}
+
+size_t vector_capacity(Vector * vector) {
+    return (vector == NULL) ? 0 : vector->capacity;
+}
+
+// Utilities
+
+// Ensures there is enough capacity for N more elements, otherwise grows the array following the growth policy
+bool vector_ensure_capacity(Vector * vector, size_t elements_amount) {
+    if (elements_amount > SIZE_MAX - vector->size) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The vector size would overflow");
+        return false;
+    }
+    size_t required_capacity = vector->size + elements_amount;
+    if (required_capacity <= vector->capacity) return true;
+    size_t new_capacity = growth_policy_next_capacity(&vector->sequence_index, required_capacity);
+    return vector_resize_buffer(vector, new_capacity);
+}
+
+bool vector_resize_buffer(Vector * vector, size_t new_capacity) {
+    if (new_capacity > SIZE_MAX / vector->element_size) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "The new capacity is too big for the 'element_size'");
+        return false;
+    }
+    char * resized_elements = realloc(vector->elements, vector->element_size * new_capacity);
+    if (resized_elements == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to reallocate memory for 'resized_elements'");
+        return false;
+    }
+    vector->elements = resized_elements;
+    vector->capacity = new_capacity;
+    return true;
+}
+
+// Checks whether the given source points inside the elements of the vector, and its byte offset if so
+bool vector_source_offset(Vector * vector, const void * source, size_t * offset) {
+    // Compared as plain numbers (the source might belong to another allocation, so pointers can't be compared)
+    uintptr_t start = (uintptr_t) vector->elements;
+    uintptr_t address = (uintptr_t) source;
+    if (vector->elements == NULL || address < start || address >= start + vector->size * vector->element_size) return false;
+    (* offset) = address - start;
+    return true;
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdbool.h>   // For "true", "false" (boolean constants)
+#include <stddef.h>    // For "size_t" (size type)
+
+/* vector.h */
+#ifndef ARRAYS_VECTOR_H
+#define ARRAYS_VECTOR_H
+
+typedef struct vector Vector;
+
+/**
+ * Creates a growable array of elements of the given size, with the default initial capacity (16 elements).
+ *
+ * The returned vector must be freed by the client after its usage.
+ *
+ * @param element_size the size of every element (in bytes)
+ *
+ * @return a new vector, or {@code NULL} if an error occurred
+ */
+Vector * vector_create_default(size_t element_size);
+
+/**
+ * Creates a growable array of elements of the given size, with the given initial capacity.
+ *
+ * The vector grows following the same golden ratio sequence as the string builder (see "growth_policy_next_capacity").
+ *
+ * The returned vector must be freed by the client after its usage.
+ *
+ * @param element_size the size of every element (in bytes)
+ * @param initial_capacity the initial capacity (in elements)
+ *
+ * @return a new vector, or {@code NULL} if an error occurred
+ */
+Vector * vector_create(size_t element_size, size_t initial_capacity);
+
+/**
+ * Frees the given vector and its elements buffer.
+ *
+ * @param vector the vector that is about to be freed
+ */
+void vector_destroy(Vector * vector);
+
+/**
+ * Ensures the given vector can hold at least the given amount of elements without growing (the capacity becomes
+ * exactly the given one if it was smaller).
+ *
+ * @param vector the vector whose capacity is to be reserved
+ * @param capacity the minimum capacity (in elements)
+ *
+ * @return {@code true} if the capacity was reserved, {@code false} otherwise
+ */
+bool vector_reserve(Vector * vector, size_t capacity);
+
+/**
+ * Appends a copy of the given element to the end of the given vector.
+ *
+ * @param vector the vector to whom the element must be appended to
+ * @param element the element to be copied ("element_size" bytes, might point into the vector itself)
+ *
+ * @note the append operation can only fail if there was a reallocation error
+ *
+ * @return {@code true} if the append operation was successful, {@code false} otherwise
+ */
+bool vector_push(Vector * vector, const void * element);
+
+/**
+ * Appends a copy of the given contiguous elements to the end of the given vector (growing at most once).
+ *
+ * @param vector the vector to whom the elements must be appended to
+ * @param elements the elements to be copied ("amount * element_size" bytes, might point into the vector itself)
+ * @param amount the amount of elements
+ *
+ * @return {@code true} if the append operation was successful, {@code false} otherwise
+ */
+bool vector_push_many(Vector * vector, const void * elements, size_t amount);
+
+/**
+ * Removes the last element of the given vector.
+ *
+ * @param vector the vector from whom the last element is to be removed
+ * @param element where the removed element is copied to (or {@code NULL} to discard it)
+ *
+ * @return {@code true} if an element was removed, {@code false} if the vector was empty
+ */
+bool vector_pop(Vector * vector, void * element);
+
+/**
+ * Inserts a copy of the given contiguous elements at the given index, shifting the following elements to the right.
+ *
+ * @param vector the vector in whom the elements are to be inserted
+ * @param index the index of the first inserted element (at most the size of the vector)
+ * @param elements the elements to be copied ("amount * element_size" bytes, might point into the vector itself)
+ * @param amount the amount of elements
+ *
+ * @return {@code true} if the insert operation was successful, {@code false} otherwise
+ */
+bool vector_insert(Vector * vector, size_t index, const void * elements, size_t amount);
+
+/**
+ * Removes all the elements between the start index (inclusive) and stop index (inclusive) from the given vector,
+ * shifting the following elements to the left.
+ *
+ * @param vector the vector from whom the elements in the given range are to be removed
+ * @param start_index the start inclusive index
+ * @param stop_index the stop inclusive index
+ *
+ * @return {@code true} if the erase operation was successful, {@code false} otherwise
+ */
+bool vector_erase(Vector * vector, size_t start_index, size_t stop_index);
+
+/**
+ * Removes all the elements of the given vector (keeping its capacity).
+ *
+ * @param vector the vector that is about to be cleared
+ *
+ * @return {@code true} if the clear operation was successful, {@code false} otherwise
+ */
+bool vector_clear(Vector * vector);
+
+/**
+ * Returns the address of the element at the given index.
+ *
+ * @param vector the vector whose element is to be found
+ * @param index the index of the element
+ *
+ * @note the address is only valid until the next operation that grows the vector
+ *
+ * @return the address of the element, or {@code NULL} if the index is out of bounds
+ */
+void * vector_at(Vector * vector, size_t index);
+
+/**
+ * Returns the address of the first element (all the elements are contiguous).
+ *
+ * @return the elements buffer of the vector (only valid until the next operation that grows the vector)
+ */
+void * vector_data(Vector * vector);
+
+/**
+ * Returns the amount of elements present in the given vector.
+ *
+ * @return the size of the vector
+ */
+size_t vector_size(Vector * vector);
+
+/**
+ * Returns the current capacity of the given vector (in elements).
+ *
+ * @return the current capacity of the vector
+ */
+size_t vector_capacity(Vector * vector);
+
+/**
+ * Generates a typed facade of the vector for the given element type, where every function is named after the given
+ * prefix (i.e., "VECTOR_DEFINE_TYPED(int_vector, int)" generates "int_vector_create", "int_vector_push",
+ * "int_vector_pop", "int_vector_get", "int_vector_set" and "int_vector_data"), so the elements are passed by value
+ * and checked by the compiler.
+ *
+ * @note the facade functions are "static inline" (so it can be used in several translation units), and the "get" and
+ *       "set" ones do not check the bounds (as indexing a plain array)
+ */
+#define VECTOR_DEFINE_TYPED(prefix, type)                                                                              \
+    static inline Vector * prefix##_create(size_t initial_capacity) {                                                 \
+        return vector_create(sizeof(type), initial_capacity);                                                          \
+    }                                                                                                                  \
+    static inline bool prefix##_push(Vector * vector, type element) {                                                  \
+        return vector_push(vector, &element);                                                                          \
+    }                                                                                                                  \
+    static inline bool prefix##_pop(Vector * vector, type * element) {                                                 \
+        return vector_pop(vector, element);                                                                            \
+    }                                                                                                                  \
+    static inline type prefix##_get(Vector * vector, size_t index) {                                                   \
+        return ((type *) vector_data(vector))[index];                                                                  \
+    }                                                                                                                  \
+    static inline void prefix##_set(Vector * vector, size_t index, type element) {                                     \
+        ((type *) vector_data(vector))[index] = element;                                                               \
+    }                                                                                                                  \
+    static inline type * prefix##_data(Vector * vector) {                                                              \
+        return (type *) vector_data(vector);                                                                           \
+    }
+
+#endif /* ARRAYS_VECTOR_H */
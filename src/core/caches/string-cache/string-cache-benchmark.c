@@ -0,0 +1,239 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L // For "clock_gettime", "CLOCK_MONOTONIC" (monotonic clock), "getline"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "string-cache.h"
+
+// Benchmarking snippet (not abstracted away for piece of code portability)
+double elapsed_seconds(struct timespec start, struct timespec stop) {
+    return (double) (stop.tv_sec - start.tv_sec) + (double) (stop.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// A trace is a sequence of key indexes, replayed as "cache-aside" lookups: every miss renders a fragment (whose size
+// depends on the key) and puts it into the cache
+
+#define KEYS_AMOUNT 100000
+#define KEY_LENGTH 16
+#define MAX_FRAGMENT_LENGTH 1024
+#define SCAN_EVERY 50000        // Every such amount of accesses a one-off scan happens (e.g. a crawler)
+#define SCAN_LENGTH 5000        // The amount of distinct never repeated keys of a scan
+
+typedef struct trace {
+    uint32_t * accesses;        // The keys indexes of the accesses
+    size_t accesses_amount;     // The amount of accesses
+    char * keys;                // The keys (every one "KEY_LENGTH" bytes long)
+    size_t keys_amount;         // The amount of distinct keys
+} Trace;
+
+uint64_t next_random(uint64_t * random_state) {
+    (* random_state) ^= (* random_state) << 13;
+    (* random_state) ^= (* random_state) >> 7;
+    (* random_state) ^= (* random_state) << 17;
+    return (* random_state);
+}
+
+// Builds a Zipf distributed trace (exponent one, so the "i"-th most popular key has weight "1 / i"), with scans
+Trace * trace_generate(size_t accesses_amount) {
+    Trace * trace = malloc(sizeof(Trace));
+    size_t scans_amount = accesses_amount / SCAN_EVERY + 1;
+    trace->keys_amount = KEYS_AMOUNT + scans_amount * SCAN_LENGTH;
+    trace->keys = malloc(trace->keys_amount * KEY_LENGTH);
+    // The index is bounded to 11 digits, so every key fits in "KEY_LENGTH" bytes (including the 'NULL' terminator)
+    for (size_t i = 0; i < trace->keys_amount; i++) snprintf(trace->keys + i * KEY_LENGTH, KEY_LENGTH, "key-%011llu", (unsigned long long) (i % 100000000000ULL));
+    double * cumulative = malloc(sizeof(double) * KEYS_AMOUNT);
+    double total = 0;
+    for (size_t i = 0; i < KEYS_AMOUNT; i++) {
+        total += 1.0 / (double) (i + 1);
+        cumulative[i] = total;
+    }
+    trace->accesses = malloc(sizeof(uint32_t) * accesses_amount);
+    trace->accesses_amount = accesses_amount;
+    uint64_t random_state = 0x9e3779b97f4a7c15ULL;
+    size_t next_scan_key = KEYS_AMOUNT;
+    for (size_t i = 0; i < accesses_amount; i++) {
+        if (i % SCAN_EVERY == SCAN_EVERY - SCAN_LENGTH && next_scan_key + SCAN_LENGTH <= trace->keys_amount) {
+            for (size_t j = 0; j < SCAN_LENGTH && i < accesses_amount; j++) trace->accesses[i++] = (uint32_t) next_scan_key++;
+            i--;
+            continue;
+        }
+        double target = (double) (next_random(&random_state) >> 11) / (double) (1ULL << 53) * total;
+        size_t low = 0, high = KEYS_AMOUNT - 1;
+        while (low < high) {
+            size_t middle = (low + high) / 2;
+            if (cumulative[middle] < target) low = middle + 1; else high = middle;
+        }
+        // Scatter the popularity ranks over the keys (so the popular keys are not the lexicographically first ones)
+        trace->accesses[i] = (uint32_t) ((low * 2654435761ULL) % KEYS_AMOUNT);
+    }
+    free(cumulative);
+    return trace;
+}
+
+// Loads a trace from a file with one key per line (the keys are numbered in order of first appearance)
+Trace * trace_load(const char * path) {
+    FILE * file = fopen(path, "r");
+    if (file == NULL) return NULL;
+    Trace * trace = calloc(1, sizeof(Trace));
+    size_t accesses_capacity = 1024, keys_capacity = 1024;
+    trace->accesses = malloc(sizeof(uint32_t) * accesses_capacity);
+    trace->keys = malloc(keys_capacity * KEY_LENGTH);
+    StringCache * numbering = string_cache_create(SIZE_MAX, STRING_CACHE_POLICY_LRU);
+    char * line = NULL;
+    size_t line_capacity = 0;
+    ssize_t line_length;
+    while ((line_length = getline(&line, &line_capacity, file)) > 0) {
+        if (line[line_length - 1] == '\n') line[--line_length] = '\0';
+        if (line_length >= KEY_LENGTH) line_length = KEY_LENGTH - 1; // Longer keys are truncated
+        line[line_length] = '\0';
+        size_t index_length;
+        const char * index = string_cache_get(numbering, line, (size_t) line_length, &index_length);
+        uint32_t key_index;
+        if (index != NULL) {
+            memcpy(&key_index, index, sizeof(uint32_t));
+        } else {
+            key_index = (uint32_t) trace->keys_amount++;
+            if (trace->keys_amount > keys_capacity) trace->keys = realloc(trace->keys, (keys_capacity *= 2) * KEY_LENGTH);
+            memset(trace->keys + key_index * KEY_LENGTH, 0, KEY_LENGTH);
+            memcpy(trace->keys + key_index * KEY_LENGTH, line, (size_t) line_length);
+            string_cache_put(numbering, line, (size_t) line_length, (const char *) &key_index, sizeof(uint32_t));
+        }
+        if (trace->accesses_amount == accesses_capacity) {
+            trace->accesses = realloc(trace->accesses, sizeof(uint32_t) * (accesses_capacity *= 2));
+        }
+        trace->accesses[trace->accesses_amount++] = key_index;
+    }
+    free(line);
+    string_cache_destroy(numbering);
+    fclose(file);
+    return trace;
+}
+
+void trace_destroy(Trace * trace) {
+    free(trace->accesses);
+    free(trace->keys);
+    free(trace);
+}
+
+// The rendered fragment size of a key (between 64 and "MAX_FRAGMENT_LENGTH" bytes, fixed for every key)
+size_t fragment_length(uint32_t key_index) {
+    return 64 + (size_t) ((key_index * 2654435761ULL) >> 7) % (MAX_FRAGMENT_LENGTH - 64);
+}
+
+// Benchmarks
+
+void string_cache_policies_benchmark(Trace * trace, size_t capacity_bytes) {
+    char fragment[MAX_FRAGMENT_LENGTH];
+    memset(fragment, 'f', sizeof(fragment));
+    const char * names[2] = { "LRU", "CLOCK" };
+    StringCachePolicy policies[2] = { STRING_CACHE_POLICY_LRU, STRING_CACHE_POLICY_CLOCK };
+    printf("Single-threaded replay (%zu accesses, %zu distinct keys, %zu KiB capacity)\n",
+           trace->accesses_amount, trace->keys_amount, capacity_bytes / 1024);
+    printf("%8s %12s %12s %12s\n", "policy", "hit ratio", "Mops/s", "evictions");
+    for (size_t i = 0; i < 2; i++) {
+        StringCache * cache = string_cache_create(capacity_bytes, policies[i]);
+        struct timespec start, stop;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (size_t j = 0; j < trace->accesses_amount; j++) {
+            uint32_t key_index = trace->accesses[j];
+            const char * key = trace->keys + (size_t) key_index * KEY_LENGTH;
+            size_t key_length = strlen(key);
+            if (string_cache_get(cache, key, key_length, NULL) == NULL) {
+                string_cache_put(cache, key, key_length, fragment, fragment_length(key_index));
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        StringCacheStatistics statistics;
+        string_cache_statistics(cache, &statistics);
+        double hit_ratio = (double) statistics.hits / (double) (statistics.hits + statistics.misses);
+        double throughput = (double) trace->accesses_amount / elapsed_seconds(start, stop) / 1e6;
+        printf("%8s %12.4f %12.2f %12zu\n", names[i], hit_ratio, throughput, statistics.evictions);
+        string_cache_destroy(cache);
+    }
+}
+
+typedef struct worker_argument {
+    ShardedStringCache * cache;
+    Trace * trace;
+    size_t first_access;        // Every thread replays the trace from its own offset
+    size_t accesses_amount;
+} WorkerArgument;
+
+void * sharded_worker(void * argument) {
+    WorkerArgument * worker = argument;
+    char fragment[MAX_FRAGMENT_LENGTH];
+    memset(fragment, 'f', sizeof(fragment));
+    for (size_t i = 0; i < worker->accesses_amount; i++) {
+        uint32_t key_index = worker->trace->accesses[(worker->first_access + i) % worker->trace->accesses_amount];
+        const char * key = worker->trace->keys + (size_t) key_index * KEY_LENGTH;
+        size_t key_length = strlen(key);
+        char * value = sharded_string_cache_get_copy(worker->cache, key, key_length, NULL);
+        if (value == NULL) {
+            sharded_string_cache_put(worker->cache, key, key_length, fragment, fragment_length(key_index));
+        }
+        free(value);
+    }
+    return NULL;
+}
+
+void sharded_string_cache_scaling_benchmark(Trace * trace, size_t capacity_bytes, size_t max_threads_amount) {
+    printf("Sharded replay (CLOCK, 64 shards)\n");
+    printf("%8s %12s %12s\n", "threads", "hit ratio", "Mops/s");
+    for (size_t threads_amount = 1; threads_amount <= max_threads_amount; threads_amount *= 2) {
+        ShardedStringCache * cache = sharded_string_cache_create(capacity_bytes, STRING_CACHE_POLICY_CLOCK, 64);
+        pthread_t * threads = malloc(sizeof(pthread_t) * threads_amount);
+        WorkerArgument * arguments = malloc(sizeof(WorkerArgument) * threads_amount);
+        struct timespec start, stop;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (size_t i = 0; i < threads_amount; i++) {
+            arguments[i].cache = cache;
+            arguments[i].trace = trace;
+            arguments[i].first_access = i * (trace->accesses_amount / threads_amount);
+            arguments[i].accesses_amount = trace->accesses_amount / threads_amount;
+            pthread_create(&threads[i], NULL, sharded_worker, &arguments[i]);
+        }
+        for (size_t i = 0; i < threads_amount; i++) pthread_join(threads[i], NULL);
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        StringCacheStatistics statistics;
+        sharded_string_cache_statistics(cache, &statistics);
+        double hit_ratio = (double) statistics.hits / (double) (statistics.hits + statistics.misses);
+        double throughput = (double) (arguments[0].accesses_amount * threads_amount) / elapsed_seconds(start, stop) / 1e6;
+        printf("%8zu %12.4f %12.2f\n", threads_amount, hit_ratio, throughput);
+        free(threads);
+        free(arguments);
+        sharded_string_cache_destroy(cache);
+    }
+}
+
+// Benchmarks runner (the arguments optionally override the amount of accesses, the maximum amount of threads, the
+// capacity in KiB, and the path of a trace file with one key per line replacing the synthetic Zipf trace)
+
+int main(int argc, char * argv[]) {
+    size_t accesses_amount = (argc > 1) ? strtoull(argv[1], NULL, 10) : 4000000;
+    size_t max_threads_amount = (argc > 2) ? strtoull(argv[2], NULL, 10) : 16;
+    size_t capacity_bytes = ((argc > 3) ? strtoull(argv[3], NULL, 10) : 8192) * 1024;
+    Trace * trace = (argc > 4) ? trace_load(argv[4]) : trace_generate(accesses_amount);
+    if (trace == NULL || trace->accesses_amount == 0) {
+        printf("Unable to load the trace file\n");
+        return 1;
+    }
+    string_cache_policies_benchmark(trace, capacity_bytes);
+    sharded_string_cache_scaling_benchmark(trace, capacity_bytes, max_threads_amount);
+    trace_destroy(trace);
+}
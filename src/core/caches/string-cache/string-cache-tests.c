@@ -0,0 +1,268 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdio.h>          // For "printf", "stderr" (printing errors)
+#include <stdlib.h>         // For "exit"
+#include <string.h>
+#include <pthread.h>
+#include "string-cache.h"
+#include "error-reporter.h"
+
+// Assertion snippet (not abstracted away for piece of code portability)
+void assert(int condition, char message[]) {
+    if (condition != 1) {
+        printf("%s\n", message);
+        exit(1);
+    }
+}
+
+// Unit testing
+
+// Returns the bytes accounted for a single entry (every key and value of the tests below has the same lengths)
+size_t entry_size_of(StringCachePolicy policy) {
+    StringCache * cache = string_cache_create(1 << 20, policy);
+    string_cache_put(cache, "k0", 2, "value-0", 7);
+    StringCacheStatistics statistics;
+    string_cache_statistics(cache, &statistics);
+    string_cache_destroy(cache);
+    return statistics.used_bytes;
+}
+
+void string_cache_put_get_remove_test() {
+    printf("*** Running test '%s'\n", __func__);
+    StringCache * cache = string_cache_create(4096, STRING_CACHE_POLICY_LRU);
+    assert(cache != NULL, "The 'cache' must not be null");
+    size_t value_length = 0;
+    assert(string_cache_get(cache, "page", 4, &value_length) == NULL, "A missing key must not be found");
+    assert(string_cache_put(cache, "page", 4, "<p>old</p>", 10), "The entry must be stored");
+    assert(string_cache_put(cache, "page", 4, "<p>new</p>!", 11), "The entry must be replaced");
+    assert(string_cache_put(cache, "", 0, "", 0), "An empty key and value must be stored");
+    const char * value = string_cache_get(cache, "page", 4, &value_length);
+    assert(value != NULL && value_length == 11, "The new value must be found");
+    assert(strcmp(value, "<p>new</p>!") == 0, "The value must be null terminated and match");
+    value = string_cache_get(cache, "", 0, &value_length);
+    assert(value != NULL && value_length == 0 && value[0] == '\0', "The empty key must be found");
+    assert(string_cache_get(cache, "pages", 5, NULL) == NULL, "A longer key must not match");
+    assert(string_cache_remove(cache, "page", 4), "The entry must be removed");
+    assert(!string_cache_remove(cache, "page", 4), "A removed entry must not be removed again");
+    assert(string_cache_get(cache, "page", 4, NULL) == NULL, "A removed entry must not be found");
+    StringCacheStatistics statistics;
+    assert(string_cache_statistics(cache, &statistics), "The statistics must be read");
+    assert(statistics.entries == 1, "Only the empty key must be left");
+    assert(statistics.hits == 2 && statistics.misses == 3, "The hits and misses must be counted");
+    assert(statistics.insertions == 3 && statistics.evictions == 0, "Replacements must not count as evictions");
+    assert(statistics.capacity_bytes == 4096, "The capacity must be kept");
+    string_cache_destroy(cache);
+}
+
+void string_cache_lru_eviction_test() {
+    printf("*** Running test '%s'\n", __func__);
+    size_t entry_size = entry_size_of(STRING_CACHE_POLICY_LRU);
+    StringCache * cache = string_cache_create(entry_size * 3, STRING_CACHE_POLICY_LRU);
+    string_cache_put(cache, "k1", 2, "value-1", 7);
+    string_cache_put(cache, "k2", 2, "value-2", 7);
+    string_cache_put(cache, "k3", 2, "value-3", 7);
+    // Touching "k1" makes "k2" the least recently used entry
+    assert(string_cache_get(cache, "k1", 2, NULL) != NULL, "The first entry must be found");
+    string_cache_put(cache, "k4", 2, "value-4", 7);
+    assert(string_cache_get(cache, "k2", 2, NULL) == NULL, "The least recently used entry must be evicted");
+    assert(string_cache_get(cache, "k1", 2, NULL) != NULL, "The touched entry must be kept");
+    assert(string_cache_get(cache, "k3", 2, NULL) != NULL, "The third entry must be kept");
+    assert(string_cache_get(cache, "k4", 2, NULL) != NULL, "The new entry must be kept");
+    StringCacheStatistics statistics;
+    string_cache_statistics(cache, &statistics);
+    assert(statistics.evictions == 1 && statistics.entries == 3, "Exactly one entry must be evicted");
+    assert(statistics.used_bytes == entry_size * 3, "The used bytes must match the entries");
+    string_cache_destroy(cache);
+}
+
+void string_cache_clock_eviction_test() {
+    printf("*** Running test '%s'\n", __func__);
+    size_t entry_size = entry_size_of(STRING_CACHE_POLICY_CLOCK);
+    StringCache * cache = string_cache_create(entry_size * 3, STRING_CACHE_POLICY_CLOCK);
+    string_cache_put(cache, "k1", 2, "value-1", 7);
+    string_cache_put(cache, "k2", 2, "value-2", 7);
+    string_cache_put(cache, "k3", 2, "value-3", 7);
+    // Referenced "k1" and "k2" get a second chance, so "k3" is the first unreferenced entry found
+    string_cache_get(cache, "k1", 2, NULL);
+    string_cache_get(cache, "k2", 2, NULL);
+    string_cache_put(cache, "k4", 2, "value-4", 7);
+    assert(string_cache_get(cache, "k3", 2, NULL) == NULL, "The unreferenced entry must be evicted");
+    assert(string_cache_get(cache, "k1", 2, NULL) != NULL, "The first referenced entry must be kept");
+    assert(string_cache_get(cache, "k2", 2, NULL) != NULL, "The second referenced entry must be kept");
+    // Every entry is referenced now, so the sweep clears them all and evicts the oldest one ("k1")
+    string_cache_get(cache, "k4", 2, NULL);
+    string_cache_put(cache, "k5", 2, "value-5", 7);
+    assert(string_cache_get(cache, "k1", 2, NULL) == NULL, "The oldest entry must be evicted after a full sweep");
+    assert(string_cache_get(cache, "k5", 2, NULL) != NULL, "The new entry must be kept");
+    string_cache_destroy(cache);
+}
+
+void string_cache_byte_capacity_test() {
+    printf("*** Running test '%s'\n", __func__);
+    size_t entry_size = entry_size_of(STRING_CACHE_POLICY_LRU);
+    StringCache * cache = string_cache_create(entry_size * 4, STRING_CACHE_POLICY_LRU);
+    char large[256];
+    memset(large, 'x', sizeof(large));
+    for (int i = 0; i < 4; i++) {
+        char key[3] = { 'k', (char) ('0' + i), '\0' };
+        string_cache_put(cache, key, 2, "value-0", 7);
+    }
+    // A large value takes the room of several small entries
+    assert(string_cache_put(cache, "kl", 2, large, 256 - entry_size * 2), "The large entry must be stored");
+    StringCacheStatistics statistics;
+    string_cache_statistics(cache, &statistics);
+    assert(statistics.used_bytes <= statistics.capacity_bytes, "The used bytes must never exceed the capacity");
+    assert(statistics.evictions >= 1, "Small entries must be evicted to make room");
+    // An entry bigger than the whole cache is rejected (and leaves the cache untouched)
+    StringCache * tiny = string_cache_create(64, STRING_CACHE_POLICY_LRU);
+    assert(!string_cache_put(tiny, "kl", 2, large, sizeof(large)), "An oversized entry must be rejected");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "The error must be an invalid argument");
+    string_cache_statistics(tiny, &statistics);
+    assert(statistics.entries == 0 && statistics.used_bytes == 0, "A rejected entry must not be stored");
+    string_cache_destroy(tiny);
+    string_cache_destroy(cache);
+}
+
+void string_cache_many_entries_test() {
+    printf("*** Running test '%s'\n", __func__);
+    StringCache * cache = string_cache_create(1 << 22, STRING_CACHE_POLICY_CLOCK);
+    char key[32];
+    char value[32];
+    // Enough entries to grow the index several times
+    for (int i = 0; i < 20000; i++) {
+        int key_length = sprintf(key, "key-%d", i);
+        int value_length = sprintf(value, "value-%d", i);
+        assert(string_cache_put(cache, key, (size_t) key_length, value, (size_t) value_length), "The entry must be stored");
+    }
+    for (int i = 0; i < 20000; i++) {
+        int key_length = sprintf(key, "key-%d", i);
+        sprintf(value, "value-%d", i);
+        const char * found = string_cache_get(cache, key, (size_t) key_length, NULL);
+        assert(found != NULL && strcmp(found, value) == 0, "Every entry must be found with its value");
+    }
+    string_cache_destroy(cache);
+}
+
+void string_cache_invalid_arguments_test() {
+    printf("*** Running test '%s'\n", __func__);
+    assert(string_cache_create(1024, (StringCachePolicy) 7) == NULL, "An unknown policy must be rejected");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "The error must be an invalid argument");
+    assert(!string_cache_put(NULL, "a", 1, "b", 1), "A 'NULL' cache must be rejected");
+    assert(error_reporter_last_code() == ERROR_CODE_NULL_ARGUMENT, "The error must be a null argument");
+    StringCache * cache = string_cache_create(1024, STRING_CACHE_POLICY_LRU);
+    assert(!string_cache_put(cache, NULL, 1, "b", 1), "A 'NULL' key must be rejected");
+    assert(!string_cache_put(cache, "a", 1, NULL, 1), "A 'NULL' value must be rejected");
+    assert(string_cache_get(cache, NULL, 1, NULL) == NULL, "A 'NULL' key must not be found");
+    assert(!string_cache_statistics(cache, NULL), "A 'NULL' statistics must be rejected");
+    assert(sharded_string_cache_create(1024, STRING_CACHE_POLICY_LRU, 0) == NULL, "A zero shards amount must be rejected");
+    assert(sharded_string_cache_get_copy(NULL, "a", 1, NULL) == NULL, "A 'NULL' sharded cache must be rejected");
+    string_cache_destroy(cache);
+    string_cache_destroy(NULL);
+    sharded_string_cache_destroy(NULL);
+}
+
+void sharded_string_cache_test() {
+    printf("*** Running test '%s'\n", __func__);
+    ShardedStringCache * cache = sharded_string_cache_create(1 << 16, STRING_CACHE_POLICY_LRU, 3);
+    assert(cache != NULL, "The 'cache' must not be null");
+    assert(sharded_string_cache_put(cache, "page", 4, "<p>body</p>", 11), "The entry must be stored");
+    size_t value_length = 0;
+    char * copy = sharded_string_cache_get_copy(cache, "page", 4, &value_length);
+    assert(copy != NULL && value_length == 11 && strcmp(copy, "<p>body</p>") == 0, "A copy of the value must be returned");
+    free(copy);
+    assert(sharded_string_cache_get_copy(cache, "other", 5, NULL) == NULL, "A missing key must not be found");
+    assert(sharded_string_cache_remove(cache, "page", 4), "The entry must be removed");
+    assert(sharded_string_cache_get_copy(cache, "page", 4, NULL) == NULL, "A removed entry must not be found");
+    StringCacheStatistics statistics;
+    assert(sharded_string_cache_statistics(cache, &statistics), "The statistics must be read");
+    assert(statistics.hits == 1 && statistics.misses == 2, "The statistics must be summed across shards");
+    assert(statistics.capacity_bytes == 1 << 16, "The capacity must be split across the shards");
+    sharded_string_cache_destroy(cache);
+}
+
+// Every thread puts and reads keys of a shared key space within a small cache (so evictions happen all the time),
+// where every found value must be the one of its key
+#define THREADS_AMOUNT 8
+#define KEYS_AMOUNT 2048
+#define OPERATIONS_PER_THREAD 40000
+
+typedef struct worker_state {
+    ShardedStringCache * cache;
+    size_t worker_index;
+    bool is_consistent;
+} WorkerState;
+
+void * sharded_string_cache_worker(void * argument) {
+    WorkerState * worker = argument;
+    char key[32];
+    char value[48];
+    unsigned long long random_state = 0x9e3779b97f4a7c15ULL * (worker->worker_index + 1);
+    for (size_t i = 0; i < OPERATIONS_PER_THREAD; i++) {
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 7;
+        random_state ^= random_state << 17;
+        unsigned long key_index = (unsigned long) (random_state % KEYS_AMOUNT);
+        int key_length = sprintf(key, "k-%lu", key_index);
+        if (random_state % 4 == 0) {
+            int value_length = sprintf(value, "value-of-%lu", key_index);
+            sharded_string_cache_put(worker->cache, key, (size_t) key_length, value, (size_t) value_length);
+        } else if (random_state % 16 == 1) {
+            sharded_string_cache_remove(worker->cache, key, (size_t) key_length);
+        } else {
+            char * copy = sharded_string_cache_get_copy(worker->cache, key, (size_t) key_length, NULL);
+            if (copy != NULL) {
+                unsigned long found_index = strtoul(copy + 9, NULL, 10);
+                if (found_index != key_index) worker->is_consistent = false;
+                free(copy);
+            }
+        }
+    }
+    return NULL;
+}
+
+void sharded_string_cache_threads_test() {
+    printf("*** Running test '%s'\n", __func__);
+    ShardedStringCache * cache = sharded_string_cache_create(32 * 1024, STRING_CACHE_POLICY_CLOCK, 8);
+    pthread_t threads[THREADS_AMOUNT];
+    WorkerState workers[THREADS_AMOUNT];
+    for (size_t i = 0; i < THREADS_AMOUNT; i++) {
+        workers[i].cache = cache;
+        workers[i].worker_index = i;
+        workers[i].is_consistent = true;
+        pthread_create(&threads[i], NULL, sharded_string_cache_worker, &workers[i]);
+    }
+    for (size_t i = 0; i < THREADS_AMOUNT; i++) {
+        pthread_join(threads[i], NULL);
+        assert(workers[i].is_consistent, "Every found value must belong to its key");
+    }
+    StringCacheStatistics statistics;
+    sharded_string_cache_statistics(cache, &statistics);
+    assert(statistics.used_bytes <= statistics.capacity_bytes, "The used bytes must never exceed the capacity");
+    assert(statistics.evictions > 0, "The small cache must have evicted entries");
+    sharded_string_cache_destroy(cache);
+}
+
+// Tests runner
+
+int main() {
+    fclose(stderr);
+    string_cache_put_get_remove_test();
+    string_cache_lru_eviction_test();
+    string_cache_clock_eviction_test();
+    string_cache_byte_capacity_test();
+    string_cache_many_entries_test();
+    string_cache_invalid_arguments_test();
+    sharded_string_cache_test();
+    sharded_string_cache_threads_test();
+}
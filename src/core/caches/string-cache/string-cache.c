@@ -0,0 +1,455 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * A Bounded String Cache Implementation (with LRU or CLOCK eviction, and an optional sharded concurrent version).
+ *
+ * ### Explanation ###
+ *
+ * A cache keeps the most useful entries within a memory budget. Every entry is a single allocation holding its
+ * header, its key and its value (so a lookup touches one block of memory, and an eviction frees one block), and the
+ * budget counts the bytes of whole entries (rendered fragments have really different sizes, so counting entries
+ * would not bound the memory at all).
+ *
+ * Every entry is linked (intrusively, through its own header) both into a chained hash index (by its FNV-1a hash)
+ * and into a doubly linked list ordered by insertion or recency, so the lookups, the insertions and the evictions
+ * are all O(1).
+ *
+ * ### Eviction Policies ###
+ *
+ * - LRU: every hit moves its entry to the front of the list, and the entry at the back is evicted.
+ * - CLOCK: every hit only sets a "referenced" bit (no list changes, so hits are cheaper), and the eviction sweeps from
+ *   the back, giving every referenced entry a second chance (clearing its bit and moving it to the front) until it
+ *   finds an unreferenced one, which approximates LRU while being scan resistant enough for most traces.
+ *
+ * ### Sharding ###
+ *
+ * The concurrent version splits the capacity across shards (picked by the high bits of the key hash), each one a
+ * single-threaded cache guarded by its own mutex, and the values are returned as copies (another thread might evict
+ * the entry as soon as the shard is unlocked).
+ *
+ * ### References ###
+ *
+ * - https://en.wikipedia.org/wiki/Cache_replacement_policies
+ * - https://www.multicians.org/paging-experiment.pdf (Corbató, A Paging Experiment with the Multics System, CLOCK)
+ * - https://s3fifo.com/ (Yang et al., FIFO Queues are All You Need for Cache Eviction)
+ */
+
+// Imports & Headers
+
+#include <stdlib.h>         // For "malloc", "calloc", "free" (memory management)
+#include <stdint.h>         // For "uint64_t" (more integer types)
+#include <string.h>         // For "memcpy", "memcmp" (copying and comparing entries)
+#include <pthread.h>        // For "pthread_mutex_t" (shards locks)
+#include "string-cache.h"
+#include "fnv1a.h"          // For "hashes_fnv1a_hash64_bytes_into" (hashing keys)
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+
+// Default implementation values
+
+#define CACHE_LINE_SIZE 64                  // The size of a cache line (to avoid false sharing between shards)
+#define INITIAL_BUCKETS_AMOUNT 64           // The amount of buckets of a new index
+
+// Structures
+
+typedef struct cache_entry {
+    struct cache_entry * chain_next;        // The next entry of the same index bucket
+    struct cache_entry * previous;          // The previous (more recent) entry of the list
+    struct cache_entry * next;              // The next (less recent) entry of the list
+    uint64_t hash;                          // The hash of the key
+    size_t key_length;                      // The length of the key
+    size_t value_length;                    // The length of the value
+    bool is_referenced;                     // Whether the entry was hit since the last sweep (CLOCK only)
+    char bytes[];                           // The key bytes, followed by the value bytes (null terminated)
+} CacheEntry;
+
+struct string_cache {
+    CacheEntry ** buckets;                  // The chained hash index
+    size_t buckets_mask;                    // The mask of the bucket of a hash (the amount of buckets minus one)
+    CacheEntry * head;                      // The most recent entry
+    CacheEntry * tail;                      // The least recent entry (the eviction candidate)
+    StringCachePolicy policy;               // The eviction policy
+    StringCacheStatistics statistics;       // The counters (also holding the entries amount and the used bytes)
+};
+
+typedef struct cache_shard {
+    _Alignas(CACHE_LINE_SIZE) pthread_mutex_t lock;     // Guards the shard cache
+    StringCache * cache;                                // The single-threaded cache of the shard
+} CacheShard;
+
+struct sharded_string_cache {
+    CacheShard * shards;                    // The shards (each one on its own cache lines)
+    size_t shards_amount;                   // The amount of shards (always a power of two)
+    unsigned shard_shift;                   // The shift of the hash high bits picking the shard (plus one)
+};
+
+// Definition (to be able to use methods before declaring them, to follow up the top-bottom code style)
+
+bool string_cache_put_hashed(StringCache * cache, uint64_t hash, const char * key, size_t key_length, const char * value, size_t value_length);
+CacheEntry * string_cache_get_hashed(StringCache * cache, uint64_t hash, const char * key, size_t key_length);
+bool string_cache_remove_hashed(StringCache * cache, uint64_t hash, const char * key, size_t key_length);
+CacheEntry * string_cache_find(StringCache * cache, uint64_t hash, const char * key, size_t key_length);
+void string_cache_unlink(StringCache * cache, CacheEntry * entry);
+void string_cache_push_front(StringCache * cache, CacheEntry * entry);
+void string_cache_list_remove(StringCache * cache, CacheEntry * entry);
+void string_cache_evict_one(StringCache * cache);
+void string_cache_grow_index(StringCache * cache);
+size_t string_cache_entry_size(size_t key_length, size_t value_length);
+bool string_cache_validate(const void * cache, const char * key, size_t key_length, const char function[]);
+
+// Implementation (single-threaded cache)
+
+StringCache * string_cache_create(size_t capacity_bytes, StringCachePolicy policy) {
+    if (policy != STRING_CACHE_POLICY_LRU && policy != STRING_CACHE_POLICY_CLOCK) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "Unknown cache eviction policy");
+        return NULL;
+    }
+    StringCache * cache = malloc(sizeof(StringCache));
+    if (cache == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'cache'");
+        return NULL;
+    }
+    cache->buckets = calloc(INITIAL_BUCKETS_AMOUNT, sizeof(CacheEntry *));
+    if (cache->buckets == NULL) {
+        free(cache);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'buckets'");
+        return NULL;
+    }
+    cache->buckets_mask = INITIAL_BUCKETS_AMOUNT - 1;
+    cache->head = NULL;
+    cache->tail = NULL;
+    cache->policy = policy;
+    memset(&cache->statistics, 0, sizeof(StringCacheStatistics));
+    cache->statistics.capacity_bytes = capacity_bytes;
+    return cache;
+}
+
+void string_cache_destroy(StringCache * cache) {
+    if (cache == NULL) return;
+    CacheEntry * entry = cache->head;
+    while (entry != NULL) {
+        CacheEntry * next = entry->next;
+        free(entry);
+        entry = next;
+    }
+    free(cache->buckets);
+    free(cache);
+}
+
+bool string_cache_put(StringCache * cache, const char * key, size_t key_length, const char * value, size_t value_length) {
+    if (!string_cache_validate(cache, key, key_length, __func__)) return false;
+    uint64_t hash;
+    hashes_fnv1a_hash64_bytes_into(key, key_length, &hash);
+    return string_cache_put_hashed(cache, hash, key, key_length, value, value_length);
+}
+
+const char * string_cache_get(StringCache * cache, const char * key, size_t key_length, size_t * value_length) {
+    if (!string_cache_validate(cache, key, key_length, __func__)) return NULL;
+    uint64_t hash;
+    hashes_fnv1a_hash64_bytes_into(key, key_length, &hash);
+    CacheEntry * entry = string_cache_get_hashed(cache, hash, key, key_length);
+    if (entry == NULL) return NULL;
+    if (value_length != NULL) (* value_length) = entry->value_length;
+    return entry->bytes + entry->key_length;
+}
+
+bool string_cache_remove(StringCache * cache, const char * key, size_t key_length) {
+    if (!string_cache_validate(cache, key, key_length, __func__)) return false;
+    uint64_t hash;
+    hashes_fnv1a_hash64_bytes_into(key, key_length, &hash);
+    return string_cache_remove_hashed(cache, hash, key, key_length);
+}
+
+bool string_cache_statistics(StringCache * cache, StringCacheStatistics * statistics) {
+    if (cache == NULL || statistics == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to read the statistics of a 'NULL' cache");
+        return false;
+    }
+    (* statistics) = cache->statistics;
+    return true;
+}
+
+// Implementation (sharded concurrent cache)
+
+ShardedStringCache * sharded_string_cache_create(size_t capacity_bytes, StringCachePolicy policy, size_t shards_amount) {
+    if (shards_amount == 0 || shards_amount > ((size_t) 1 << 16)) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The shards amount must be between 1 and 65536");
+        return NULL;
+    }
+    unsigned shard_bits = 0;
+    while (((size_t) 1 << shard_bits) < shards_amount) shard_bits++;
+    shards_amount = (size_t) 1 << shard_bits;
+    ShardedStringCache * sharded_cache = malloc(sizeof(ShardedStringCache));
+    if (sharded_cache == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'cache'");
+        return NULL;
+    }
+    sharded_cache->shards = aligned_alloc(CACHE_LINE_SIZE, sizeof(CacheShard) * shards_amount);
+    if (sharded_cache->shards == NULL) {
+        free(sharded_cache);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'shards'");
+        return NULL;
+    }
+    size_t created_amount = 0;
+    for (; created_amount < shards_amount; created_amount++) {
+        CacheShard * shard = &sharded_cache->shards[created_amount];
+        shard->cache = string_cache_create(capacity_bytes / shards_amount, policy);
+        if (shard->cache == NULL) break;
+        pthread_mutex_init(&shard->lock, NULL);
+    }
+    if (created_amount < shards_amount) {
+        for (size_t i = 0; i < created_amount; i++) {
+            string_cache_destroy(sharded_cache->shards[i].cache);
+            pthread_mutex_destroy(&sharded_cache->shards[i].lock);
+        }
+        free(sharded_cache->shards);
+        free(sharded_cache);
+        return NULL;
+    }
+    sharded_cache->shards_amount = shards_amount;
+    // The shift is split in two, so a single shard (zero bits) does not need a full width shift (undefined behavior)
+    sharded_cache->shard_shift = 63 - shard_bits;
+    return sharded_cache;
+}
+
+void sharded_string_cache_destroy(ShardedStringCache * cache) {
+    if (cache == NULL) return;
+    for (size_t i = 0; i < cache->shards_amount; i++) {
+        string_cache_destroy(cache->shards[i].cache);
+        pthread_mutex_destroy(&cache->shards[i].lock);
+    }
+    free(cache->shards);
+    free(cache);
+}
+
+bool sharded_string_cache_put(ShardedStringCache * cache, const char * key, size_t key_length, const char * value, size_t value_length) {
+    if (!string_cache_validate(cache, key, key_length, __func__)) return false;
+    uint64_t hash;
+    hashes_fnv1a_hash64_bytes_into(key, key_length, &hash);
+    CacheShard * shard = &cache->shards[(hash >> cache->shard_shift) >> 1];
+    pthread_mutex_lock(&shard->lock);
+    bool is_stored = string_cache_put_hashed(shard->cache, hash, key, key_length, value, value_length);
+    pthread_mutex_unlock(&shard->lock);
+    return is_stored;
+}
+
+char * sharded_string_cache_get_copy(ShardedStringCache * cache, const char * key, size_t key_length, size_t * value_length) {
+    if (!string_cache_validate(cache, key, key_length, __func__)) return NULL;
+    uint64_t hash;
+    hashes_fnv1a_hash64_bytes_into(key, key_length, &hash);
+    CacheShard * shard = &cache->shards[(hash >> cache->shard_shift) >> 1];
+    char * copy = NULL;
+    pthread_mutex_lock(&shard->lock);
+    CacheEntry * entry = string_cache_get_hashed(shard->cache, hash, key, key_length);
+    if (entry != NULL) {
+        copy = malloc(entry->value_length + 1);
+        if (copy != NULL) {
+            memcpy(copy, entry->bytes + entry->key_length, entry->value_length + 1);
+            if (value_length != NULL) (* value_length) = entry->value_length;
+        }
+    }
+    pthread_mutex_unlock(&shard->lock);
+    if (entry != NULL && copy == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'copy'");
+    }
+    return copy;
+}
+
+bool sharded_string_cache_remove(ShardedStringCache * cache, const char * key, size_t key_length) {
+    if (!string_cache_validate(cache, key, key_length, __func__)) return false;
+    uint64_t hash;
+    hashes_fnv1a_hash64_bytes_into(key, key_length, &hash);
+    CacheShard * shard = &cache->shards[(hash >> cache->shard_shift) >> 1];
+    pthread_mutex_lock(&shard->lock);
+    bool is_removed = string_cache_remove_hashed(shard->cache, hash, key, key_length);
+    pthread_mutex_unlock(&shard->lock);
+    return is_removed;
+}
+
+bool sharded_string_cache_statistics(ShardedStringCache * cache, StringCacheStatistics * statistics) {
+    if (cache == NULL || statistics == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to read the statistics of a 'NULL' cache");
+        return false;
+    }
+    memset(statistics, 0, sizeof(StringCacheStatistics));
+    for (size_t i = 0; i < cache->shards_amount; i++) {
+        CacheShard * shard = &cache->shards[i];
+        pthread_mutex_lock(&shard->lock);
+        StringCacheStatistics * shard_statistics = &shard->cache->statistics;
+        statistics->hits += shard_statistics->hits;
+        statistics->misses += shard_statistics->misses;
+        statistics->insertions += shard_statistics->insertions;
+        statistics->evictions += shard_statistics->evictions;
+        statistics->entries += shard_statistics->entries;
+        statistics->used_bytes += shard_statistics->used_bytes;
+        statistics->capacity_bytes += shard_statistics->capacity_bytes;
+        pthread_mutex_unlock(&shard->lock);
+    }
+    return true;
+}
+
+// Utilities
+
+bool string_cache_put_hashed(StringCache * cache, uint64_t hash, const char * key, size_t key_length, const char * value, size_t value_length) {
+    if (value == NULL && value_length > 0) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to put a 'NULL' value");
+        return false;
+    }
+    size_t entry_size = string_cache_entry_size(key_length, value_length);
+    if (entry_size > cache->statistics.capacity_bytes) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The entry is bigger than the cache capacity");
+        return false;
+    }
+    // Step 1: Build the new entry (header, key and value in a single allocation)
+    CacheEntry * entry = malloc(sizeof(CacheEntry) + key_length + value_length + 1);
+    if (entry == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'entry'");
+        return false;
+    }
+    entry->hash = hash;
+    entry->key_length = key_length;
+    entry->value_length = value_length;
+    entry->is_referenced = false;
+    if (key_length > 0) memcpy(entry->bytes, key, key_length);
+    if (value_length > 0) memcpy(entry->bytes + key_length, value, value_length);
+    entry->bytes[key_length + value_length] = '\0';
+    // Step 2: Drop the previous entry of the key (if any), and make room for the new one
+    string_cache_remove_hashed(cache, hash, key, key_length);
+    while (cache->statistics.used_bytes + entry_size > cache->statistics.capacity_bytes) {
+        string_cache_evict_one(cache);
+    }
+    // Step 3: Link the new entry into the index and the list
+    if (cache->statistics.entries >= cache->buckets_mask + 1) string_cache_grow_index(cache);
+    CacheEntry ** bucket = &cache->buckets[hash & cache->buckets_mask];
+    entry->chain_next = (* bucket);
+    (* bucket) = entry;
+    string_cache_push_front(cache, entry);
+    cache->statistics.entries++;
+    cache->statistics.used_bytes += entry_size;
+    cache->statistics.insertions++;
+    return true;
+}
+
+CacheEntry * string_cache_get_hashed(StringCache * cache, uint64_t hash, const char * key, size_t key_length) {
+    CacheEntry * entry = string_cache_find(cache, hash, key, key_length);
+    if (entry == NULL) {
+        cache->statistics.misses++;
+        return NULL;
+    }
+    cache->statistics.hits++;
+    // LRU moves the entry to the front, while CLOCK only marks it (which is cheaper, as the list is untouched)
+    if (cache->policy == STRING_CACHE_POLICY_LRU) {
+        if (cache->head != entry) {
+            string_cache_list_remove(cache, entry);
+            string_cache_push_front(cache, entry);
+        }
+    } else {
+        entry->is_referenced = true;
+    }
+    return entry;
+}
+
+bool string_cache_remove_hashed(StringCache * cache, uint64_t hash, const char * key, size_t key_length) {
+    CacheEntry * entry = string_cache_find(cache, hash, key, key_length);
+    if (entry == NULL) return false;
+    string_cache_unlink(cache, entry);
+    return true;
+}
+
+CacheEntry * string_cache_find(StringCache * cache, uint64_t hash, const char * key, size_t key_length) {
+    CacheEntry * entry = cache->buckets[hash & cache->buckets_mask];
+    while (entry != NULL) {
+        if (entry->hash == hash && entry->key_length == key_length && (key_length == 0 || memcmp(entry->bytes, key, key_length) == 0)) {
+            return entry;
+        }
+        entry = entry->chain_next;
+    }
+    return NULL;
+}
+
+// Unlinks the entry from the index and the list, and frees it
+void string_cache_unlink(StringCache * cache, CacheEntry * entry) {
+    CacheEntry ** link = &cache->buckets[entry->hash & cache->buckets_mask];
+    while ((* link) != entry) link = &(* link)->chain_next;
+    (* link) = entry->chain_next;
+    string_cache_list_remove(cache, entry);
+    cache->statistics.entries--;
+    cache->statistics.used_bytes -= string_cache_entry_size(entry->key_length, entry->value_length);
+    free(entry);
+}
+
+void string_cache_push_front(StringCache * cache, CacheEntry * entry) {
+    entry->previous = NULL;
+    entry->next = cache->head;
+    if (cache->head != NULL) cache->head->previous = entry;
+    cache->head = entry;
+    if (cache->tail == NULL) cache->tail = entry;
+}
+
+void string_cache_list_remove(StringCache * cache, CacheEntry * entry) {
+    if (entry->previous != NULL) entry->previous->next = entry->next; else cache->head = entry->next;
+    if (entry->next != NULL) entry->next->previous = entry->previous; else cache->tail = entry->previous;
+}
+
+// Evicts the entry chosen by the policy (the cache must not be empty)
+void string_cache_evict_one(StringCache * cache) {
+    CacheEntry * victim = cache->tail;
+    // CLOCK gives every referenced entry a second chance (terminates, as every visited entry loses its mark)
+    if (cache->policy == STRING_CACHE_POLICY_CLOCK) {
+        while (victim->is_referenced) {
+            victim->is_referenced = false;
+            string_cache_list_remove(cache, victim);
+            string_cache_push_front(cache, victim);
+            victim = cache->tail;
+        }
+    }
+    string_cache_unlink(cache, victim);
+    cache->statistics.evictions++;
+}
+
+// Doubles the amount of buckets (keeping the load factor at most one, so the chains stay short)
+void string_cache_grow_index(StringCache * cache) {
+    size_t buckets_amount = (cache->buckets_mask + 1) * 2;
+    CacheEntry ** buckets = calloc(buckets_amount, sizeof(CacheEntry *));
+    if (buckets == NULL) return; // Keep the current index (longer chains, but still correct)
+    for (size_t i = 0; i <= cache->buckets_mask; i++) {
+        CacheEntry * entry = cache->buckets[i];
+        while (entry != NULL) {
+            CacheEntry * next = entry->chain_next;
+            CacheEntry ** bucket = &buckets[entry->hash & (buckets_amount - 1)];
+            entry->chain_next = (* bucket);
+            (* bucket) = entry;
+            entry = next;
+        }
+    }
+    free(cache->buckets);
+    cache->buckets = buckets;
+    cache->buckets_mask = buckets_amount - 1;
+}
+
+// The bytes accounted for an entry (its header, its key, and its null terminated value)
+size_t string_cache_entry_size(size_t key_length, size_t value_length) {
+    return sizeof(CacheEntry) + key_length + value_length + 1;
+}
+
+bool string_cache_validate(const void * cache, const char * key, size_t key_length, const char function[]) {
+    if (cache == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, function, "Trying to use a 'NULL' cache");
+        return false;
+    }
+    if (key == NULL && key_length > 0) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, function, "Trying to use a 'NULL' key");
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdbool.h>   // For "true", "false" (boolean constants)
+#include <stddef.h>    // For "size_t" (size type)
+
+/* string-cache.h */
+#ifndef CACHES_STRING_CACHE_H
+#define CACHES_STRING_CACHE_H
+
+typedef struct string_cache StringCache;
+typedef struct sharded_string_cache ShardedStringCache;
+
+/**
+ * Which entry is evicted when the cache needs room for a new one.
+ */
+typedef enum string_cache_policy {
+    STRING_CACHE_POLICY_LRU = 0,    // The least recently used entry (every hit moves its entry to the front)
+    STRING_CACHE_POLICY_CLOCK,      // The oldest entry not hit since the last sweep (every hit only marks its entry)
+} StringCachePolicy;
+
+/**
+ * The counters of a cache (the hit ratio is "hits / (hits + misses)").
+ */
+typedef struct string_cache_statistics {
+    size_t hits;                    // The amount of lookups that found their key
+    size_t misses;                  // The amount of lookups that did not find their key
+    size_t insertions;              // The amount of stored entries (including the replacements)
+    size_t evictions;               // The amount of entries evicted to make room for others
+    size_t entries;                 // The amount of entries currently stored
+    size_t used_bytes;              // The amount of bytes currently taken by the entries (including their headers)
+    size_t capacity_bytes;          // The maximum amount of bytes the entries can take
+} StringCacheStatistics;
+
+// Single-threaded cache
+
+/**
+ * Creates a bounded cache of string keys to string values (both copied into a single allocation per entry), which
+ * evicts entries once their total size (keys, values and headers) exceeds the given capacity.
+ *
+ * The returned cache must be freed by the client after its usage.
+ *
+ * @param capacity_bytes the maximum amount of bytes the entries can take
+ * @param policy the eviction policy
+ *
+ * @return a new cache, or {@code NULL} if an error occurred
+ */
+StringCache * string_cache_create(size_t capacity_bytes, StringCachePolicy policy);
+
+/**
+ * Frees the given cache and all its entries.
+ *
+ * @param cache the cache that is about to be freed
+ */
+void string_cache_destroy(StringCache * cache);
+
+/**
+ * Stores a copy of the given value under a copy of the given key (replacing the previous value, if any), evicting
+ * other entries if needed.
+ *
+ * @param cache the cache where the entry is to be stored
+ * @param key the bytes of the key
+ * @param key_length the length of the key (an empty key is valid)
+ * @param value the bytes of the value
+ * @param value_length the length of the value (an empty value is valid)
+ *
+ * @return {@code true} if the entry was stored, {@code false} if it is bigger than the whole cache (or an error
+ *         occurred)
+ */
+bool string_cache_put(StringCache * cache, const char * key, size_t key_length, const char * value, size_t value_length);
+
+/**
+ * Looks up the value of the given key (counting a hit or a miss, and marking the entry as recently used).
+ *
+ * @param cache the cache where the key is to be looked up
+ * @param key the bytes of the key
+ * @param key_length the length of the key (an empty key is valid)
+ * @param value_length where the length of the value is to be stored (if found), can be {@code NULL} if not needed
+ *
+ * @return the value (null terminated, and only valid until the next change of the cache), or {@code NULL} if the key
+ *         is missing (or an error occurred)
+ */
+const char * string_cache_get(StringCache * cache, const char * key, size_t key_length, size_t * value_length);
+
+/**
+ * Removes the entry of the given key.
+ *
+ * @param cache the cache where the entry is to be removed from
+ * @param key the bytes of the key
+ * @param key_length the length of the key (an empty key is valid)
+ *
+ * @return {@code true} if the entry was removed, {@code false} if it was missing (or an error occurred)
+ */
+bool string_cache_remove(StringCache * cache, const char * key, size_t key_length);
+
+/**
+ * Obtains the counters of the given cache.
+ *
+ * @param cache the cache to be checked
+ * @param statistics where the counters are to be stored
+ *
+ * @return {@code true} if the counters were obtained, {@code false} if an argument is {@code NULL}
+ */
+bool string_cache_statistics(StringCache * cache, StringCacheStatistics * statistics);
+
+// Sharded concurrent cache
+
+/**
+ * Creates a concurrent bounded cache, split in shards (each one a single-threaded cache with its own lock and an
+ * equal part of the capacity), where the shard of a key is picked by the high bits of its hash.
+ *
+ * The returned cache must be freed by the client after its usage.
+ *
+ * @param capacity_bytes the maximum amount of bytes the entries of all the shards can take
+ * @param policy the eviction policy of every shard
+ * @param shards_amount the minimum amount of shards (rounded up to a power of two)
+ *
+ * @return a new cache, or {@code NULL} if an error occurred
+ */
+ShardedStringCache * sharded_string_cache_create(size_t capacity_bytes, StringCachePolicy policy, size_t shards_amount);
+
+/**
+ * Frees the given cache and all its entries.
+ *
+ * @param cache the cache that is about to be freed
+ *
+ * @note no thread must be using the cache during its destruction
+ */
+void sharded_string_cache_destroy(ShardedStringCache * cache);
+
+/**
+ * Stores a copy of the given value under a copy of the given key (see "string_cache_put").
+ *
+ * @param cache the cache where the entry is to be stored
+ * @param key the bytes of the key
+ * @param key_length the length of the key (an empty key is valid)
+ * @param value the bytes of the value
+ * @param value_length the length of the value (an empty value is valid)
+ *
+ * @return {@code true} if the entry was stored, {@code false} if it is bigger than a whole shard (or an error
+ *         occurred)
+ */
+bool sharded_string_cache_put(ShardedStringCache * cache, const char * key, size_t key_length, const char * value, size_t value_length);
+
+/**
+ * Looks up the value of the given key, returning a copy of it (as the entry might be evicted by another thread as
+ * soon as the shard lock is released).
+ *
+ * The returned copy must be freed by the client after its usage.
+ *
+ * @param cache the cache where the key is to be looked up
+ * @param key the bytes of the key
+ * @param key_length the length of the key (an empty key is valid)
+ * @param value_length where the length of the value is to be stored (if found), can be {@code NULL} if not needed
+ *
+ * @return a null terminated copy of the value, or {@code NULL} if the key is missing (or an error occurred)
+ */
+char * sharded_string_cache_get_copy(ShardedStringCache * cache, const char * key, size_t key_length, size_t * value_length);
+
+/**
+ * Removes the entry of the given key.
+ *
+ * @param cache the cache where the entry is to be removed from
+ * @param key the bytes of the key
+ * @param key_length the length of the key (an empty key is valid)
+ *
+ * @return {@code true} if the entry was removed, {@code false} if it was missing (or an error occurred)
+ */
+bool sharded_string_cache_remove(ShardedStringCache * cache, const char * key, size_t key_length);
+
+/**
+ * Obtains the counters of the given cache (the sum of the counters of all its shards).
+ *
+ * @param cache the cache to be checked
+ * @param statistics where the counters are to be stored
+ *
+ * @return {@code true} if the counters were obtained, {@code false} if an argument is {@code NULL}
+ */
+bool sharded_string_cache_statistics(ShardedStringCache * cache, StringCacheStatistics * statistics);
+
+#endif /* CACHES_STRING_CACHE_H */
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L // For "clock_gettime", "CLOCK_MONOTONIC" (monotonic clock)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <pthread.h>
+#include "mpmc-queue.h"
+#include "fnv1a.h"
+
+// Benchmarking snippet (not abstracted away for piece of code portability)
+double elapsed_seconds(struct timespec start, struct timespec stop) {
+    return (double) (stop.tv_sec - start.tv_sec) + (double) (stop.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// A two stages pipeline: the producers pass keys (the hash stage input) to the consumers, which hash them (the build
+// stage), through either a mutex guarded queue, or the lock-free queue (one key at a time, or in batches)
+
+#define QUEUE_CAPACITY 1024
+#define BATCH_SIZE 32
+#define KEY_LENGTH 24
+
+typedef struct mutex_queue {
+    void * slots[QUEUE_CAPACITY];
+    size_t head;
+    size_t size;
+    bool is_closed;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+} MutexQueue;
+
+typedef enum pipeline_mode {
+    PIPELINE_MODE_MUTEX,
+    PIPELINE_MODE_SINGLE,
+    PIPELINE_MODE_BATCH,
+} PipelineMode;
+
+typedef struct pipeline {
+    PipelineMode mode;
+    MutexQueue * mutex_queue;
+    MpmcQueue * queue;
+    char * keys;
+    size_t keys_per_producer;
+    atomic_uint_fast64_t checksum;
+} Pipeline;
+
+typedef struct producer_argument {
+    Pipeline * pipeline;
+    size_t producer_index;
+} ProducerArgument;
+
+void mutex_queue_push(MutexQueue * queue, void * item) {
+    pthread_mutex_lock(&queue->lock);
+    while (queue->size == QUEUE_CAPACITY) pthread_cond_wait(&queue->not_full, &queue->lock);
+    queue->slots[(queue->head + queue->size) % QUEUE_CAPACITY] = item;
+    queue->size++;
+    pthread_cond_signal(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+bool mutex_queue_pop(MutexQueue * queue, void ** item) {
+    pthread_mutex_lock(&queue->lock);
+    while (queue->size == 0 && !queue->is_closed) pthread_cond_wait(&queue->not_empty, &queue->lock);
+    bool is_popped = queue->size > 0;
+    if (is_popped) {
+        (* item) = queue->slots[queue->head];
+        queue->head = (queue->head + 1) % QUEUE_CAPACITY;
+        queue->size--;
+        pthread_cond_signal(&queue->not_full);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return is_popped;
+}
+
+void * pipeline_producer(void * argument) {
+    ProducerArgument * producer = argument;
+    Pipeline * pipeline = producer->pipeline;
+    char * first_key = pipeline->keys + producer->producer_index * pipeline->keys_per_producer * KEY_LENGTH;
+    void * batch[BATCH_SIZE];
+    size_t batch_size = 0;
+    for (size_t i = 0; i < pipeline->keys_per_producer; i++) {
+        char * key = first_key + i * KEY_LENGTH;
+        if (pipeline->mode == PIPELINE_MODE_MUTEX) {
+            mutex_queue_push(pipeline->mutex_queue, key);
+        } else if (pipeline->mode == PIPELINE_MODE_SINGLE) {
+            mpmc_queue_enqueue(pipeline->queue, key);
+        } else {
+            batch[batch_size++] = key;
+            if (batch_size == BATCH_SIZE || i + 1 == pipeline->keys_per_producer) {
+                mpmc_queue_enqueue_batch(pipeline->queue, batch, batch_size);
+                batch_size = 0;
+            }
+        }
+    }
+    return NULL;
+}
+
+void * pipeline_consumer(void * argument) {
+    Pipeline * pipeline = argument;
+    void * batch[BATCH_SIZE];
+    uint64_t checksum = 0;
+    while (true) {
+        size_t amount;
+        if (pipeline->mode == PIPELINE_MODE_MUTEX) {
+            amount = mutex_queue_pop(pipeline->mutex_queue, batch) ? 1 : 0;
+        } else if (pipeline->mode == PIPELINE_MODE_SINGLE) {
+            amount = mpmc_queue_dequeue(pipeline->queue, batch) ? 1 : 0;
+        } else {
+            amount = mpmc_queue_dequeue_batch(pipeline->queue, batch, BATCH_SIZE);
+        }
+        if (amount == 0) break;
+        for (size_t i = 0; i < amount; i++) {
+            uint64_t * hash = hashes_fnv1a_hash64_bytes(batch[i], KEY_LENGTH);
+            checksum += (* hash);
+            free(hash);
+        }
+    }
+    atomic_fetch_add(&pipeline->checksum, checksum);
+    return NULL;
+}
+
+double run_pipeline(Pipeline * pipeline, size_t threads_amount) {
+    struct timespec start, stop;
+    MutexQueue mutex_queue = { .head = 0, .size = 0, .is_closed = false };
+    pthread_mutex_init(&mutex_queue.lock, NULL);
+    pthread_cond_init(&mutex_queue.not_empty, NULL);
+    pthread_cond_init(&mutex_queue.not_full, NULL);
+    pipeline->mutex_queue = &mutex_queue;
+    pipeline->queue = mpmc_queue_create(QUEUE_CAPACITY);
+    atomic_store(&pipeline->checksum, 0);
+    pthread_t * producers = malloc(sizeof(pthread_t) * threads_amount);
+    pthread_t * consumers = malloc(sizeof(pthread_t) * threads_amount);
+    ProducerArgument * arguments = malloc(sizeof(ProducerArgument) * threads_amount);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < threads_amount; i++) {
+        pthread_create(&consumers[i], NULL, pipeline_consumer, pipeline);
+        arguments[i].pipeline = pipeline;
+        arguments[i].producer_index = i;
+        pthread_create(&producers[i], NULL, pipeline_producer, &arguments[i]);
+    }
+    for (size_t i = 0; i < threads_amount; i++) pthread_join(producers[i], NULL);
+    pthread_mutex_lock(&mutex_queue.lock);
+    mutex_queue.is_closed = true;
+    pthread_cond_broadcast(&mutex_queue.not_empty);
+    pthread_mutex_unlock(&mutex_queue.lock);
+    mpmc_queue_close(pipeline->queue);
+    for (size_t i = 0; i < threads_amount; i++) pthread_join(consumers[i], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    mpmc_queue_destroy(pipeline->queue);
+    pthread_mutex_destroy(&mutex_queue.lock);
+    pthread_cond_destroy(&mutex_queue.not_empty);
+    pthread_cond_destroy(&mutex_queue.not_full);
+    free(producers);
+    free(consumers);
+    free(arguments);
+    return elapsed_seconds(start, stop);
+}
+
+// Benchmarks
+
+void mpmc_queue_pipeline_benchmark(size_t keys_amount, size_t max_threads_amount) {
+    printf("%8s %14s %14s %14s %10s\n", "threads", "mutex Mk/s", "single Mk/s", "batch Mk/s", "checksum");
+    for (size_t threads_amount = 1; threads_amount <= max_threads_amount; threads_amount *= 2) {
+        Pipeline pipeline;
+        pipeline.keys_per_producer = keys_amount / threads_amount;
+        size_t total_keys = pipeline.keys_per_producer * threads_amount;
+        pipeline.keys = malloc(total_keys * KEY_LENGTH);
+        for (size_t i = 0; i < total_keys * KEY_LENGTH; i++) pipeline.keys[i] = (char) ('a' + (i * 7 + i / KEY_LENGTH) % 26);
+        double seconds[3];
+        uint64_t checksums[3];
+        PipelineMode modes[3] = { PIPELINE_MODE_MUTEX, PIPELINE_MODE_SINGLE, PIPELINE_MODE_BATCH };
+        for (size_t mode = 0; mode < 3; mode++) {
+            pipeline.mode = modes[mode];
+            seconds[mode] = run_pipeline(&pipeline, threads_amount);
+            checksums[mode] = atomic_load(&pipeline.checksum);
+        }
+        bool is_valid = checksums[0] == checksums[1] && checksums[1] == checksums[2];
+        printf("%8zu %14.2f %14.2f %14.2f %10s\n", threads_amount, total_keys / seconds[0] / 1e6,
+               total_keys / seconds[1] / 1e6, total_keys / seconds[2] / 1e6, is_valid ? "ok" : "WRONG");
+        free(pipeline.keys);
+    }
+}
+
+// Benchmarks runner (the arguments optionally override the amount of keys and the maximum amount of threads per stage)
+
+int main(int argc, char * argv[]) {
+    size_t keys_amount = (argc > 1) ? strtoull(argv[1], NULL, 10) : 4000000;
+    size_t max_threads_amount = (argc > 2) ? strtoull(argv[2], NULL, 10) : 16;
+    mpmc_queue_pipeline_benchmark(keys_amount, max_threads_amount);
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "mpmc-queue.h"
+#include "error-reporter.h"
+
+// Assertion snippet (not abstracted away for piece of code portability)
+void assert(int condition, char message[]) {
+    if (condition != 1) {
+        printf("%s\n", message);
+        exit(1);
+    }
+}
+
+// Unit testing
+
+void mpmc_queue_try_enqueue_dequeue_test() {
+    printf("*** Running test '%s'\n", __func__);
+    MpmcQueue * queue = mpmc_queue_create(3);
+    assert(queue != NULL, "The 'queue' must not be null");
+    assert(mpmc_queue_capacity(queue) == 4, "The capacity must be rounded up to a power of two");
+    void * item = NULL;
+    assert(!mpmc_queue_try_dequeue(queue, &item), "An empty queue must not dequeue anything");
+    // Go around the queue a few times, so the sequence numbers move through several laps
+    for (uintptr_t round = 0; round < 5; round++) {
+        for (uintptr_t i = 1; i <= 4; i++) {
+            assert(mpmc_queue_try_enqueue(queue, (void *) (round * 10 + i)), "A non full queue must accept the item");
+        }
+        assert(!mpmc_queue_try_enqueue(queue, (void *) 99), "A full queue must reject the item");
+        assert(mpmc_queue_size(queue) == 4, "The size must match the amount of enqueued items");
+        for (uintptr_t i = 1; i <= 4; i++) {
+            assert(mpmc_queue_try_dequeue(queue, &item), "A non empty queue must dequeue");
+            assert((uintptr_t) item == round * 10 + i, "The items must be dequeued in order");
+        }
+        assert(mpmc_queue_size(queue) == 0, "The queue must be empty after dequeuing everything");
+    }
+    mpmc_queue_destroy(queue);
+}
+
+void mpmc_queue_batch_test() {
+    printf("*** Running test '%s'\n", __func__);
+    MpmcQueue * queue = mpmc_queue_create(8);
+    void * items[12];
+    for (uintptr_t i = 0; i < 12; i++) items[i] = (void *) (i + 1);
+    // Move the indexes to the middle, so the batches wrap around the end of the slots
+    assert(mpmc_queue_try_enqueue_batch(queue, items, 5) == 5, "The whole batch must fit");
+    void * dequeued[12];
+    assert(mpmc_queue_try_dequeue_batch(queue, dequeued, 5) == 5, "The whole batch must be dequeued");
+    assert(mpmc_queue_try_enqueue_batch(queue, items, 12) == 8, "Only the free slots must be claimed");
+    assert(mpmc_queue_try_enqueue_batch(queue, items, 1) == 0, "A full queue must reject the batch");
+    assert(mpmc_queue_try_dequeue_batch(queue, dequeued, 3) == 3, "The requested amount must be dequeued");
+    assert(mpmc_queue_try_dequeue_batch(queue, dequeued + 3, 12) == 5, "Only the stored items must be dequeued");
+    for (uintptr_t i = 0; i < 8; i++) {
+        assert((uintptr_t) dequeued[i] == i + 1, "The batches must keep the items order");
+    }
+    assert(mpmc_queue_try_dequeue_batch(queue, dequeued, 12) == 0, "An empty queue must not dequeue anything");
+    mpmc_queue_destroy(queue);
+}
+
+void mpmc_queue_close_test() {
+    printf("*** Running test '%s'\n", __func__);
+    MpmcQueue * queue = mpmc_queue_create(4);
+    assert(mpmc_queue_enqueue(queue, (void *) 1), "An open queue must accept the item");
+    mpmc_queue_close(queue);
+    assert(mpmc_queue_is_closed(queue), "The queue must be closed");
+    assert(!mpmc_queue_enqueue(queue, (void *) 2), "A closed queue must reject the item");
+    assert(!mpmc_queue_try_enqueue(queue, (void *) 2), "A closed queue must reject the item");
+    void * item = NULL;
+    assert(mpmc_queue_dequeue(queue, &item) && (uintptr_t) item == 1, "The remaining items must still be dequeued");
+    assert(!mpmc_queue_dequeue(queue, &item), "A closed and empty queue must not block");
+    mpmc_queue_destroy(queue);
+}
+
+void mpmc_queue_invalid_arguments_test() {
+    printf("*** Running test '%s'\n", __func__);
+    assert(mpmc_queue_create(0) == NULL, "A zero capacity must be rejected");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "The error must be an invalid argument");
+    assert(!mpmc_queue_enqueue(NULL, NULL), "A 'NULL' queue must be rejected");
+    assert(error_reporter_last_code() == ERROR_CODE_NULL_ARGUMENT, "The error must be a null argument");
+    assert(mpmc_queue_dequeue_batch(NULL, NULL, 1) == 0, "A 'NULL' queue must be rejected");
+    assert(mpmc_queue_size(NULL) == 0, "A 'NULL' queue must have no items");
+    mpmc_queue_destroy(NULL);
+}
+
+// Several producers enqueue (blocking, in batches) tagged sequences, and several consumers dequeue them, where every
+// consumer must see the items of each producer in increasing order, and all the items must be seen exactly once
+#define PRODUCERS_AMOUNT 4
+#define CONSUMERS_AMOUNT 4
+#define ITEMS_PER_PRODUCER 50000
+
+typedef struct consumer_state {
+    MpmcQueue * queue;
+    uintptr_t last_seen[PRODUCERS_AMOUNT];
+    size_t received_amount;
+    uint64_t sum;
+    bool is_ordered;
+} ConsumerState;
+
+typedef struct producer_state {
+    MpmcQueue * queue;
+    uintptr_t producer_index;
+} ProducerState;
+
+void * mpmc_queue_producer(void * argument) {
+    ProducerState * producer = argument;
+    void * batch[5];
+    uintptr_t next = 1;
+    while (next <= ITEMS_PER_PRODUCER) {
+        size_t batch_size = 1 + next % 5;
+        if (next + batch_size > ITEMS_PER_PRODUCER + 1) batch_size = ITEMS_PER_PRODUCER + 1 - next;
+        for (size_t i = 0; i < batch_size; i++) batch[i] = (void *) ((producer->producer_index << 32) | (next + i));
+        if (batch_size == 1) {
+            mpmc_queue_enqueue(producer->queue, batch[0]);
+        } else {
+            mpmc_queue_enqueue_batch(producer->queue, batch, batch_size);
+        }
+        next += batch_size;
+    }
+    return NULL;
+}
+
+void * mpmc_queue_consumer(void * argument) {
+    ConsumerState * consumer = argument;
+    void * batch[3];
+    size_t amount;
+    while ((amount = mpmc_queue_dequeue_batch(consumer->queue, batch, 1 + consumer->received_amount % 3)) > 0) {
+        for (size_t i = 0; i < amount; i++) {
+            uintptr_t item = (uintptr_t) batch[i];
+            uintptr_t producer_index = item >> 32;
+            uintptr_t sequence = item & 0xFFFFFFFF;
+            if (sequence <= consumer->last_seen[producer_index]) consumer->is_ordered = false;
+            consumer->last_seen[producer_index] = sequence;
+            consumer->sum += sequence;
+            consumer->received_amount++;
+        }
+    }
+    return NULL;
+}
+
+void mpmc_queue_threads_test() {
+    printf("*** Running test '%s'\n", __func__);
+    MpmcQueue * queue = mpmc_queue_create(16);
+    pthread_t producers[PRODUCERS_AMOUNT];
+    pthread_t consumers[CONSUMERS_AMOUNT];
+    ProducerState producer_states[PRODUCERS_AMOUNT];
+    ConsumerState consumer_states[CONSUMERS_AMOUNT] = { 0 };
+    for (size_t i = 0; i < CONSUMERS_AMOUNT; i++) {
+        consumer_states[i].queue = queue;
+        consumer_states[i].is_ordered = true;
+        pthread_create(&consumers[i], NULL, mpmc_queue_consumer, &consumer_states[i]);
+    }
+    for (size_t i = 0; i < PRODUCERS_AMOUNT; i++) {
+        producer_states[i].queue = queue;
+        producer_states[i].producer_index = i;
+        pthread_create(&producers[i], NULL, mpmc_queue_producer, &producer_states[i]);
+    }
+    for (size_t i = 0; i < PRODUCERS_AMOUNT; i++) pthread_join(producers[i], NULL);
+    mpmc_queue_close(queue);
+    size_t received_amount = 0;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < CONSUMERS_AMOUNT; i++) {
+        pthread_join(consumers[i], NULL);
+        assert(consumer_states[i].is_ordered, "Every consumer must see the items of a producer in order");
+        received_amount += consumer_states[i].received_amount;
+        sum += consumer_states[i].sum;
+    }
+    assert(received_amount == PRODUCERS_AMOUNT * ITEMS_PER_PRODUCER, "Every item must be received exactly once");
+    uint64_t expected_sum = (uint64_t) PRODUCERS_AMOUNT * ITEMS_PER_PRODUCER * (ITEMS_PER_PRODUCER + 1) / 2;
+    assert(sum == expected_sum, "The received items must be the enqueued ones");
+    mpmc_queue_destroy(queue);
+}
+
+// Tests runner
+
+int main() {
+    fclose(stderr);
+    mpmc_queue_try_enqueue_dequeue_test();
+    mpmc_queue_batch_test();
+    mpmc_queue_close_test();
+    mpmc_queue_invalid_arguments_test();
+    mpmc_queue_threads_test();
+}
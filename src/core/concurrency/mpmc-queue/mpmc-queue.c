@@ -0,0 +1,389 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * A Bounded Multi-Producer/Multi-Consumer Queue Implementation (Vyukov's array queue, with batches and futexes).
+ *
+ * ### Explanation ###
+ *
+ * The queue is a circular array of slots, where the producers claim the next enqueue index and the consumers claim
+ * the next dequeue index with a compare-and-swap, so the producers and the consumers only contend among themselves
+ * (and on different cache lines).
+ *
+ * ### Sequence Numbers ###
+ *
+ * Every slot has a sequence number telling which index it is ready for, so a thread knows whether the slot of its
+ * index is usable without any lock (and without the ABA problem, as the sequence numbers only grow):
+ *
+ * - The sequence of the slot of the index "i" is "i" when it is free (ready to be written by the producer of "i").
+ * - The producer of "i" writes the item and then publishes it by storing "i + 1" (ready to be read by the consumer).
+ * - The consumer of "i" reads the item and then frees it by storing "i + capacity" (the next lap of the same slot).
+ *
+ * If the sequence is behind the index, the queue is full (enqueue) or empty (dequeue).
+ *
+ * ### Batches ###
+ *
+ * A batch counts how many consecutive slots (from the current index) are ready, and claims all of them with a single
+ * compare-and-swap. The counted slots cannot stop being ready before the claim, as only the owner of an index can
+ * change the state of its slot, and owning any of those indexes requires moving the same index the claim moves.
+ *
+ * ### Blocking ###
+ *
+ * The blocking operations spin for a while (yielding the CPU), and then sleep on a futex, whose word is an epoch
+ * incremented by every wake up. The sleeper reads the epoch before registering itself and retrying, so if a wake up
+ * happens between the retry and the sleep, the kernel sees a different epoch and the sleep returns immediately. The
+ * wakers only make the system call when there are registered sleepers, so a queue that never blocks never pays it.
+ *
+ * ### References ###
+ *
+ * - https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue (Vyukov, Bounded MPMC Queue)
+ * - https://man7.org/linux/man-pages/man2/futex.2.html (Linux, Fast User-Space Locking)
+ * - https://www.akkadia.org/drepper/futex.pdf (Drepper, Futexes Are Tricky)
+ */
+
+// Imports & Headers
+
+#define _GNU_SOURCE         // For "syscall" (futex system calls)
+
+#include <stdlib.h>         // For "aligned_alloc", "malloc", "free" (memory management)
+#include <stdint.h>         // For "SIZE_MAX", "intptr_t" (more integer types)
+#include <limits.h>         // For "INT_MAX" (waking every sleeper)
+#include <stdatomic.h>      // For "atomic_size_t", "atomic_compare_exchange_weak_explicit" (lock-free indexes)
+#include <sched.h>          // For "sched_yield" (spinning politely)
+#ifdef __linux__
+#include <unistd.h>         // For "syscall" (futex system calls)
+#include <sys/syscall.h>    // For "SYS_futex" (futex system call number)
+#include <linux/futex.h>    // For "FUTEX_WAIT_PRIVATE", "FUTEX_WAKE_PRIVATE" (futex operations)
+#endif
+#include "mpmc-queue.h"
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+
+// Default implementation values
+
+#define CACHE_LINE_SIZE 64                  // The size of a cache line (to avoid false sharing)
+#define MIN_CAPACITY 2                      // The minimum amount of slots (the sequence numbers need at least two)
+#define SPIN_ATTEMPTS 32                    // The amount of yielding retries before sleeping on the futex
+
+// Structures
+
+typedef struct slot {
+    atomic_size_t sequence;                 // The index the slot is ready for (see the explanation)
+    void * item;                            // The stored pointer
+} Slot;
+
+typedef struct waiters {
+    _Alignas(CACHE_LINE_SIZE) atomic_uint epoch;    // The futex word (incremented by every wake up)
+    atomic_uint amount;                             // The amount of sleeping (or about to sleep) threads
+} Waiters;
+
+struct mpmc_queue {
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t enqueue_index;  // The next index to be claimed by a producer
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t dequeue_index;  // The next index to be claimed by a consumer
+    Waiters not_full;                                       // The producers waiting for a free slot
+    Waiters not_empty;                                      // The consumers waiting for an item
+    _Alignas(CACHE_LINE_SIZE) size_t capacity;              // The amount of slots (always a power of two)
+    size_t mask;                                            // The mask of the slot of an index ("capacity - 1")
+    Slot * slots;                                           // The circular array of slots
+    atomic_bool is_closed;                                  // Whether the queue was closed
+};
+
+// Definition (to be able to use methods before declaring them, to follow up the top-bottom code style)
+
+size_t mpmc_queue_claim_enqueue(MpmcQueue * queue, void * const * items, size_t items_amount);
+size_t mpmc_queue_claim_dequeue(MpmcQueue * queue, void ** items, size_t max_items_amount);
+unsigned mpmc_queue_register_waiter(Waiters * waiters);
+void mpmc_queue_unregister_waiter(Waiters * waiters);
+void mpmc_queue_wait(Waiters * waiters, unsigned epoch);
+void mpmc_queue_wake(Waiters * waiters, size_t amount);
+void mpmc_queue_signal(Waiters * waiters, size_t amount);
+
+// Implementation
+
+MpmcQueue * mpmc_queue_create(size_t capacity) {
+    if (capacity == 0 || capacity > SIZE_MAX / 4) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The capacity must be positive and not too big");
+        return NULL;
+    }
+    size_t rounded_capacity = MIN_CAPACITY;
+    while (rounded_capacity < capacity) rounded_capacity <<= 1;
+    MpmcQueue * queue = aligned_alloc(CACHE_LINE_SIZE, sizeof(MpmcQueue));
+    if (queue == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'queue'");
+        return NULL;
+    }
+    queue->slots = malloc(sizeof(Slot) * rounded_capacity);
+    if (queue->slots == NULL) {
+        free(queue);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'slots'");
+        return NULL;
+    }
+    // Every slot starts free for the index of its first lap
+    for (size_t i = 0; i < rounded_capacity; i++) {
+        atomic_init(&queue->slots[i].sequence, i);
+        queue->slots[i].item = NULL;
+    }
+    atomic_init(&queue->enqueue_index, 0);
+    atomic_init(&queue->dequeue_index, 0);
+    atomic_init(&queue->not_full.epoch, 0);
+    atomic_init(&queue->not_full.amount, 0);
+    atomic_init(&queue->not_empty.epoch, 0);
+    atomic_init(&queue->not_empty.amount, 0);
+    atomic_init(&queue->is_closed, false);
+    queue->capacity = rounded_capacity;
+    queue->mask = rounded_capacity - 1;
+    return queue;
+}
+
+void mpmc_queue_destroy(MpmcQueue * queue) {
+    if (queue == NULL) return;
+    free(queue->slots);
+    free(queue);
+}
+
+size_t mpmc_queue_capacity(MpmcQueue * queue) {
+    if (queue == NULL) return 0;
+    return queue->capacity;
+}
+
+size_t mpmc_queue_size(MpmcQueue * queue) {
+    if (queue == NULL) return 0;
+    size_t dequeue_index = atomic_load_explicit(&queue->dequeue_index, memory_order_acquire);
+    size_t enqueue_index = atomic_load_explicit(&queue->enqueue_index, memory_order_acquire);
+    // The indexes are loaded at different moments, so the difference is clamped to the valid range
+    intptr_t size = (intptr_t) (enqueue_index - dequeue_index);
+    if (size < 0) return 0;
+    if ((size_t) size > queue->capacity) return queue->capacity;
+    return (size_t) size;
+}
+
+void mpmc_queue_close(MpmcQueue * queue) {
+    if (queue == NULL) return;
+    atomic_store(&queue->is_closed, true);
+    // Change both epochs even without registered sleepers (so no thread goes to sleep after missing the close)
+    mpmc_queue_signal(&queue->not_full, INT_MAX);
+    mpmc_queue_signal(&queue->not_empty, INT_MAX);
+}
+
+bool mpmc_queue_is_closed(MpmcQueue * queue) {
+    if (queue == NULL) return true;
+    return atomic_load(&queue->is_closed);
+}
+
+bool mpmc_queue_try_enqueue(MpmcQueue * queue, void * item) {
+    return mpmc_queue_try_enqueue_batch(queue, &item, 1) == 1;
+}
+
+size_t mpmc_queue_try_enqueue_batch(MpmcQueue * queue, void * const * items, size_t items_amount) {
+    if (queue == NULL || items == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to enqueue with a 'NULL' queue or items");
+        return 0;
+    }
+    if (atomic_load(&queue->is_closed)) return 0;
+    size_t enqueued_amount = mpmc_queue_claim_enqueue(queue, items, items_amount);
+    if (enqueued_amount > 0) mpmc_queue_wake(&queue->not_empty, enqueued_amount);
+    return enqueued_amount;
+}
+
+bool mpmc_queue_try_dequeue(MpmcQueue * queue, void ** item) {
+    return mpmc_queue_try_dequeue_batch(queue, item, 1) == 1;
+}
+
+size_t mpmc_queue_try_dequeue_batch(MpmcQueue * queue, void ** items, size_t max_items_amount) {
+    if (queue == NULL || items == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to dequeue with a 'NULL' queue or items");
+        return 0;
+    }
+    size_t dequeued_amount = mpmc_queue_claim_dequeue(queue, items, max_items_amount);
+    if (dequeued_amount > 0) mpmc_queue_wake(&queue->not_full, dequeued_amount);
+    return dequeued_amount;
+}
+
+bool mpmc_queue_enqueue(MpmcQueue * queue, void * item) {
+    return mpmc_queue_enqueue_batch(queue, &item, 1) == 1;
+}
+
+size_t mpmc_queue_enqueue_batch(MpmcQueue * queue, void * const * items, size_t items_amount) {
+    if (queue == NULL || items == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to enqueue with a 'NULL' queue or items");
+        return 0;
+    }
+    size_t enqueued_amount = 0;
+    size_t attempts = 0;
+    while (enqueued_amount < items_amount && !atomic_load(&queue->is_closed)) {
+        // Step 1: Try to enqueue the remaining items
+        size_t amount = mpmc_queue_claim_enqueue(queue, items + enqueued_amount, items_amount - enqueued_amount);
+        if (amount == 0 && attempts < SPIN_ATTEMPTS) {
+            attempts++;
+            sched_yield();
+            continue;
+        }
+        // Step 2: Register as a sleeper, retry (a slot might have been freed meanwhile), and sleep if still full
+        if (amount == 0) {
+            unsigned epoch = mpmc_queue_register_waiter(&queue->not_full);
+            amount = mpmc_queue_claim_enqueue(queue, items + enqueued_amount, items_amount - enqueued_amount);
+            if (amount == 0 && !atomic_load(&queue->is_closed)) mpmc_queue_wait(&queue->not_full, epoch);
+            mpmc_queue_unregister_waiter(&queue->not_full);
+        }
+        // Step 3: Wake up the consumers of the enqueued items
+        if (amount > 0) {
+            enqueued_amount += amount;
+            attempts = 0;
+            mpmc_queue_wake(&queue->not_empty, amount);
+        }
+    }
+    return enqueued_amount;
+}
+
+bool mpmc_queue_dequeue(MpmcQueue * queue, void ** item) {
+    return mpmc_queue_dequeue_batch(queue, item, 1) == 1;
+}
+
+size_t mpmc_queue_dequeue_batch(MpmcQueue * queue, void ** items, size_t max_items_amount) {
+    if (queue == NULL || items == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to dequeue with a 'NULL' queue or items");
+        return 0;
+    }
+    if (max_items_amount == 0) return 0;
+    size_t attempts = 0;
+    while (true) {
+        // Step 1: Try to dequeue (once closed, only the remaining items are dequeued)
+        bool is_closed = atomic_load(&queue->is_closed);
+        size_t amount = mpmc_queue_claim_dequeue(queue, items, max_items_amount);
+        if (amount == 0 && is_closed) return 0;
+        if (amount == 0 && attempts < SPIN_ATTEMPTS) {
+            attempts++;
+            sched_yield();
+            continue;
+        }
+        // Step 2: Register as a sleeper, retry (an item might have been enqueued meanwhile), and sleep if still empty
+        if (amount == 0) {
+            unsigned epoch = mpmc_queue_register_waiter(&queue->not_empty);
+            amount = mpmc_queue_claim_dequeue(queue, items, max_items_amount);
+            if (amount == 0 && !atomic_load(&queue->is_closed)) mpmc_queue_wait(&queue->not_empty, epoch);
+            mpmc_queue_unregister_waiter(&queue->not_empty);
+        }
+        // Step 3: Wake up the producers waiting for the freed slots
+        if (amount > 0) {
+            mpmc_queue_wake(&queue->not_full, amount);
+            return amount;
+        }
+    }
+}
+
+// Utilities
+
+// Claims (and fills) the consecutive free slots from the enqueue index, returning the amount of enqueued items
+size_t mpmc_queue_claim_enqueue(MpmcQueue * queue, void * const * items, size_t items_amount) {
+    if (items_amount == 0) return 0;
+    size_t index = atomic_load_explicit(&queue->enqueue_index, memory_order_relaxed);
+    size_t amount;
+    while (true) {
+        // Step 1: Count the consecutive free slots
+        for (amount = 0; amount < items_amount; amount++) {
+            Slot * slot = &queue->slots[(index + amount) & queue->mask];
+            if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != index + amount) break;
+        }
+        // Step 2: If none, either the queue is full or the index is stale (another producer claimed it)
+        if (amount == 0) {
+            size_t sequence = atomic_load_explicit(&queue->slots[index & queue->mask].sequence, memory_order_acquire);
+            if ((intptr_t) (sequence - index) < 0) return 0;
+            index = atomic_load_explicit(&queue->enqueue_index, memory_order_relaxed);
+            continue;
+        }
+        // Step 3: Claim all of them at once (on failure, the index is refreshed and the slots are counted again)
+        if (atomic_compare_exchange_weak_explicit(&queue->enqueue_index, &index, index + amount, memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+    // Step 4: Write and publish the items
+    for (size_t i = 0; i < amount; i++) {
+        Slot * slot = &queue->slots[(index + i) & queue->mask];
+        slot->item = items[i];
+        atomic_store_explicit(&slot->sequence, index + i + 1, memory_order_release);
+    }
+    return amount;
+}
+
+// Claims (and reads) the consecutive published slots from the dequeue index, returning the amount of dequeued items
+size_t mpmc_queue_claim_dequeue(MpmcQueue * queue, void ** items, size_t max_items_amount) {
+    if (max_items_amount == 0) return 0;
+    size_t index = atomic_load_explicit(&queue->dequeue_index, memory_order_relaxed);
+    size_t amount;
+    while (true) {
+        // Step 1: Count the consecutive published slots
+        for (amount = 0; amount < max_items_amount; amount++) {
+            Slot * slot = &queue->slots[(index + amount) & queue->mask];
+            if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != index + amount + 1) break;
+        }
+        // Step 2: If none, either the queue is empty or the index is stale (another consumer claimed it)
+        if (amount == 0) {
+            size_t sequence = atomic_load_explicit(&queue->slots[index & queue->mask].sequence, memory_order_acquire);
+            if ((intptr_t) (sequence - (index + 1)) < 0) return 0;
+            index = atomic_load_explicit(&queue->dequeue_index, memory_order_relaxed);
+            continue;
+        }
+        // Step 3: Claim all of them at once (on failure, the index is refreshed and the slots are counted again)
+        if (atomic_compare_exchange_weak_explicit(&queue->dequeue_index, &index, index + amount, memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+    // Step 4: Read the items and free their slots for the next lap
+    for (size_t i = 0; i < amount; i++) {
+        Slot * slot = &queue->slots[(index + i) & queue->mask];
+        items[i] = slot->item;
+        atomic_store_explicit(&slot->sequence, index + i + queue->capacity, memory_order_release);
+    }
+    return amount;
+}
+
+// Registers the calling thread as a sleeper, returning the epoch to sleep on (read before the caller retries)
+unsigned mpmc_queue_register_waiter(Waiters * waiters) {
+    unsigned epoch = atomic_load(&waiters->epoch);
+    atomic_fetch_add(&waiters->amount, 1);
+    // Pairs with the fence of the wakers (either they see the registration, or the retry sees their items)
+    atomic_thread_fence(memory_order_seq_cst);
+    return epoch;
+}
+
+void mpmc_queue_unregister_waiter(Waiters * waiters) {
+    atomic_fetch_sub(&waiters->amount, 1);
+}
+
+// Sleeps until the epoch changes (or returns immediately if it already changed)
+void mpmc_queue_wait(Waiters * waiters, unsigned epoch) {
+#ifdef __linux__
+    syscall(SYS_futex, &waiters->epoch, FUTEX_WAIT_PRIVATE, epoch, NULL, NULL, 0);
+#else
+    (void) waiters;
+    (void) epoch;
+    sched_yield();
+#endif
+}
+
+// Wakes up to "amount" sleepers (only paying the system call when there is any registered sleeper)
+void mpmc_queue_wake(Waiters * waiters, size_t amount) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&waiters->amount, memory_order_relaxed) == 0) return;
+    mpmc_queue_signal(waiters, amount);
+}
+
+// Changes the epoch and wakes up to "amount" sleepers
+void mpmc_queue_signal(Waiters * waiters, size_t amount) {
+    atomic_fetch_add(&waiters->epoch, 1);
+#ifdef __linux__
+    int wake_amount = (amount > INT_MAX) ? INT_MAX : (int) amount;
+    syscall(SYS_futex, &waiters->epoch, FUTEX_WAKE_PRIVATE, wake_amount, NULL, NULL, 0);
+#else
+    (void) amount;
+#endif
+}
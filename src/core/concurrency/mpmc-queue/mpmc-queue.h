@@ -0,0 +1,170 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdbool.h>   // For "true", "false" (boolean constants)
+#include <stddef.h>    // For "size_t" (size type)
+
+/* mpmc-queue.h */
+#ifndef CONCURRENCY_MPMC_QUEUE_H
+#define CONCURRENCY_MPMC_QUEUE_H
+
+typedef struct mpmc_queue MpmcQueue;
+
+/**
+ * Creates a bounded queue of pointers, for any amount of producer and consumer threads.
+ *
+ * The returned queue must be freed by the client after its usage.
+ *
+ * @param capacity the minimum amount of pointers the queue can hold (rounded up to a power of two, at least '2')
+ *
+ * @return a new queue, or {@code NULL} if an error occurred
+ */
+MpmcQueue * mpmc_queue_create(size_t capacity);
+
+/**
+ * Frees the given queue (the pointers still stored in it are not freed).
+ *
+ * @param queue the queue that is about to be freed
+ *
+ * @note no thread must be using (or waiting on) the queue during its destruction
+ */
+void mpmc_queue_destroy(MpmcQueue * queue);
+
+/**
+ * Returns the amount of pointers the given queue can hold.
+ *
+ * @param queue the queue to be checked
+ *
+ * @return the capacity of the queue, or '0' if the queue is {@code NULL}
+ */
+size_t mpmc_queue_capacity(MpmcQueue * queue);
+
+/**
+ * Returns an approximation of the amount of pointers stored in the given queue (a snapshot, as other threads might
+ * be enqueuing or dequeuing meanwhile).
+ *
+ * @param queue the queue to be checked
+ *
+ * @return the approximate amount of stored pointers, or '0' if the queue is {@code NULL}
+ */
+size_t mpmc_queue_size(MpmcQueue * queue);
+
+/**
+ * Closes the given queue: the following enqueues fail, and the blocked (and following) dequeues fail once the
+ * remaining pointers were dequeued. Every blocked thread is woken up.
+ *
+ * @param queue the queue to be closed
+ *
+ * @note it is meant to be called once all the producers finished (an enqueue racing with the close might be lost)
+ */
+void mpmc_queue_close(MpmcQueue * queue);
+
+/**
+ * Returns whether the given queue was closed.
+ *
+ * @param queue the queue to be checked
+ *
+ * @return {@code true} if the queue was closed (or is {@code NULL}), {@code false} otherwise
+ */
+bool mpmc_queue_is_closed(MpmcQueue * queue);
+
+/**
+ * Enqueues a pointer at the end of the given queue, without blocking.
+ *
+ * @param queue the queue where the pointer is to be enqueued
+ * @param item the pointer to be enqueued
+ *
+ * @return {@code true} if the pointer was enqueued, {@code false} if the queue is full or closed (or {@code NULL})
+ */
+bool mpmc_queue_try_enqueue(MpmcQueue * queue, void * item);
+
+/**
+ * Enqueues as many of the given pointers as there are consecutive free slots, claiming them all at once (so they are
+ * dequeued in the same order, with no pointer of other producers in between), without blocking.
+ *
+ * @param queue the queue where the pointers are to be enqueued
+ * @param items the pointers to be enqueued (in order)
+ * @param items_amount the amount of pointers in the "items" array
+ *
+ * @return the amount of enqueued pointers (the first ones of the array)
+ */
+size_t mpmc_queue_try_enqueue_batch(MpmcQueue * queue, void * const * items, size_t items_amount);
+
+/**
+ * Dequeues the pointer at the start of the given queue, without blocking.
+ *
+ * @param queue the queue where the pointer is to be dequeued from
+ * @param item where the dequeued pointer is to be stored
+ *
+ * @return {@code true} if a pointer was dequeued, {@code false} if the queue is empty (or an error occurred)
+ */
+bool mpmc_queue_try_dequeue(MpmcQueue * queue, void ** item);
+
+/**
+ * Dequeues up to "max_items_amount" consecutive pointers from the start of the given queue, claiming them all at
+ * once, without blocking.
+ *
+ * @param queue the queue where the pointers are to be dequeued from
+ * @param items where the dequeued pointers are to be stored (in order)
+ * @param max_items_amount the maximum amount of pointers to be dequeued (the capacity of the "items" array)
+ *
+ * @return the amount of dequeued pointers
+ */
+size_t mpmc_queue_try_dequeue_batch(MpmcQueue * queue, void ** items, size_t max_items_amount);
+
+/**
+ * Enqueues a pointer at the end of the given queue, waiting (spinning briefly, and then sleeping on a futex) while
+ * the queue is full.
+ *
+ * @param queue the queue where the pointer is to be enqueued
+ * @param item the pointer to be enqueued
+ *
+ * @return {@code true} if the pointer was enqueued, {@code false} if the queue is closed (or {@code NULL})
+ */
+bool mpmc_queue_enqueue(MpmcQueue * queue, void * item);
+
+/**
+ * Enqueues all the given pointers at the end of the given queue (in as many batches as needed), waiting while the
+ * queue is full.
+ *
+ * @param queue the queue where the pointers are to be enqueued
+ * @param items the pointers to be enqueued (in order)
+ * @param items_amount the amount of pointers in the "items" array
+ *
+ * @return the amount of enqueued pointers, which is less than "items_amount" only if the queue was closed
+ */
+size_t mpmc_queue_enqueue_batch(MpmcQueue * queue, void * const * items, size_t items_amount);
+
+/**
+ * Dequeues the pointer at the start of the given queue, waiting (spinning briefly, and then sleeping on a futex)
+ * while the queue is empty.
+ *
+ * @param queue the queue where the pointer is to be dequeued from
+ * @param item where the dequeued pointer is to be stored
+ *
+ * @return {@code true} if a pointer was dequeued, {@code false} if the queue is closed and empty (or an error occurred)
+ */
+bool mpmc_queue_dequeue(MpmcQueue * queue, void ** item);
+
+/**
+ * Dequeues up to "max_items_amount" pointers from the start of the given queue, waiting while the queue is empty.
+ *
+ * @param queue the queue where the pointers are to be dequeued from
+ * @param items where the dequeued pointers are to be stored (in order)
+ * @param max_items_amount the maximum amount of pointers to be dequeued (the capacity of the "items" array)
+ *
+ * @return the amount of dequeued pointers (at least '1'), or '0' if the queue is closed and empty
+ */
+size_t mpmc_queue_dequeue_batch(MpmcQueue * queue, void ** items, size_t max_items_amount);
+
+#endif /* CONCURRENCY_MPMC_QUEUE_H */
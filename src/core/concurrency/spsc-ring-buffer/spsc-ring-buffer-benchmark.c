@@ -0,0 +1,195 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L // For "clock_gettime", "CLOCK_MONOTONIC" (monotonic clock)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include "spsc-ring-buffer.h"
+#include "string-builder.h"
+
+// Benchmarking snippet (not abstracted away for piece of code portability)
+double elapsed_seconds(struct timespec start, struct timespec stop) {
+    return (double) (stop.tv_sec - start.tv_sec) + (double) (stop.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// A producer builds log lines and a single writer consumes them (summing their lengths, instead of flushing them)
+
+static char FRAGMENT[] = "GET /index.html HTTP/1.1 200 ";
+
+#define QUEUE_CAPACITY 1024
+#define BATCH_SIZE 32
+
+typedef struct mutex_queue {
+    StringBuilder * slots[QUEUE_CAPACITY];
+    size_t head;
+    size_t size;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+} MutexQueue;
+
+typedef struct handoff {
+    MutexQueue * queue;
+    SpscRingBuffer * ring;
+    SpscRecordRingBuffer * record_ring;
+    size_t lines_amount;
+} Handoff;
+
+StringBuilder * build_line(size_t index) {
+    StringBuilder * line = string_builder_create(64);
+    string_builder_append_all(line, FRAGMENT);
+    char number[24];
+    snprintf(number, sizeof(number), "%zu\n", index);
+    string_builder_append_all(line, number);
+    return line;
+}
+
+void * mutex_queue_producer(void * argument) {
+    Handoff * handoff = argument;
+    MutexQueue * queue = handoff->queue;
+    for (size_t i = 0; i < handoff->lines_amount; i++) {
+        StringBuilder * line = build_line(i);
+        pthread_mutex_lock(&queue->lock);
+        while (queue->size == QUEUE_CAPACITY) pthread_cond_wait(&queue->not_full, &queue->lock);
+        queue->slots[(queue->head + queue->size) % QUEUE_CAPACITY] = line;
+        queue->size++;
+        pthread_cond_signal(&queue->not_empty);
+        pthread_mutex_unlock(&queue->lock);
+    }
+    return NULL;
+}
+
+size_t mutex_queue_consumer(Handoff * handoff) {
+    MutexQueue * queue = handoff->queue;
+    size_t total_length = 0;
+    for (size_t i = 0; i < handoff->lines_amount; i++) {
+        pthread_mutex_lock(&queue->lock);
+        while (queue->size == 0) pthread_cond_wait(&queue->not_empty, &queue->lock);
+        StringBuilder * line = queue->slots[queue->head];
+        queue->head = (queue->head + 1) % QUEUE_CAPACITY;
+        queue->size--;
+        pthread_cond_signal(&queue->not_full);
+        pthread_mutex_unlock(&queue->lock);
+        total_length += string_builder_size(line);
+        string_builder_destroy(line);
+    }
+    return total_length;
+}
+
+void * ring_producer(void * argument) {
+    Handoff * handoff = argument;
+    StringBuilder * batch[BATCH_SIZE];
+    for (size_t i = 0; i < handoff->lines_amount; i += BATCH_SIZE) {
+        size_t batch_size = (handoff->lines_amount - i < BATCH_SIZE) ? handoff->lines_amount - i : BATCH_SIZE;
+        for (size_t j = 0; j < batch_size; j++) batch[j] = build_line(i + j);
+        size_t pushed = 0;
+        while (pushed < batch_size) {
+            size_t amount = spsc_ring_buffer_push_batch(handoff->ring, (void * const *) batch + pushed, batch_size - pushed);
+            if (amount == 0) sched_yield();
+            pushed += amount;
+        }
+    }
+    return NULL;
+}
+
+size_t ring_consumer(Handoff * handoff) {
+    void * batch[BATCH_SIZE];
+    size_t total_length = 0;
+    size_t received = 0;
+    while (received < handoff->lines_amount) {
+        size_t amount = spsc_ring_buffer_pop_batch(handoff->ring, batch, BATCH_SIZE);
+        if (amount == 0) sched_yield();
+        for (size_t i = 0; i < amount; i++) {
+            total_length += string_builder_size(batch[i]);
+            string_builder_destroy(batch[i]);
+        }
+        received += amount;
+    }
+    return total_length;
+}
+
+void * record_ring_producer(void * argument) {
+    Handoff * handoff = argument;
+    for (size_t i = 0; i < handoff->lines_amount; i++) {
+        char * destination;
+        while ((destination = spsc_record_ring_buffer_reserve(handoff->record_ring, 64)) == NULL) sched_yield();
+        memcpy(destination, FRAGMENT, sizeof(FRAGMENT) - 1);
+        int written = snprintf(destination + sizeof(FRAGMENT) - 1, 64 - (sizeof(FRAGMENT) - 1), "%zu\n", i);
+        spsc_record_ring_buffer_commit(handoff->record_ring, sizeof(FRAGMENT) - 1 + (size_t) written);
+    }
+    return NULL;
+}
+
+size_t record_ring_consumer(Handoff * handoff) {
+    size_t total_length = 0;
+    for (size_t i = 0; i < handoff->lines_amount; i++) {
+        size_t length;
+        while (spsc_record_ring_buffer_peek(handoff->record_ring, &length) == NULL) sched_yield();
+        total_length += length;
+        spsc_record_ring_buffer_release(handoff->record_ring);
+    }
+    return total_length;
+}
+
+double run_handoff(void * (* producer)(void *), size_t (* consumer)(Handoff *), Handoff * handoff, size_t * total_length) {
+    struct timespec start, stop;
+    pthread_t thread;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pthread_create(&thread, NULL, producer, handoff);
+    (* total_length) = consumer(handoff);
+    pthread_join(thread, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    return elapsed_seconds(start, stop);
+}
+
+// Benchmarks
+
+void spsc_ring_buffer_handoff_benchmark(size_t lines_amount) {
+    MutexQueue queue = { .head = 0, .size = 0 };
+    pthread_mutex_init(&queue.lock, NULL);
+    pthread_cond_init(&queue.not_empty, NULL);
+    pthread_cond_init(&queue.not_full, NULL);
+    Handoff handoff = {
+        .queue = &queue,
+        .ring = spsc_ring_buffer_create(QUEUE_CAPACITY),
+        .record_ring = spsc_record_ring_buffer_create(QUEUE_CAPACITY * 64),
+        .lines_amount = lines_amount,
+    };
+    size_t mutex_length, ring_length, record_length;
+    double mutex_seconds = run_handoff(mutex_queue_producer, mutex_queue_consumer, &handoff, &mutex_length);
+    double ring_seconds = run_handoff(ring_producer, ring_consumer, &handoff, &ring_length);
+    double record_seconds = run_handoff(record_ring_producer, record_ring_consumer, &handoff, &record_length);
+    printf("%-28s %12s %10s\n", "handoff", "Mlines/s", "speedup");
+    printf("%-28s %12.2f %9.2fx\n", "mutex queue (builders)", lines_amount / mutex_seconds / 1e6, 1.0);
+    printf("%-28s %12.2f %9.2fx\n", "spsc ring (builders)", lines_amount / ring_seconds / 1e6, mutex_seconds / ring_seconds);
+    printf("%-28s %12.2f %9.2fx\n", "spsc ring (records)", lines_amount / record_seconds / 1e6, mutex_seconds / record_seconds);
+    bool is_valid = mutex_length == ring_length && ring_length == record_length;
+    printf("checksum: %s (%zu bytes)\n", is_valid ? "ok" : "WRONG", record_length);
+    spsc_ring_buffer_destroy(handoff.ring);
+    spsc_record_ring_buffer_destroy(handoff.record_ring);
+    pthread_mutex_destroy(&queue.lock);
+    pthread_cond_destroy(&queue.not_empty);
+    pthread_cond_destroy(&queue.not_full);
+}
+
+// Benchmarks runner (the first argument optionally overrides the amount of lines)
+
+int main(int argc, char * argv[]) {
+    size_t lines_amount = (argc > 1) ? strtoull(argv[1], NULL, 10) : 4000000;
+    spsc_ring_buffer_handoff_benchmark(lines_amount);
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "spsc-ring-buffer.h"
+#include "error-reporter.h"
+
+// Assertion snippet (not abstracted away for piece of code portability)
+void assert(int condition, char message[]) {
+    if (condition != 1) {
+        printf("%s\n", message);
+        exit(1);
+    }
+}
+
+// Unit testing (pointers mode)
+
+void spsc_ring_buffer_push_pop_test() {
+    printf("*** Running test '%s'\n", __func__);
+    SpscRingBuffer * ring = spsc_ring_buffer_create(3);
+    assert(ring != NULL, "The 'ring' must not be null");
+    assert(spsc_ring_buffer_capacity(ring) == 4, "The capacity must be rounded up to a power of two");
+    void * item = NULL;
+    assert(!spsc_ring_buffer_pop(ring, &item), "An empty ring must not pop anything");
+    // Go around the ring a few times, so the indexes wrap over the slots
+    for (uintptr_t round = 0; round < 5; round++) {
+        for (uintptr_t i = 1; i <= 4; i++) {
+            assert(spsc_ring_buffer_push(ring, (void *) (round * 10 + i)), "A non full ring must accept the push");
+        }
+        assert(!spsc_ring_buffer_push(ring, (void *) 99), "A full ring must reject the push");
+        assert(spsc_ring_buffer_size(ring) == 4, "The size must match the amount of pushed items");
+        for (uintptr_t i = 1; i <= 4; i++) {
+            assert(spsc_ring_buffer_pop(ring, &item), "A non empty ring must pop");
+            assert((uintptr_t) item == round * 10 + i, "The items must be popped in order");
+        }
+        assert(spsc_ring_buffer_size(ring) == 0, "The ring must be empty after popping everything");
+    }
+    spsc_ring_buffer_destroy(ring);
+}
+
+void spsc_ring_buffer_batch_test() {
+    printf("*** Running test '%s'\n", __func__);
+    SpscRingBuffer * ring = spsc_ring_buffer_create(8);
+    void * items[12];
+    for (uintptr_t i = 0; i < 12; i++) items[i] = (void *) (i + 1);
+    // Move the indexes to the middle, so the batches wrap around the end of the slots
+    assert(spsc_ring_buffer_push_batch(ring, items, 5) == 5, "The whole batch must fit");
+    void * popped[12];
+    assert(spsc_ring_buffer_pop_batch(ring, popped, 5) == 5, "The whole batch must be popped");
+    assert(spsc_ring_buffer_push_batch(ring, items, 12) == 8, "Only the free slots must be filled");
+    assert(spsc_ring_buffer_push_batch(ring, items, 1) == 0, "A full ring must reject the batch");
+    assert(spsc_ring_buffer_pop_batch(ring, popped, 3) == 3, "The requested amount must be popped");
+    assert(spsc_ring_buffer_pop_batch(ring, popped + 3, 12) == 5, "Only the stored items must be popped");
+    for (uintptr_t i = 0; i < 8; i++) {
+        assert((uintptr_t) popped[i] == i + 1, "The batches must keep the items order");
+    }
+    assert(spsc_ring_buffer_pop_batch(ring, popped, 12) == 0, "An empty ring must not pop anything");
+    spsc_ring_buffer_destroy(ring);
+}
+
+void spsc_ring_buffer_invalid_arguments_test() {
+    printf("*** Running test '%s'\n", __func__);
+    assert(spsc_ring_buffer_create(0) == NULL, "A zero capacity must be rejected");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "The error must be an invalid argument");
+    assert(!spsc_ring_buffer_push(NULL, NULL), "A 'NULL' ring must be rejected");
+    assert(error_reporter_last_code() == ERROR_CODE_NULL_ARGUMENT, "The error must be a null argument");
+    assert(spsc_ring_buffer_pop_batch(NULL, NULL, 1) == 0, "A 'NULL' ring must be rejected");
+    assert(spsc_ring_buffer_size(NULL) == 0, "A 'NULL' ring must have no items");
+    spsc_ring_buffer_destroy(NULL);
+}
+
+// Producer pushes (in batches of varying sizes) a long increasing sequence, which the consumer must see in order
+#define HANDOFF_ITEMS_AMOUNT 200000
+
+void * spsc_ring_buffer_producer(void * argument) {
+    SpscRingBuffer * ring = argument;
+    void * batch[7];
+    uintptr_t next = 1;
+    while (next <= HANDOFF_ITEMS_AMOUNT) {
+        size_t batch_size = 1 + next % 7;
+        if (next + batch_size > HANDOFF_ITEMS_AMOUNT + 1) batch_size = HANDOFF_ITEMS_AMOUNT + 1 - next;
+        for (size_t i = 0; i < batch_size; i++) batch[i] = (void *) (next + i);
+        size_t pushed = 0;
+        while (pushed < batch_size) {
+            size_t amount = spsc_ring_buffer_push_batch(ring, batch + pushed, batch_size - pushed);
+            if (amount == 0) sched_yield();
+            pushed += amount;
+        }
+        next += batch_size;
+    }
+    return NULL;
+}
+
+void spsc_ring_buffer_threads_test() {
+    printf("*** Running test '%s'\n", __func__);
+    SpscRingBuffer * ring = spsc_ring_buffer_create(64);
+    pthread_t producer;
+    pthread_create(&producer, NULL, spsc_ring_buffer_producer, ring);
+    uintptr_t expected = 1;
+    while (expected <= HANDOFF_ITEMS_AMOUNT) {
+        void * item;
+        if (expected % 2 == 0) {
+            if (!spsc_ring_buffer_pop(ring, &item)) {
+                sched_yield();
+                continue;
+            }
+            assert((uintptr_t) item == expected, "The items must be received in order");
+            expected++;
+        } else {
+            void * items[5];
+            size_t amount = spsc_ring_buffer_pop_batch(ring, items, 5);
+            if (amount == 0) sched_yield();
+            for (size_t i = 0; i < amount; i++) {
+                assert((uintptr_t) items[i] == expected, "The items must be received in order");
+                expected++;
+            }
+        }
+    }
+    pthread_join(producer, NULL);
+    assert(spsc_ring_buffer_size(ring) == 0, "All the items must have been received");
+    spsc_ring_buffer_destroy(ring);
+}
+
+// Unit testing (records mode)
+
+void spsc_record_ring_buffer_push_peek_release_test() {
+    printf("*** Running test '%s'\n", __func__);
+    SpscRecordRingBuffer * ring = spsc_record_ring_buffer_create(10);
+    assert(ring != NULL, "The 'ring' must not be null");
+    assert(spsc_record_ring_buffer_max_record_length(ring) == 32 - sizeof(size_t), "The capacity must be at least '64'");
+    size_t length;
+    assert(spsc_record_ring_buffer_peek(ring, &length) == NULL, "An empty ring must not have records");
+    assert(spsc_record_ring_buffer_push(ring, "hello", 5), "The record must fit");
+    assert(spsc_record_ring_buffer_push(ring, "", 0), "An empty record must be allowed");
+    const char * record = spsc_record_ring_buffer_peek(ring, &length);
+    assert(record != NULL && length == 5 && memcmp(record, "hello", 5) == 0, "The first record must be peeked");
+    assert(spsc_record_ring_buffer_release(ring), "The first record must be released");
+    record = spsc_record_ring_buffer_peek(ring, &length);
+    assert(record != NULL && length == 0, "The empty record must be peeked");
+    assert(spsc_record_ring_buffer_release(ring), "The empty record must be released");
+    assert(!spsc_record_ring_buffer_release(ring), "An empty ring must not release anything");
+    spsc_record_ring_buffer_destroy(ring);
+}
+
+void spsc_record_ring_buffer_reserve_commit_test() {
+    printf("*** Running test '%s'\n", __func__);
+    SpscRecordRingBuffer * ring = spsc_record_ring_buffer_create(64);
+    char * destination = spsc_record_ring_buffer_reserve(ring, 20);
+    assert(destination != NULL, "The reservation must fit");
+    assert(spsc_record_ring_buffer_reserve(ring, 1) == NULL, "Only one reservation at a time is allowed");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_STATE, "The error must be an invalid state");
+    size_t length;
+    assert(spsc_record_ring_buffer_peek(ring, &length) == NULL, "A reserved record must not be visible");
+    // Write less bytes than reserved (as a formatter would), the remaining space is given back
+    int written = snprintf(destination, 20, "line %d", 42);
+    assert(!spsc_record_ring_buffer_commit(ring, 21), "A record bigger than the reservation must be rejected");
+    assert(spsc_record_ring_buffer_commit(ring, (size_t) written), "The record must be committed");
+    assert(!spsc_record_ring_buffer_commit(ring, 0), "A commit without reservation must be rejected");
+    const char * record = spsc_record_ring_buffer_peek(ring, &length);
+    assert(length == 7 && memcmp(record, "line 42", 7) == 0, "The committed record must be peeked");
+    spsc_record_ring_buffer_release(ring);
+    assert(spsc_record_ring_buffer_reserve(ring, 25) == NULL, "A record bigger than the maximum must be rejected");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "The error must be an invalid argument");
+    spsc_record_ring_buffer_destroy(ring);
+}
+
+void spsc_record_ring_buffer_wrap_around_test() {
+    printf("*** Running test '%s'\n", __func__);
+    SpscRecordRingBuffer * ring = spsc_record_ring_buffer_create(64);
+    size_t length;
+    // Every record takes 24 bytes, so the third one never fits until the end and the remaining bytes are skipped
+    for (int i = 0; i < 50; i++) {
+        char line[16];
+        int line_length = snprintf(line, sizeof(line), "record-%05d", i);
+        while (!spsc_record_ring_buffer_push(ring, line, (size_t) line_length)) {
+            const char * record = spsc_record_ring_buffer_peek(ring, &length);
+            assert(record != NULL, "A full ring must have records");
+            spsc_record_ring_buffer_release(ring);
+        }
+        const char * record = spsc_record_ring_buffer_peek(ring, &length);
+        assert(record != NULL && length == 12 && memcmp(record, "record-", 7) == 0, "The records must be intact");
+    }
+    while (spsc_record_ring_buffer_release(ring));
+    assert(spsc_record_ring_buffer_reserve(ring, 24) != NULL, "A maximum record must fit in an empty ring");
+    spsc_record_ring_buffer_destroy(ring);
+}
+
+// Producer writes variable-length lines in place, which the consumer must see in order and intact
+#define RECORDS_AMOUNT 100000
+
+void * spsc_record_ring_buffer_producer(void * argument) {
+    SpscRecordRingBuffer * ring = argument;
+    for (int i = 0; i < RECORDS_AMOUNT; i++) {
+        size_t repeat = (size_t) i % 37;
+        char * destination;
+        while ((destination = spsc_record_ring_buffer_reserve(ring, 16 + repeat)) == NULL) sched_yield();
+        int written = sprintf(destination, "%d:", i);
+        memset(destination + written, 'a' + i % 26, repeat);
+        spsc_record_ring_buffer_commit(ring, (size_t) written + repeat);
+    }
+    return NULL;
+}
+
+void spsc_record_ring_buffer_threads_test() {
+    printf("*** Running test '%s'\n", __func__);
+    SpscRecordRingBuffer * ring = spsc_record_ring_buffer_create(256);
+    pthread_t producer;
+    pthread_create(&producer, NULL, spsc_record_ring_buffer_producer, ring);
+    for (int i = 0; i < RECORDS_AMOUNT; i++) {
+        size_t length;
+        const char * record;
+        while ((record = spsc_record_ring_buffer_peek(ring, &length)) == NULL) sched_yield();
+        char expected[64];
+        int written = sprintf(expected, "%d:", i);
+        size_t repeat = (size_t) i % 37;
+        memset(expected + written, 'a' + i % 26, repeat);
+        assert(length == (size_t) written + repeat, "The record length must match the committed one");
+        assert(memcmp(record, expected, length) == 0, "The record bytes must match the written ones");
+        spsc_record_ring_buffer_release(ring);
+    }
+    pthread_join(producer, NULL);
+    size_t length;
+    assert(spsc_record_ring_buffer_peek(ring, &length) == NULL, "All the records must have been received");
+    spsc_record_ring_buffer_destroy(ring);
+}
+
+// Tests runner
+
+int main() {
+    fclose(stderr);
+    spsc_ring_buffer_push_pop_test();
+    spsc_ring_buffer_batch_test();
+    spsc_ring_buffer_invalid_arguments_test();
+    spsc_ring_buffer_threads_test();
+    spsc_record_ring_buffer_push_peek_release_test();
+    spsc_record_ring_buffer_reserve_commit_test();
+    spsc_record_ring_buffer_wrap_around_test();
+    spsc_record_ring_buffer_threads_test();
+}
@@ -0,0 +1,392 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * A Lock-Free Single-Producer/Single-Consumer Ring Buffer Implementation (of pointers and of byte records).
+ *
+ * ### Explanation ###
+ *
+ * When exactly one thread produces and exactly one thread consumes, a bounded queue needs neither locks nor atomic
+ * read-modify-write operations: the producer is the only writer of the "tail" index, the consumer is the only writer
+ * of the "head" index, and each side just publishes its own index with a release store and reads the other one with
+ * an acquire load (so the slots written before publishing the tail are visible to the consumer, and the slots read
+ * before publishing the head can be safely overwritten by the producer).
+ *
+ * The indexes are never wrapped (they only grow), the capacity is a power of two, and the slot of an index is found
+ * with a mask, so "tail - head" is always the amount of stored items (even once the indexes overflow).
+ *
+ * ### False Sharing & Cached Indexes ###
+ *
+ * The head and the tail live on different cache lines (otherwise every push would invalidate the consumer line and
+ * vice versa). Moreover, each side keeps a private copy of the index of the other side, and only reloads it (paying a
+ * cache miss) when the copy says that the ring is full (producer) or empty (consumer), which in a steady stream
+ * happens once per many items instead of once per item.
+ *
+ * The batch operations go further, publishing a whole run of items with a single index store.
+ *
+ * ### Records Mode ###
+ *
+ * The records ring stores variable-length runs of bytes, each one preceded by a header with its length, so the
+ * producer writes (e.g., formats a log line) directly into the ring memory and no allocation is needed per record:
+ *
+ * 1. The producer reserves space for a record of up to "n" bytes and writes into the returned pointer.
+ * 2. The producer commits the actual length, which publishes the record (and gives back the unused space).
+ * 3. The consumer peeks the record (which is read in place) and releases it once done.
+ *
+ * A record is never split at the end of the buffer, instead the remaining bytes are skipped with a padding header,
+ * which is why a record can take at most half of the capacity (so an empty ring can always hold it).
+ *
+ * ### References ###
+ *
+ * - https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue (Vyukov, Bounded Queues)
+ * - https://rigtorp.se/ringbuffer/ (Rigtorp, Optimizing a Ring Buffer for Throughput)
+ * - https://lwn.net/Articles/653488/ (Linux, BPF Ring Buffer Reserve/Commit Design)
+ */
+
+// Imports & Headers
+
+#include <stdlib.h>         // For "aligned_alloc", "free" (memory management)
+#include <stdint.h>         // For "SIZE_MAX" (size limits)
+#include <string.h>         // For "memcpy" (copying records)
+#include <stdatomic.h>      // For "atomic_size_t", "atomic_load_explicit" (lock-free indexes)
+#include "spsc-ring-buffer.h"
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+
+// Default implementation values
+
+#define CACHE_LINE_SIZE 64                              // The size of a cache line (to avoid false sharing)
+#define RECORD_HEADER_SIZE sizeof(size_t)               // The size of a record header (also the records alignment)
+#define RECORD_PADDING_MARKER SIZE_MAX                  // The header value of the skipped bytes at the buffer end
+#define RECORD_MIN_CAPACITY 64                          // The minimum amount of bytes of a records ring
+
+// Structures
+
+struct spsc_ring_buffer {
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t head;   // The next index to be popped (only written by the consumer)
+    size_t tail_cache;                              // The last tail seen by the consumer
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t tail;   // The next index to be pushed (only written by the producer)
+    size_t head_cache;                              // The last head seen by the producer
+    _Alignas(CACHE_LINE_SIZE) size_t capacity;      // The amount of slots (always a power of two)
+    size_t mask;                                    // The mask of the slot of an index ("capacity - 1")
+    void ** slots;                                  // The circular array of pointers
+};
+
+struct spsc_record_ring_buffer {
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t head;   // The byte index of the next record (only written by the consumer)
+    size_t tail_cache;                              // The last tail seen by the consumer
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t tail;   // The byte index after the last record (only written by the producer)
+    size_t head_cache;                              // The last head seen by the producer
+    size_t reserved_index;                          // The byte index of the header of the reserved record
+    size_t reserved_length;                         // The maximum length of the reserved record
+    bool is_reserved;                               // Whether there is a reserved (not committed yet) record
+    _Alignas(CACHE_LINE_SIZE) size_t capacity;      // The amount of bytes (always a power of two)
+    size_t mask;                                    // The mask of the offset of a byte index ("capacity - 1")
+    char * buffer;                                  // The circular array of bytes
+};
+
+// Definition (to be able to use methods before declaring them, to follow up the top-bottom code style)
+
+size_t spsc_ring_buffer_round_capacity(size_t capacity, const char function[]);
+size_t spsc_record_ring_buffer_record_size(size_t length);
+size_t * spsc_record_ring_buffer_front(SpscRecordRingBuffer * ring);
+
+// Implementation (pointers mode)
+
+SpscRingBuffer * spsc_ring_buffer_create(size_t capacity) {
+    capacity = spsc_ring_buffer_round_capacity(capacity, __func__);
+    if (capacity == 0) return NULL;
+    SpscRingBuffer * ring = aligned_alloc(CACHE_LINE_SIZE, sizeof(SpscRingBuffer));
+    if (ring == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'ring'");
+        return NULL;
+    }
+    ring->slots = malloc(sizeof(void *) * capacity);
+    if (ring->slots == NULL) {
+        free(ring);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'slots'");
+        return NULL;
+    }
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    ring->tail_cache = 0;
+    ring->head_cache = 0;
+    ring->capacity = capacity;
+    ring->mask = capacity - 1;
+    return ring;
+}
+
+void spsc_ring_buffer_destroy(SpscRingBuffer * ring) {
+    if (ring == NULL) return;
+    free(ring->slots);
+    free(ring);
+}
+
+size_t spsc_ring_buffer_capacity(SpscRingBuffer * ring) {
+    if (ring == NULL) return 0;
+    return ring->capacity;
+}
+
+size_t spsc_ring_buffer_size(SpscRingBuffer * ring) {
+    if (ring == NULL) return 0;
+    // The head is loaded first, so the difference can never be negative (the tail only grows meanwhile)
+    size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    return tail - head;
+}
+
+bool spsc_ring_buffer_push(SpscRingBuffer * ring, void * item) {
+    if (ring == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to push to a 'NULL' ring");
+        return false;
+    }
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    // Only reload the head (a cache miss) when the cached one says that the ring is full
+    if (tail - ring->head_cache == ring->capacity) {
+        ring->head_cache = atomic_load_explicit(&ring->head, memory_order_acquire);
+        if (tail - ring->head_cache == ring->capacity) return false;
+    }
+    ring->slots[tail & ring->mask] = item;
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+size_t spsc_ring_buffer_push_batch(SpscRingBuffer * ring, void * const * items, size_t items_amount) {
+    if (ring == NULL || items == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to push a batch with a 'NULL' ring or items");
+        return 0;
+    }
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    size_t free_amount = ring->capacity - (tail - ring->head_cache);
+    if (free_amount < items_amount) {
+        ring->head_cache = atomic_load_explicit(&ring->head, memory_order_acquire);
+        free_amount = ring->capacity - (tail - ring->head_cache);
+    }
+    size_t pushed_amount = (items_amount < free_amount) ? items_amount : free_amount;
+    if (pushed_amount == 0) return 0;
+    // Copy the items in (at most) two runs, the one until the end of the array and the one from its start
+    size_t offset = tail & ring->mask;
+    size_t first_run = ring->capacity - offset;
+    if (first_run > pushed_amount) first_run = pushed_amount;
+    memcpy(&ring->slots[offset], items, sizeof(void *) * first_run);
+    memcpy(ring->slots, items + first_run, sizeof(void *) * (pushed_amount - first_run));
+    // Publish all the items at once
+    atomic_store_explicit(&ring->tail, tail + pushed_amount, memory_order_release);
+    return pushed_amount;
+}
+
+bool spsc_ring_buffer_pop(SpscRingBuffer * ring, void ** item) {
+    if (ring == NULL || item == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to pop with a 'NULL' ring or item");
+        return false;
+    }
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    // Only reload the tail (a cache miss) when the cached one says that the ring is empty
+    if (head == ring->tail_cache) {
+        ring->tail_cache = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if (head == ring->tail_cache) return false;
+    }
+    (* item) = ring->slots[head & ring->mask];
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    return true;
+}
+
+size_t spsc_ring_buffer_pop_batch(SpscRingBuffer * ring, void ** items, size_t max_items_amount) {
+    if (ring == NULL || items == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to pop a batch with a 'NULL' ring or items");
+        return 0;
+    }
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t stored_amount = ring->tail_cache - head;
+    if (stored_amount < max_items_amount) {
+        ring->tail_cache = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        stored_amount = ring->tail_cache - head;
+    }
+    size_t popped_amount = (max_items_amount < stored_amount) ? max_items_amount : stored_amount;
+    if (popped_amount == 0) return 0;
+    // Copy the items in (at most) two runs, the one until the end of the array and the one from its start
+    size_t offset = head & ring->mask;
+    size_t first_run = ring->capacity - offset;
+    if (first_run > popped_amount) first_run = popped_amount;
+    memcpy(items, &ring->slots[offset], sizeof(void *) * first_run);
+    memcpy(items + first_run, ring->slots, sizeof(void *) * (popped_amount - first_run));
+    // Release all the slots at once
+    atomic_store_explicit(&ring->head, head + popped_amount, memory_order_release);
+    return popped_amount;
+}
+
+// Implementation (records mode)
+
+SpscRecordRingBuffer * spsc_record_ring_buffer_create(size_t capacity) {
+    if (capacity < RECORD_MIN_CAPACITY) capacity = RECORD_MIN_CAPACITY;
+    capacity = spsc_ring_buffer_round_capacity(capacity, __func__);
+    if (capacity == 0) return NULL;
+    SpscRecordRingBuffer * ring = aligned_alloc(CACHE_LINE_SIZE, sizeof(SpscRecordRingBuffer));
+    if (ring == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'ring'");
+        return NULL;
+    }
+    // The capacity is a power of two of at least a cache line, so it is a valid "aligned_alloc" size
+    ring->buffer = aligned_alloc(CACHE_LINE_SIZE, capacity);
+    if (ring->buffer == NULL) {
+        free(ring);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'buffer'");
+        return NULL;
+    }
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    ring->tail_cache = 0;
+    ring->head_cache = 0;
+    ring->reserved_index = 0;
+    ring->reserved_length = 0;
+    ring->is_reserved = false;
+    ring->capacity = capacity;
+    ring->mask = capacity - 1;
+    return ring;
+}
+
+void spsc_record_ring_buffer_destroy(SpscRecordRingBuffer * ring) {
+    if (ring == NULL) return;
+    free(ring->buffer);
+    free(ring);
+}
+
+size_t spsc_record_ring_buffer_max_record_length(SpscRecordRingBuffer * ring) {
+    if (ring == NULL) return 0;
+    return ring->capacity / 2 - RECORD_HEADER_SIZE;
+}
+
+char * spsc_record_ring_buffer_reserve(SpscRecordRingBuffer * ring, size_t length) {
+    // Step 1: Validate the arguments and the state
+    if (ring == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to reserve a record in a 'NULL' ring");
+        return NULL;
+    }
+    if (ring->is_reserved) {
+        error_reporter_report(ERROR_CODE_INVALID_STATE, __func__, "The previous reserved record was not committed yet");
+        return NULL;
+    }
+    if (length > spsc_record_ring_buffer_max_record_length(ring)) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The record is bigger than the maximum record length");
+        return NULL;
+    }
+    // Step 2: Compute the needed space (if the record does not fit until the buffer end, the remaining bytes are skipped)
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    size_t offset = tail & ring->mask;
+    size_t contiguous_size = ring->capacity - offset;
+    size_t record_size = spsc_record_ring_buffer_record_size(length);
+    size_t padding_size = (record_size <= contiguous_size) ? 0 : contiguous_size;
+    size_t needed_size = padding_size + record_size;
+    // Step 3: Check the free space (only reloading the head when the cached one says that there is not enough)
+    if (ring->capacity - (tail - ring->head_cache) < needed_size) {
+        ring->head_cache = atomic_load_explicit(&ring->head, memory_order_acquire);
+        if (ring->capacity - (tail - ring->head_cache) < needed_size) return NULL;
+    }
+    // Step 4: Mark the skipped bytes (not visible to the consumer until the record is committed)
+    if (padding_size > 0) {
+        (* (size_t *) &ring->buffer[offset]) = RECORD_PADDING_MARKER;
+    }
+    ring->reserved_index = tail + padding_size;
+    ring->reserved_length = length;
+    ring->is_reserved = true;
+    return &ring->buffer[(ring->reserved_index & ring->mask) + RECORD_HEADER_SIZE];
+}
+
+bool spsc_record_ring_buffer_commit(SpscRecordRingBuffer * ring, size_t length) {
+    if (ring == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to commit a record in a 'NULL' ring");
+        return false;
+    }
+    if (!ring->is_reserved) {
+        error_reporter_report(ERROR_CODE_INVALID_STATE, __func__, "Trying to commit without any reserved record");
+        return false;
+    }
+    if (length > ring->reserved_length) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The record is bigger than the reserved length");
+        return false;
+    }
+    // Write the header, and then publish the record (the release store orders both the header and the bytes)
+    (* (size_t *) &ring->buffer[ring->reserved_index & ring->mask]) = length;
+    size_t tail = ring->reserved_index + spsc_record_ring_buffer_record_size(length);
+    atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    ring->is_reserved = false;
+    return true;
+}
+
+bool spsc_record_ring_buffer_push(SpscRecordRingBuffer * ring, const char * bytes, size_t length) {
+    if (bytes == NULL && length > 0) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to push 'NULL' bytes");
+        return false;
+    }
+    char * destination = spsc_record_ring_buffer_reserve(ring, length);
+    if (destination == NULL) return false;
+    if (length > 0) memcpy(destination, bytes, length);
+    return spsc_record_ring_buffer_commit(ring, length);
+}
+
+const char * spsc_record_ring_buffer_peek(SpscRecordRingBuffer * ring, size_t * length) {
+    if (ring == NULL || length == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to peek with a 'NULL' ring or length");
+        return NULL;
+    }
+    size_t * header = spsc_record_ring_buffer_front(ring);
+    if (header == NULL) return NULL;
+    (* length) = (* header);
+    return (const char *) header + RECORD_HEADER_SIZE;
+}
+
+bool spsc_record_ring_buffer_release(SpscRecordRingBuffer * ring) {
+    if (ring == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to release a record of a 'NULL' ring");
+        return false;
+    }
+    size_t * header = spsc_record_ring_buffer_front(ring);
+    if (header == NULL) return false;
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    atomic_store_explicit(&ring->head, head + spsc_record_ring_buffer_record_size(* header), memory_order_release);
+    return true;
+}
+
+// Utilities
+
+// Rounds the capacity up to a power of two (or reports an error and returns '0' if it is not possible)
+size_t spsc_ring_buffer_round_capacity(size_t capacity, const char function[]) {
+    if (capacity == 0 || capacity > SIZE_MAX / 4) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, function, "The capacity must be positive and not too big");
+        return 0;
+    }
+    size_t rounded_capacity = 1;
+    while (rounded_capacity < capacity) rounded_capacity <<= 1;
+    return rounded_capacity;
+}
+
+// The amount of bytes taken by a record of the given length (its header plus its bytes, rounded to the alignment)
+size_t spsc_record_ring_buffer_record_size(size_t length) {
+    return (RECORD_HEADER_SIZE + length + RECORD_HEADER_SIZE - 1) & ~(RECORD_HEADER_SIZE - 1);
+}
+
+// Returns the header of the first record (skipping the padding at the buffer end), or 'NULL' if there is no record
+size_t * spsc_record_ring_buffer_front(SpscRecordRingBuffer * ring) {
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    while (true) {
+        if (head == ring->tail_cache) {
+            ring->tail_cache = atomic_load_explicit(&ring->tail, memory_order_acquire);
+            if (head == ring->tail_cache) return NULL;
+        }
+        size_t offset = head & ring->mask;
+        size_t * header = (size_t *) &ring->buffer[offset];
+        if ((* header) != RECORD_PADDING_MARKER) return header;
+        // Give the skipped bytes back to the producer and continue with the record at the buffer start
+        head += ring->capacity - offset;
+        atomic_store_explicit(&ring->head, head, memory_order_release);
+    }
+}
@@ -0,0 +1,197 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdbool.h>   // For "true", "false" (boolean constants)
+#include <stddef.h>    // For "size_t" (size type)
+
+/* spsc-ring-buffer.h */
+#ifndef CONCURRENCY_SPSC_RING_BUFFER_H
+#define CONCURRENCY_SPSC_RING_BUFFER_H
+
+typedef struct spsc_ring_buffer SpscRingBuffer;
+typedef struct spsc_record_ring_buffer SpscRecordRingBuffer;
+
+// Pointers mode (every slot holds a single pointer, e.g., a "StringBuilder" handed off to the consumer)
+
+/**
+ * Creates a bounded ring buffer of pointers, for exactly one producer thread and one consumer thread.
+ *
+ * The returned ring buffer must be freed by the client after its usage.
+ *
+ * @param capacity the minimum amount of pointers the ring buffer can hold (rounded up to a power of two)
+ *
+ * @return a new ring buffer, or {@code NULL} if an error occurred
+ */
+SpscRingBuffer * spsc_ring_buffer_create(size_t capacity);
+
+/**
+ * Frees the given ring buffer (the pointers still stored in it are not freed).
+ *
+ * @param ring the ring buffer that is about to be freed
+ */
+void spsc_ring_buffer_destroy(SpscRingBuffer * ring);
+
+/**
+ * Returns the amount of pointers the given ring buffer can hold.
+ *
+ * @param ring the ring buffer to be checked
+ *
+ * @return the capacity of the ring buffer, or '0' if the ring buffer is {@code NULL}
+ */
+size_t spsc_ring_buffer_capacity(SpscRingBuffer * ring);
+
+/**
+ * Returns the amount of pointers currently stored in the given ring buffer (only exact when called by the producer or
+ * the consumer while the other side is idle, otherwise it is a snapshot).
+ *
+ * @param ring the ring buffer to be checked
+ *
+ * @return the amount of stored pointers, or '0' if the ring buffer is {@code NULL}
+ */
+size_t spsc_ring_buffer_size(SpscRingBuffer * ring);
+
+/**
+ * Pushes a pointer at the end of the given ring buffer (must only be called by the producer thread).
+ *
+ * @param ring the ring buffer where the pointer is to be pushed
+ * @param item the pointer to be pushed
+ *
+ * @return {@code true} if the pointer was pushed, {@code false} if the ring buffer is full (or {@code NULL})
+ */
+bool spsc_ring_buffer_push(SpscRingBuffer * ring, void * item);
+
+/**
+ * Pushes as many of the given pointers as fit at the end of the given ring buffer, publishing them all at once (must
+ * only be called by the producer thread).
+ *
+ * @param ring the ring buffer where the pointers are to be pushed
+ * @param items the pointers to be pushed (in order)
+ * @param items_amount the amount of pointers in the "items" array
+ *
+ * @return the amount of pushed pointers (the first ones of the array), which is less than "items_amount" if the ring
+ *         buffer got full
+ */
+size_t spsc_ring_buffer_push_batch(SpscRingBuffer * ring, void * const * items, size_t items_amount);
+
+/**
+ * Pops the pointer at the start of the given ring buffer (must only be called by the consumer thread).
+ *
+ * @param ring the ring buffer where the pointer is to be popped from
+ * @param item where the popped pointer is to be stored
+ *
+ * @return {@code true} if a pointer was popped, {@code false} if the ring buffer is empty (or {@code NULL})
+ */
+bool spsc_ring_buffer_pop(SpscRingBuffer * ring, void ** item);
+
+/**
+ * Pops up to "max_items_amount" pointers from the start of the given ring buffer, releasing their slots all at once
+ * (must only be called by the consumer thread).
+ *
+ * @param ring the ring buffer where the pointers are to be popped from
+ * @param items where the popped pointers are to be stored (in order)
+ * @param max_items_amount the maximum amount of pointers to be popped (the capacity of the "items" array)
+ *
+ * @return the amount of popped pointers
+ */
+size_t spsc_ring_buffer_pop_batch(SpscRingBuffer * ring, void ** items, size_t max_items_amount);
+
+// Records mode (every record is a variable-length run of bytes written in place, e.g., a log line)
+
+/**
+ * Creates a bounded ring buffer of variable-length byte records, for exactly one producer thread and one consumer
+ * thread.
+ *
+ * Every record takes its length plus a small header (rounded up to the header alignment), and a single record can
+ * take at most half of the capacity (see "spsc_record_ring_buffer_max_record_length").
+ *
+ * The returned ring buffer must be freed by the client after its usage.
+ *
+ * @param capacity the minimum amount of bytes of the ring buffer (rounded up to a power of two, at least '64')
+ *
+ * @return a new ring buffer, or {@code NULL} if an error occurred
+ */
+SpscRecordRingBuffer * spsc_record_ring_buffer_create(size_t capacity);
+
+/**
+ * Frees the given ring buffer (the records still stored in it are discarded).
+ *
+ * @param ring the ring buffer that is about to be freed
+ */
+void spsc_record_ring_buffer_destroy(SpscRecordRingBuffer * ring);
+
+/**
+ * Returns the maximum length of a single record of the given ring buffer.
+ *
+ * @param ring the ring buffer to be checked
+ *
+ * @return the maximum record length, or '0' if the ring buffer is {@code NULL}
+ */
+size_t spsc_record_ring_buffer_max_record_length(SpscRecordRingBuffer * ring);
+
+/**
+ * Reserves space for a record of up to "length" bytes at the end of the given ring buffer, and returns where its
+ * bytes are to be written (must only be called by the producer thread).
+ *
+ * The record is not visible to the consumer until it is committed, and only one record can be reserved at a time.
+ *
+ * @param ring the ring buffer where the record is to be reserved
+ * @param length the maximum length of the record
+ *
+ * @return where the record bytes are to be written, or {@code NULL} if the ring buffer is full (or an error occurred)
+ */
+char * spsc_record_ring_buffer_reserve(SpscRecordRingBuffer * ring, size_t length);
+
+/**
+ * Publishes the currently reserved record to the consumer (must only be called by the producer thread).
+ *
+ * @param ring the ring buffer where the record was reserved
+ * @param length the actual length of the record (at most the reserved length, the remaining space is given back)
+ *
+ * @return {@code true} if the record was published, {@code false} if there is no reservation or the length is bigger
+ *         than the reserved one
+ */
+bool spsc_record_ring_buffer_commit(SpscRecordRingBuffer * ring, size_t length);
+
+/**
+ * Copies the given bytes as a new record at the end of the given ring buffer (a reservation followed by a commit).
+ *
+ * @param ring the ring buffer where the record is to be pushed
+ * @param bytes the bytes of the record
+ * @param length the length of the record
+ *
+ * @return {@code true} if the record was pushed, {@code false} if the ring buffer is full (or an error occurred)
+ */
+bool spsc_record_ring_buffer_push(SpscRecordRingBuffer * ring, const char * bytes, size_t length);
+
+/**
+ * Returns the record at the start of the given ring buffer without removing it (must only be called by the consumer
+ * thread). The record bytes remain valid until the record is released.
+ *
+ * @param ring the ring buffer where the record is to be read from
+ * @param length where the length of the record is to be stored
+ *
+ * @return the bytes of the record, or {@code NULL} if the ring buffer is empty (or an error occurred)
+ */
+const char * spsc_record_ring_buffer_peek(SpscRecordRingBuffer * ring, size_t * length);
+
+/**
+ * Removes the record at the start of the given ring buffer, giving its space back to the producer (must only be called
+ * by the consumer thread, after a successful peek).
+ *
+ * @param ring the ring buffer where the record is to be removed from
+ *
+ * @return {@code true} if the record was removed, {@code false} if the ring buffer is empty (or {@code NULL})
+ */
+bool spsc_record_ring_buffer_release(SpscRecordRingBuffer * ring);
+
+#endif /* CONCURRENCY_SPSC_RING_BUFFER_H */
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L // For "clock_gettime", "CLOCK_MONOTONIC" (monotonic clock)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "thread-pool.h"
+#include "fnv1a.h"
+
+// Benchmarking snippet (not abstracted away for piece of code portability)
+double elapsed_seconds(struct timespec start, struct timespec stop) {
+    return (double) (stop.tv_sec - start.tv_sec) + (double) (stop.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// A large set of keys (between 16 and 64 bytes long) stored contiguously, addressed by their offsets
+
+typedef struct key_set {
+    char * bytes;
+    size_t * offsets;
+    size_t keys_amount;
+    atomic_uint_fast64_t checksum;
+} KeySet;
+
+void key_set_init(KeySet * keys, size_t keys_amount) {
+    keys->offsets = malloc(sizeof(size_t) * (keys_amount + 1));
+    keys->bytes = malloc(keys_amount * 64);
+    keys->keys_amount = keys_amount;
+    uint64_t random_state = 88172645463325252ULL;
+    size_t offset = 0;
+    for (size_t i = 0; i < keys_amount; i++) {
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 7;
+        random_state ^= random_state << 17;
+        size_t length = 16 + random_state % 49;
+        keys->offsets[i] = offset;
+        for (size_t j = 0; j < length; j++) keys->bytes[offset + j] = (char) ('a' + (random_state >> (j % 50)) % 26);
+        offset += length;
+    }
+    keys->offsets[keys_amount] = offset;
+}
+
+void hash_keys(size_t start, size_t stop, void * context) {
+    KeySet * keys = context;
+    uint64_t checksum = 0;
+    for (size_t i = start; i < stop; i++) {
+        uint64_t * hash = hashes_fnv1a_hash64_bytes(keys->bytes + keys->offsets[i], keys->offsets[i + 1] - keys->offsets[i]);
+        checksum += (* hash);
+        free(hash);
+    }
+    atomic_fetch_add_explicit(&keys->checksum, checksum, memory_order_relaxed);
+}
+
+// Benchmarks
+
+void thread_pool_parallel_for_hash_benchmark(size_t keys_amount, size_t max_threads_amount) {
+    struct timespec start, stop;
+    KeySet keys;
+    key_set_init(&keys, keys_amount);
+    // Sequential baseline (no pool at all)
+    atomic_init(&keys.checksum, 0);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    hash_keys(0, keys_amount, &keys);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    double sequential_seconds = elapsed_seconds(start, stop);
+    uint64_t expected_checksum = atomic_load(&keys.checksum);
+    printf("%8s %14s %10s %10s\n", "threads", "Mkeys/s", "speedup", "checksum");
+    printf("%8s %14.2f %9.2fx %10s\n", "serial", keys_amount / sequential_seconds / 1e6, 1.0, "ok");
+    for (size_t threads_amount = 1; threads_amount <= max_threads_amount; threads_amount *= 2) {
+        ThreadPoolOptions options = { threads_amount, THREAD_POOL_AFFINITY_NONE, NULL, 0 };
+        ThreadPool * pool = thread_pool_create(&options);
+        atomic_store(&keys.checksum, 0);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        thread_pool_parallel_for(pool, 0, keys_amount, 4096, hash_keys, &keys);
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        double seconds = elapsed_seconds(start, stop);
+        bool is_valid = atomic_load(&keys.checksum) == expected_checksum;
+        printf("%8zu %14.2f %9.2fx %10s\n", threads_amount, keys_amount / seconds / 1e6, sequential_seconds / seconds, is_valid ? "ok" : "WRONG");
+        thread_pool_destroy(pool);
+    }
+    free(keys.bytes);
+    free(keys.offsets);
+}
+
+// Benchmarks runner (the arguments optionally override the amount of keys and the maximum amount of threads)
+
+int main(int argc, char * argv[]) {
+    size_t keys_amount = (argc > 1) ? strtoull(argv[1], NULL, 10) : 4000000;
+    size_t max_threads_amount = (argc > 2) ? strtoull(argv[2], NULL, 10) : 64;
+    thread_pool_parallel_for_hash_benchmark(keys_amount, max_threads_amount);
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "thread-pool.h"
+
+// Assertion snippet (not abstracted away for piece of code portability)
+void assert(int condition, char message[]) {
+    if (condition != 1) {
+        printf("%s\n", message);
+        exit(1);
+    }
+}
+
+// Unit testing
+
+void * double_task(void * argument) {
+    return (void *) ((uintptr_t) argument * 2);
+}
+
+void thread_pool_submit_test() {
+    printf("*** Running test '%s'\n", __func__);
+    ThreadPool * pool = thread_pool_create_default();
+    assert(pool != NULL, "The 'pool' must not be null");
+    assert(thread_pool_threads_amount(pool) >= 1, "The 'pool' must have at least one worker");
+    ThreadPoolFuture * futures[100];
+    for (uintptr_t i = 0; i < 100; i++) {
+        futures[i] = thread_pool_submit(pool, double_task, (void *) i);
+        assert(futures[i] != NULL, "The 'future' must not be null");
+    }
+    for (uintptr_t i = 0; i < 100; i++) {
+        assert((uintptr_t) thread_pool_future_join(futures[i]) == i * 2, "The future result must match the task result");
+    }
+    thread_pool_destroy(pool);
+}
+
+// Recursive fibonacci where every call submits its left branch (so workers wait on futures of other tasks)
+static ThreadPool * fibonacci_pool;
+
+void * fibonacci_task(void * argument) {
+    uintptr_t n = (uintptr_t) argument;
+    if (n < 2) return (void *) n;
+    ThreadPoolFuture * left = thread_pool_submit(fibonacci_pool, fibonacci_task, (void *) (n - 1));
+    uintptr_t right = (uintptr_t) fibonacci_task((void *) (n - 2));
+    return (void *) ((uintptr_t) thread_pool_future_join(left) + right);
+}
+
+void thread_pool_nested_submit_test() {
+    printf("*** Running test '%s'\n", __func__);
+    ThreadPoolOptions options = { 4, THREAD_POOL_AFFINITY_NONE, NULL, 0 };
+    fibonacci_pool = thread_pool_create(&options);
+    ThreadPoolFuture * future = thread_pool_submit(fibonacci_pool, fibonacci_task, (void *) 20);
+    assert((uintptr_t) thread_pool_future_join(future) == 6765, "The fibonacci of '20' must be equal to '6765'");
+    thread_pool_destroy(fibonacci_pool);
+}
+
+typedef struct visit_context {
+    atomic_int * visits;
+    atomic_size_t calls_amount;
+    size_t grain_size;
+    atomic_bool is_grain_exceeded;
+} VisitContext;
+
+void visit_range(size_t start, size_t stop, void * context) {
+    VisitContext * visit = context;
+    if (stop - start > visit->grain_size) atomic_store(&visit->is_grain_exceeded, true);
+    for (size_t i = start; i < stop; i++) atomic_fetch_add(&visit->visits[i], 1);
+    atomic_fetch_add(&visit->calls_amount, 1);
+}
+
+void thread_pool_parallel_for_test() {
+    printf("*** Running test '%s'\n", __func__);
+    ThreadPoolOptions options = { 4, THREAD_POOL_AFFINITY_NONE, NULL, 0 };
+    ThreadPool * pool = thread_pool_create(&options);
+    size_t grain_sizes[] = { 1, 7, 1000, 200000 };
+    for (size_t g = 0; g < sizeof(grain_sizes) / sizeof(size_t); g++) {
+        VisitContext context;
+        context.visits = calloc(100000, sizeof(atomic_int));
+        atomic_init(&context.calls_amount, 0);
+        context.grain_size = grain_sizes[g];
+        atomic_init(&context.is_grain_exceeded, false);
+        assert(thread_pool_parallel_for(pool, 10, 100000, grain_sizes[g], visit_range, &context), "The parallel for must be successful");
+        for (size_t i = 0; i < 100000; i++) {
+            assert(atomic_load(&context.visits[i]) == (i >= 10 ? 1 : 0), "Every iteration of the range must be executed exactly once");
+        }
+        assert(!atomic_load(&context.is_grain_exceeded), "No body call must exceed the grain size");
+        free(context.visits);
+    }
+    assert(thread_pool_parallel_for(pool, 5, 5, 1, visit_range, NULL), "An empty range must be successful");
+    assert(!thread_pool_parallel_for(pool, 0, 10, 0, visit_range, NULL), "A zero grain size must fail");
+    assert(!thread_pool_parallel_for(pool, 10, 0, 1, visit_range, NULL), "A reversed range must fail");
+    assert(!thread_pool_parallel_for(NULL, 0, 10, 1, visit_range, NULL), "A 'NULL' pool must fail");
+    thread_pool_destroy(pool);
+}
+
+// A parallel for started from inside a worker (the worker splits the range itself)
+static ThreadPool * nested_pool;
+
+void * nested_parallel_for_task(void * argument) {
+    VisitContext * context = argument;
+    return (void *) (uintptr_t) thread_pool_parallel_for(nested_pool, 0, 5000, 16, visit_range, context);
+}
+
+void thread_pool_nested_parallel_for_test() {
+    printf("*** Running test '%s'\n", __func__);
+    ThreadPoolOptions options = { 3, THREAD_POOL_AFFINITY_NONE, NULL, 0 };
+    nested_pool = thread_pool_create(&options);
+    VisitContext context;
+    context.visits = calloc(5000, sizeof(atomic_int));
+    atomic_init(&context.calls_amount, 0);
+    context.grain_size = 16;
+    atomic_init(&context.is_grain_exceeded, false);
+    ThreadPoolFuture * future = thread_pool_submit(nested_pool, nested_parallel_for_task, &context);
+    assert((uintptr_t) thread_pool_future_join(future) == 1, "The nested parallel for must be successful");
+    for (size_t i = 0; i < 5000; i++) {
+        assert(atomic_load(&context.visits[i]) == 1, "Every iteration of the nested range must be executed exactly once");
+    }
+    free(context.visits);
+    thread_pool_destroy(nested_pool);
+}
+
+static atomic_int detached_amount;
+
+void * detached_task(void * argument) {
+    (void) argument;
+    atomic_fetch_add(&detached_amount, 1);
+    return NULL;
+}
+
+void thread_pool_detached_test() {
+    printf("*** Running test '%s'\n", __func__);
+    atomic_init(&detached_amount, 0);
+    ThreadPool * pool = thread_pool_create_default();
+    for (int i = 0; i < 1000; i++) {
+        assert(thread_pool_submit_detached(pool, detached_task, NULL), "The detached submit must be successful");
+    }
+    thread_pool_destroy(pool); // Waits for all the submitted tasks
+    assert(atomic_load(&detached_amount) == 1000, "All the detached tasks must be executed before destroying");
+}
+
+static ThreadPool * index_pool;
+
+void * worker_index_task(void * argument) {
+    (void) argument;
+    size_t index = SIZE_MAX;
+    bool is_worker = thread_pool_worker_index(index_pool, &index);
+    return (void *) (uintptr_t) (is_worker && index < thread_pool_threads_amount(index_pool));
+}
+
+void thread_pool_worker_index_test() {
+    printf("*** Running test '%s'\n", __func__);
+    int cpus[] = { 0 };
+    ThreadPoolOptions options = { 2, THREAD_POOL_AFFINITY_CUSTOM, cpus, 1 };
+    index_pool = thread_pool_create(&options);
+    assert(index_pool != NULL, "The pinned 'pool' must not be null");
+    size_t index;
+    assert(!thread_pool_worker_index(index_pool, &index), "The main thread must not be a worker");
+    ThreadPoolFuture * future = thread_pool_submit(index_pool, worker_index_task, NULL);
+    assert((uintptr_t) thread_pool_future_join(future) == 1, "A task must run on a worker with a valid index");
+    thread_pool_destroy(index_pool);
+    ThreadPoolOptions invalid_options = { 2, THREAD_POOL_AFFINITY_CUSTOM, NULL, 0 };
+    assert(thread_pool_create(&invalid_options) == NULL, "The custom affinity without CPUs must fail");
+}
+
+// Tests runner
+
+int main() {
+    fclose(stderr); // Prevent printing "expected" errors
+    thread_pool_submit_test();
+    thread_pool_nested_submit_test();
+    thread_pool_parallel_for_test();
+    thread_pool_nested_parallel_for_test();
+    thread_pool_detached_test();
+    thread_pool_worker_index_test();
+}
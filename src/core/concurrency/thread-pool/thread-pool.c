@@ -0,0 +1,681 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * A Work-Stealing Thread Pool Implementation (with per-worker Chase-Lev deques).
+ *
+ * ### Explanation ###
+ *
+ * A thread pool keeps a fixed set of worker threads alive, so tasks can be executed concurrently without paying the
+ * thread creation cost for each one of them.
+ *
+ * The simplest pool has a single queue protected by a mutex, where every worker pops its next task from, but then all
+ * the workers contend on the same lock (and the same cache lines) for every task, which doesn't scale with small tasks.
+ *
+ * ### Work Stealing ###
+ *
+ * Instead, every worker owns a double-ended queue (or deque) of tasks, where it pushes the tasks it spawns and pops
+ * them from the same end (the bottom, in LIFO order, which is also cache friendly as the newest tasks are the hottest),
+ * and only when its own deque is empty it becomes a "thief" and steals the oldest task (from the top) of a randomly
+ * chosen victim. The oldest tasks are usually the biggest ones (i.e., the left halves of a recursively split range),
+ * so a single steal moves a lot of work, and the steals are rare.
+ *
+ * The tasks submitted from threads outside of the pool go through a shared (mutex protected) injection queue.
+ *
+ * ### Chase-Lev Deque ###
+ *
+ * The deque is the lock-free Chase-Lev deque (as formalized for the C11 memory model by Lê et al.), where the owner
+ * pushes and pops the bottom without any atomic read-modify-write (except when racing for the last task), and the
+ * thieves steal the top with a single compare-and-swap. When full, the owner doubles the circular array, and the old
+ * array is kept alive until the pool is destroyed (a thief might still be reading it).
+ *
+ * ### Sleeping ###
+ *
+ * The workers go to sleep when there is nothing to execute, and the submitters only take the sleep lock when there is
+ * any sleeping worker (the "pending tasks" and "sleepers" counters are checked in opposite orders with sequentially
+ * consistent operations, so a wake up can never be lost).
+ *
+ * ### References ###
+ *
+ * - https://www.dre.vanderbilt.edu/~schmidt/PDF/work-stealing-dequeue.pdf (Chase & Lev, Dynamic Circular Work-Stealing Deque)
+ * - https://fzn.fr/readings/ppopp13.pdf (Lê et al., Correct and Efficient Work-Stealing for Weak Memory Models)
+ * - http://supertech.csail.mit.edu/papers/steal.pdf (Blumofe & Leiserson, Scheduling Multithreaded Computations by Work Stealing)
+ */
+
+// Imports & Headers
+
+#define _GNU_SOURCE         // For "pthread_setaffinity_np", "CPU_SET" (CPU affinity)
+
+#include <stdlib.h>         // For "malloc", "calloc", "free" (memory management)
+#include <stdint.h>         // For "int64_t", "uint64_t" (more integer types)
+#include <stdatomic.h>      // For "atomic_int_fast64_t", "atomic_thread_fence" (lock-free deques)
+#include <pthread.h>        // For "pthread_create", "pthread_mutex_t", "pthread_cond_t" (workers & sleeping)
+#include <sched.h>          // For "sched_yield", "cpu_set_t" (yielding & CPU affinity)
+#include <unistd.h>         // For "sysconf" (amount of online CPUs)
+#include "thread-pool.h"
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+
+// Structures
+
+typedef struct task {
+    ThreadPoolTask function;        // The function to be executed
+    void * argument;                // The argument passed to the function
+    ThreadPoolFuture * future;      // Where the result is to be stored, or 'NULL' if the task is detached
+    struct task * next;             // The next task of the injection queue
+} Task;
+
+typedef struct deque_array {
+    int64_t capacity;               // The amount of slots (always a power of two)
+    struct deque_array * retired;   // The previous (smaller) array, kept alive until the pool is destroyed
+    _Atomic(Task *) slots[];        // The circular array of tasks
+} DequeArray;
+
+typedef struct worker {
+    _Alignas(64) atomic_int_fast64_t top;   // The index thieves steal from (on its own cache line)
+    _Alignas(64) atomic_int_fast64_t bottom; // The index the owner pushes to and pops from
+    _Atomic(DequeArray *) array;            // The current circular array of the deque
+    ThreadPool * pool;                      // The pool the worker belongs to
+    size_t index;                           // The index of the worker in the pool
+    uint64_t random_state;                  // The state of the victims random generator ("xorshift64")
+    pthread_t thread;                       // The worker thread
+} Worker;
+
+typedef struct latch {
+    atomic_bool is_open;            // Whether the awaited event already happened
+    pthread_mutex_t lock;           // Protects the sleeping of the waiters that are not workers
+    pthread_cond_t opened;          // Signaled once the latch is opened
+} Latch;
+
+struct thread_pool_future {
+    Latch latch;                    // Opened once the task finished
+    void * result;                  // The value returned by the task
+};
+
+typedef struct range_job {
+    ThreadPool * pool;              // The pool where the chunks are executed
+    Latch latch;                    // Opened once all the iterations were executed
+    atomic_size_t remaining;        // The amount of iterations not executed yet
+    size_t grain_size;              // The maximum amount of iterations of a single body call
+    ThreadPoolRangeTask body;       // The body to be executed for every sub-range
+    void * context;                 // The user pointer passed to every body call
+} RangeJob;
+
+typedef struct range_chunk {
+    RangeJob * job;                 // The job the chunk belongs to
+    size_t start;                   // The first iteration of the chunk (inclusive)
+    size_t stop;                    // The last iteration of the chunk (exclusive)
+} RangeChunk;
+
+struct thread_pool {
+    Worker * workers;               // The workers (and their deques)
+    size_t threads_amount;          // The amount of workers
+    atomic_size_t pending_amount;   // The amount of queued tasks that were not taken yet (by anyone)
+    atomic_size_t sleepers_amount;  // The amount of sleeping (or about to sleep) workers
+    atomic_bool is_shutdown;        // Whether the workers must exit once there are no pending tasks
+    pthread_mutex_t sleep_lock;     // Protects the sleeping of the workers
+    pthread_cond_t work_available;  // Signaled when a task is queued (and there are sleeping workers)
+    pthread_mutex_t injection_lock; // Protects the injection queue
+    Task * injection_head;          // The first task of the injection queue (submitted from outside of the pool)
+    Task * injection_tail;          // The last task of the injection queue
+    atomic_size_t injected_amount;  // The amount of tasks in the injection queue (checked before taking its lock)
+};
+
+// The worker the current thread is (or 'NULL' if the current thread does not belong to any pool)
+
+static _Thread_local Worker * current_worker = NULL;
+
+// Definition (to be able to use methods before declaring them, to follow up the top-bottom code style)
+
+void * thread_pool_worker_run(void * argument);
+bool thread_pool_worker_pin(Worker * worker, const ThreadPoolOptions * options);
+Task * thread_pool_find_task(ThreadPool * pool, Worker * worker);
+void thread_pool_execute(Task * task);
+bool thread_pool_enqueue(ThreadPool * pool, Task * task);
+bool thread_pool_deque_push(Worker * worker, Task * task);
+Task * thread_pool_deque_take(Worker * worker);
+Task * thread_pool_deque_steal(Worker * victim);
+DequeArray * thread_pool_deque_array_create(int64_t capacity);
+bool thread_pool_latch_init(Latch * latch);
+void thread_pool_latch_open(Latch * latch);
+void thread_pool_latch_wait(Latch * latch);
+void thread_pool_latch_destroy(Latch * latch);
+void * thread_pool_range_chunk_run(void * argument);
+void thread_pool_stop_workers(ThreadPool * pool, size_t started_amount);
+void thread_pool_free(ThreadPool * pool);
+
+// Default implementation values
+
+static const int64_t DEFAULT_DEQUE_CAPACITY = 256;
+static const size_t STEAL_ATTEMPTS_FACTOR = 4; // Steal attempts (per worker of the pool) before going to sleep
+
+ThreadPool * thread_pool_create_default() {
+    ThreadPoolOptions options = { 0, THREAD_POOL_AFFINITY_NONE, NULL, 0 };
+    return thread_pool_create(&options);
+}
+
+ThreadPool * thread_pool_create(const ThreadPoolOptions * options) {
+    if (options == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to create a pool with 'NULL' options");
+        return NULL;
+    }
+    if (options->affinity == THREAD_POOL_AFFINITY_CUSTOM && (options->cpus == NULL || options->cpus_amount == 0)) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The custom affinity requires a non empty 'cpus' array");
+        return NULL;
+    }
+    size_t threads_amount = options->threads_amount;
+    if (threads_amount == 0) {
+        long online_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads_amount = (online_cpus > 0) ? (size_t) online_cpus : 1;
+    }
+    ThreadPool * pool = malloc(sizeof(ThreadPool));
+    if (pool == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'pool'");
+        return NULL;
+    }
+    // The workers are aligned to the cache line size (so the deques indexes of different workers never share a line)
+    pool->workers = aligned_alloc(_Alignof(Worker), sizeof(Worker) * threads_amount);
+    if (pool->workers == NULL) {
+        free(pool);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'workers'");
+        return NULL;
+    }
+    pool->threads_amount = threads_amount;
+    atomic_init(&pool->pending_amount, 0);
+    atomic_init(&pool->sleepers_amount, 0);
+    atomic_init(&pool->is_shutdown, false);
+    pthread_mutex_init(&pool->sleep_lock, NULL);
+    pthread_cond_init(&pool->work_available, NULL);
+    pthread_mutex_init(&pool->injection_lock, NULL);
+    pool->injection_head = NULL;
+    pool->injection_tail = NULL;
+    atomic_init(&pool->injected_amount, 0);
+    // Initialize all the deques before starting any worker (as any worker might try to steal from any other)
+    size_t initialized_amount = 0;
+    for (; initialized_amount < threads_amount; initialized_amount++) {
+        Worker * worker = &pool->workers[initialized_amount];
+        DequeArray * array = thread_pool_deque_array_create(DEFAULT_DEQUE_CAPACITY);
+        if (array == NULL) break;
+        atomic_init(&worker->top, 0);
+        atomic_init(&worker->bottom, 0);
+        atomic_init(&worker->array, array);
+        worker->pool = pool;
+        worker->index = initialized_amount;
+        worker->random_state = 0x9e3779b97f4a7c15ULL * (initialized_amount + 1);
+    }
+    if (initialized_amount < threads_amount) {
+        for (size_t i = 0; i < initialized_amount; i++) free(atomic_load(&pool->workers[i].array));
+        free(pool->workers);
+        free(pool);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'array'");
+        return NULL;
+    }
+    // Start the workers (if any of them can't be started, then the already started ones are stopped)
+    size_t started_amount = 0;
+    for (; started_amount < threads_amount; started_amount++) {
+        Worker * worker = &pool->workers[started_amount];
+        if (pthread_create(&worker->thread, NULL, thread_pool_worker_run, worker) != 0) break;
+        if (options->affinity != THREAD_POOL_AFFINITY_NONE) thread_pool_worker_pin(worker, options);
+    }
+    if (started_amount < threads_amount) {
+        thread_pool_stop_workers(pool, started_amount);
+        thread_pool_free(pool);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to start the 'workers' threads");
+        return NULL;
+    }
+    // Return the new pool
+    return pool;
+}
+
+bool thread_pool_worker_pin(Worker * worker, const ThreadPoolOptions * options) {
+#ifdef __linux__
+    long online_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (online_cpus < 1) online_cpus = 1;
+    int cpu = (options->affinity == THREAD_POOL_AFFINITY_CUSTOM)
+            ? options->cpus[worker->index % options->cpus_amount]
+            : (int) (worker->index % (size_t) online_cpus);
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    if (pthread_setaffinity_np(worker->thread, sizeof(cpu_set_t), &cpu_set) != 0) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "Unable to pin the worker to the requested CPU");
+        return false;
+    }
+    return true;
+#else
+    error_reporter_report(ERROR_CODE_UNSUPPORTED, __func__, "The CPU affinity is only supported on Linux");
+    return false;
+#endif
+}
+
+void * thread_pool_worker_run(void * argument) {
+    Worker * worker = argument;
+    ThreadPool * pool = worker->pool;
+    current_worker = worker;
+    while (true) {
+        Task * task = thread_pool_find_task(pool, worker);
+        if (task != NULL) {
+            thread_pool_execute(task);
+            continue;
+        }
+        // Nothing was found, so announce that we are about to sleep, and only sleep if there is still nothing pending
+        pthread_mutex_lock(&pool->sleep_lock);
+        atomic_fetch_add(&pool->sleepers_amount, 1);
+        while (atomic_load(&pool->pending_amount) == 0 && !atomic_load(&pool->is_shutdown)) {
+            pthread_cond_wait(&pool->work_available, &pool->sleep_lock);
+        }
+        atomic_fetch_sub(&pool->sleepers_amount, 1);
+        bool is_exiting = atomic_load(&pool->is_shutdown) && atomic_load(&pool->pending_amount) == 0;
+        pthread_mutex_unlock(&pool->sleep_lock);
+        if (is_exiting) break;
+    }
+    current_worker = NULL;
+    return NULL;
+}
+
+Task * thread_pool_find_task(ThreadPool * pool, Worker * worker) {
+    // First, our own deque (the newest task, which is the hottest one in the cache)
+    Task * task = thread_pool_deque_take(worker);
+    if (task != NULL) return task;
+    // Then, the injection queue (the tasks submitted from outside of the pool)
+    if (atomic_load_explicit(&pool->injected_amount, memory_order_relaxed) > 0) {
+        pthread_mutex_lock(&pool->injection_lock);
+        task = pool->injection_head;
+        if (task != NULL) {
+            pool->injection_head = task->next;
+            if (pool->injection_head == NULL) pool->injection_tail = NULL;
+            atomic_fetch_sub_explicit(&pool->injected_amount, 1, memory_order_relaxed);
+        }
+        pthread_mutex_unlock(&pool->injection_lock);
+        if (task != NULL) {
+            atomic_fetch_sub(&pool->pending_amount, 1);
+            return task;
+        }
+    }
+    // Finally, steal the oldest task of randomly chosen victims
+    for (size_t attempt = 0; attempt < pool->threads_amount * STEAL_ATTEMPTS_FACTOR; attempt++) {
+        worker->random_state ^= worker->random_state << 13;
+        worker->random_state ^= worker->random_state >> 7;
+        worker->random_state ^= worker->random_state << 17;
+        Worker * victim = &pool->workers[worker->random_state % pool->threads_amount];
+        if (victim == worker) continue;
+        task = thread_pool_deque_steal(victim);
+        if (task != NULL) return task;
+    }
+    return NULL;
+}
+
+void thread_pool_execute(Task * task) {
+    void * result = task->function(task->argument);
+    if (task->future != NULL) {
+        task->future->result = result;
+        thread_pool_latch_open(&task->future->latch);
+    }
+    free(task);
+}
+
+bool thread_pool_enqueue(ThreadPool * pool, Task * task) {
+    Worker * worker = current_worker;
+    if (worker != NULL && worker->pool == pool) {
+        // Workers push to their own deque (without any lock)
+        if (!thread_pool_deque_push(worker, task)) return false;
+    } else {
+        // Outsiders push to the injection queue
+        task->next = NULL;
+        pthread_mutex_lock(&pool->injection_lock);
+        if (pool->injection_tail == NULL) {
+            pool->injection_head = task;
+        } else {
+            pool->injection_tail->next = task;
+        }
+        pool->injection_tail = task;
+        atomic_fetch_add_explicit(&pool->injected_amount, 1, memory_order_relaxed);
+        pthread_mutex_unlock(&pool->injection_lock);
+    }
+    // Wake up a sleeping worker (only taking the lock if someone is sleeping)
+    atomic_fetch_add(&pool->pending_amount, 1);
+    if (atomic_load(&pool->sleepers_amount) > 0) {
+        pthread_mutex_lock(&pool->sleep_lock);
+        pthread_cond_signal(&pool->work_available);
+        pthread_mutex_unlock(&pool->sleep_lock);
+    }
+    return true;
+}
+
+ThreadPoolFuture * thread_pool_submit(ThreadPool * pool, ThreadPoolTask task, void * argument) {
+    if (pool == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to submit a task to a 'NULL' pool");
+        return NULL;
+    }
+    if (task == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to submit a 'NULL' task to a pool");
+        return NULL;
+    }
+    ThreadPoolFuture * future = malloc(sizeof(ThreadPoolFuture));
+    if (future == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'future'");
+        return NULL;
+    }
+    Task * queued_task = malloc(sizeof(Task));
+    if (queued_task == NULL || !thread_pool_latch_init(&future->latch)) {
+        free(queued_task);
+        free(future);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'queued_task'");
+        return NULL;
+    }
+    future->result = NULL;
+    queued_task->function = task;
+    queued_task->argument = argument;
+    queued_task->future = future;
+    if (!thread_pool_enqueue(pool, queued_task)) {
+        thread_pool_latch_destroy(&future->latch);
+        free(queued_task);
+        free(future);
+        return NULL;
+    }
+    return future;
+}
+
+bool thread_pool_submit_detached(ThreadPool * pool, ThreadPoolTask task, void * argument) {
+    if (pool == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to submit a task to a 'NULL' pool");
+        return false;
+    }
+    if (task == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to submit a 'NULL' task to a pool");
+        return false;
+    }
+    Task * queued_task = malloc(sizeof(Task));
+    if (queued_task == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'queued_task'");
+        return false;
+    }
+    queued_task->function = task;
+    queued_task->argument = argument;
+    queued_task->future = NULL;
+    if (!thread_pool_enqueue(pool, queued_task)) {
+        free(queued_task);
+        return false;
+    }
+    return true;
+}
+
+bool thread_pool_future_is_done(ThreadPoolFuture * future) {
+    if (future == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to check a 'NULL' future");
+        return false;
+    }
+    return atomic_load_explicit(&future->latch.is_open, memory_order_acquire);
+}
+
+void * thread_pool_future_join(ThreadPoolFuture * future) {
+    if (future == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to join a 'NULL' future");
+        return NULL;
+    }
+    thread_pool_latch_wait(&future->latch);
+    void * result = future->result;
+    thread_pool_latch_destroy(&future->latch);
+    free(future);
+    return result;
+}
+
+bool thread_pool_parallel_for(ThreadPool * pool, size_t start, size_t stop, size_t grain_size, ThreadPoolRangeTask body, void * context) {
+    if (pool == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to run a parallel for on a 'NULL' pool");
+        return false;
+    }
+    if (body == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to run a parallel for with a 'NULL' body");
+        return false;
+    }
+    if (grain_size < 1) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'grain_size' must be an integer bigger or equal to '1'");
+        return false;
+    }
+    if (start > stop) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'start' must not be greater than the 'stop'");
+        return false;
+    }
+    if (start == stop) return true;
+    RangeJob job;
+    if (!thread_pool_latch_init(&job.latch)) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to initialize the 'latch' of the job");
+        return false;
+    }
+    atomic_init(&job.remaining, stop - start);
+    job.pool = pool;
+    job.grain_size = grain_size;
+    job.body = body;
+    job.context = context;
+    RangeChunk * root = malloc(sizeof(RangeChunk));
+    if (root == NULL) {
+        thread_pool_latch_destroy(&job.latch);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'root'");
+        return false;
+    }
+    root->job = &job;
+    root->start = start;
+    root->stop = stop;
+    Worker * worker = current_worker;
+    if (worker != NULL && worker->pool == pool) {
+        // Workers split the root chunk themselves (and help executing the stolen halves while waiting)
+        thread_pool_range_chunk_run(root);
+    } else if (!thread_pool_submit_detached(pool, thread_pool_range_chunk_run, root)) {
+        // If the root chunk couldn't be submitted, then the calling thread executes the whole range
+        thread_pool_range_chunk_run(root);
+    }
+    thread_pool_latch_wait(&job.latch);
+    thread_pool_latch_destroy(&job.latch);
+    return true;
+}
+
+void * thread_pool_range_chunk_run(void * argument) {
+    RangeChunk * chunk = argument;
+    RangeJob * job = chunk->job;
+    size_t start = chunk->start;
+    size_t stop = chunk->stop;
+    free(chunk);
+    // While the range is too big, keep the left half and push the right half (which might be stolen by other workers)
+    while (stop - start > job->grain_size) {
+        size_t middle = start + (stop - start) / 2;
+        RangeChunk * right = malloc(sizeof(RangeChunk));
+        if (right == NULL) break; // Can't split anymore, so the whole remaining range is executed here
+        right->job = job;
+        right->start = middle;
+        right->stop = stop;
+        if (!thread_pool_submit_detached(job->pool, thread_pool_range_chunk_run, right)) {
+            free(right);
+            break;
+        }
+        stop = middle;
+    }
+    job->body(start, stop, job->context);
+    // The last finished chunk opens the latch
+    size_t executed = stop - start;
+    if (atomic_fetch_sub_explicit(&job->remaining, executed, memory_order_acq_rel) == executed) {
+        thread_pool_latch_open(&job->latch);
+    }
+    return NULL;
+}
+
+size_t thread_pool_threads_amount(ThreadPool * pool) {
+    if (pool == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to get the threads amount of a 'NULL' pool");
+        return 0;
+    }
+    return pool->threads_amount;
+}
+
+bool thread_pool_worker_index(ThreadPool * pool, size_t * index) {
+    Worker * worker = current_worker;
+    if (worker == NULL || worker->pool != pool) return false;
+    if (index != NULL) (* index) = worker->index;
+    return true;
+}
+
+void thread_pool_destroy(ThreadPool * pool) {
+    if (pool != NULL) {
+        thread_pool_stop_workers(pool, pool->threads_amount);
+        thread_pool_free(pool);
+    }
+}
+
+void thread_pool_stop_workers(ThreadPool * pool, size_t started_amount) {
+    // Wake up all the workers, which exit once there are no pending tasks
+    pthread_mutex_lock(&pool->sleep_lock);
+    atomic_store(&pool->is_shutdown, true);
+    pthread_cond_broadcast(&pool->work_available);
+    pthread_mutex_unlock(&pool->sleep_lock);
+    for (size_t i = 0; i < started_amount; i++) {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+}
+
+void thread_pool_free(ThreadPool * pool) {
+    // Free the deques arrays (including the retired ones)
+    for (size_t i = 0; i < pool->threads_amount; i++) {
+        DequeArray * array = atomic_load(&pool->workers[i].array);
+        while (array != NULL) {
+            DequeArray * retired = array->retired;
+            free(array);
+            array = retired;
+        }
+    }
+    pthread_mutex_destroy(&pool->sleep_lock);
+    pthread_cond_destroy(&pool->work_available);
+    pthread_mutex_destroy(&pool->injection_lock);
+    free(pool->workers);
+    free(pool);
+}
+
+// Chase-Lev deque (the owner pushes and takes at the bottom, the thieves steal at the top)
+
+DequeArray * thread_pool_deque_array_create(int64_t capacity) {
+    DequeArray * array = malloc(sizeof(DequeArray) + sizeof(_Atomic(Task *)) * capacity);
+    if (array == NULL) return NULL;
+    array->capacity = capacity;
+    array->retired = NULL;
+    return array;
+}
+
+bool thread_pool_deque_push(Worker * worker, Task * task) {
+    int64_t bottom = atomic_load_explicit(&worker->bottom, memory_order_relaxed);
+    int64_t top = atomic_load_explicit(&worker->top, memory_order_acquire);
+    DequeArray * array = atomic_load_explicit(&worker->array, memory_order_relaxed);
+    // If the circular array is full, then double it (copying the live range), the old one is retired (not freed)
+    if (bottom - top > array->capacity - 1) {
+        DequeArray * resized = thread_pool_deque_array_create(array->capacity * 2);
+        if (resized == NULL) {
+            error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'resized'");
+            return false;
+        }
+        for (int64_t i = top; i < bottom; i++) {
+            Task * moved = atomic_load_explicit(&array->slots[i & (array->capacity - 1)], memory_order_relaxed);
+            atomic_store_explicit(&resized->slots[i & (resized->capacity - 1)], moved, memory_order_relaxed);
+        }
+        resized->retired = array;
+        atomic_store_explicit(&worker->array, resized, memory_order_release);
+        array = resized;
+    }
+    atomic_store_explicit(&array->slots[bottom & (array->capacity - 1)], task, memory_order_relaxed);
+    // Publish the task (a release store, so the thieves that observe the new bottom also observe the task contents)
+    atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_release);
+    return true;
+}
+
+Task * thread_pool_deque_take(Worker * worker) {
+    int64_t bottom = atomic_load_explicit(&worker->bottom, memory_order_relaxed) - 1;
+    DequeArray * array = atomic_load_explicit(&worker->array, memory_order_relaxed);
+    atomic_store_explicit(&worker->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t top = atomic_load_explicit(&worker->top, memory_order_relaxed);
+    Task * task = NULL;
+    if (top <= bottom) {
+        task = atomic_load_explicit(&array->slots[bottom & (array->capacity - 1)], memory_order_relaxed);
+        if (top == bottom) {
+            // It is the last task, so we race against the thieves for it
+            if (!atomic_compare_exchange_strong_explicit(&worker->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) {
+                task = NULL;
+            }
+            atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+        }
+    } else {
+        // The deque was empty
+        atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+    }
+    if (task != NULL) atomic_fetch_sub(&worker->pool->pending_amount, 1);
+    return task;
+}
+
+Task * thread_pool_deque_steal(Worker * victim) {
+    int64_t top = atomic_load_explicit(&victim->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t bottom = atomic_load_explicit(&victim->bottom, memory_order_acquire);
+    if (top >= bottom) return NULL;
+    DequeArray * array = atomic_load_explicit(&victim->array, memory_order_acquire);
+    Task * task = atomic_load_explicit(&array->slots[top & (array->capacity - 1)], memory_order_relaxed);
+    // If another thief (or the owner) took it first, then we give up (the caller tries another victim)
+    if (!atomic_compare_exchange_strong_explicit(&victim->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) {
+        return NULL;
+    }
+    atomic_fetch_sub(&victim->pool->pending_amount, 1);
+    return task;
+}
+
+// Latch (workers execute other tasks while waiting, outsiders sleep on the condition variable)
+
+bool thread_pool_latch_init(Latch * latch) {
+    atomic_init(&latch->is_open, false);
+    if (pthread_mutex_init(&latch->lock, NULL) != 0) return false;
+    if (pthread_cond_init(&latch->opened, NULL) != 0) {
+        pthread_mutex_destroy(&latch->lock);
+        return false;
+    }
+    return true;
+}
+
+void thread_pool_latch_open(Latch * latch) {
+    pthread_mutex_lock(&latch->lock);
+    atomic_store_explicit(&latch->is_open, true, memory_order_release);
+    pthread_cond_broadcast(&latch->opened);
+    pthread_mutex_unlock(&latch->lock);
+}
+
+void thread_pool_latch_wait(Latch * latch) {
+    Worker * worker = current_worker;
+    if (worker != NULL) {
+        // Workers never block, they keep executing tasks until the latch is opened
+        while (!atomic_load_explicit(&latch->is_open, memory_order_acquire)) {
+            Task * task = thread_pool_find_task(worker->pool, worker);
+            if (task != NULL) {
+                thread_pool_execute(task);
+            } else {
+                sched_yield();
+            }
+        }
+        // Synchronize with the opener (so the latch is not destroyed while it is still inside the critical section)
+        pthread_mutex_lock(&latch->lock);
+        pthread_mutex_unlock(&latch->lock);
+        return;
+    }
+    pthread_mutex_lock(&latch->lock);
+    while (!atomic_load_explicit(&latch->is_open, memory_order_acquire)) {
+        pthread_cond_wait(&latch->opened, &latch->lock);
+    }
+    pthread_mutex_unlock(&latch->lock);
+}
+
+void thread_pool_latch_destroy(Latch * latch) {
+    pthread_mutex_destroy(&latch->lock);
+    pthread_cond_destroy(&latch->opened);
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdbool.h>   // For "true", "false" (boolean constants)
+#include <stddef.h>    // For "size_t" (size type)
+
+/* thread-pool.h */
+#ifndef CONCURRENCY_THREAD_POOL_H
+#define CONCURRENCY_THREAD_POOL_H
+
+typedef struct thread_pool ThreadPool;
+typedef struct thread_pool_future ThreadPoolFuture;
+
+/**
+ * A task executed by one of the pool workers, whose returned value is stored in its future.
+ */
+typedef void * (* ThreadPoolTask)(void * argument);
+
+/**
+ * The body of a parallel for, executed for every "[start, stop)" sub-range of the whole iteration range.
+ */
+typedef void (* ThreadPoolRangeTask)(size_t start, size_t stop, void * context);
+
+/**
+ * Where the pool workers are allowed to run.
+ */
+typedef enum thread_pool_affinity {
+    THREAD_POOL_AFFINITY_NONE = 0,  // The workers can run on any CPU (the scheduler decides)
+    THREAD_POOL_AFFINITY_PER_CPU,   // The worker "i" is pinned to the online CPU "i % cpus_amount"
+    THREAD_POOL_AFFINITY_CUSTOM,    // The worker "i" is pinned to the CPU "cpus[i % cpus_amount]"
+} ThreadPoolAffinity;
+
+/**
+ * The pool creation options.
+ */
+typedef struct thread_pool_options {
+    size_t threads_amount;          // The amount of workers, or '0' to use the amount of online CPUs
+    ThreadPoolAffinity affinity;    // Where the workers are allowed to run
+    const int * cpus;               // The CPUs the workers are pinned to (only used by the custom affinity)
+    size_t cpus_amount;             // The amount of CPUs in the "cpus" array (only used by the custom affinity)
+} ThreadPoolOptions;
+
+/**
+ * Creates a thread pool with one worker per online CPU (and no CPU affinity).
+ *
+ * The returned pool must be freed by the client after its usage.
+ *
+ * @return a new thread pool, or {@code NULL} if an error occurred
+ */
+ThreadPool * thread_pool_create_default();
+
+/**
+ * Creates a thread pool with the provided options.
+ *
+ * The returned pool must be freed by the client after its usage.
+ *
+ * @param options the pool creation options
+ *
+ * @return a new thread pool, or {@code NULL} if an error occurred
+ */
+ThreadPool * thread_pool_create(const ThreadPoolOptions * options);
+
+/**
+ * Waits for all the submitted tasks to finish, then stops the workers and frees the pool.
+ *
+ * @param pool the thread pool that is about to be freed
+ *
+ * @note no task must be submitted concurrently with (or after) the destruction
+ */
+void thread_pool_destroy(ThreadPool * pool);
+
+/**
+ * Returns the amount of workers of the given pool.
+ *
+ * @return the amount of workers of the pool
+ */
+size_t thread_pool_threads_amount(ThreadPool * pool);
+
+/**
+ * Obtains the index of the calling thread in the given pool (useful to address per-worker state).
+ *
+ * @param pool the thread pool to whom the calling thread might belong to
+ * @param index where the worker index (between '0' and the amount of workers, exclusive) is to be stored
+ *
+ * @return {@code true} if the calling thread is a worker of the pool, {@code false} otherwise
+ */
+bool thread_pool_worker_index(ThreadPool * pool, size_t * index);
+
+/**
+ * Submits a task to be executed by the pool.
+ *
+ * When called from a worker, the task is pushed to its own deque (where idle workers steal it from), otherwise it is
+ * pushed to the shared injection queue.
+ *
+ * The returned future must be joined by the client (which frees it).
+ *
+ * @param pool the thread pool where the task is to be executed
+ * @param task the task to be executed
+ * @param argument the argument passed to the task
+ *
+ * @return the future of the task result, or {@code NULL} if an allocation error occurred
+ */
+ThreadPoolFuture * thread_pool_submit(ThreadPool * pool, ThreadPoolTask task, void * argument);
+
+/**
+ * Submits a task to be executed by the pool, without any future (its returned value is discarded).
+ *
+ * @param pool the thread pool where the task is to be executed
+ * @param task the task to be executed
+ * @param argument the argument passed to the task
+ *
+ * @return {@code true} if the task was submitted, {@code false} otherwise
+ */
+bool thread_pool_submit_detached(ThreadPool * pool, ThreadPoolTask task, void * argument);
+
+/**
+ * Returns whether the task of the given future already finished.
+ *
+ * @param future the future to be checked
+ *
+ * @return {@code true} if the task finished, {@code false} otherwise
+ */
+bool thread_pool_future_is_done(ThreadPoolFuture * future);
+
+/**
+ * Waits for the task of the given future to finish, frees the future, and returns the task result.
+ *
+ * When called from a worker, it executes other tasks while waiting (so workers never deadlock waiting each other).
+ *
+ * @param future the future to be joined
+ *
+ * @return the value returned by the task, or {@code NULL} if the future is {@code NULL}
+ */
+void * thread_pool_future_join(ThreadPoolFuture * future);
+
+/**
+ * Executes the given body over the "[start, stop)" range, split in sub-ranges of at most "grain_size" iterations.
+ *
+ * The range is split recursively in halves (the right half is pushed to the worker deque, so it can be stolen), which
+ * balances the load even if the iterations have really different costs, and it returns once the whole range was done.
+ *
+ * @param pool the thread pool where the body is to be executed
+ * @param start the first iteration (inclusive)
+ * @param stop the last iteration (exclusive)
+ * @param grain_size the maximum amount of iterations executed by a single body call (must be at least '1')
+ * @param body the body to be executed for every sub-range
+ * @param context the user pointer passed to every body call
+ *
+ * @return {@code true} if the whole range was executed, {@code false} if an error occurred
+ */
+bool thread_pool_parallel_for(ThreadPool * pool, size_t start, size_t stop, size_t grain_size, ThreadPoolRangeTask body, void * context);
+
+#endif /* CONCURRENCY_THREAD_POOL_H */
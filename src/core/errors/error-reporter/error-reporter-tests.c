@@ -0,0 +1,101 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "error-reporter.h"
+
+// Assertion snippet (not abstracted away for piece of code portability)
+void assert(int condition, char message[]) {
+    if (condition != 1) {
+        printf("%s\n", message);
+        exit(1);
+    }
+}
+
+// Unit testing
+
+void error_reporter_last_error_test() {
+    printf("*** Running test '%s'\n", __func__);
+    error_reporter_clear();
+    assert(error_reporter_last_code() == ERROR_CODE_NONE, "The last error code must be none after clearing");
+    error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to test a 'NULL' argument");
+    Error error = error_reporter_last_error();
+    assert(error.code == ERROR_CODE_NULL_ARGUMENT, "The last error code must match the reported code");
+    assert(strcmp(error.function, __func__) == 0, "The last error function must match the reporting function");
+    assert(strcmp(error.message, "Trying to test a 'NULL' argument") == 0, "The last error message must match");
+    error_reporter_clear();
+    assert(error_reporter_last_code() == ERROR_CODE_NONE, "The last error code must be none after clearing");
+}
+
+void error_reporter_silent_mode_test() {
+    printf("*** Running test '%s'\n", __func__);
+    assert(error_reporter_configure(ERROR_REPORTER_MODE_SILENT, NULL, NULL), "The silent mode must be configured");
+    assert(error_reporter_mode() == ERROR_REPORTER_MODE_SILENT, "The mode must be the silent mode");
+    error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory");
+    assert(error_reporter_last_code() == ERROR_CODE_OUT_OF_MEMORY, "The last error must be recorded in silent mode");
+    assert(error_reporter_configure(ERROR_REPORTER_MODE_STDERR, NULL, NULL), "The stderr mode must be configured");
+}
+
+void error_reporter_count_callback(const Error * error, void * context) {
+    if (error->code == ERROR_CODE_INVALID_STATE) {
+        (* (int *) context)++;
+    }
+}
+
+void error_reporter_callback_mode_test() {
+    printf("*** Running test '%s'\n", __func__);
+    int calls_amount = 0;
+    assert(!error_reporter_configure(ERROR_REPORTER_MODE_CALLBACK, NULL, NULL), "The callback mode requires a callback");
+    assert(error_reporter_mode() == ERROR_REPORTER_MODE_STDERR, "A failed configuration must not change the mode");
+    assert(error_reporter_configure(ERROR_REPORTER_MODE_CALLBACK, error_reporter_count_callback, &calls_amount), "The callback mode must be configured");
+    error_reporter_report(ERROR_CODE_INVALID_STATE, __func__, "Trying to remove from an empty structure");
+    error_reporter_report(ERROR_CODE_INVALID_STATE, __func__, "Trying to remove from an empty structure");
+    assert(calls_amount == 2, "The callback must be invoked once per reported error");
+    assert(error_reporter_configure(ERROR_REPORTER_MODE_STDERR, NULL, NULL), "The stderr mode must be configured");
+}
+
+void * error_reporter_report_in_thread(void * argument) {
+    (void) argument;
+    error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'argument' is invalid");
+    return NULL;
+}
+
+void error_reporter_thread_local_test() {
+    printf("*** Running test '%s'\n", __func__);
+    error_reporter_clear();
+    pthread_t thread;
+    pthread_create(&thread, NULL, error_reporter_report_in_thread, NULL);
+    pthread_join(thread, NULL);
+    assert(error_reporter_last_code() == ERROR_CODE_NONE, "Errors of other threads must not be visible");
+}
+
+void error_reporter_code_name_test() {
+    printf("*** Running test '%s'\n", __func__);
+    assert(strcmp(error_reporter_code_name(ERROR_CODE_NONE), "ERROR_CODE_NONE") == 0, "The none code name must match");
+    assert(strcmp(error_reporter_code_name(ERROR_CODE_UNSUPPORTED), "ERROR_CODE_UNSUPPORTED") == 0, "The unsupported code name must match");
+    assert(strcmp(error_reporter_code_name((ErrorCode) 1234), "ERROR_CODE_UNKNOWN") == 0, "The unknown code name must match");
+}
+
+// Tests runner
+
+int main() {
+    fclose(stderr); // Prevent printing "expected" errors
+    error_reporter_last_error_test();
+    error_reporter_silent_mode_test();
+    error_reporter_callback_mode_test();
+    error_reporter_thread_local_test();
+    error_reporter_code_name_test();
+}
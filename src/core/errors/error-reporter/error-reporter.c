@@ -0,0 +1,111 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * A Thread-Safe Error Reporter Implementation (with thread-local last error).
+ *
+ * ### Explanation ###
+ *
+ * Printing every validation failure with "fprintf(stderr, ...)" takes the "stderr" stream lock and performs a system
+ * call, so under a flood of malformed input all the threads end up serialized on that lock. Instead, the kit functions
+ * report their failures here, where the error is always stored as the thread-local last error (a few plain stores,
+ * same idea as "errno"), and then it is handled according to the configured mode:
+ * - Stderr (default): the error is printed to "stderr", preserving the original behavior of the kit.
+ * - Callback: the error is passed to a user callback (i.e., to forward it to the application logger).
+ * - Silent: nothing else is done, so the hot paths never touch "stdio" and the caller inspects the last error.
+ *
+ * The messages are static chains (never formatted nor copied), that's why reporting in silent mode is that cheap.
+ *
+ * ### References ###
+ *
+ * - https://en.cppreference.com/w/c/language/storage_duration (thread storage duration)
+ * - https://man7.org/linux/man-pages/man3/errno.3.html
+ */
+
+// Imports & Headers
+
+#include <stdio.h>          // For "fprintf", "stderr" (printing errors)
+#include <stdatomic.h>      // For "atomic_int", "atomic_load_explicit" (process-wide configuration)
+#include "error-reporter.h"
+
+// Process-wide configuration (read with acquire semantics, so a configured callback is always seen with its context)
+
+static atomic_int configured_mode = ERROR_REPORTER_MODE_STDERR;
+static _Atomic(ErrorCallback) configured_callback = NULL;
+static _Atomic(void *) configured_context = NULL;
+
+// Thread-local last error
+
+static _Thread_local Error last_error = { ERROR_CODE_NONE, NULL, NULL };
+
+bool error_reporter_configure(ErrorReporterMode mode, ErrorCallback callback, void * context) {
+    if (mode != ERROR_REPORTER_MODE_STDERR && mode != ERROR_REPORTER_MODE_CALLBACK && mode != ERROR_REPORTER_MODE_SILENT) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'mode' must be a valid reporter mode");
+        return false;
+    }
+    if (mode == ERROR_REPORTER_MODE_CALLBACK && callback == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "The callback mode requires a non 'NULL' callback");
+        return false;
+    }
+    // Store the callback before the mode, so whoever observes the new mode also observes its callback
+    atomic_store_explicit(&configured_context, context, memory_order_relaxed);
+    atomic_store_explicit(&configured_callback, callback, memory_order_relaxed);
+    atomic_store_explicit(&configured_mode, mode, memory_order_release);
+    return true;
+}
+
+ErrorReporterMode error_reporter_mode() {
+    return atomic_load_explicit(&configured_mode, memory_order_acquire);
+}
+
+void error_reporter_report(ErrorCode code, const char * function, const char * message) {
+    // Always record the error as the last error of the current thread
+    last_error.code = code;
+    last_error.function = function;
+    last_error.message = message;
+    ErrorReporterMode mode = atomic_load_explicit(&configured_mode, memory_order_acquire);
+    if (mode == ERROR_REPORTER_MODE_SILENT) return;
+    if (mode == ERROR_REPORTER_MODE_CALLBACK) {
+        ErrorCallback callback = atomic_load_explicit(&configured_callback, memory_order_relaxed);
+        void * context = atomic_load_explicit(&configured_context, memory_order_relaxed);
+        callback(&last_error, context);
+        return;
+    }
+    fprintf(stderr, "%s at '%s'\n", message, function);
+}
+
+Error error_reporter_last_error() {
+    return last_error;
+}
+
+ErrorCode error_reporter_last_code() {
+    return last_error.code;
+}
+
+void error_reporter_clear() {
+    last_error.code = ERROR_CODE_NONE;
+    last_error.function = NULL;
+    last_error.message = NULL;
+}
+
+const char * error_reporter_code_name(ErrorCode code) {
+    switch (code) {
+        case ERROR_CODE_NONE: return "ERROR_CODE_NONE";
+        case ERROR_CODE_NULL_ARGUMENT: return "ERROR_CODE_NULL_ARGUMENT";
+        case ERROR_CODE_INVALID_ARGUMENT: return "ERROR_CODE_INVALID_ARGUMENT";
+        case ERROR_CODE_OUT_OF_MEMORY: return "ERROR_CODE_OUT_OF_MEMORY";
+        case ERROR_CODE_INVALID_STATE: return "ERROR_CODE_INVALID_STATE";
+        case ERROR_CODE_UNSUPPORTED: return "ERROR_CODE_UNSUPPORTED";
+        default: return "ERROR_CODE_UNKNOWN";
+    }
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdbool.h>        // For "true", "false" (boolean constants)
+
+/* error-reporter.h */
+#ifndef ERRORS_ERROR_REPORTER_H
+#define ERRORS_ERROR_REPORTER_H
+
+/**
+ * The kind of failure that was reported by any of the kit functions.
+ */
+typedef enum error_code {
+    ERROR_CODE_NONE = 0,            // No error was reported (yet) in the current thread
+    ERROR_CODE_NULL_ARGUMENT,       // A required pointer argument was 'NULL'
+    ERROR_CODE_INVALID_ARGUMENT,    // An argument was outside of its valid domain
+    ERROR_CODE_OUT_OF_MEMORY,       // An allocation or a reallocation failed
+    ERROR_CODE_INVALID_STATE,       // The operation is not allowed in the current state (i.e., removing from empty)
+    ERROR_CODE_UNSUPPORTED,         // The operation is not available (i.e., it was disabled at compile time)
+} ErrorCode;
+
+/**
+ * A reported error, the "function" and "message" chains are static (they never need to be freed).
+ */
+typedef struct error {
+    ErrorCode code;                 // The kind of failure
+    const char * function;          // The name of the function that reported the error
+    const char * message;           // The human readable description of the error
+} Error;
+
+/**
+ * The user callback invoked (in the reporting thread) for every reported error when using the callback mode.
+ */
+typedef void (* ErrorCallback)(const Error * error, void * context);
+
+/**
+ * What happens when an error is reported (the thread-local last error is always recorded, in any mode).
+ */
+typedef enum error_reporter_mode {
+    ERROR_REPORTER_MODE_STDERR = 0, // The error is printed to "stderr" (default mode)
+    ERROR_REPORTER_MODE_CALLBACK,   // The error is passed to the configured user callback
+    ERROR_REPORTER_MODE_SILENT,     // The error is only recorded as the thread-local last error
+} ErrorReporterMode;
+
+/**
+ * Configures how the errors are reported from now on, by all the threads.
+ *
+ * @param mode the new reporting mode
+ * @param callback the callback to be invoked on every error (only required by the callback mode)
+ * @param context the user pointer passed to every callback invocation (might be {@code NULL})
+ *
+ * @note it is meant to be called at startup, before other threads start reporting errors
+ *
+ * @return {@code true} if the configuration was applied, {@code false} otherwise
+ */
+bool error_reporter_configure(ErrorReporterMode mode, ErrorCallback callback, void * context);
+
+/**
+ * Returns the currently configured reporting mode.
+ *
+ * @return the current reporting mode
+ */
+ErrorReporterMode error_reporter_mode();
+
+/**
+ * Reports an error, it is recorded as the last error of the calling thread and then handled by the configured mode.
+ *
+ * @param code the kind of failure
+ * @param function the name of the function that is reporting the error (usually "__func__")
+ * @param message the static human readable description of the error (it is never copied)
+ */
+void error_reporter_report(ErrorCode code, const char * function, const char * message);
+
+/**
+ * Returns the last error reported in the calling thread (successful calls do NOT clear it, same as "errno").
+ *
+ * @return the last error, which has the {@code ERROR_CODE_NONE} code if no error was reported since the last clear
+ */
+Error error_reporter_last_error();
+
+/**
+ * Returns the code of the last error reported in the calling thread.
+ *
+ * @return the last error code, or {@code ERROR_CODE_NONE} if no error was reported since the last clear
+ */
+ErrorCode error_reporter_last_code();
+
+/**
+ * Clears the last error of the calling thread.
+ */
+void error_reporter_clear();
+
+/**
+ * Returns the name of the given error code (i.e., "ERROR_CODE_NULL_ARGUMENT").
+ *
+ * @param code the error code whose name is to be returned
+ *
+ * @return the static name of the code, or "ERROR_CODE_UNKNOWN" if the code is not valid
+ */
+const char * error_reporter_code_name(ErrorCode code);
+
+#endif /* ERRORS_ERROR_REPORTER_H */
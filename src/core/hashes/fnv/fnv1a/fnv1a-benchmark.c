@@ -0,0 +1,68 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L // For "clock_gettime", "CLOCK_MONOTONIC" (monotonic clock)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include "fnv1a.h"
+
+// Benchmarking snippet (not abstracted away for piece of code portability)
+double elapsed_seconds(struct timespec start, struct timespec stop) {
+    return (double) (stop.tv_sec - start.tv_sec) + (double) (stop.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Benchmarks
+
+void hashes_fnv1a_hash32_bytes_benchmark(const char * bytes, size_t length, size_t iterations) {
+    struct timespec start, stop;
+    uint32_t checksum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < iterations; i++) {
+        uint32_t * hash = hashes_fnv1a_hash32_bytes(bytes, length);
+        checksum += (* hash);
+        free(hash);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    double seconds = elapsed_seconds(start, stop);
+    printf("%-36s %8zu bytes %10.3f ms %10.1f MB/s (checksum %u)\n", __func__, length, seconds * 1e3, length * iterations / seconds / 1e6, checksum);
+}
+
+void hashes_fnv1a_hash64_bytes_benchmark(const char * bytes, size_t length, size_t iterations) {
+    struct timespec start, stop;
+    uint64_t checksum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < iterations; i++) {
+        uint64_t * hash = hashes_fnv1a_hash64_bytes(bytes, length);
+        checksum += (* hash);
+        free(hash);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    double seconds = elapsed_seconds(start, stop);
+    printf("%-36s %8zu bytes %10.3f ms %10.1f MB/s (checksum %llu)\n", __func__, length, seconds * 1e3, length * iterations / seconds / 1e6, (unsigned long long) checksum);
+}
+
+// Benchmarks runner (the first argument optionally overrides the total amount of hashed bytes per key length)
+
+int main(int argc, char * argv[]) {
+    size_t total_bytes = (argc > 1) ? strtoull(argv[1], NULL, 10) : 200000000;
+    size_t lengths[] = { 8, 32, 256, 4096 };
+    char * bytes = malloc(4096);
+    for (size_t i = 0; i < 4096; i++) bytes[i] = (char) ('a' + i % 26);
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(size_t); i++) {
+        hashes_fnv1a_hash32_bytes_benchmark(bytes, lengths[i], total_bytes / lengths[i]);
+        hashes_fnv1a_hash64_bytes_benchmark(bytes, lengths[i], total_bytes / lengths[i]);
+    }
+    free(bytes);
+}
@@ -14,6 +14,7 @@
 #include <stdio.h>          // For "printf", "stderr" (printing errors)
 #include <stdlib.h>         // For "exit"
 #include "fnv1a.h"
+#include "error-reporter.h"
 
 // Assertion snippet (not abstracted away for piece of code portability)
 void assert(int condition, char message[]) {
@@ -64,6 +65,7 @@ void hashes_fnv1a_hash64_str_test() {
     // Testing hashes pointers return 'NULL' if parameters validation fails
     uint64_t * fourth = hashes_fnv1a_hash64_bytes(NULL, 10);
     assert(fourth == NULL, "Fourth hash result must be NULL!");
+    assert(error_reporter_last_code() == ERROR_CODE_NULL_ARGUMENT, "Fourth hash error must be a 'NULL' argument error!");
     free(fourth);
     uint64_t * fifth = hashes_fnv1a_hash64_bytes("sample text", 0);
     assert(fifth == NULL, "Fifth hash result must be NULL!");
@@ -73,8 +75,23 @@ void hashes_fnv1a_hash64_str_test() {
     free(sixth);
 }
 
+void hashes_fnv1a_hash64_bytes_into_test() {
+    printf("*** Running test '%s'\n", __func__);
+    // Testing hashes values match the allocating version
+    uint64_t hash = 0;
+    assert(hashes_fnv1a_hash64_bytes_into("Welcome home!", 13, &hash), "First hash must be computed!");
+    assert(hash == 6875887167340965921, "First hash result does not match expected!");
+    assert(hashes_fnv1a_hash64_bytes_into("", 0, &hash), "Empty bytes hash must be computed!");
+    assert(hash == 0xcbf29ce484222325, "Empty bytes hash must be the offset basis!");
+    // Testing hashes return 'false' if parameters validation fails
+    assert(!hashes_fnv1a_hash64_bytes_into(NULL, 10, &hash), "Hashing 'NULL' bytes must fail!");
+    assert(error_reporter_last_code() == ERROR_CODE_NULL_ARGUMENT, "Hashing 'NULL' bytes error must be a 'NULL' argument error!");
+    assert(!hashes_fnv1a_hash64_bytes_into("sample text", 11, NULL), "Hashing into a 'NULL' hash must fail!");
+}
+
 int main() {
     fclose(stderr); // Prevent printing "expected" errors
     hashes_fnv1a_hash32_str_test();
     hashes_fnv1a_hash64_str_test();
+    hashes_fnv1a_hash64_bytes_into_test();
 }
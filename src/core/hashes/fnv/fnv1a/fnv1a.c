@@ -13,10 +13,13 @@
 
 // Imports & Headers
 
-#include <stdio.h>          // For "printf", "stderr" (printing errors)
+#include <stdbool.h>        // For "true", "false" (boolean constants)
 #include <stdint.h>         // For "uint32_t", "uint64_t" (more integer types)
 #include <string.h>         // For "memcpy", "strlen" (better memory copy and utils)
 #include <stdlib.h>         // For "exit"
+#include "fnv1a.h"
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+#include "usdt.h"           // For "USDT_PROBE2" (optional static tracing probes)
 
 /*
  * ### Introduction ###
@@ -41,17 +44,18 @@ static const uint32_t INIT_32 = 0x811c9dc5;
 static const uint32_t PRIME_32 = 16777619;
 
 uint32_t * hashes_fnv1a_hash32_bytes(const char * bytes, const size_t length) {
+    USDT_PROBE2(fnv1a_hash32, bytes, length);
     if (bytes == NULL) {
-        fprintf(stderr, "Trying to hash 'NULL' bytes at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to hash 'NULL' bytes");
         return NULL;
     }
     if (length <= 0) {
-        fprintf(stderr, "The 'length' must be greater than zero at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'length' must be greater than zero");
         return NULL;
     }
     uint32_t * hash = malloc(sizeof(uint32_t));
     if (hash == NULL) {
-        fprintf(stderr, "Unable to allocate memory for 'hash' at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'hash'");
         return NULL;
     }
     (* hash) = INIT_32;
@@ -73,26 +77,38 @@ static const uint64_t PRIME_64 = 1099511628211;
 
 uint64_t * hashes_fnv1a_hash64_bytes(const char * bytes, const size_t length) {
     if (bytes == NULL) {
-        fprintf(stderr, "Trying to hash 'NULL' bytes at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to hash 'NULL' bytes");
         return NULL;
     }
     if (length <= 0) {
-        fprintf(stderr, "The 'length' must be greater than zero at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'length' must be greater than zero");
         return NULL;
     }
     uint64_t * hash = malloc(sizeof(uint64_t));
     if (hash == NULL) {
-        fprintf(stderr, "Unable to allocate memory for 'hash' at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'hash'");
         return NULL;
     }
-    (* hash) = INIT_64;
-    for (size_t i = 0; i < length; i++) {
-        (* hash) ^= (bytes[i] & 0xff);
-        (* hash) *= PRIME_64;
-    }
+    // The hashing itself (and its probe) lives in "hashes_fnv1a_hash64_bytes_into"
+    hashes_fnv1a_hash64_bytes_into(bytes, length, hash);
     return hash;
 }
 
 uint64_t * hashes_fnv1a_hash64_str(const char * text) {
     return hashes_fnv1a_hash64_bytes(text, strlen(text));
 }
+
+bool hashes_fnv1a_hash64_bytes_into(const char * bytes, const size_t length, uint64_t * hash) {
+    USDT_PROBE2(fnv1a_hash64, bytes, length);
+    if ((bytes == NULL && length > 0) || hash == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to hash 'NULL' bytes or into a 'NULL' hash");
+        return false;
+    }
+    uint64_t value = INIT_64;
+    for (size_t i = 0; i < length; i++) {
+        value ^= (bytes[i] & 0xff);
+        value *= PRIME_64;
+    }
+    (* hash) = value;
+    return true;
+}
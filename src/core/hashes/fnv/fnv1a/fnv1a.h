@@ -67,4 +67,18 @@ uint64_t * hashes_fnv1a_hash64_bytes(const char * bytes, const size_t length);
  */
 uint64_t * hashes_fnv1a_hash64_str(const char * text);
 
+/**
+ * Computes the 64 bit integer hash of the given bytes into the given destination (without any allocation, so it is
+ * suitable for hot paths, e.g., hash tables lookups).
+ *
+ * Unlike the allocating version, an empty run of bytes (a zero "length") is valid, and hashes to the offset basis.
+ *
+ * @param bytes the bytes to be hashed (only allowed to be {@code NULL} if the "length" is zero)
+ * @param length the amount of bytes to be hashed
+ * @param hash where the hash value is to be stored
+ *
+ * @return {@code true} if the hash was computed, {@code false} if an argument is {@code NULL}
+ */
+bool hashes_fnv1a_hash64_bytes_into(const char * bytes, const size_t length, uint64_t * hash);
+
 #endif /* HASHES_FNV1A_H */
\ No newline at end of file
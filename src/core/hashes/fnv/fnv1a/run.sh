@@ -5,7 +5,7 @@ rm -rf main
 rm -rf report.txt
 
 # Compile and run with valgrind
-gcc -O0 -g -o main fnv1a-tests.c fnv1a.c
+gcc -O0 -g -I../../../tracing/usdt -I../../../errors/error-reporter -o main fnv1a-tests.c fnv1a.c ../../../errors/error-reporter/error-reporter.c
 valgrind --leak-check=full \
          --show-leak-kinds=all \
          --track-origins=yes \
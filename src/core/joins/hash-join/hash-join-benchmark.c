@@ -0,0 +1,79 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L // For "clock_gettime", "CLOCK_MONOTONIC" (monotonic clock)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include "hash-join.h"
+#include "thread-pool.h"
+
+#define KEY_SIZE 16
+
+// Benchmarking snippet (not abstracted away for piece of code portability)
+double elapsed_seconds(struct timespec start, struct timespec stop) {
+    return (double) (stop.tv_sec - start.tv_sec) + (double) (stop.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Benchmarks
+
+// Joins "rows_amount" unique build keys with as many probe keys (every probe key picks a random build key)
+void hash_join_benchmark(size_t rows_amount, ThreadPool * pool) {
+    char * build_arena = malloc(rows_amount * KEY_SIZE);
+    char * probe_arena = malloc(rows_amount * KEY_SIZE);
+    HashJoinKey * build = malloc(sizeof(HashJoinKey) * rows_amount);
+    HashJoinKey * probe = malloc(sizeof(HashJoinKey) * rows_amount);
+    uint64_t random_state = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < rows_amount; i++) {
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 7;
+        random_state ^= random_state << 17;
+        build[i].bytes = build_arena + i * KEY_SIZE;
+        build[i].length = (size_t) snprintf(build_arena + i * KEY_SIZE, KEY_SIZE, "key-%011zu", i);
+        probe[i].bytes = probe_arena + i * KEY_SIZE;
+        probe[i].length = (size_t) snprintf(probe_arena + i * KEY_SIZE, KEY_SIZE, "key-%011zu", (size_t) (random_state % rows_amount));
+    }
+    const char * names[] = { "partitioned", "non-partitioned" };
+    HashJoinOptions options[] = { { true, 0 }, { false, 0 } };
+    double seconds[2];
+    for (size_t i = 0; i < 2; i++) {
+        struct timespec start, stop;
+        size_t matches_amount;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        HashJoinMatch * matches = hash_join(build, rows_amount, probe, rows_amount, &options[i], pool, &matches_amount);
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        seconds[i] = elapsed_seconds(start, stop);
+        if (matches_amount != rows_amount) printf("%s join found %zu matches instead of %zu\n", names[i], matches_amount, rows_amount);
+        free(matches);
+    }
+    printf("%12zu %16.1f %16.1f %10.2fx\n", rows_amount, 2 * rows_amount / seconds[0] / 1e6, 2 * rows_amount / seconds[1] / 1e6, seconds[1] / seconds[0]);
+    free(build);
+    free(probe);
+    free(build_arena);
+    free(probe_arena);
+}
+
+// Benchmarks runner (the arguments optionally override the maximum amount of rows per side and the amount of threads)
+
+int main(int argc, char * argv[]) {
+    size_t max_rows_amount = (argc > 1) ? strtoull(argv[1], NULL, 10) : 10000000;
+    size_t threads_amount = (argc > 2) ? strtoull(argv[2], NULL, 10) : 0;
+    ThreadPoolOptions options = { threads_amount, THREAD_POOL_AFFINITY_NONE, NULL, 0 };
+    ThreadPool * pool = thread_pool_create(&options);
+    printf("%zu threads\n", thread_pool_threads_amount(pool));
+    printf("%12s %16s %16s %11s\n", "rows", "partitioned M/s", "shared M/s", "speedup");
+    for (size_t rows_amount = 1000000; rows_amount <= max_rows_amount; rows_amount *= 10) hash_join_benchmark(rows_amount, pool);
+    thread_pool_destroy(pool);
+}
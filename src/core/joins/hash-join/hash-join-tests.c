@@ -0,0 +1,149 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "hash-join.h"
+#include "thread-pool.h"
+#include "error-reporter.h"
+
+#define THREADS_AMOUNT 4
+#define KEY_SIZE 16
+
+// Assertion snippet (not abstracted away for piece of code portability)
+void assert(int condition, char message[]) {
+    if (condition != 1) {
+        printf("%s\n", message);
+        exit(1);
+    }
+}
+
+// Utilities
+
+int compare_matches(const void * first, const void * second) {
+    const HashJoinMatch * first_match = first;
+    const HashJoinMatch * second_match = second;
+    if (first_match->build_index != second_match->build_index) return (first_match->build_index < second_match->build_index) ? -1 : 1;
+    if (first_match->probe_index != second_match->probe_index) return (first_match->probe_index < second_match->probe_index) ? -1 : 1;
+    return 0;
+}
+
+// Generates keys "key-<id>", stored in the given arena
+HashJoinKey * generate_keys(size_t amount, size_t ids_amount, size_t step, char ** arena) {
+    HashJoinKey * keys = malloc(sizeof(HashJoinKey) * amount);
+    * arena = malloc(amount * KEY_SIZE);
+    for (size_t i = 0; i < amount; i++) {
+        char * bytes = * arena + i * KEY_SIZE;
+        keys[i].bytes = bytes;
+        keys[i].length = (size_t) snprintf(bytes, KEY_SIZE, "key-%zu", i * step % ids_amount);
+    }
+    return keys;
+}
+
+// Unit testing
+
+void hash_join_small_test(ThreadPool * pool) {
+    printf("*** Running test '%s'\n", __func__);
+    HashJoinKey build[] = { { "apple", 5 }, { "pear", 4 }, { "apple", 5 }, { "", 0 }, { "plum", 4 } };
+    HashJoinKey probe[] = { { "pear", 4 }, { "apple", 5 }, { "kiwi", 4 }, { "", 0 }, { "appl", 4 } };
+    HashJoinMatch expected[] = { { 0, 1 }, { 1, 0 }, { 2, 1 }, { 3, 3 } };
+    HashJoinOptions options[] = { { true, 0 }, { true, 3 }, { true, 14 }, { false, 0 } };
+    for (size_t i = 0; i < sizeof(options) / sizeof(HashJoinOptions); i++) {
+        size_t matches_amount;
+        HashJoinMatch * matches = hash_join(build, 5, probe, 5, &options[i], pool, &matches_amount);
+        assert(matches != NULL, "Join must succeed");
+        assert(matches_amount == 4, "Join must find 4 matches");
+        qsort(matches, matches_amount, sizeof(HashJoinMatch), compare_matches);
+        for (size_t j = 0; j < 4; j++) assert(compare_matches(&matches[j], &expected[j]) == 0, "Join matches must be the expected ones");
+        free(matches);
+    }
+}
+
+void hash_join_large_test(ThreadPool * pool) {
+    printf("*** Running test '%s'\n", __func__);
+    // Every build id appears 3 times, and the probe ids cover twice the build ids (so half of them miss)
+    const size_t BUILD_AMOUNT = 60000;
+    const size_t PROBE_AMOUNT = 90000;
+    char * build_arena;
+    char * probe_arena;
+    HashJoinKey * build = generate_keys(BUILD_AMOUNT, BUILD_AMOUNT / 3, 1, &build_arena);
+    HashJoinKey * probe = generate_keys(PROBE_AMOUNT, BUILD_AMOUNT / 3 * 2, 7, &probe_arena);
+    size_t expected_amount = 0;
+    for (size_t i = 0; i < PROBE_AMOUNT; i++) expected_amount += (i * 7 % (BUILD_AMOUNT / 3 * 2) < BUILD_AMOUNT / 3) ? 3 : 0;
+    // The automatic bits, a single pass, two passes, and the shared table must obtain the same matches
+    HashJoinOptions options[] = { { true, 0 }, { true, 6 }, { true, 13 }, { false, 0 } };
+    HashJoinMatch * reference = NULL;
+    for (size_t i = 0; i < sizeof(options) / sizeof(HashJoinOptions); i++) {
+        size_t matches_amount;
+        HashJoinMatch * matches = hash_join(build, BUILD_AMOUNT, probe, PROBE_AMOUNT, &options[i], pool, &matches_amount);
+        assert(matches != NULL, "Join must succeed");
+        assert(matches_amount == expected_amount, "Join must find the expected amount of matches");
+        qsort(matches, matches_amount, sizeof(HashJoinMatch), compare_matches);
+        for (size_t j = 0; j < matches_amount; j++) {
+            HashJoinKey * build_key = &build[matches[j].build_index];
+            HashJoinKey * probe_key = &probe[matches[j].probe_index];
+            assert(build_key->length == probe_key->length && memcmp(build_key->bytes, probe_key->bytes, build_key->length) == 0, "Matched keys must be equal");
+            assert(j == 0 || compare_matches(&matches[j - 1], &matches[j]) != 0, "Matches must not be repeated");
+        }
+        if (reference == NULL) {
+            reference = matches;
+            continue;
+        }
+        assert(memcmp(reference, matches, sizeof(HashJoinMatch) * matches_amount) == 0, "Every join variant must find the same matches");
+        free(matches);
+    }
+    free(reference);
+    free(build);
+    free(build_arena);
+    free(probe);
+    free(probe_arena);
+}
+
+void hash_join_empty_test(ThreadPool * pool) {
+    printf("*** Running test '%s'\n", __func__);
+    HashJoinKey keys[] = { { "a", 1 } };
+    size_t matches_amount = 42;
+    HashJoinMatch * matches = hash_join(NULL, 0, keys, 1, NULL, pool, &matches_amount);
+    assert(matches != NULL && matches_amount == 0, "Empty build side must have no matches");
+    free(matches);
+    HashJoinOptions options = { false, 0 };
+    matches = hash_join(keys, 1, NULL, 0, &options, pool, &matches_amount);
+    assert(matches != NULL && matches_amount == 0, "Empty probe side must have no matches");
+    free(matches);
+}
+
+void hash_join_invalid_arguments_test(ThreadPool * pool) {
+    printf("*** Running test '%s'\n", __func__);
+    HashJoinKey keys[] = { { "a", 1 } };
+    size_t matches_amount;
+    assert(hash_join(NULL, 1, keys, 1, NULL, pool, &matches_amount) == NULL, "'NULL' build keys must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_NULL_ARGUMENT, "Error must be a 'NULL' argument error");
+    assert(hash_join(keys, 1, keys, 1, NULL, NULL, &matches_amount) == NULL, "'NULL' pool must fail");
+    assert(hash_join(keys, 1, keys, 1, NULL, pool, NULL) == NULL, "'NULL' matches amount must fail");
+    HashJoinOptions options = { true, 21 };
+    assert(hash_join(keys, 1, keys, 1, &options, pool, &matches_amount) == NULL, "Too many radix bits must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "Error must be an invalid argument error");
+}
+
+int main() {
+    fclose(stderr); // Prevent printing "expected" errors
+    ThreadPoolOptions options = { THREADS_AMOUNT, THREAD_POOL_AFFINITY_NONE, NULL, 0 };
+    ThreadPool * pool = thread_pool_create(&options);
+    hash_join_small_test(pool);
+    hash_join_large_test(pool);
+    hash_join_empty_test(pool);
+    hash_join_invalid_arguments_test(pool);
+    thread_pool_destroy(pool);
+}
@@ -0,0 +1,493 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * A Parallel Radix-Partitioned Hash Join Implementation (for string keys).
+ *
+ * ### Explanation ###
+ *
+ * A hash join builds a hash table with the keys of one side (the "build" side) and then looks up every key of the
+ * other side (the "probe" side). When the build side is big, its table doesn't fit in any cache, so every lookup is a
+ * cache miss (and usually a TLB miss as well), which makes the join memory latency bound.
+ *
+ * Instead, both sides are first partitioned by the hash of their keys, so the rows of the partition "p" of one side
+ * can only match the rows of the partition "p" of the other side, and there are enough partitions for every build
+ * partition table to fit in the L2 cache. Partitioning reads and writes everything sequentially (so it is memory
+ * bandwidth bound instead), and then every lookup hits the cache.
+ *
+ * The keys are hashed once (with "fnv1a"), and the partitions only move 16 bytes tuples (the hash and the row index),
+ * where the full hash is compared before the keys, so the key bytes are only read for real matches.
+ *
+ * ### Partitioning ###
+ *
+ * Every pass splits the input in chunks, counts the rows of every partition per chunk, computes where every chunk
+ * writes every partition (the prefix sums), and then every chunk scatters its rows in parallel (without any locks).
+ *
+ * Scattering to many partitions at once writes to as many different pages (a TLB miss per row), so the rows are
+ * first appended to a cache line sized buffer per partition (a software write-combining buffer), and only full cache
+ * lines are copied to the output. A pass writes to at most "2^MAX_PASS_BITS" partitions (whose buffers fit in the
+ * L1/L2 cache), so more partitions are obtained with a second pass, which partitions every first pass partition in
+ * parallel.
+ *
+ * The partitions use the highest bits of the hash, and the tables use the lowest bits, so they are independent.
+ *
+ * ### Build & probe ###
+ *
+ * Every partition builds a bucket-chained table (an array of buckets heads, and the next row of every row), which
+ * supports duplicated build keys, and probes it right away, so the table is still cached. The partitions are
+ * executed as a parallel for, and every worker appends the matches to its own vector (see "thread_pool_worker_index").
+ *
+ * The non-partitioned join (mostly kept as a baseline) builds a single shared table in parallel, where every row is
+ * pushed to the head of its bucket with an atomic exchange, and then probes it in parallel.
+ *
+ * ### References ###
+ *
+ * - https://dl.acm.org/doi/10.1109/ICDE.2013.6544839 (Main-memory hash joins on multi-core CPUs: tuning to the
+ *   underlying hardware, Balkesen et al.)
+ * - https://dl.acm.org/doi/10.1145/1989323.1989328 (Design and evaluation of main memory hash join algorithms for
+ *   multi-core CPUs, Blanas et al.)
+ */
+
+// Imports & Headers
+
+#include <stdlib.h>         // For "malloc", "calloc", "free" (memory management)
+#include <stdint.h>         // For "uint32_t", "uint64_t", "UINT32_MAX" (more integer types)
+#include <string.h>         // For "memcpy", "memcmp" (copying tuples & comparing keys)
+#include <stdatomic.h>      // For "atomic_exchange_explicit" (shared table build)
+#include <unistd.h>         // For "sysconf" (L2 cache size)
+#include "hash-join.h"
+#include "fnv1a.h"          // For "hashes_fnv1a_hash64_bytes_into" (hashing keys)
+#include "vector.h"         // For "vector_push" (per worker matches)
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+
+// Default implementation values
+
+#define CACHE_LINE_SIZE 64
+#define TUPLES_PER_LINE (CACHE_LINE_SIZE / sizeof(JoinTuple))
+#define MAX_PASS_BITS 10
+#define MAX_RADIX_BITS 20
+#define CHUNKS_PER_THREAD 4
+#define DEFAULT_L2_CACHE_SIZE (256 * 1024)
+#define RANGE_GRAIN_SIZE 16384
+#define EMPTY_BUCKET UINT32_MAX
+
+// Structures
+
+typedef struct join_tuple {
+    uint64_t hash;                  // The hash of the key of the row
+    size_t index;                   // The index of the row in its side
+} JoinTuple;
+
+typedef struct join_side {
+    const HashJoinKey * keys;       // The keys of the side
+    size_t amount;                  // The amount of rows of the side
+    JoinTuple * tuples;             // The (partitioned, after partitioning) tuples of the side
+    JoinTuple * scratch;            // The output of the next partitioning pass
+    size_t * histograms;            // The first pass row counts (and then write offsets) of every chunk and partition
+    size_t * first_pass_starts;     // Where every first pass partition starts (plus the amount of rows at the end)
+    size_t * partition_starts;      // Where every partition starts (plus the amount of rows at the end)
+} JoinSide;
+
+typedef struct join {
+    JoinSide build;                 // The build side
+    JoinSide probe;                 // The probe side
+    size_t first_pass_bits;         // The amount of partitioning bits of the first pass
+    size_t second_pass_bits;        // The amount of partitioning bits of the second pass (or '0')
+    size_t chunks_amount;           // The amount of chunks of the first pass
+    ThreadPool * pool;              // The pool executing the parallel steps
+    Vector ** matches;              // The matches of every worker (plus one for a non-worker thread)
+    size_t matches_vectors_amount;  // The amount of matches vectors
+    _Atomic uint32_t * buckets;     // The heads of the buckets of the shared table (non-partitioned join)
+    uint32_t * next_rows;           // The next row of every build row of the shared table (non-partitioned join)
+    size_t bucket_mask;             // The amount of buckets of the shared table minus one
+    atomic_bool has_failed;         // Whether any allocation of the parallel steps failed
+} Join;
+
+typedef struct join_step {
+    Join * join;                    // The join being executed
+    JoinSide * side;                // The side processed by the step
+} JoinStep;
+
+// Definition (to be able to use methods before declaring them, to follow up the top-bottom code style)
+
+bool hash_join_partition_side(Join * join, JoinSide * side);
+bool hash_join_shared_table(Join * join);
+void hash_join_hash_range(size_t start, size_t stop, void * context);
+void hash_join_count_chunks(size_t start, size_t stop, void * context);
+void hash_join_scatter_chunks(size_t start, size_t stop, void * context);
+void hash_join_second_pass(size_t start, size_t stop, void * context);
+bool hash_join_scatter(const JoinTuple * input, size_t amount, JoinTuple * output, size_t * offsets, size_t shift, size_t fanout);
+size_t hash_join_partition_of(uint64_t hash, size_t shift, size_t fanout);
+void hash_join_partitions(size_t start, size_t stop, void * context);
+bool hash_join_partition(Join * join, size_t partition, Vector * matches);
+void hash_join_build_shared_range(size_t start, size_t stop, void * context);
+void hash_join_probe_shared_range(size_t start, size_t stop, void * context);
+Vector * hash_join_worker_matches(Join * join);
+bool hash_join_keys_equal(const HashJoinKey * first, const HashJoinKey * second);
+size_t hash_join_default_radix_bits(size_t build_amount);
+void hash_join_free_side(JoinSide * side);
+
+// Implementation
+
+HashJoinMatch * hash_join(const HashJoinKey * build_keys, size_t build_amount, const HashJoinKey * probe_keys, size_t probe_amount,
+                          const HashJoinOptions * options, ThreadPool * pool, size_t * matches_amount) {
+    if ((build_keys == NULL && build_amount > 0) || (probe_keys == NULL && probe_amount > 0) || pool == NULL || matches_amount == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to join using 'NULL' arguments");
+        return NULL;
+    }
+    if (build_amount >= EMPTY_BUCKET) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The build side must have less than 2^32 - 1 rows");
+        return NULL;
+    }
+    HashJoinOptions default_options = { true, 0 };
+    if (options == NULL) options = &default_options;
+    if (options->radix_bits > MAX_RADIX_BITS) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'radix_bits' must be at most 20");
+        return NULL;
+    }
+    Join join = { 0 };
+    join.build.keys = build_keys;
+    join.build.amount = build_amount;
+    join.probe.keys = probe_keys;
+    join.probe.amount = probe_amount;
+    join.pool = pool;
+    atomic_init(&join.has_failed, false);
+    size_t radix_bits = (options->radix_bits == 0) ? hash_join_default_radix_bits(build_amount) : options->radix_bits;
+    join.first_pass_bits = (radix_bits <= MAX_PASS_BITS) ? radix_bits : (radix_bits + 1) / 2;
+    join.second_pass_bits = radix_bits - join.first_pass_bits;
+    join.chunks_amount = thread_pool_threads_amount(pool) * CHUNKS_PER_THREAD;
+    join.matches_vectors_amount = thread_pool_threads_amount(pool) + 1;
+    join.matches = calloc(join.matches_vectors_amount, sizeof(Vector *));
+    bool is_done = join.matches != NULL;
+    for (size_t i = 0; i < join.matches_vectors_amount && is_done; i++) {
+        join.matches[i] = vector_create_default(sizeof(HashJoinMatch));
+        is_done = join.matches[i] != NULL;
+    }
+    // Step 1: hash the keys of both sides, and partition them (or build the shared table)
+    JoinSide * sides[2] = { &join.build, &join.probe };
+    for (size_t i = 0; i < 2 && is_done; i++) {
+        sides[i]->tuples = malloc(sizeof(JoinTuple) * (sides[i]->amount + 1));
+        is_done = sides[i]->tuples != NULL;
+        JoinStep step = { &join, sides[i] };
+        is_done = is_done && thread_pool_parallel_for(pool, 0, sides[i]->amount, RANGE_GRAIN_SIZE, hash_join_hash_range, &step);
+        if (options->is_partitioned) is_done = is_done && hash_join_partition_side(&join, sides[i]);
+    }
+    // Step 2: build and probe every partition (or probe the shared table)
+    if (options->is_partitioned) {
+        size_t partitions_amount = (size_t) 1 << radix_bits;
+        is_done = is_done && thread_pool_parallel_for(pool, 0, partitions_amount, 1, hash_join_partitions, &join);
+    } else {
+        is_done = is_done && hash_join_shared_table(&join);
+    }
+    is_done = is_done && !atomic_load(&join.has_failed);
+    // Step 3: gather the matches of every worker
+    HashJoinMatch * matches = NULL;
+    if (is_done) {
+        size_t total_amount = 0;
+        for (size_t i = 0; i < join.matches_vectors_amount; i++) total_amount += vector_size(join.matches[i]);
+        matches = malloc(sizeof(HashJoinMatch) * (total_amount + 1));
+        if (matches != NULL) {
+            * matches_amount = 0;
+            for (size_t i = 0; i < join.matches_vectors_amount; i++) {
+                memcpy(matches + * matches_amount, vector_data(join.matches[i]), sizeof(HashJoinMatch) * vector_size(join.matches[i]));
+                * matches_amount += vector_size(join.matches[i]);
+            }
+        }
+    }
+    if (matches == NULL) error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for the join");
+    for (size_t i = 0; join.matches != NULL && i < join.matches_vectors_amount; i++) vector_destroy(join.matches[i]);
+    free(join.matches);
+    free(join.buckets);
+    free(join.next_rows);
+    hash_join_free_side(&join.build);
+    hash_join_free_side(&join.probe);
+    return matches;
+}
+
+// Utilities
+
+/**
+ * Partitions the (hashed) tuples of the given side, in one or two passes.
+ */
+bool hash_join_partition_side(Join * join, JoinSide * side) {
+    size_t first_fanout = (size_t) 1 << join->first_pass_bits;
+    size_t partitions_amount = first_fanout << join->second_pass_bits;
+    side->scratch = malloc(sizeof(JoinTuple) * (side->amount + 1));
+    side->histograms = calloc(join->chunks_amount * first_fanout, sizeof(size_t));
+    side->first_pass_starts = malloc(sizeof(size_t) * (first_fanout + 1));
+    side->partition_starts = malloc(sizeof(size_t) * (partitions_amount + 1));
+    if (side->scratch == NULL || side->histograms == NULL || side->first_pass_starts == NULL || side->partition_starts == NULL) return false;
+    JoinStep step = { join, side };
+    // Step 1: count the rows of every chunk and partition
+    if (!thread_pool_parallel_for(join->pool, 0, join->chunks_amount, 1, hash_join_count_chunks, &step)) return false;
+    // Step 2: compute where every chunk writes every partition
+    size_t offset = 0;
+    for (size_t partition = 0; partition < first_fanout; partition++) {
+        side->first_pass_starts[partition] = offset;
+        for (size_t chunk = 0; chunk < join->chunks_amount; chunk++) {
+            size_t count = side->histograms[chunk * first_fanout + partition];
+            side->histograms[chunk * first_fanout + partition] = offset;
+            offset += count;
+        }
+    }
+    side->first_pass_starts[first_fanout] = side->amount;
+    side->partition_starts[partitions_amount] = side->amount;
+    // Step 3: scatter every chunk
+    if (!thread_pool_parallel_for(join->pool, 0, join->chunks_amount, 1, hash_join_scatter_chunks, &step)) return false;
+    JoinTuple * swapped = side->tuples;
+    side->tuples = side->scratch;
+    side->scratch = swapped;
+    // Step 4: partition every first pass partition again (in parallel)
+    if (join->second_pass_bits == 0) {
+        memcpy(side->partition_starts, side->first_pass_starts, sizeof(size_t) * first_fanout);
+    } else {
+        if (!thread_pool_parallel_for(join->pool, 0, first_fanout, 1, hash_join_second_pass, &step)) return false;
+        swapped = side->tuples;
+        side->tuples = side->scratch;
+        side->scratch = swapped;
+    }
+    return !atomic_load(&join->has_failed);
+}
+
+/**
+ * Builds the shared table with all the build rows in parallel, and probes it with all the probe rows in parallel.
+ */
+bool hash_join_shared_table(Join * join) {
+    size_t buckets_amount = 1;
+    while (buckets_amount < join->build.amount) buckets_amount *= 2;
+    join->bucket_mask = buckets_amount - 1;
+    join->buckets = malloc(sizeof(_Atomic uint32_t) * buckets_amount);
+    join->next_rows = malloc(sizeof(uint32_t) * (join->build.amount + 1));
+    if (join->buckets == NULL || join->next_rows == NULL) return false;
+    for (size_t i = 0; i < buckets_amount; i++) atomic_init(&join->buckets[i], EMPTY_BUCKET);
+    return thread_pool_parallel_for(join->pool, 0, join->build.amount, RANGE_GRAIN_SIZE, hash_join_build_shared_range, join)
+           && thread_pool_parallel_for(join->pool, 0, join->probe.amount, RANGE_GRAIN_SIZE, hash_join_probe_shared_range, join);
+}
+
+void hash_join_hash_range(size_t start, size_t stop, void * context) {
+    JoinSide * side = ((JoinStep *) context)->side;
+    for (size_t i = start; i < stop; i++) {
+        hashes_fnv1a_hash64_bytes_into(side->keys[i].bytes, side->keys[i].length, &side->tuples[i].hash);
+        side->tuples[i].index = i;
+    }
+}
+
+void hash_join_count_chunks(size_t start, size_t stop, void * context) {
+    Join * join = ((JoinStep *) context)->join;
+    JoinSide * side = ((JoinStep *) context)->side;
+    size_t first_fanout = (size_t) 1 << join->first_pass_bits;
+    for (size_t chunk = start; chunk < stop; chunk++) {
+        size_t * histogram = side->histograms + chunk * first_fanout;
+        size_t chunk_start = side->amount * chunk / join->chunks_amount;
+        size_t chunk_stop = side->amount * (chunk + 1) / join->chunks_amount;
+        for (size_t i = chunk_start; i < chunk_stop; i++) histogram[hash_join_partition_of(side->tuples[i].hash, 64 - join->first_pass_bits, first_fanout)]++;
+    }
+}
+
+void hash_join_scatter_chunks(size_t start, size_t stop, void * context) {
+    Join * join = ((JoinStep *) context)->join;
+    JoinSide * side = ((JoinStep *) context)->side;
+    size_t first_fanout = (size_t) 1 << join->first_pass_bits;
+    for (size_t chunk = start; chunk < stop; chunk++) {
+        size_t chunk_start = side->amount * chunk / join->chunks_amount;
+        size_t chunk_stop = side->amount * (chunk + 1) / join->chunks_amount;
+        if (!hash_join_scatter(side->tuples + chunk_start, chunk_stop - chunk_start, side->scratch,
+                               side->histograms + chunk * first_fanout, 64 - join->first_pass_bits, first_fanout)) {
+            atomic_store(&join->has_failed, true);
+        }
+    }
+}
+
+void hash_join_second_pass(size_t start, size_t stop, void * context) {
+    Join * join = ((JoinStep *) context)->join;
+    JoinSide * side = ((JoinStep *) context)->side;
+    size_t second_fanout = (size_t) 1 << join->second_pass_bits;
+    size_t shift = 64 - join->first_pass_bits - join->second_pass_bits;
+    for (size_t first_partition = start; first_partition < stop; first_partition++) {
+        size_t partition_start = side->first_pass_starts[first_partition];
+        size_t partition_stop = side->first_pass_starts[first_partition + 1];
+        size_t * offsets = calloc(second_fanout, sizeof(size_t));
+        if (offsets == NULL) {
+            atomic_store(&join->has_failed, true);
+            return;
+        }
+        for (size_t i = partition_start; i < partition_stop; i++) offsets[hash_join_partition_of(side->tuples[i].hash, shift, second_fanout)]++;
+        size_t offset = partition_start;
+        for (size_t partition = 0; partition < second_fanout; partition++) {
+            size_t count = offsets[partition];
+            offsets[partition] = offset;
+            offset += count;
+        }
+        memcpy(side->partition_starts + first_partition * second_fanout, offsets, sizeof(size_t) * second_fanout);
+        if (!hash_join_scatter(side->tuples + partition_start, partition_stop - partition_start, side->scratch, offsets, shift, second_fanout)) {
+            atomic_store(&join->has_failed, true);
+        }
+        free(offsets);
+    }
+}
+
+/**
+ * Scatters the given tuples to their partitions, where every partition is written through a cache line sized buffer.
+ *
+ * @param offsets where the next tuple of every partition is written in the output (they are advanced)
+ * @param shift the amount of bits shifted from the hash before masking the partition
+ */
+bool hash_join_scatter(const JoinTuple * input, size_t amount, JoinTuple * output, size_t * offsets, size_t shift, size_t fanout) {
+    JoinTuple * buffers = aligned_alloc(CACHE_LINE_SIZE, fanout * CACHE_LINE_SIZE);
+    unsigned char * fills = calloc(fanout, sizeof(unsigned char));
+    if (buffers == NULL || fills == NULL) {
+        free(buffers);
+        free(fills);
+        return false;
+    }
+    for (size_t i = 0; i < amount; i++) {
+        size_t partition = hash_join_partition_of(input[i].hash, shift, fanout);
+        JoinTuple * buffer = buffers + partition * TUPLES_PER_LINE;
+        buffer[fills[partition]++] = input[i];
+        // A full buffer is written as a whole cache line
+        if (fills[partition] == TUPLES_PER_LINE) {
+            memcpy(output + offsets[partition], buffer, CACHE_LINE_SIZE);
+            offsets[partition] += TUPLES_PER_LINE;
+            fills[partition] = 0;
+        }
+    }
+    for (size_t partition = 0; partition < fanout; partition++) {
+        memcpy(output + offsets[partition], buffers + partition * TUPLES_PER_LINE, sizeof(JoinTuple) * fills[partition]);
+        offsets[partition] += fills[partition];
+    }
+    free(buffers);
+    free(fills);
+    return true;
+}
+
+/**
+ * Returns the partition of the given hash (a shift of 64 bits, meaning no partitioning bits, is undefined in C).
+ */
+size_t hash_join_partition_of(uint64_t hash, size_t shift, size_t fanout) {
+    return (shift >= 64) ? 0 : (size_t) (hash >> shift) & (fanout - 1);
+}
+
+void hash_join_partitions(size_t start, size_t stop, void * context) {
+    Join * join = context;
+    Vector * matches = hash_join_worker_matches(join);
+    for (size_t partition = start; partition < stop; partition++) {
+        if (!hash_join_partition(join, partition, matches)) {
+            atomic_store(&join->has_failed, true);
+            return;
+        }
+    }
+}
+
+/**
+ * Builds the table of the given build partition (which fits in the L2 cache), and probes it with the probe partition.
+ */
+bool hash_join_partition(Join * join, size_t partition, Vector * matches) {
+    const JoinTuple * build_tuples = join->build.tuples + join->build.partition_starts[partition];
+    size_t build_amount = join->build.partition_starts[partition + 1] - join->build.partition_starts[partition];
+    const JoinTuple * probe_tuples = join->probe.tuples + join->probe.partition_starts[partition];
+    size_t probe_amount = join->probe.partition_starts[partition + 1] - join->probe.partition_starts[partition];
+    if (build_amount == 0 || probe_amount == 0) return true;
+    size_t buckets_amount = 1;
+    while (buckets_amount < build_amount) buckets_amount *= 2;
+    size_t mask = buckets_amount - 1;
+    uint32_t * buckets = malloc(sizeof(uint32_t) * buckets_amount);
+    uint32_t * next_rows = malloc(sizeof(uint32_t) * build_amount);
+    if (buckets == NULL || next_rows == NULL) {
+        free(buckets);
+        free(next_rows);
+        return false;
+    }
+    // Step 1: build (every row is pushed to the head of its bucket chain)
+    memset(buckets, 0xff, sizeof(uint32_t) * buckets_amount);
+    for (size_t i = 0; i < build_amount; i++) {
+        size_t bucket = (size_t) build_tuples[i].hash & mask;
+        next_rows[i] = buckets[bucket];
+        buckets[bucket] = (uint32_t) i;
+    }
+    // Step 2: probe (the keys are only compared when the hashes are equal)
+    bool is_done = true;
+    for (size_t i = 0; i < probe_amount && is_done; i++) {
+        uint64_t hash = probe_tuples[i].hash;
+        const HashJoinKey * probe_key = &join->probe.keys[probe_tuples[i].index];
+        for (uint32_t row = buckets[hash & mask]; row != EMPTY_BUCKET && is_done; row = next_rows[row]) {
+            if (build_tuples[row].hash != hash || !hash_join_keys_equal(&join->build.keys[build_tuples[row].index], probe_key)) continue;
+            HashJoinMatch match = { build_tuples[row].index, probe_tuples[i].index };
+            is_done = vector_push(matches, &match);
+        }
+    }
+    free(buckets);
+    free(next_rows);
+    return is_done;
+}
+
+void hash_join_build_shared_range(size_t start, size_t stop, void * context) {
+    Join * join = context;
+    for (size_t i = start; i < stop; i++) {
+        size_t bucket = (size_t) join->build.tuples[i].hash & join->bucket_mask;
+        join->next_rows[i] = atomic_exchange_explicit(&join->buckets[bucket], (uint32_t) i, memory_order_relaxed);
+    }
+}
+
+void hash_join_probe_shared_range(size_t start, size_t stop, void * context) {
+    Join * join = context;
+    Vector * matches = hash_join_worker_matches(join);
+    for (size_t i = start; i < stop; i++) {
+        uint64_t hash = join->probe.tuples[i].hash;
+        uint32_t row = atomic_load_explicit(&join->buckets[hash & join->bucket_mask], memory_order_relaxed);
+        for (; row != EMPTY_BUCKET; row = join->next_rows[row]) {
+            if (join->build.tuples[row].hash != hash || !hash_join_keys_equal(&join->build.keys[row], &join->probe.keys[i])) continue;
+            HashJoinMatch match = { row, i };
+            if (!vector_push(matches, &match)) {
+                atomic_store(&join->has_failed, true);
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * Returns the matches vector of the calling worker (the last one belongs to a non-worker thread).
+ */
+Vector * hash_join_worker_matches(Join * join) {
+    size_t worker_index;
+    if (!thread_pool_worker_index(join->pool, &worker_index)) worker_index = join->matches_vectors_amount - 1;
+    return join->matches[worker_index];
+}
+
+bool hash_join_keys_equal(const HashJoinKey * first, const HashJoinKey * second) {
+    return first->length == second->length && memcmp(first->bytes, second->bytes, first->length) == 0;
+}
+
+/**
+ * Returns the amount of partitioning bits which makes every build partition table fit in half of the L2 cache.
+ */
+size_t hash_join_default_radix_bits(size_t build_amount) {
+    long cache_size = -1;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    cache_size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+    size_t l2_cache_size = (cache_size > 0) ? (size_t) cache_size : DEFAULT_L2_CACHE_SIZE;
+    // Every build row costs its tuple, its bucket and its next row
+    size_t rows_per_partition = l2_cache_size / 2 / (sizeof(JoinTuple) + 2 * sizeof(uint32_t));
+    size_t radix_bits = 0;
+    while ((build_amount >> radix_bits) > rows_per_partition && radix_bits < MAX_RADIX_BITS) radix_bits++;
+    return radix_bits;
+}
+
+void hash_join_free_side(JoinSide * side) {
+    free(side->tuples);
+    free(side->scratch);
+    free(side->histograms);
+    free(side->first_pass_starts);
+    free(side->partition_starts);
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdbool.h>        // For "true", "false" (boolean constants)
+#include <stddef.h>         // For "size_t" (size type)
+#include "thread-pool.h"
+
+/* hash-join.h */
+#ifndef JOINS_HASH_JOIN_H
+#define JOINS_HASH_JOIN_H
+
+/**
+ * A join key (its bytes are never copied, so they must outlive the join).
+ */
+typedef struct hash_join_key {
+    const char * bytes;             // The bytes of the key
+    size_t length;                  // The amount of bytes of the key
+} HashJoinKey;
+
+/**
+ * A pair of rows whose keys are equal.
+ */
+typedef struct hash_join_match {
+    size_t build_index;             // The index of the row in the build side
+    size_t probe_index;             // The index of the row in the probe side
+} HashJoinMatch;
+
+/**
+ * The join options.
+ */
+typedef struct hash_join_options {
+    bool is_partitioned;            // Whether both sides are radix partitioned (otherwise a single table is shared)
+    size_t radix_bits;              // The amount of partitioning bits, or '0' to fit every partition table in the L2
+} HashJoinOptions;
+
+/**
+ * Joins (an inner equi-join) the given sides, obtaining every pair of rows whose keys are equal.
+ *
+ * By default, both sides are radix partitioned by their hash (in one or two passes, so every pass writes to few enough
+ * partitions to not thrash the TLB), until every build partition table fits in the L2 cache, and then the partitions
+ * are built and probed in parallel (see "hash-join.c").
+ *
+ * The returned matches (in no particular order) must be freed by the client after its usage.
+ *
+ * @param build_keys the keys of the build side (usually the smaller one)
+ * @param build_amount the amount of rows of the build side
+ * @param probe_keys the keys of the probe side
+ * @param probe_amount the amount of rows of the probe side
+ * @param options the join options, or {@code NULL} to use the defaults (partitioned, fitting the L2)
+ * @param pool the thread pool where the join is executed
+ * @param matches_amount where the amount of matches is to be stored
+ *
+ * @return the array of matches (never {@code NULL} on success, even if empty), or {@code NULL} if an error occurred
+ */
+HashJoinMatch * hash_join(const HashJoinKey * build_keys, size_t build_amount, const HashJoinKey * probe_keys, size_t probe_amount,
+                          const HashJoinOptions * options, ThreadPool * pool, size_t * matches_amount);
+
+#endif /* JOINS_HASH_JOIN_H */
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L // For "clock_gettime", "nanosleep", "CLOCK_MONOTONIC" (monotonic clock)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <pthread.h>
+#include "lock-free-hash-map.h"
+#include "sharded-hash-map.h"
+
+// Benchmarking snippet (not abstracted away for piece of code portability)
+double elapsed_seconds(struct timespec start, struct timespec stop) {
+    return (double) (stop.tv_sec - start.tv_sec) + (double) (stop.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Readers look routes up as fast as they can, while a single writer updates a route every few microseconds
+
+#define ROUTES_AMOUNT 4096
+#define ROUTE_LENGTH 24
+
+typedef struct workload {
+    LockFreeHashMap * lock_free_map;
+    ShardedHashMap * sharded_map;
+    char * routes;
+    size_t lookups_per_reader;
+    atomic_bool is_reading;
+} Workload;
+
+void * lock_free_reader(void * argument) {
+    Workload * workload = argument;
+    LockFreeHashMapReader * reader = lock_free_hash_map_reader_register(workload->lock_free_map);
+    size_t route_index = 0;
+    void * value;
+    for (size_t i = 0; i < workload->lookups_per_reader; i++) {
+        route_index = (route_index + 97) % ROUTES_AMOUNT;
+        lock_free_hash_map_get(reader, workload->routes + route_index * ROUTE_LENGTH, ROUTE_LENGTH, &value);
+    }
+    lock_free_hash_map_reader_unregister(reader);
+    return NULL;
+}
+
+void * sharded_reader(void * argument) {
+    Workload * workload = argument;
+    size_t route_index = 0;
+    void * value;
+    for (size_t i = 0; i < workload->lookups_per_reader; i++) {
+        route_index = (route_index + 97) % ROUTES_AMOUNT;
+        sharded_hash_map_get(workload->sharded_map, workload->routes + route_index * ROUTE_LENGTH, ROUTE_LENGTH, &value);
+    }
+    return NULL;
+}
+
+void * writer(void * argument) {
+    Workload * workload = argument;
+    struct timespec pause = { 0, 10000 };
+    size_t route_index = 0;
+    while (atomic_load(&workload->is_reading)) {
+        route_index = (route_index + 1) % ROUTES_AMOUNT;
+        char * route = workload->routes + route_index * ROUTE_LENGTH;
+        if (workload->lock_free_map != NULL) lock_free_hash_map_put(workload->lock_free_map, route, ROUTE_LENGTH, route, NULL);
+        if (workload->sharded_map != NULL) sharded_hash_map_put(workload->sharded_map, route, ROUTE_LENGTH, route, NULL);
+        nanosleep(&pause, NULL);
+    }
+    return NULL;
+}
+
+double run_readers(Workload * workload, void * (* reader)(void *), size_t readers_amount) {
+    struct timespec start, stop;
+    pthread_t * threads = malloc(sizeof(pthread_t) * readers_amount);
+    pthread_t writer_thread;
+    atomic_store(&workload->is_reading, true);
+    pthread_create(&writer_thread, NULL, writer, workload);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < readers_amount; i++) pthread_create(&threads[i], NULL, reader, workload);
+    for (size_t i = 0; i < readers_amount; i++) pthread_join(threads[i], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    atomic_store(&workload->is_reading, false);
+    pthread_join(writer_thread, NULL);
+    free(threads);
+    return elapsed_seconds(start, stop);
+}
+
+// Benchmarks
+
+void lock_free_hash_map_read_mostly_benchmark(size_t lookups, size_t max_readers_amount) {
+    char * routes = malloc(ROUTES_AMOUNT * ROUTE_LENGTH);
+    for (size_t i = 0; i < ROUTES_AMOUNT; i++) snprintf(routes + i * ROUTE_LENGTH, ROUTE_LENGTH, "/api/v1/route/%09zu", i);
+    printf("%8s %18s %18s %10s\n", "readers", "lock-free Ml/s", "sharded Ml/s", "speedup");
+    for (size_t readers_amount = 1; readers_amount <= max_readers_amount; readers_amount *= 2) {
+        Workload workload = { .routes = routes, .lookups_per_reader = lookups / readers_amount };
+        // The lock-free map alone (with its own writer)
+        workload.lock_free_map = lock_free_hash_map_create();
+        workload.sharded_map = NULL;
+        for (size_t i = 0; i < ROUTES_AMOUNT; i++) lock_free_hash_map_put(workload.lock_free_map, routes + i * ROUTE_LENGTH, ROUTE_LENGTH, NULL, NULL);
+        double lock_free_seconds = run_readers(&workload, lock_free_reader, readers_amount);
+        lock_free_hash_map_destroy(workload.lock_free_map);
+        // The sharded map alone (with its own writer)
+        workload.lock_free_map = NULL;
+        workload.sharded_map = sharded_hash_map_create_default();
+        for (size_t i = 0; i < ROUTES_AMOUNT; i++) sharded_hash_map_put(workload.sharded_map, routes + i * ROUTE_LENGTH, ROUTE_LENGTH, NULL, NULL);
+        double sharded_seconds = run_readers(&workload, sharded_reader, readers_amount);
+        sharded_hash_map_destroy(workload.sharded_map);
+        double total_lookups = (double) (workload.lookups_per_reader * readers_amount);
+        printf("%8zu %18.2f %18.2f %9.2fx\n", readers_amount, total_lookups / lock_free_seconds / 1e6,
+               total_lookups / sharded_seconds / 1e6, sharded_seconds / lock_free_seconds);
+    }
+    free(routes);
+}
+
+// Benchmarks runner (the arguments optionally override the amount of lookups and the maximum amount of readers)
+
+int main(int argc, char * argv[]) {
+    size_t lookups = (argc > 1) ? strtoull(argv[1], NULL, 10) : 8000000;
+    size_t max_readers_amount = (argc > 2) ? strtoull(argv[2], NULL, 10) : 32;
+    lock_free_hash_map_read_mostly_benchmark(lookups, max_readers_amount);
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "lock-free-hash-map.h"
+#include "error-reporter.h"
+
+// Assertion snippet (not abstracted away for piece of code portability)
+void assert(int condition, char message[]) {
+    if (condition != 1) {
+        printf("%s\n", message);
+        exit(1);
+    }
+}
+
+// Unit testing
+
+void lock_free_hash_map_put_get_remove_test() {
+    printf("*** Running test '%s'\n", __func__);
+    LockFreeHashMap * map = lock_free_hash_map_create();
+    assert(map != NULL, "The 'map' must not be null");
+    LockFreeHashMapReader * reader = lock_free_hash_map_reader_register(map);
+    assert(reader != NULL, "The 'reader' must not be null");
+    void * value = NULL;
+    assert(!lock_free_hash_map_get(reader, "route", 5, &value), "A missing key must not be found");
+    assert(lock_free_hash_map_put(map, "route", 5, (void *) 1, &value), "The key must be stored");
+    assert(value == NULL, "A new key must have no previous value");
+    assert(lock_free_hash_map_put(map, "", 0, (void *) 2, NULL), "An empty key must be stored");
+    assert(lock_free_hash_map_put(map, "route", 5, (void *) 3, &value), "The value must be replaced");
+    assert((uintptr_t) value == 1, "The previous value must be returned");
+    assert(lock_free_hash_map_size(map) == 2, "The size must match the amount of keys");
+    assert(lock_free_hash_map_get(reader, "route", 5, &value) && (uintptr_t) value == 3, "The new value must be found");
+    assert(lock_free_hash_map_get(reader, "", 0, &value) && (uintptr_t) value == 2, "The empty key must be found");
+    assert(!lock_free_hash_map_get(reader, "router", 6, &value), "A longer key must not match");
+    assert(lock_free_hash_map_remove(map, "route", 5, &value) && (uintptr_t) value == 3, "The key must be removed");
+    assert(!lock_free_hash_map_remove(map, "route", 5, NULL), "A removed key must not be removed again");
+    assert(!lock_free_hash_map_get(reader, "route", 5, &value), "A removed key must not be found");
+    assert(lock_free_hash_map_size(map) == 1, "The size must be decreased by the removal");
+    lock_free_hash_map_reader_unregister(reader);
+    lock_free_hash_map_destroy(map);
+}
+
+void lock_free_hash_map_growth_test() {
+    printf("*** Running test '%s'\n", __func__);
+    LockFreeHashMap * map = lock_free_hash_map_create();
+    LockFreeHashMapReader * reader = lock_free_hash_map_reader_register(map);
+    char key[32];
+    // Insert and remove many keys (so the table is replaced many times, and the retired memory is freed meanwhile)
+    for (uintptr_t i = 0; i < 20000; i++) {
+        int length = sprintf(key, "key-%lu", (unsigned long) i);
+        assert(lock_free_hash_map_put(map, key, (size_t) length, (void *) (i + 1), NULL), "The key must be stored");
+        if (i % 3 == 0) assert(lock_free_hash_map_remove(map, key, (size_t) length, NULL), "The key must be removed");
+    }
+    assert(lock_free_hash_map_size(map) == 20000 - 6667, "The size must match the amount of kept keys");
+    for (uintptr_t i = 0; i < 20000; i++) {
+        int length = sprintf(key, "key-%lu", (unsigned long) i);
+        void * value = NULL;
+        bool is_found = lock_free_hash_map_get(reader, key, (size_t) length, &value);
+        assert(is_found == (i % 3 != 0), "Only the kept keys must be found");
+        assert(!is_found || (uintptr_t) value == i + 1, "The kept keys must keep their values");
+    }
+    // The reader handle is left registered (the map frees it)
+    lock_free_hash_map_destroy(map);
+}
+
+void lock_free_hash_map_invalid_arguments_test() {
+    printf("*** Running test '%s'\n", __func__);
+    void * value;
+    assert(lock_free_hash_map_reader_register(NULL) == NULL, "A 'NULL' map must be rejected");
+    assert(error_reporter_last_code() == ERROR_CODE_NULL_ARGUMENT, "The error must be a null argument");
+    assert(!lock_free_hash_map_get(NULL, "a", 1, &value), "A 'NULL' reader must be rejected");
+    LockFreeHashMap * map = lock_free_hash_map_create();
+    assert(!lock_free_hash_map_put(map, NULL, 1, NULL, NULL), "A 'NULL' key must be rejected");
+    assert(!lock_free_hash_map_remove(NULL, "a", 1, NULL), "A 'NULL' map must be rejected");
+    assert(lock_free_hash_map_size(NULL) == 0, "A 'NULL' map must have no keys");
+    lock_free_hash_map_destroy(map);
+    lock_free_hash_map_destroy(NULL);
+    lock_free_hash_map_reader_unregister(NULL);
+}
+
+// Readers look keys up while a writer keeps replacing, removing and inserting them again (so slots are reused and
+// tables are replaced), where every found value must be the one of its key (the value encodes the key index)
+#define READERS_AMOUNT 6
+#define KEYS_AMOUNT 256
+#define WRITES_AMOUNT 60000
+
+typedef struct reader_state {
+    LockFreeHashMap * map;
+    atomic_bool * is_writing;
+    size_t found_amount;
+    bool is_consistent;
+} ReaderState;
+
+void * lock_free_hash_map_reader(void * argument) {
+    ReaderState * state = argument;
+    LockFreeHashMapReader * reader = lock_free_hash_map_reader_register(state->map);
+    char key[32];
+    uintptr_t key_index = 0;
+    while (atomic_load(state->is_writing)) {
+        key_index = (key_index + 7) % KEYS_AMOUNT;
+        int length = sprintf(key, "k-%lu", (unsigned long) key_index);
+        void * value;
+        if (lock_free_hash_map_get(reader, key, (size_t) length, &value)) {
+            if ((uintptr_t) value >> 16 != key_index) state->is_consistent = false;
+            state->found_amount++;
+        }
+    }
+    lock_free_hash_map_reader_unregister(reader);
+    return NULL;
+}
+
+void lock_free_hash_map_threads_test() {
+    printf("*** Running test '%s'\n", __func__);
+    LockFreeHashMap * map = lock_free_hash_map_create();
+    atomic_bool is_writing;
+    atomic_init(&is_writing, true);
+    pthread_t threads[READERS_AMOUNT];
+    ReaderState states[READERS_AMOUNT];
+    for (size_t i = 0; i < READERS_AMOUNT; i++) {
+        states[i].map = map;
+        states[i].is_writing = &is_writing;
+        states[i].found_amount = 0;
+        states[i].is_consistent = true;
+        pthread_create(&threads[i], NULL, lock_free_hash_map_reader, &states[i]);
+    }
+    char key[32];
+    uint64_t random_state = 88172645463325252ULL;
+    for (uintptr_t i = 0; i < WRITES_AMOUNT; i++) {
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 7;
+        random_state ^= random_state << 17;
+        uintptr_t key_index = random_state % KEYS_AMOUNT;
+        int length = sprintf(key, "k-%lu", (unsigned long) key_index);
+        if (random_state % 3 == 0) {
+            lock_free_hash_map_remove(map, key, (size_t) length, NULL);
+        } else {
+            lock_free_hash_map_put(map, key, (size_t) length, (void *) ((key_index << 16) | (i & 0xFFFF)), NULL);
+        }
+    }
+    atomic_store(&is_writing, false);
+    for (size_t i = 0; i < READERS_AMOUNT; i++) {
+        pthread_join(threads[i], NULL);
+        assert(states[i].is_consistent, "Every found value must belong to its key");
+    }
+    lock_free_hash_map_destroy(map);
+}
+
+// Tests runner
+
+int main() {
+    fclose(stderr);
+    lock_free_hash_map_put_get_remove_test();
+    lock_free_hash_map_growth_test();
+    lock_free_hash_map_invalid_arguments_test();
+    lock_free_hash_map_threads_test();
+}
@@ -0,0 +1,409 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * A Lock-Free Read-Mostly Hash Map Implementation (open addressing, with epoch-based memory reclamation).
+ *
+ * ### Explanation ###
+ *
+ * Configuration and routing tables are read millions of times per second and updated rarely, so even a lock per
+ * shard (or a seqlock, whose readers retry while a writer runs) costs more than the lookups themselves. This map is
+ * built the read-copy-update (RCU) way: the readers never lock, never retry and never write any shared memory, and
+ * all the cost is moved to the (serialized) writers.
+ *
+ * The table uses open addressing with linear probing (as the sharded map), where every field of an entry is atomic,
+ * and a writer only makes changes that a reader can observe in any order without harm:
+ *
+ * - An insertion writes the hash and the value of a free slot, and then publishes the key (with a release store).
+ * - A replacement stores the new value (the key stays the same).
+ * - A removal replaces the key with a tombstone (so the probe sequences of other keys are not broken).
+ * - A growth builds a whole new table, and then publishes it (the readers of the old table keep reading it).
+ *
+ * A reader re-reads the key of the entry after reading its value, so a slot that was reused meanwhile (removed and
+ * inserted again for another key) is never reported with the value of another key.
+ *
+ * ### Epoch-Based Reclamation ###
+ *
+ * A removed key (or a replaced table) might still be read by a reader, so it is retired and freed later, once no
+ * reader can be reading it anymore. The map has a global epoch, and every reader announces the epoch it entered on
+ * (in its own handle, on its own cache line, so the readers never share any line written by another thread):
+ *
+ * 1. A writer retires the memory it unlinked, tagged with the current epoch "e".
+ * 2. A writer advances the epoch only when every active reader announced the current epoch.
+ * 3. Once the epoch is "e + 2", every active reader entered after the memory was unlinked, so it is freed.
+ *
+ * ### References ###
+ *
+ * - https://www.cl.cam.ac.uk/techreports/UCAM-CL-TR-579.pdf (Fraser, Practical Lock-Freedom, Epoch-Based Reclamation)
+ * - https://www.kernel.org/doc/html/latest/RCU/whatisRCU.html (Linux, What is RCU?)
+ * - https://preshing.com/20160726/using-quiescent-states-to-reclaim-memory/ (Preshing, Quiescent States)
+ */
+
+// Imports & Headers
+
+#include <stdlib.h>         // For "malloc", "aligned_alloc", "free" (memory management)
+#include <stdint.h>         // For "uint64_t" (more integer types)
+#include <string.h>         // For "memcpy", "memcmp" (copying and comparing keys)
+#include <stdatomic.h>      // For "atomic_size_t", "atomic_thread_fence" (lock-free reads & epochs)
+#include <pthread.h>        // For "pthread_mutex_t" (serializing the writers)
+#include "lock-free-hash-map.h"
+#include "fnv1a.h"          // For "hashes_fnv1a_hash64_bytes_into" (hashing keys)
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+
+// Default implementation values
+
+#define CACHE_LINE_SIZE 64                  // The size of a cache line (every reader handle takes its own)
+#define INITIAL_TABLE_CAPACITY 16           // The amount of slots of the first table
+#define READER_ACTIVE 1                     // The flag of an announced epoch of a reader inside a lookup
+
+// Structures
+
+typedef struct retired {
+    struct retired * next;                  // The next retired memory (in retirement order)
+    size_t epoch;                           // The epoch when the memory was retired
+} Retired;
+
+typedef struct map_key {
+    Retired retired;                        // The retirement header (only used once removed)
+    size_t length;                          // The length of the key
+    char bytes[];                           // The bytes of the key (copied from the client)
+} MapKey;
+
+typedef struct entry {
+    _Atomic(MapKey *) key;                  // The key, 'NULL' if the slot is empty, or the tombstone if removed
+    atomic_uint_fast64_t hash;              // The hash of the key (compared before the key bytes)
+    _Atomic(void *) value;                  // The value associated to the key
+} Entry;
+
+typedef struct table {
+    Retired retired;                        // The retirement header (only used once replaced)
+    size_t capacity;                        // The amount of slots (always a power of two)
+    Entry entries[];                        // The slots of the table
+} Table;
+
+struct lock_free_hash_map_reader {
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t state;  // The announced epoch (shifted) plus the active flag, or '0'
+    LockFreeHashMap * map;                          // The map being read
+    struct lock_free_hash_map_reader * next;        // The next registered reader
+};
+
+struct lock_free_hash_map {
+    _Atomic(Table *) table;                 // The current table
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t epoch;  // The global epoch (only written by the writers)
+    atomic_size_t size;                     // The amount of keys
+    size_t used_amount;                     // The amount of keys plus tombstones (writers only)
+    pthread_mutex_t lock;                   // Serializes the writers (and the readers registration)
+    LockFreeHashMapReader * readers;        // The registered readers
+    Retired * retired_head;                 // The oldest retired memory (freed first)
+    Retired * retired_tail;                 // The newest retired memory
+};
+
+// The marker of a removed entry (never dereferenced)
+
+static MapKey tombstone;
+
+// Definition (to be able to use methods before declaring them, to follow up the top-bottom code style)
+
+Entry * lock_free_hash_map_find_entry(Table * table, uint64_t hash, const char * key, size_t key_length, Entry ** free_entry);
+bool lock_free_hash_map_insert_locked(LockFreeHashMap * map, uint64_t hash, const char * key, size_t key_length, void * value);
+Table * lock_free_hash_map_table_create(size_t capacity);
+void lock_free_hash_map_retire(LockFreeHashMap * map, Retired * retired);
+void lock_free_hash_map_collect(LockFreeHashMap * map);
+bool lock_free_hash_map_validate(const void * target, const char * key, size_t key_length, const char function[]);
+
+// Implementation
+
+LockFreeHashMap * lock_free_hash_map_create() {
+    LockFreeHashMap * map = aligned_alloc(CACHE_LINE_SIZE, sizeof(LockFreeHashMap));
+    if (map == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'map'");
+        return NULL;
+    }
+    Table * table = lock_free_hash_map_table_create(INITIAL_TABLE_CAPACITY);
+    if (table == NULL) {
+        free(map);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'table'");
+        return NULL;
+    }
+    atomic_init(&map->table, table);
+    atomic_init(&map->epoch, 1);
+    atomic_init(&map->size, 0);
+    map->used_amount = 0;
+    pthread_mutex_init(&map->lock, NULL);
+    map->readers = NULL;
+    map->retired_head = NULL;
+    map->retired_tail = NULL;
+    return map;
+}
+
+void lock_free_hash_map_destroy(LockFreeHashMap * map) {
+    if (map == NULL) return;
+    while (map->retired_head != NULL) {
+        Retired * next = map->retired_head->next;
+        free(map->retired_head);
+        map->retired_head = next;
+    }
+    Table * table = atomic_load(&map->table);
+    for (size_t i = 0; i < table->capacity; i++) {
+        MapKey * key = atomic_load_explicit(&table->entries[i].key, memory_order_relaxed);
+        if (key != NULL && key != &tombstone) free(key);
+    }
+    free(table);
+    while (map->readers != NULL) {
+        LockFreeHashMapReader * next = map->readers->next;
+        free(map->readers);
+        map->readers = next;
+    }
+    pthread_mutex_destroy(&map->lock);
+    free(map);
+}
+
+size_t lock_free_hash_map_size(LockFreeHashMap * map) {
+    if (map == NULL) return 0;
+    return atomic_load_explicit(&map->size, memory_order_relaxed);
+}
+
+LockFreeHashMapReader * lock_free_hash_map_reader_register(LockFreeHashMap * map) {
+    if (map == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to register a reader of a 'NULL' map");
+        return NULL;
+    }
+    LockFreeHashMapReader * reader = aligned_alloc(CACHE_LINE_SIZE, sizeof(LockFreeHashMapReader));
+    if (reader == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'reader'");
+        return NULL;
+    }
+    atomic_init(&reader->state, 0);
+    reader->map = map;
+    pthread_mutex_lock(&map->lock);
+    reader->next = map->readers;
+    map->readers = reader;
+    pthread_mutex_unlock(&map->lock);
+    return reader;
+}
+
+void lock_free_hash_map_reader_unregister(LockFreeHashMapReader * reader) {
+    if (reader == NULL) return;
+    LockFreeHashMap * map = reader->map;
+    pthread_mutex_lock(&map->lock);
+    LockFreeHashMapReader ** link = &map->readers;
+    while ((* link) != NULL && (* link) != reader) link = &(* link)->next;
+    if ((* link) != NULL) (* link) = reader->next;
+    pthread_mutex_unlock(&map->lock);
+    free(reader);
+}
+
+bool lock_free_hash_map_get(LockFreeHashMapReader * reader, const char * key, size_t key_length, void ** value) {
+    if (!lock_free_hash_map_validate(reader, key, key_length, __func__)) return false;
+    if (value == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to get into a 'NULL' value");
+        return false;
+    }
+    LockFreeHashMap * map = reader->map;
+    uint64_t hash;
+    hashes_fnv1a_hash64_bytes_into(key, key_length, &hash);
+    // Step 1: Announce the current epoch (the fence orders the announcement before every read of the lookup)
+    size_t epoch = atomic_load_explicit(&map->epoch, memory_order_acquire);
+    atomic_store_explicit(&reader->state, (epoch << 1) | READER_ACTIVE, memory_order_release);
+    atomic_thread_fence(memory_order_seq_cst);
+    // Step 2: Probe the current table (bounded by its capacity)
+    Table * table = atomic_load_explicit(&map->table, memory_order_acquire);
+    size_t mask = table->capacity - 1;
+    bool is_found = false;
+    for (size_t i = 0; i < table->capacity; i++) {
+        Entry * entry = &table->entries[(hash + i) & mask];
+        MapKey * entry_key = atomic_load_explicit(&entry->key, memory_order_acquire);
+        if (entry_key == NULL) break;
+        if (entry_key == &tombstone || atomic_load_explicit(&entry->hash, memory_order_relaxed) != hash) continue;
+        if (entry_key->length != key_length || (key_length > 0 && memcmp(entry_key->bytes, key, key_length) != 0)) continue;
+        // The key is read again, as the slot might have been reused meanwhile (then the key was removed meanwhile)
+        void * entry_value = atomic_load_explicit(&entry->value, memory_order_acquire);
+        if (atomic_load_explicit(&entry->key, memory_order_acquire) == entry_key) {
+            (* value) = entry_value;
+            is_found = true;
+        }
+        break;
+    }
+    // Step 3: Leave the epoch (every read of the lookup is ordered before it, so the writers can free after seeing it)
+    atomic_store_explicit(&reader->state, 0, memory_order_release);
+    return is_found;
+}
+
+bool lock_free_hash_map_put(LockFreeHashMap * map, const char * key, size_t key_length, void * value, void ** previous_value) {
+    if (!lock_free_hash_map_validate(map, key, key_length, __func__)) return false;
+    uint64_t hash;
+    hashes_fnv1a_hash64_bytes_into(key, key_length, &hash);
+    pthread_mutex_lock(&map->lock);
+    Entry * entry = lock_free_hash_map_find_entry(atomic_load_explicit(&map->table, memory_order_relaxed), hash, key, key_length, NULL);
+    bool is_stored = true;
+    if (entry != NULL) {
+        if (previous_value != NULL) (* previous_value) = atomic_load_explicit(&entry->value, memory_order_relaxed);
+        atomic_store_explicit(&entry->value, value, memory_order_release);
+    } else {
+        if (previous_value != NULL) (* previous_value) = NULL;
+        is_stored = lock_free_hash_map_insert_locked(map, hash, key, key_length, value);
+    }
+    lock_free_hash_map_collect(map);
+    pthread_mutex_unlock(&map->lock);
+    return is_stored;
+}
+
+bool lock_free_hash_map_remove(LockFreeHashMap * map, const char * key, size_t key_length, void ** previous_value) {
+    if (!lock_free_hash_map_validate(map, key, key_length, __func__)) return false;
+    uint64_t hash;
+    hashes_fnv1a_hash64_bytes_into(key, key_length, &hash);
+    pthread_mutex_lock(&map->lock);
+    Entry * entry = lock_free_hash_map_find_entry(atomic_load_explicit(&map->table, memory_order_relaxed), hash, key, key_length, NULL);
+    if (entry != NULL) {
+        if (previous_value != NULL) (* previous_value) = atomic_load_explicit(&entry->value, memory_order_relaxed);
+        MapKey * removed_key = atomic_load_explicit(&entry->key, memory_order_relaxed);
+        atomic_store_explicit(&entry->key, &tombstone, memory_order_release);
+        lock_free_hash_map_retire(map, &removed_key->retired);
+        atomic_fetch_sub_explicit(&map->size, 1, memory_order_relaxed);
+    }
+    lock_free_hash_map_collect(map);
+    pthread_mutex_unlock(&map->lock);
+    return entry != NULL;
+}
+
+// Utilities
+
+// Finds the entry of the key (only called by the writers), and optionally the first reusable slot
+Entry * lock_free_hash_map_find_entry(Table * table, uint64_t hash, const char * key, size_t key_length, Entry ** free_entry) {
+    size_t mask = table->capacity - 1;
+    if (free_entry != NULL) (* free_entry) = NULL;
+    for (size_t i = 0; i < table->capacity; i++) {
+        Entry * entry = &table->entries[(hash + i) & mask];
+        MapKey * entry_key = atomic_load_explicit(&entry->key, memory_order_relaxed);
+        if (entry_key == NULL || entry_key == &tombstone) {
+            if (free_entry != NULL && (* free_entry) == NULL) (* free_entry) = entry;
+            if (entry_key == NULL) return NULL;
+            continue;
+        }
+        if (atomic_load_explicit(&entry->hash, memory_order_relaxed) != hash) continue;
+        if (entry_key->length == key_length && (key_length == 0 || memcmp(entry_key->bytes, key, key_length) == 0)) return entry;
+    }
+    return NULL;
+}
+
+// Inserts a missing key (under the writers lock), replacing the table first if it is half used
+bool lock_free_hash_map_insert_locked(LockFreeHashMap * map, uint64_t hash, const char * key, size_t key_length, void * value) {
+    // Step 1: Copy the key
+    MapKey * new_key = malloc(sizeof(MapKey) + key_length);
+    if (new_key == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'key'");
+        return false;
+    }
+    new_key->length = key_length;
+    if (key_length > 0) memcpy(new_key->bytes, key, key_length);
+    // Step 2: Build and publish a new table if needed (the old one is retired, as readers might still be probing it)
+    Table * table = atomic_load_explicit(&map->table, memory_order_relaxed);
+    if ((map->used_amount + 1) * 2 > table->capacity) {
+        size_t size = atomic_load_explicit(&map->size, memory_order_relaxed);
+        size_t capacity = INITIAL_TABLE_CAPACITY;
+        while (capacity < (size + 1) * 4) capacity <<= 1;
+        Table * new_table = lock_free_hash_map_table_create(capacity);
+        if (new_table == NULL) {
+            free(new_key);
+            error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'table'");
+            return false;
+        }
+        for (size_t i = 0; i < table->capacity; i++) {
+            Entry * entry = &table->entries[i];
+            MapKey * entry_key = atomic_load_explicit(&entry->key, memory_order_relaxed);
+            if (entry_key == NULL || entry_key == &tombstone) continue;
+            uint64_t entry_hash = atomic_load_explicit(&entry->hash, memory_order_relaxed);
+            Entry * free_entry;
+            lock_free_hash_map_find_entry(new_table, entry_hash, entry_key->bytes, entry_key->length, &free_entry);
+            atomic_init(&free_entry->hash, entry_hash);
+            atomic_init(&free_entry->value, atomic_load_explicit(&entry->value, memory_order_relaxed));
+            atomic_init(&free_entry->key, entry_key);
+        }
+        atomic_store_explicit(&map->table, new_table, memory_order_release);
+        lock_free_hash_map_retire(map, &table->retired);
+        table = new_table;
+        map->used_amount = size;
+    }
+    // Step 3: Fill the slot, and publish it through its key
+    Entry * free_entry;
+    lock_free_hash_map_find_entry(table, hash, key, key_length, &free_entry);
+    if (atomic_load_explicit(&free_entry->key, memory_order_relaxed) == NULL) map->used_amount++;
+    atomic_store_explicit(&free_entry->hash, hash, memory_order_relaxed);
+    atomic_store_explicit(&free_entry->value, value, memory_order_release);
+    atomic_store_explicit(&free_entry->key, new_key, memory_order_release);
+    atomic_fetch_add_explicit(&map->size, 1, memory_order_relaxed);
+    return true;
+}
+
+Table * lock_free_hash_map_table_create(size_t capacity) {
+    Table * table = malloc(sizeof(Table) + sizeof(Entry) * capacity);
+    if (table == NULL) return NULL;
+    table->capacity = capacity;
+    for (size_t i = 0; i < capacity; i++) {
+        atomic_init(&table->entries[i].key, NULL);
+        atomic_init(&table->entries[i].hash, 0);
+        atomic_init(&table->entries[i].value, NULL);
+    }
+    return table;
+}
+
+// Appends unlinked memory to the retired list (tagged with the current epoch)
+void lock_free_hash_map_retire(LockFreeHashMap * map, Retired * retired) {
+    retired->next = NULL;
+    retired->epoch = atomic_load_explicit(&map->epoch, memory_order_relaxed);
+    if (map->retired_tail == NULL) {
+        map->retired_head = retired;
+    } else {
+        map->retired_tail->next = retired;
+    }
+    map->retired_tail = retired;
+}
+
+// Advances the epoch if every active reader announced the current one, and frees the memory no reader can reach
+void lock_free_hash_map_collect(LockFreeHashMap * map) {
+    if (map->retired_head == NULL) return;
+    // Step 1: Check the announced epochs (ordered after the unlinking stores, pairs with the readers announcements)
+    atomic_thread_fence(memory_order_seq_cst);
+    size_t epoch = atomic_load_explicit(&map->epoch, memory_order_relaxed);
+    bool is_advanceable = true;
+    for (LockFreeHashMapReader * reader = map->readers; reader != NULL; reader = reader->next) {
+        size_t state = atomic_load_explicit(&reader->state, memory_order_acquire);
+        if ((state & READER_ACTIVE) && (state >> 1) != epoch) {
+            is_advanceable = false;
+            break;
+        }
+    }
+    if (is_advanceable) {
+        epoch++;
+        atomic_store_explicit(&map->epoch, epoch, memory_order_release);
+    }
+    // Step 2: Free the memory retired at least two epochs ago (in retirement order, so the oldest ones come first)
+    while (map->retired_head != NULL && map->retired_head->epoch + 2 <= epoch) {
+        Retired * next = map->retired_head->next;
+        free(map->retired_head);
+        map->retired_head = next;
+    }
+    if (map->retired_head == NULL) map->retired_tail = NULL;
+}
+
+bool lock_free_hash_map_validate(const void * target, const char * key, size_t key_length, const char function[]) {
+    if (target == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, function, "Trying to use a 'NULL' map or reader");
+        return false;
+    }
+    if (key == NULL && key_length > 0) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, function, "Trying to use a 'NULL' key");
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdbool.h>   // For "true", "false" (boolean constants)
+#include <stddef.h>    // For "size_t" (size type)
+
+/* lock-free-hash-map.h */
+#ifndef MAPS_LOCK_FREE_HASH_MAP_H
+#define MAPS_LOCK_FREE_HASH_MAP_H
+
+typedef struct lock_free_hash_map LockFreeHashMap;
+typedef struct lock_free_hash_map_reader LockFreeHashMapReader;
+
+/**
+ * Creates a read-mostly concurrent hash map of string keys (copied into the map) to pointer values (owned by the
+ * client), whose lookups never lock nor write any shared memory.
+ *
+ * The returned map must be freed by the client after its usage.
+ *
+ * @return a new map, or {@code NULL} if an error occurred
+ */
+LockFreeHashMap * lock_free_hash_map_create();
+
+/**
+ * Frees the given map, its keys and its remaining reader handles (the values are not freed).
+ *
+ * @param map the map that is about to be freed
+ *
+ * @note no thread must be using the map (nor any of its reader handles) during its destruction
+ */
+void lock_free_hash_map_destroy(LockFreeHashMap * map);
+
+/**
+ * Returns the amount of keys stored in the given map (a snapshot, as a writer might be changing it meanwhile).
+ *
+ * @param map the map to be checked
+ *
+ * @return the amount of keys, or '0' if the map is {@code NULL}
+ */
+size_t lock_free_hash_map_size(LockFreeHashMap * map);
+
+/**
+ * Registers a new reader of the given map, whose handle is needed to look keys up (it holds the epoch announced by
+ * the reader, on its own cache line, so the writers know which memory might still be read).
+ *
+ * A reader handle must only be used by one thread at a time (usually, every reading thread registers its own).
+ *
+ * @param map the map to be read
+ *
+ * @return a new reader handle, or {@code NULL} if an error occurred
+ */
+LockFreeHashMapReader * lock_free_hash_map_reader_register(LockFreeHashMap * map);
+
+/**
+ * Unregisters (and frees) the given reader handle.
+ *
+ * @param reader the reader handle that is about to be freed
+ */
+void lock_free_hash_map_reader_unregister(LockFreeHashMapReader * reader);
+
+/**
+ * Looks up the value of the given key, without locking nor writing any shared memory (wait-free).
+ *
+ * @param reader the reader handle of the calling thread
+ * @param key the bytes of the key
+ * @param key_length the length of the key (an empty key is valid)
+ * @param value where the value is to be stored (if found)
+ *
+ * @return {@code true} if the key was found, {@code false} otherwise (or if an error occurred)
+ */
+bool lock_free_hash_map_get(LockFreeHashMapReader * reader, const char * key, size_t key_length, void ** value);
+
+/**
+ * Associates the given value to the given key, replacing the previous value (if any).
+ *
+ * The writers are serialized among themselves (the map is meant for rare updates), but never block the readers.
+ *
+ * @param map the map where the key is to be stored
+ * @param key the bytes of the key
+ * @param key_length the length of the key (an empty key is valid)
+ * @param value the value to be associated
+ * @param previous_value where the replaced value (or {@code NULL} if the key was missing) is to be stored, can be
+ *                       {@code NULL} if not needed
+ *
+ * @return {@code true} if the value was stored, {@code false} if an error occurred
+ */
+bool lock_free_hash_map_put(LockFreeHashMap * map, const char * key, size_t key_length, void * value, void ** previous_value);
+
+/**
+ * Removes the given key from the given map (the key memory is freed once no reader can be reading it anymore).
+ *
+ * @param map the map where the key is to be removed from
+ * @param key the bytes of the key
+ * @param key_length the length of the key (an empty key is valid)
+ * @param previous_value where the removed value is to be stored, can be {@code NULL} if not needed
+ *
+ * @return {@code true} if the key was removed, {@code false} if it was missing (or an error occurred)
+ */
+bool lock_free_hash_map_remove(LockFreeHashMap * map, const char * key, size_t key_length, void ** previous_value);
+
+#endif /* MAPS_LOCK_FREE_HASH_MAP_H */
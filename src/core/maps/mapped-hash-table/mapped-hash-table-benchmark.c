@@ -0,0 +1,124 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L // For "clock_gettime", "CLOCK_MONOTONIC" (monotonic clock)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "mapped-hash-table.h"
+#include "sharded-hash-map.h"
+
+#define LINE_SIZE 64
+#define LOOKUPS_AMOUNT 1000000
+#define OPENS_AMOUNT 1000
+
+// Benchmarking snippet (not abstracted away for piece of code portability)
+double elapsed_seconds(struct timespec start, struct timespec stop) {
+    return (double) (stop.tv_sec - start.tv_sec) + (double) (stop.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Generates a text map of "<key>\t<offset>" lines (the usual source of the map, rebuilt on every cold start)
+void generate_text(const char * path, size_t entries_amount) {
+    FILE * file = fopen(path, "w");
+    for (size_t i = 0; i < entries_amount; i++) fprintf(file, "/objects/key-%011zu\t%zu\n", i, i * 4096);
+    fclose(file);
+}
+
+// Parses the text map, calling the given function with every entry
+void parse_text(const char * path, void (* consume)(void * target, const char * key, size_t key_length, uint64_t value), void * target) {
+    FILE * file = fopen(path, "r");
+    char line[LINE_SIZE];
+    while (fgets(line, LINE_SIZE, file) != NULL) {
+        char * separator = strchr(line, '\t');
+        if (separator == NULL) continue;
+        consume(target, line, (size_t) (separator - line), strtoull(separator + 1, NULL, 10));
+    }
+    fclose(file);
+}
+
+void consume_into_map(void * target, const char * key, size_t key_length, uint64_t value) {
+    sharded_hash_map_put(target, key, key_length, (void *) (uintptr_t) value, NULL);
+}
+
+void consume_into_writer(void * target, const char * key, size_t key_length, uint64_t value) {
+    mapped_hash_table_writer_add(target, key, key_length, value);
+}
+
+// Benchmarks
+
+void mapped_hash_table_startup_benchmark(size_t entries_amount) {
+    const char * text_path = "/tmp/mapped-hash-table-benchmark.txt";
+    const char * table_path = "/tmp/mapped-hash-table-benchmark.table";
+    generate_text(text_path, entries_amount);
+    printf("%zu entries\n", entries_amount);
+    struct timespec start, stop;
+    // Baseline: rebuild an in-memory map from the text on every start
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ShardedHashMap * map = sharded_hash_map_create_default();
+    parse_text(text_path, consume_into_map, map);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    printf("%-32s %12.3f s\n", "text rebuild", elapsed_seconds(start, stop));
+    // One-off conversion of the text into a table file
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    MappedHashTableWriter * writer = mapped_hash_table_writer_create();
+    parse_text(text_path, consume_into_writer, writer);
+    mapped_hash_table_writer_write(writer, table_path);
+    mapped_hash_table_writer_destroy(writer);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    printf("%-32s %12.3f s\n", "table write (one-off)", elapsed_seconds(start, stop));
+    // Startup: opening the table (averaged, as a single open is too fast to be measured reliably)
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < OPENS_AMOUNT; i++) mapped_hash_table_close(mapped_hash_table_open(table_path));
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    printf("%-32s %12.3f us\n", "table open", elapsed_seconds(start, stop) / OPENS_AMOUNT * 1e6);
+    MappedHashTable * table = mapped_hash_table_open(table_path);
+    // Random lookups over both (hits only, the usual access pattern of an offset index)
+    char key[LINE_SIZE];
+    double seconds[2];
+    size_t found_amounts[2] = { 0, 0 };
+    for (size_t variant = 0; variant < 2; variant++) {
+        uint64_t random_state = 0x9e3779b97f4a7c15ULL;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (size_t i = 0; i < LOOKUPS_AMOUNT; i++) {
+            random_state ^= random_state << 13;
+            random_state ^= random_state >> 7;
+            random_state ^= random_state << 17;
+            int length = snprintf(key, LINE_SIZE, "/objects/key-%011zu", (size_t) (random_state % entries_amount));
+            if (variant == 0) {
+                void * value;
+                found_amounts[variant] += sharded_hash_map_get(map, key, (size_t) length, &value);
+            } else {
+                uint64_t value;
+                found_amounts[variant] += mapped_hash_table_get(table, key, (size_t) length, &value);
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        seconds[variant] = elapsed_seconds(start, stop);
+    }
+    printf("%-32s %12.2f Mops/s (%zu found)\n", "in-memory map lookups", LOOKUPS_AMOUNT / seconds[0] / 1e6, found_amounts[0]);
+    printf("%-32s %12.2f Mops/s (%zu found)\n", "mapped table lookups", LOOKUPS_AMOUNT / seconds[1] / 1e6, found_amounts[1]);
+    mapped_hash_table_close(table);
+    sharded_hash_map_destroy(map);
+    remove(text_path);
+    remove(table_path);
+}
+
+// Benchmarks runner (the arguments optionally override the amount of entries)
+
+int main(int argc, char * argv[]) {
+    size_t entries_amount = (argc > 1) ? strtoull(argv[1], NULL, 10) : 10000000;
+    mapped_hash_table_startup_benchmark(entries_amount);
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "mapped-hash-table.h"
+#include "error-reporter.h"
+
+#define TABLE_PATH "/tmp/mapped-hash-table-tests.table"
+
+// Assertion snippet (not abstracted away for piece of code portability)
+void assert(int condition, char message[]) {
+    if (condition != 1) {
+        printf("%s\n", message);
+        exit(1);
+    }
+}
+
+// Utilities
+
+void write_bytes(const char * path, const char * bytes, size_t length) {
+    FILE * file = fopen(path, "wb");
+    fwrite(bytes, 1, length, file);
+    fclose(file);
+}
+
+char * read_bytes(const char * path, size_t * length) {
+    FILE * file = fopen(path, "rb");
+    fseek(file, 0, SEEK_END);
+    * length = (size_t) ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char * bytes = malloc(* length);
+    * length = fread(bytes, 1, * length, file);
+    fclose(file);
+    return bytes;
+}
+
+// Unit testing
+
+void mapped_hash_table_write_open_get_test() {
+    printf("*** Running test '%s'\n", __func__);
+    MappedHashTableWriter * writer = mapped_hash_table_writer_create();
+    assert(writer != NULL, "The 'writer' must not be null");
+    assert(mapped_hash_table_writer_add(writer, "apple", 5, 1), "The entry must be added");
+    assert(mapped_hash_table_writer_add(writer, "", 0, 2), "An empty key must be added");
+    assert(mapped_hash_table_writer_add(writer, "pear", 4, 3), "The entry must be added");
+    assert(mapped_hash_table_writer_add(writer, "apple", 5, 4), "A repeated key must be added");
+    assert(mapped_hash_table_writer_write(writer, TABLE_PATH), "The table must be written");
+    mapped_hash_table_writer_destroy(writer);
+    MappedHashTable * table = mapped_hash_table_open(TABLE_PATH);
+    assert(table != NULL, "The table must be opened");
+    assert(mapped_hash_table_size(table) == 3, "The size must only count the unique keys");
+    uint64_t value = 0;
+    assert(mapped_hash_table_get(table, "apple", 5, &value) && value == 4, "The last value of a repeated key must be found");
+    assert(mapped_hash_table_get(table, "", 0, &value) && value == 2, "The empty key must be found");
+    assert(mapped_hash_table_get(table, "pear", 4, &value) && value == 3, "The value must be found");
+    assert(!mapped_hash_table_get(table, "apples", 6, &value), "A longer key must not match");
+    assert(!mapped_hash_table_get(table, "appl", 4, &value), "A shorter key must not match");
+    assert(!mapped_hash_table_get(table, "kiwi", 4, &value), "A missing key must not be found");
+    mapped_hash_table_close(table);
+    remove(TABLE_PATH);
+}
+
+void mapped_hash_table_many_keys_test() {
+    printf("*** Running test '%s'\n", __func__);
+    const size_t KEYS_AMOUNT = 100000;
+    MappedHashTableWriter * writer = mapped_hash_table_writer_create();
+    char key[32];
+    for (size_t i = 0; i < KEYS_AMOUNT; i++) {
+        // The lengths vary, so the entries need different paddings
+        int length = snprintf(key, sizeof(key), "key-%zu-%.*s", i, (int) (i % 7), "xxxxxxx");
+        assert(mapped_hash_table_writer_add(writer, key, (size_t) length, i * 1000), "The entry must be added");
+    }
+    assert(mapped_hash_table_writer_write(writer, TABLE_PATH), "The table must be written");
+    // Rewriting replaces the previous file
+    assert(mapped_hash_table_writer_add(writer, "extra", 5, 42), "The entry must be added");
+    assert(mapped_hash_table_writer_write(writer, TABLE_PATH), "The table must be rewritten");
+    mapped_hash_table_writer_destroy(writer);
+    MappedHashTable * table = mapped_hash_table_open(TABLE_PATH);
+    assert(table != NULL, "The table must be opened");
+    assert(mapped_hash_table_size(table) == KEYS_AMOUNT + 1, "The size must match the amount of keys");
+    uint64_t value;
+    for (size_t i = 0; i < KEYS_AMOUNT; i++) {
+        int length = snprintf(key, sizeof(key), "key-%zu-%.*s", i, (int) (i % 7), "xxxxxxx");
+        assert(mapped_hash_table_get(table, key, (size_t) length, &value) && value == i * 1000, "Every value must be found");
+        length = snprintf(key, sizeof(key), "key-%zu-", i + KEYS_AMOUNT);
+        assert(!mapped_hash_table_get(table, key, (size_t) length, &value), "A missing key must not be found");
+    }
+    assert(mapped_hash_table_get(table, "extra", 5, &value) && value == 42, "The rewritten entry must be found");
+    mapped_hash_table_close(table);
+    remove(TABLE_PATH);
+}
+
+void mapped_hash_table_empty_test() {
+    printf("*** Running test '%s'\n", __func__);
+    MappedHashTableWriter * writer = mapped_hash_table_writer_create();
+    assert(mapped_hash_table_writer_write(writer, TABLE_PATH), "An empty table must be written");
+    mapped_hash_table_writer_destroy(writer);
+    MappedHashTable * table = mapped_hash_table_open(TABLE_PATH);
+    assert(table != NULL, "An empty table must be opened");
+    assert(mapped_hash_table_size(table) == 0, "An empty table must have no keys");
+    uint64_t value;
+    assert(!mapped_hash_table_get(table, "", 0, &value), "An empty table must not find any key");
+    mapped_hash_table_close(table);
+    remove(TABLE_PATH);
+}
+
+void mapped_hash_table_invalid_files_test() {
+    printf("*** Running test '%s'\n", __func__);
+    assert(mapped_hash_table_open("/tmp/mapped-hash-table-tests.missing") == NULL, "A missing file must not be opened");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "Error must be an invalid argument error");
+    write_bytes(TABLE_PATH, "apple 1\npear 2\n", 15);
+    assert(mapped_hash_table_open(TABLE_PATH) == NULL, "A too small file must not be opened");
+    // Write a valid table, and then break it in different ways
+    MappedHashTableWriter * writer = mapped_hash_table_writer_create();
+    mapped_hash_table_writer_add(writer, "apple", 5, 1);
+    mapped_hash_table_writer_write(writer, TABLE_PATH);
+    mapped_hash_table_writer_destroy(writer);
+    size_t length;
+    char * bytes = read_bytes(TABLE_PATH, &length);
+    write_bytes(TABLE_PATH, bytes, length - 8);
+    assert(mapped_hash_table_open(TABLE_PATH) == NULL, "A truncated file must not be opened");
+    bytes[0] ^= 1;
+    write_bytes(TABLE_PATH, bytes, length);
+    assert(mapped_hash_table_open(TABLE_PATH) == NULL, "A wrong magic must not be opened");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "Error must be an invalid argument error");
+    bytes[0] ^= 1;
+    bytes[12] ^= 1;
+    write_bytes(TABLE_PATH, bytes, length);
+    assert(mapped_hash_table_open(TABLE_PATH) == NULL, "A different byte order must not be opened");
+    bytes[12] ^= 1;
+    // Point every bucket past the end of the file (the header is still valid, so it is only detected by the lookups)
+    for (size_t offset = 64; offset + 16 <= length - 16; offset += 16) {
+        if (* (uint64_t *) (bytes + offset + 8) != 0) * (uint64_t *) (bytes + offset + 8) = length;
+    }
+    write_bytes(TABLE_PATH, bytes, length);
+    MappedHashTable * table = mapped_hash_table_open(TABLE_PATH);
+    assert(table != NULL, "A table with a valid header must be opened");
+    uint64_t value;
+    assert(!mapped_hash_table_get(table, "apple", 5, &value), "A corrupted entry must not be found");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_STATE, "Error must be an invalid state error");
+    mapped_hash_table_close(table);
+    free(bytes);
+    remove(TABLE_PATH);
+}
+
+void mapped_hash_table_invalid_arguments_test() {
+    printf("*** Running test '%s'\n", __func__);
+    uint64_t value;
+    assert(!mapped_hash_table_writer_add(NULL, "a", 1, 1), "A 'NULL' writer must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_NULL_ARGUMENT, "Error must be a 'NULL' argument error");
+    assert(!mapped_hash_table_writer_write(NULL, TABLE_PATH), "A 'NULL' writer must not be written");
+    assert(mapped_hash_table_open(NULL) == NULL, "A 'NULL' path must not be opened");
+    assert(!mapped_hash_table_get(NULL, "a", 1, &value), "A 'NULL' table must fail");
+    assert(mapped_hash_table_size(NULL) == 0, "A 'NULL' table must have no keys");
+    MappedHashTableWriter * writer = mapped_hash_table_writer_create();
+    assert(!mapped_hash_table_writer_add(writer, NULL, 1, 1), "A 'NULL' key must fail");
+    assert(!mapped_hash_table_writer_write(writer, "/tmp/missing-directory/table"), "A path in a missing directory must fail");
+    mapped_hash_table_writer_destroy(writer);
+}
+
+int main() {
+    fclose(stderr); // Prevent printing "expected" errors
+    mapped_hash_table_write_open_get_test();
+    mapped_hash_table_many_keys_test();
+    mapped_hash_table_empty_test();
+    mapped_hash_table_invalid_files_test();
+    mapped_hash_table_invalid_arguments_test();
+}
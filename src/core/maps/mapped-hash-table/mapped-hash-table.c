@@ -0,0 +1,378 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * A Memory-Mappable Read-Only Hash Table Implementation (with an on-disk open addressing layout).
+ *
+ * ### Explanation ###
+ *
+ * Loading a big map from a text file at startup parses, hashes and inserts every single entry (minutes for tens of
+ * millions of them), even if the process only looks up a handful of keys before exiting. Instead, the table is
+ * written once in the exact layout the lookups need, so opening it is just mapping the file and checking its header,
+ * and the operating system pages in (and caches across processes) only the parts that are actually read.
+ *
+ * ### Format ###
+ *
+ * All the integers are stored in the byte order of the writer (recorded in the header, so a table written on a
+ * machine of a different byte order is rejected instead of misread), and every section is 8 bytes aligned:
+ *
+ * 1. Header (64 bytes): the magic, the version, the byte order, the amounts of entries and buckets, the offsets of
+ *    the sections and the total size of the file (so a truncated file is detected on open).
+ * 2. Buckets: an open addressing table of (hash, entry offset) pairs with linear probing, where a zero offset marks
+ *    an empty bucket. The amount of buckets is not a power of two (the load factor is kept at 3/4, which would waste
+ *    up to half of the space when rounding up), so the home bucket of a hash is picked by a multiply and shift.
+ * 3. Blob: the entries (the value, the key length and the key bytes), stored in the order of their buckets.
+ *
+ * A lookup hashes the key with the 64 bit FNV-1a, walks the buckets comparing the full hashes (so the blob is almost
+ * only touched for the matching key), and compares the key bytes of the entry the matching bucket points to.
+ *
+ * ### Robustness ###
+ *
+ * Opening validates the header against the size of the file in constant time, but the buckets are not walked (it
+ * would turn the open into a full scan), so every lookup checks that the entry it reads lies inside the mapping,
+ * and a corrupted entry is reported instead of read out of bounds. The writer replaces the file atomically (it
+ * writes a temporary sibling file, synchronizes it and renames it over the path), so a reader never maps a partial
+ * table, and the processes which already mapped the previous version keep reading it until they close it.
+ *
+ * ### References ###
+ *
+ * - https://cr.yp.to/cdb/cdb.txt (Bernstein, Constant Database)
+ * - https://lemire.me/blog/2016/06/27/a-fast-alternative-to-the-modulo-reduction/
+ * - https://en.wikipedia.org/wiki/Linear_probing
+ */
+
+// Imports & Headers
+
+#include <stdlib.h>         // For "malloc", "calloc", "free" (memory management)
+#include <stdio.h>          // For "fopen", "fwrite", "fseeko", "rename" (writing the file)
+#include <string.h>         // For "memcmp", "strlen" (comparing keys & building the temporary path)
+#include <stddef.h>         // For "offsetof" (size of the entries)
+#include <fcntl.h>          // For "open" (opening the file)
+#include <unistd.h>         // For "close", "fsync" (closing & synchronizing the file)
+#include <sys/mman.h>       // For "mmap", "munmap", "madvise" (mapping the file)
+#include <sys/stat.h>       // For "fstat" (file size)
+#include "mapped-hash-table.h"
+#include "fnv1a.h"          // For "hashes_fnv1a_hash64_bytes_into" (hashing keys)
+#include "vector.h"         // For "vector_push", "vector_push_many" (storing the added entries)
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+
+// Default implementation values
+
+#define FORMAT_MAGIC "CDKMHT\r\n"           // The first bytes of a table file (the line ending catches text mangling)
+#define FORMAT_VERSION 1                    // The version of the format (bumped on every incompatible change)
+#define FORMAT_BYTE_ORDER 0x01020304u       // Read back as a different value on a machine of another byte order
+#define FORMAT_ALIGNMENT 8                  // The alignment of every section and entry
+#define WRITE_BUFFER_SIZE (1024 * 1024)     // The buffer of the written file (fewer, bigger writes)
+
+// Structures
+
+typedef struct mapped_header {
+    char magic[8];                          // The "FORMAT_MAGIC" bytes
+    uint32_t version;                       // The "FORMAT_VERSION" of the writer
+    uint32_t byte_order;                    // The "FORMAT_BYTE_ORDER", as stored by the writer
+    uint64_t entries_amount;                // The amount of keys
+    uint64_t buckets_amount;                // The amount of buckets (always greater than the amount of keys)
+    uint64_t buckets_offset;                // The offset of the buckets (right after the header)
+    uint64_t blob_offset;                   // The offset of the entries (right after the buckets)
+    uint64_t file_size;                     // The size of the whole file
+    uint64_t reserved;                      // Zero (keeps the header 64 bytes long, for future use)
+} MappedHeader;
+
+typedef struct mapped_bucket {
+    uint64_t hash;                          // The hash of the key (compared before the key bytes)
+    uint64_t entry_offset;                  // The offset of the entry from the start of the file, '0' if empty
+} MappedBucket;
+
+typedef struct mapped_entry {
+    uint64_t value;                         // The value associated to the key
+    uint32_t key_length;                    // The length of the key
+    char key[];                             // The bytes of the key (padded up to the alignment)
+} MappedEntry;
+
+typedef struct writer_entry {
+    uint64_t hash;                          // The hash of the key
+    uint64_t value;                         // The value associated to the key
+    size_t key_offset;                      // The offset of the key bytes into the keys of the writer
+    size_t key_length;                      // The length of the key
+} WriterEntry;
+
+struct mapped_hash_table_writer {
+    Vector * entries;                       // The added entries (as "WriterEntry")
+    Vector * keys;                          // The bytes of the added keys (back to back)
+};
+
+struct mapped_hash_table {
+    const char * bytes;                     // The mapping of the whole file
+    size_t length;                          // The length of the mapping
+    const MappedBucket * buckets;           // The buckets (inside the mapping)
+    size_t buckets_amount;                  // The amount of buckets
+    size_t entries_amount;                  // The amount of keys
+    size_t blob_offset;                     // The offset of the first entry
+};
+
+// Definition (to be able to use methods before declaring them, to follow up the top-bottom code style)
+
+size_t mapped_hash_table_home_bucket(uint64_t hash, size_t buckets_amount);
+size_t mapped_hash_table_entry_size(size_t key_length);
+size_t mapped_hash_table_writer_fill_buckets(MappedHashTableWriter * writer, MappedBucket * buckets, size_t buckets_amount);
+bool mapped_hash_table_writer_write_file(MappedHashTableWriter * writer, FILE * file, MappedBucket * buckets, size_t buckets_amount, size_t entries_amount);
+bool mapped_hash_table_is_header_valid(const MappedHeader * header, size_t file_size);
+
+// Implementation
+
+MappedHashTableWriter * mapped_hash_table_writer_create() {
+    MappedHashTableWriter * writer = malloc(sizeof(MappedHashTableWriter));
+    if (writer == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'writer'");
+        return NULL;
+    }
+    writer->entries = vector_create_default(sizeof(WriterEntry));
+    writer->keys = vector_create_default(sizeof(char));
+    if (writer->entries == NULL || writer->keys == NULL) {
+        vector_destroy(writer->entries);
+        vector_destroy(writer->keys);
+        free(writer);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for the entries");
+        return NULL;
+    }
+    return writer;
+}
+
+void mapped_hash_table_writer_destroy(MappedHashTableWriter * writer) {
+    if (writer == NULL) return;
+    vector_destroy(writer->entries);
+    vector_destroy(writer->keys);
+    free(writer);
+}
+
+bool mapped_hash_table_writer_add(MappedHashTableWriter * writer, const char * key, size_t key_length, uint64_t value) {
+    if (writer == NULL || (key == NULL && key_length > 0)) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to add an entry using 'NULL' arguments");
+        return false;
+    }
+    if (key_length > UINT32_MAX) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The key length must fit in 32 bits");
+        return false;
+    }
+    WriterEntry entry;
+    hashes_fnv1a_hash64_bytes_into(key, key_length, &entry.hash);
+    entry.value = value;
+    entry.key_offset = vector_size(writer->keys);
+    entry.key_length = key_length;
+    if (key_length > 0 && !vector_push_many(writer->keys, key, key_length)) return false;
+    return vector_push(writer->entries, &entry);
+}
+
+bool mapped_hash_table_writer_write(MappedHashTableWriter * writer, const char * path) {
+    if (writer == NULL || path == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to write using 'NULL' arguments");
+        return false;
+    }
+    // Step 1: Place the entries into the buckets (there is always at least one empty bucket, to stop the probes)
+    size_t buckets_amount = vector_size(writer->entries) + vector_size(writer->entries) / 3 + 1;
+    MappedBucket * buckets = calloc(buckets_amount, sizeof(MappedBucket));
+    if (buckets == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'buckets'");
+        return false;
+    }
+    size_t entries_amount = mapped_hash_table_writer_fill_buckets(writer, buckets, buckets_amount);
+    // Step 2: Write a temporary sibling file, so the path is only replaced by a complete table
+    size_t path_length = strlen(path);
+    char * temporary_path = malloc(path_length + sizeof(".tmp"));
+    if (temporary_path == NULL) {
+        free(buckets);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'temporary_path'");
+        return false;
+    }
+    memcpy(temporary_path, path, path_length);
+    memcpy(temporary_path + path_length, ".tmp", sizeof(".tmp"));
+    FILE * file = fopen(temporary_path, "wb");
+    if (file == NULL) {
+        free(buckets);
+        free(temporary_path);
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "Unable to create the file");
+        return false;
+    }
+    setvbuf(file, NULL, _IOFBF, WRITE_BUFFER_SIZE);
+    bool is_written = mapped_hash_table_writer_write_file(writer, file, buckets, buckets_amount, entries_amount);
+    free(buckets);
+    // Step 3: Make the file durable before it becomes visible under its final path
+    is_written = is_written && fflush(file) == 0 && fsync(fileno(file)) == 0;
+    is_written = (fclose(file) == 0) && is_written;
+    if (!is_written || rename(temporary_path, path) != 0) {
+        remove(temporary_path);
+        free(temporary_path);
+        error_reporter_report(ERROR_CODE_INVALID_STATE, __func__, "Unable to write the file");
+        return false;
+    }
+    free(temporary_path);
+    return true;
+}
+
+MappedHashTable * mapped_hash_table_open(const char * path) {
+    if (path == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to open a 'NULL' path");
+        return NULL;
+    }
+    int descriptor = open(path, O_RDONLY);
+    if (descriptor < 0) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "Unable to open the file");
+        return NULL;
+    }
+    struct stat file_status;
+    if (fstat(descriptor, &file_status) != 0 || (size_t) file_status.st_size < sizeof(MappedHeader)) {
+        close(descriptor);
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The file is too small to be a table");
+        return NULL;
+    }
+    size_t length = (size_t) file_status.st_size;
+    char * bytes = mmap(NULL, length, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if (bytes == MAP_FAILED) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to map the file");
+        return NULL;
+    }
+    const MappedHeader * header = (const MappedHeader *) bytes;
+    if (!mapped_hash_table_is_header_valid(header, length)) {
+        munmap(bytes, length);
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The file is not a valid table (of this version and byte order)");
+        return NULL;
+    }
+    MappedHashTable * table = malloc(sizeof(MappedHashTable));
+    if (table == NULL) {
+        munmap(bytes, length);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'table'");
+        return NULL;
+    }
+    // The lookups jump all over the file, so reading ahead would only load pages that are never used
+    madvise(bytes, length, MADV_RANDOM);
+    table->bytes = bytes;
+    table->length = length;
+    table->buckets = (const MappedBucket *) (bytes + header->buckets_offset);
+    table->buckets_amount = (size_t) header->buckets_amount;
+    table->entries_amount = (size_t) header->entries_amount;
+    table->blob_offset = (size_t) header->blob_offset;
+    return table;
+}
+
+void mapped_hash_table_close(MappedHashTable * table) {
+    if (table == NULL) return;
+    munmap((void *) table->bytes, table->length);
+    free(table);
+}
+
+size_t mapped_hash_table_size(MappedHashTable * table) {
+    return (table == NULL) ? 0 : table->entries_amount;
+}
+
+bool mapped_hash_table_get(MappedHashTable * table, const char * key, size_t key_length, uint64_t * value) {
+    if (table == NULL || (key == NULL && key_length > 0) || value == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to look up using 'NULL' arguments");
+        return false;
+    }
+    uint64_t hash;
+    hashes_fnv1a_hash64_bytes_into(key, key_length, &hash);
+    size_t index = mapped_hash_table_home_bucket(hash, table->buckets_amount);
+    for (size_t probes = 0; probes < table->buckets_amount; probes++) {
+        const MappedBucket * bucket = &table->buckets[index];
+        if (bucket->entry_offset == 0) return false;
+        if (bucket->hash == hash) {
+            // The offsets come from the file, so they are checked before being followed (a corrupted file must not crash)
+            size_t entry_offset = (size_t) bucket->entry_offset;
+            if (entry_offset < table->blob_offset || entry_offset > table->length - sizeof(MappedEntry)) break;
+            const MappedEntry * entry = (const MappedEntry *) (table->bytes + entry_offset);
+            if (entry->key_length > table->length - entry_offset - offsetof(MappedEntry, key)) break;
+            if (entry->key_length == key_length && memcmp(entry->key, key, key_length) == 0) {
+                * value = entry->value;
+                return true;
+            }
+        }
+        index = (index + 1 == table->buckets_amount) ? 0 : index + 1;
+    }
+    error_reporter_report(ERROR_CODE_INVALID_STATE, __func__, "The table file is corrupted");
+    return false;
+}
+
+// Utilities
+
+// Maps the hash into [0, buckets_amount) with a multiply and shift (no division, and no power of two is needed)
+size_t mapped_hash_table_home_bucket(uint64_t hash, size_t buckets_amount) {
+    return (size_t) (((unsigned __int128) hash * buckets_amount) >> 64);
+}
+
+size_t mapped_hash_table_entry_size(size_t key_length) {
+    size_t size = offsetof(MappedEntry, key) + key_length;
+    return (size + FORMAT_ALIGNMENT - 1) & ~((size_t) FORMAT_ALIGNMENT - 1);
+}
+
+// Stores the index of every entry (plus one, as zero marks an empty bucket), and returns the amount of unique keys
+size_t mapped_hash_table_writer_fill_buckets(MappedHashTableWriter * writer, MappedBucket * buckets, size_t buckets_amount) {
+    const WriterEntry * entries = vector_data(writer->entries);
+    const char * keys = vector_data(writer->keys);
+    size_t unique_amount = 0;
+    for (size_t i = 0; i < vector_size(writer->entries); i++) {
+        const WriterEntry * entry = &entries[i];
+        size_t index = mapped_hash_table_home_bucket(entry->hash, buckets_amount);
+        while (buckets[index].entry_offset != 0) {
+            const WriterEntry * other = &entries[buckets[index].entry_offset - 1];
+            // A repeated key replaces the previous entry (the last added value wins)
+            if (other->hash == entry->hash && other->key_length == entry->key_length &&
+                memcmp(keys + other->key_offset, keys + entry->key_offset, entry->key_length) == 0) break;
+            index = (index + 1 == buckets_amount) ? 0 : index + 1;
+        }
+        if (buckets[index].entry_offset == 0) unique_amount++;
+        buckets[index].hash = entry->hash;
+        buckets[index].entry_offset = i + 1;
+    }
+    return unique_amount;
+}
+
+// Writes the blob first (after the space of the header and the buckets), as it turns the entry indexes of the buckets
+// into file offsets, and then seeks back to write the header and the buckets
+bool mapped_hash_table_writer_write_file(MappedHashTableWriter * writer, FILE * file, MappedBucket * buckets, size_t buckets_amount, size_t entries_amount) {
+    const WriterEntry * entries = vector_data(writer->entries);
+    const char * keys = vector_data(writer->keys);
+    static const char padding[FORMAT_ALIGNMENT] = { 0 };
+    MappedHeader header = { FORMAT_MAGIC, FORMAT_VERSION, FORMAT_BYTE_ORDER, entries_amount, buckets_amount, 0, 0, 0, 0 };
+    header.buckets_offset = sizeof(MappedHeader);
+    header.blob_offset = header.buckets_offset + sizeof(MappedBucket) * buckets_amount;
+    if (fseeko(file, (off_t) header.blob_offset, SEEK_SET) != 0) return false;
+    size_t offset = header.blob_offset;
+    for (size_t i = 0; i < buckets_amount; i++) {
+        if (buckets[i].entry_offset == 0) continue;
+        const WriterEntry * entry = &entries[buckets[i].entry_offset - 1];
+        uint32_t key_length = (uint32_t) entry->key_length;
+        size_t entry_size = mapped_hash_table_entry_size(entry->key_length);
+        size_t padding_size = entry_size - offsetof(MappedEntry, key) - entry->key_length;
+        if (fwrite(&entry->value, sizeof(uint64_t), 1, file) != 1) return false;
+        if (fwrite(&key_length, sizeof(uint32_t), 1, file) != 1) return false;
+        if (fwrite(keys + entry->key_offset, 1, entry->key_length, file) != entry->key_length) return false;
+        if (fwrite(padding, 1, padding_size, file) != padding_size) return false;
+        buckets[i].entry_offset = offset;
+        offset += entry_size;
+    }
+    header.file_size = offset;
+    if (fseeko(file, 0, SEEK_SET) != 0) return false;
+    if (fwrite(&header, sizeof(MappedHeader), 1, file) != 1) return false;
+    return fwrite(buckets, sizeof(MappedBucket), buckets_amount, file) == buckets_amount;
+}
+
+// Checks the header against the file in constant time (the sections must be in order, aligned, and inside the file)
+bool mapped_hash_table_is_header_valid(const MappedHeader * header, size_t file_size) {
+    if (memcmp(header->magic, FORMAT_MAGIC, sizeof(header->magic)) != 0) return false;
+    if (header->version != FORMAT_VERSION || header->byte_order != FORMAT_BYTE_ORDER) return false;
+    if (header->file_size != file_size || header->buckets_offset != sizeof(MappedHeader)) return false;
+    if (header->buckets_amount == 0 || header->entries_amount >= header->buckets_amount) return false;
+    if (header->buckets_amount > (file_size - header->buckets_offset) / sizeof(MappedBucket)) return false;
+    return header->blob_offset == header->buckets_offset + header->buckets_amount * sizeof(MappedBucket);
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdbool.h>   // For "true", "false" (boolean constants)
+#include <stddef.h>    // For "size_t" (size type)
+#include <stdint.h>    // For "uint64_t" (more integer types)
+
+/* mapped-hash-table.h */
+#ifndef MAPS_MAPPED_HASH_TABLE_H
+#define MAPS_MAPPED_HASH_TABLE_H
+
+typedef struct mapped_hash_table MappedHashTable;
+typedef struct mapped_hash_table_writer MappedHashTableWriter;
+
+/**
+ * Creates a writer of a read-only hash table file, mapping string keys (copied into the writer) to 64 bit values
+ * (i.e., offsets into another file).
+ *
+ * The returned writer must be freed by the client after its usage.
+ *
+ * @return a new writer, or {@code NULL} if an error occurred
+ */
+MappedHashTableWriter * mapped_hash_table_writer_create();
+
+/**
+ * Frees the given writer and its keys.
+ *
+ * @param writer the writer that is about to be freed
+ */
+void mapped_hash_table_writer_destroy(MappedHashTableWriter * writer);
+
+/**
+ * Adds the given entry to the given writer (if a key is added more than once, the last value is the one written).
+ *
+ * @param writer the writer where the entry is to be added
+ * @param key the bytes of the key
+ * @param key_length the length of the key (an empty key is valid, but it must fit in 32 bits)
+ * @param value the value to be associated
+ *
+ * @return {@code true} if the entry was added, {@code false} if an error occurred
+ */
+bool mapped_hash_table_writer_add(MappedHashTableWriter * writer, const char * key, size_t key_length, uint64_t value);
+
+/**
+ * Writes the entries added so far as a hash table file at the given path (replacing it atomically, as the table is
+ * written to a temporary sibling file first, which is renamed over the path once complete).
+ *
+ * The writer can still be used afterwards (i.e., to add more entries and write a newer version of the file).
+ *
+ * @param writer the writer whose entries are to be written
+ * @param path the path of the file
+ *
+ * @return {@code true} if the file was written, {@code false} if an error occurred
+ */
+bool mapped_hash_table_writer_write(MappedHashTableWriter * writer, const char * path);
+
+/**
+ * Opens the hash table file at the given path, by mapping it into memory (only the header is read and validated,
+ * so opening takes constant time regardless of the size of the table, and the lookups are served directly from the
+ * mapping, without any deserialization).
+ *
+ * The returned table must be closed by the client after its usage.
+ *
+ * @param path the path of the file
+ *
+ * @return the opened table, or {@code NULL} if an error occurred (i.e., the file is missing, or it is not a valid
+ *         table file of this version and byte order)
+ */
+MappedHashTable * mapped_hash_table_open(const char * path);
+
+/**
+ * Closes the given table, unmapping its file.
+ *
+ * @param table the table that is about to be closed
+ */
+void mapped_hash_table_close(MappedHashTable * table);
+
+/**
+ * Returns the amount of keys stored in the given table.
+ *
+ * @param table the table to be checked
+ *
+ * @return the amount of keys, or '0' if the table is {@code NULL}
+ */
+size_t mapped_hash_table_size(MappedHashTable * table);
+
+/**
+ * Looks up the value of the given key (safe to be called from many threads at once, as the table is read-only).
+ *
+ * @param table the table where the key is to be looked up
+ * @param key the bytes of the key
+ * @param key_length the length of the key (an empty key is valid)
+ * @param value where the value is to be stored (if found)
+ *
+ * @return {@code true} if the key was found, {@code false} otherwise (or if an error occurred)
+ */
+bool mapped_hash_table_get(MappedHashTable * table, const char * key, size_t key_length, uint64_t * value);
+
+#endif /* MAPS_MAPPED_HASH_TABLE_H */
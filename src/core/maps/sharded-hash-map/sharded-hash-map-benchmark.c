@@ -0,0 +1,114 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L // For "clock_gettime", "CLOCK_MONOTONIC" (monotonic clock)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include "sharded-hash-map.h"
+
+// Benchmarking snippet (not abstracted away for piece of code portability)
+double elapsed_seconds(struct timespec start, struct timespec stop) {
+    return (double) (stop.tv_sec - start.tv_sec) + (double) (stop.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Every thread runs random operations over a shared set of keys, where a given percentage of them are writes
+
+#define KEYS_AMOUNT 65536
+#define KEY_LENGTH 16
+
+typedef struct workload {
+    ShardedHashMap * map;
+    char * keys;
+    size_t operations_per_thread;
+    unsigned writes_percentage;
+} Workload;
+
+typedef struct worker_argument {
+    Workload * workload;
+    uint64_t random_state;
+    size_t found_amount;
+} WorkerArgument;
+
+void * workload_worker(void * argument) {
+    WorkerArgument * worker = argument;
+    Workload * workload = worker->workload;
+    uint64_t random_state = worker->random_state;
+    for (size_t i = 0; i < workload->operations_per_thread; i++) {
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 7;
+        random_state ^= random_state << 17;
+        size_t key_index = random_state % KEYS_AMOUNT;
+        char * key = workload->keys + key_index * KEY_LENGTH;
+        if ((random_state >> 32) % 100 < workload->writes_percentage) {
+            sharded_hash_map_put(workload->map, key, KEY_LENGTH, (void *) (uintptr_t) i, NULL);
+        } else {
+            void * value;
+            worker->found_amount += sharded_hash_map_get(workload->map, key, KEY_LENGTH, &value);
+        }
+    }
+    return NULL;
+}
+
+double run_workload(Workload * workload, size_t threads_amount) {
+    struct timespec start, stop;
+    pthread_t * threads = malloc(sizeof(pthread_t) * threads_amount);
+    WorkerArgument * arguments = malloc(sizeof(WorkerArgument) * threads_amount);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < threads_amount; i++) {
+        arguments[i].workload = workload;
+        arguments[i].random_state = 0x9e3779b97f4a7c15ULL * (i + 1);
+        arguments[i].found_amount = 0;
+        pthread_create(&threads[i], NULL, workload_worker, &arguments[i]);
+    }
+    for (size_t i = 0; i < threads_amount; i++) pthread_join(threads[i], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    free(threads);
+    free(arguments);
+    return elapsed_seconds(start, stop);
+}
+
+// Benchmarks
+
+void sharded_hash_map_scaling_benchmark(const char * name, unsigned writes_percentage, size_t operations, size_t max_threads_amount) {
+    char * keys = malloc(KEYS_AMOUNT * KEY_LENGTH);
+    for (size_t i = 0; i < KEYS_AMOUNT; i++) snprintf(keys + i * KEY_LENGTH, KEY_LENGTH, "key-%011zu", i);
+    printf("%s (%u%% writes)\n", name, writes_percentage);
+    printf("%8s %18s %18s\n", "threads", "1 shard Mops/s", "64 shards Mops/s");
+    for (size_t threads_amount = 1; threads_amount <= max_threads_amount; threads_amount *= 2) {
+        double throughput[2];
+        size_t shards_amounts[2] = { 1, 64 };
+        for (size_t i = 0; i < 2; i++) {
+            Workload workload = { sharded_hash_map_create(shards_amounts[i]), keys, operations / threads_amount, writes_percentage };
+            // Pre-populate half of the keys (so the reads are a mix of hits and misses)
+            for (size_t j = 0; j < KEYS_AMOUNT; j += 2) sharded_hash_map_put(workload.map, keys + j * KEY_LENGTH, KEY_LENGTH, NULL, NULL);
+            double seconds = run_workload(&workload, threads_amount);
+            throughput[i] = (double) (workload.operations_per_thread * threads_amount) / seconds / 1e6;
+            sharded_hash_map_destroy(workload.map);
+        }
+        printf("%8zu %18.2f %18.2f\n", threads_amount, throughput[0], throughput[1]);
+    }
+    free(keys);
+}
+
+// Benchmarks runner (the arguments optionally override the amount of operations and the maximum amount of threads)
+
+int main(int argc, char * argv[]) {
+    size_t operations = (argc > 1) ? strtoull(argv[1], NULL, 10) : 8000000;
+    size_t max_threads_amount = (argc > 2) ? strtoull(argv[2], NULL, 10) : 32;
+    sharded_hash_map_scaling_benchmark("read-heavy", 1, operations, max_threads_amount);
+    sharded_hash_map_scaling_benchmark("write-heavy", 50, operations, max_threads_amount);
+}
@@ -0,0 +1,272 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "sharded-hash-map.h"
+#include "error-reporter.h"
+
+// Assertion snippet (not abstracted away for piece of code portability)
+void assert(int condition, char message[]) {
+    if (condition != 1) {
+        printf("%s\n", message);
+        exit(1);
+    }
+}
+
+// Unit testing
+
+void sharded_hash_map_put_get_remove_test() {
+    printf("*** Running test '%s'\n", __func__);
+    ShardedHashMap * map = sharded_hash_map_create(3);
+    assert(map != NULL, "The 'map' must not be null");
+    void * value = NULL;
+    assert(!sharded_hash_map_get(map, "apple", 5, &value), "A missing key must not be found");
+    assert(sharded_hash_map_put(map, "apple", 5, (void *) 1, &value), "The key must be stored");
+    assert(value == NULL, "A new key must have no previous value");
+    assert(sharded_hash_map_put(map, "", 0, (void *) 2, NULL), "An empty key must be stored");
+    assert(sharded_hash_map_put(map, "apple", 5, (void *) 3, &value), "The value must be replaced");
+    assert((uintptr_t) value == 1, "The previous value must be returned");
+    assert(sharded_hash_map_size(map) == 2, "The size must match the amount of keys");
+    assert(sharded_hash_map_get(map, "apple", 5, &value) && (uintptr_t) value == 3, "The new value must be found");
+    assert(sharded_hash_map_get(map, "", 0, &value) && (uintptr_t) value == 2, "The empty key must be found");
+    assert(!sharded_hash_map_get(map, "apples", 6, &value), "A longer key must not match");
+    assert(sharded_hash_map_remove(map, "apple", 5, &value) && (uintptr_t) value == 3, "The key must be removed");
+    assert(!sharded_hash_map_remove(map, "apple", 5, NULL), "A removed key must not be removed again");
+    assert(!sharded_hash_map_get(map, "apple", 5, &value), "A removed key must not be found");
+    assert(sharded_hash_map_size(map) == 1, "The size must be decreased by the removal");
+    sharded_hash_map_destroy(map);
+}
+
+void sharded_hash_map_growth_test() {
+    printf("*** Running test '%s'\n", __func__);
+    ShardedHashMap * map = sharded_hash_map_create(1);
+    char key[32];
+    // Insert and remove many keys (so the table grows, and the tombstones are cleaned up while rebuilding)
+    for (uintptr_t i = 0; i < 20000; i++) {
+        int length = sprintf(key, "key-%lu", (unsigned long) i);
+        assert(sharded_hash_map_put(map, key, (size_t) length, (void *) (i + 1), NULL), "The key must be stored");
+        if (i % 3 == 0) assert(sharded_hash_map_remove(map, key, (size_t) length, NULL), "The key must be removed");
+    }
+    sharded_hash_map_reclaim(map);
+    assert(sharded_hash_map_size(map) == 20000 - 6667, "The size must match the amount of kept keys");
+    for (uintptr_t i = 0; i < 20000; i++) {
+        int length = sprintf(key, "key-%lu", (unsigned long) i);
+        void * value = NULL;
+        bool is_found = sharded_hash_map_get(map, key, (size_t) length, &value);
+        assert(is_found == (i % 3 != 0), "Only the kept keys must be found");
+        assert(!is_found || (uintptr_t) value == i + 1, "The kept keys must keep their values");
+    }
+    sharded_hash_map_destroy(map);
+}
+
+void * counting_compute(const char * key, size_t key_length, void * context) {
+    (void) key;
+    atomic_fetch_add((atomic_size_t *) context, 1);
+    return (void *) (uintptr_t) (key_length + 100);
+}
+
+void * null_compute(const char * key, size_t key_length, void * context) {
+    (void) key;
+    (void) key_length;
+    (void) context;
+    return NULL;
+}
+
+void sharded_hash_map_get_or_compute_test() {
+    printf("*** Running test '%s'\n", __func__);
+    ShardedHashMap * map = sharded_hash_map_create_default();
+    atomic_size_t computed_amount;
+    atomic_init(&computed_amount, 0);
+    void * value = sharded_hash_map_get_or_compute(map, "pear", 4, counting_compute, &computed_amount);
+    assert((uintptr_t) value == 104, "The missing value must be computed");
+    value = sharded_hash_map_get_or_compute(map, "pear", 4, counting_compute, &computed_amount);
+    assert((uintptr_t) value == 104, "The existing value must be returned");
+    assert(atomic_load(&computed_amount) == 1, "The value must be computed only once");
+    assert(sharded_hash_map_get_or_compute(map, "plum", 4, null_compute, NULL) == NULL, "A 'NULL' value must be returned");
+    assert(!sharded_hash_map_get(map, "plum", 4, &value), "A 'NULL' computed value must not be stored");
+    sharded_hash_map_destroy(map);
+}
+
+void sharded_hash_map_invalid_arguments_test() {
+    printf("*** Running test '%s'\n", __func__);
+    assert(sharded_hash_map_create(0) == NULL, "A zero shards amount must be rejected");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "The error must be an invalid argument");
+    void * value;
+    assert(!sharded_hash_map_get(NULL, "a", 1, &value), "A 'NULL' map must be rejected");
+    assert(error_reporter_last_code() == ERROR_CODE_NULL_ARGUMENT, "The error must be a null argument");
+    ShardedHashMap * map = sharded_hash_map_create_default();
+    assert(!sharded_hash_map_put(map, NULL, 1, NULL, NULL), "A 'NULL' key must be rejected");
+    assert(sharded_hash_map_get_or_compute(map, "a", 1, NULL, NULL) == NULL, "A 'NULL' compute must be rejected");
+    assert(sharded_hash_map_size(NULL) == 0, "A 'NULL' map must have no keys");
+    sharded_hash_map_destroy(map);
+    sharded_hash_map_destroy(NULL);
+}
+
+// Readers look keys up while writers keep replacing and removing them, where every found value must be the one of
+// its key (the value encodes the key index), and concurrent computes of the same keys must happen once per key
+#define THREADS_AMOUNT 8
+#define KEYS_AMOUNT 512
+#define OPERATIONS_PER_THREAD 40000
+
+typedef struct worker_state {
+    ShardedHashMap * map;
+    size_t worker_index;
+    atomic_size_t * computed_amount;
+    bool is_consistent;
+} WorkerState;
+
+void * index_compute(const char * key, size_t key_length, void * context) {
+    (void) key_length;
+    atomic_fetch_add((atomic_size_t *) context, 1);
+    return (void *) (uintptr_t) ((strtoul(key + 2, NULL, 10) << 16) | 1);
+}
+
+void * sharded_hash_map_worker(void * argument) {
+    WorkerState * worker = argument;
+    char key[32];
+    uint64_t random_state = 0x9e3779b97f4a7c15ULL * (worker->worker_index + 1);
+    for (size_t i = 0; i < OPERATIONS_PER_THREAD; i++) {
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 7;
+        random_state ^= random_state << 17;
+        uintptr_t key_index = random_state % KEYS_AMOUNT;
+        int length = sprintf(key, "k-%lu", (unsigned long) key_index);
+        void * value = NULL;
+        if (worker->worker_index < 2 && key_index % 2 == 0) {
+            // Writers (only on the even keys): replace with a new version, or remove
+            uintptr_t version = (i % 1000) + 1;
+            if (random_state % 4 == 0) {
+                sharded_hash_map_remove(worker->map, key, (size_t) length, NULL);
+            } else {
+                sharded_hash_map_put(worker->map, key, (size_t) length, (void *) ((key_index << 16) | version), NULL);
+            }
+        } else if (key_index % 2 == 1) {
+            // Computes (only on the odd keys, which are never written otherwise)
+            value = sharded_hash_map_get_or_compute(worker->map, key, (size_t) length, index_compute, worker->computed_amount);
+            if ((uintptr_t) value >> 16 != key_index) worker->is_consistent = false;
+        } else if (sharded_hash_map_get(worker->map, key, (size_t) length, &value)) {
+            if ((uintptr_t) value >> 16 != key_index) worker->is_consistent = false;
+        }
+    }
+    return NULL;
+}
+
+void sharded_hash_map_threads_test() {
+    printf("*** Running test '%s'\n", __func__);
+    ShardedHashMap * map = sharded_hash_map_create(4);
+    atomic_size_t computed_amount;
+    atomic_init(&computed_amount, 0);
+    pthread_t threads[THREADS_AMOUNT];
+    WorkerState workers[THREADS_AMOUNT];
+    for (size_t i = 0; i < THREADS_AMOUNT; i++) {
+        workers[i].map = map;
+        workers[i].worker_index = i;
+        workers[i].computed_amount = &computed_amount;
+        workers[i].is_consistent = true;
+        pthread_create(&threads[i], NULL, sharded_hash_map_worker, &workers[i]);
+    }
+    for (size_t i = 0; i < THREADS_AMOUNT; i++) {
+        pthread_join(threads[i], NULL);
+        assert(workers[i].is_consistent, "Every found value must belong to its key");
+    }
+    assert(atomic_load(&computed_amount) <= KEYS_AMOUNT / 2, "Every odd key must be computed at most once");
+    sharded_hash_map_destroy(map);
+}
+
+// A cache under churn: readers keep looking keys up while a writer keeps removing and storing them again, so the
+// retired memory must be freed while the map is in use (no quiescent point ever comes)
+#define CHURN_READERS_AMOUNT 4
+#define CHURN_KEYS_AMOUNT 256
+#define CHURN_ROUNDS_AMOUNT 400
+
+typedef struct churn_reader {
+    ShardedHashMap * map;
+    atomic_bool * is_running;
+    bool is_consistent;
+} ChurnReader;
+
+void * churn_reader_worker(void * argument) {
+    ChurnReader * reader = argument;
+    char key[32];
+    for (uintptr_t i = 0; atomic_load(reader->is_running); i++) {
+        uintptr_t key_index = i % CHURN_KEYS_AMOUNT;
+        int length = sprintf(key, "churn-%lu", (unsigned long) key_index);
+        void * value = NULL;
+        if (sharded_hash_map_get(reader->map, key, (size_t) length, &value) && (uintptr_t) value != key_index + 1) {
+            reader->is_consistent = false;
+        }
+    }
+    return NULL;
+}
+
+void sharded_hash_map_churn_reclaim_test() {
+    printf("*** Running test '%s'\n", __func__);
+    ShardedHashMap * map = sharded_hash_map_create(4);
+    char key[32];
+    atomic_bool is_running;
+    atomic_init(&is_running, true);
+    pthread_t threads[CHURN_READERS_AMOUNT];
+    ChurnReader readers[CHURN_READERS_AMOUNT];
+    for (size_t i = 0; i < CHURN_READERS_AMOUNT; i++) {
+        readers[i].map = map;
+        readers[i].is_running = &is_running;
+        readers[i].is_consistent = true;
+        pthread_create(&threads[i], NULL, churn_reader_worker, &readers[i]);
+    }
+    size_t removed_amount = 0;
+    size_t max_retired_amount = 0;
+    for (size_t round = 0; round < CHURN_ROUNDS_AMOUNT; round++) {
+        for (uintptr_t i = 0; i < CHURN_KEYS_AMOUNT; i++) {
+            int length = sprintf(key, "churn-%lu", (unsigned long) i);
+            sharded_hash_map_put(map, key, (size_t) length, (void *) (i + 1), NULL);
+            removed_amount += sharded_hash_map_remove(map, key, (size_t) length, NULL);
+        }
+        size_t retired_amount = sharded_hash_map_retired_amount(map);
+        if (retired_amount > max_retired_amount) max_retired_amount = retired_amount;
+    }
+    atomic_store(&is_running, false);
+    for (size_t i = 0; i < CHURN_READERS_AMOUNT; i++) {
+        pthread_join(threads[i], NULL);
+        assert(readers[i].is_consistent, "Every found value must belong to its key");
+    }
+    assert(removed_amount == CHURN_KEYS_AMOUNT * CHURN_ROUNDS_AMOUNT, "Every stored key must be removed");
+    // A preempted reader delays the reclamation, but never blocks it, so only a fraction of the removals is retired
+    assert(max_retired_amount < removed_amount / 4, "The retired memory must be freed while the map is in use");
+    // Without readers, a few more writes free everything but the last rounds
+    for (uintptr_t i = 0; i < CHURN_KEYS_AMOUNT; i++) {
+        int length = sprintf(key, "churn-%lu", (unsigned long) i);
+        sharded_hash_map_put(map, key, (size_t) length, (void *) (i + 1), NULL);
+        sharded_hash_map_remove(map, key, (size_t) length, NULL);
+    }
+    assert(sharded_hash_map_retired_amount(map) < 4 * 3 * 64, "The retired memory of an idle map must be bounded");
+    sharded_hash_map_reclaim(map);
+    assert(sharded_hash_map_retired_amount(map) == 0, "Reclaiming must free all the retired memory");
+    sharded_hash_map_destroy(map);
+}
+
+// Tests runner
+
+int main() {
+    fclose(stderr);
+    sharded_hash_map_put_get_remove_test();
+    sharded_hash_map_growth_test();
+    sharded_hash_map_get_or_compute_test();
+    sharded_hash_map_invalid_arguments_test();
+    sharded_hash_map_threads_test();
+    sharded_hash_map_churn_reclaim_test();
+}
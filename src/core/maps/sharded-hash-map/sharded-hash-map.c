@@ -0,0 +1,591 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * A Sharded Concurrent Hash Map Implementation (with seqlock protected open addressing tables).
+ *
+ * ### Explanation ###
+ *
+ * A single lock around a hash table serializes every thread, so the map is split in shards, each one with its own
+ * lock and its own table, and the shard of a key is picked by the high bits of its 64 bit FNV-1a hash (the low bits
+ * pick the slot inside the shard table, so both choices are independent).
+ *
+ * Every shard table uses open addressing with linear probing: the entries live in a single array (no allocation per
+ * entry, and the probes walk consecutive memory), removed entries leave a tombstone behind (so the probe sequences of
+ * other keys are not broken), and the table is rebuilt once the used slots (including tombstones) reach half of it.
+ *
+ * ### Seqlock ###
+ *
+ * The writers of a shard take its mutex, but the readers never lock (nor write any shared memory but the reader slot
+ * of their own thread, so they never invalidate each other cache lines), instead every shard has a sequence number:
+ *
+ * 1. A writer makes the sequence odd, changes the table, and makes the sequence even again.
+ * 2. A reader reads the sequence (retrying while odd), looks the key up, and reads the sequence again.
+ * 3. If both reads match, no writer changed the shard meanwhile, and the result is valid, otherwise it is retried.
+ *
+ * After many failed attempts (a continuous stream of writers) the reader falls back to the shard lock, so the amount
+ * of work of a read is always bounded.
+ *
+ * ### Retired Memory ###
+ *
+ * An optimistic reader might still be reading a key that was just removed (or a table that was just replaced), so
+ * the writers never free that memory right away, but retire it to the shard lists, tagged with the map epoch. All the
+ * reads of a reader are atomic loads of pointers to memory that is never freed while the reader runs, so a torn read
+ * is always harmless (and discarded by the sequence check).
+ *
+ * The retired memory is freed while the map is in use with an epoch scheme (as in "lock-free-hash-map.c"), but as the
+ * readers have no handle, every thread announces its reads in one of the map reader slots (picked once per thread),
+ * which count the readers inside each epoch parity:
+ *
+ * 1. A reader increments the counter of the current epoch parity in its slot, and checks the epoch did not change
+ *    meanwhile (otherwise it retries), then it probes, and finally decrements the counter.
+ * 2. Once a shard retired enough memory, its writer advances the epoch from "e" to "e + 1", but only if no reader is
+ *    left in the parity of "e - 1" (which the new epoch reuses).
+ * 3. The memory retired in epoch "r" is freed once the epoch is "r + 2", as every reader that might still hold it
+ *    entered in "r - 1" or "r", and both parities were empty when the epoch advanced.
+ *
+ * Every lookup is bounded, so the epoch keeps advancing under any amount of readers, and the retired memory of a shard
+ * stays bounded by a few reclamation rounds (instead of growing until the map is destroyed).
+ *
+ * ### References ###
+ *
+ * - https://www.hpl.hp.com/techreports/2012/HPL-2012-68.pdf (Boehm, Can Seqlocks Get Along With Programming Language Memory Models?)
+ * - https://www.kernel.org/doc/html/latest/locking/seqlock.html (Linux, Sequence Counters and Sequential Locks)
+ * - https://en.wikipedia.org/wiki/Linear_probing
+ * - https://www.cl.cam.ac.uk/techreports/UCAM-CL-TR-579.pdf (Fraser, Practical Lock-Freedom, Epoch-Based Reclamation)
+ * - https://lwn.net/Articles/202847/ (McKenney, Sleepable RCU, per-CPU counters of both parities)
+ */
+
+// Imports & Headers
+
+#include <stdlib.h>         // For "malloc", "aligned_alloc", "free" (memory management)
+#include <stdint.h>         // For "uint64_t", "SIZE_MAX" (more integer types)
+#include <string.h>         // For "memcpy", "memcmp" (copying and comparing keys)
+#include <stdatomic.h>      // For "atomic_size_t", "atomic_thread_fence" (seqlocks)
+#include <pthread.h>        // For "pthread_mutex_t" (writers locks)
+#include "sharded-hash-map.h"
+#include "fnv1a.h"          // For "hashes_fnv1a_hash64_bytes_into" (hashing keys)
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+
+// Default implementation values
+
+#define CACHE_LINE_SIZE 64                  // The size of a cache line (to avoid false sharing between shards)
+#define DEFAULT_SHARDS_AMOUNT 64            // The amount of shards of the default map
+#define INITIAL_TABLE_CAPACITY 16           // The amount of slots of a new shard table
+#define OPTIMISTIC_ATTEMPTS 64              // The amount of optimistic reads before falling back to the shard lock
+#define READER_SLOTS_AMOUNT 64              // The amount of reader slots (every thread announces its reads in one)
+#define RECLAIM_THRESHOLD 64                // The amount of retired memory of a shard before trying to free it
+
+// Structures
+
+typedef struct map_key {
+    size_t length;                          // The length of the key
+    struct map_key * next_retired;          // The next key of the retired list (once removed)
+    size_t retired_epoch;                   // The epoch when the key was removed
+    char bytes[];                           // The bytes of the key (copied from the client)
+} MapKey;
+
+typedef struct entry {
+    _Atomic(MapKey *) key;                  // The key, 'NULL' if the slot is empty, or the tombstone if removed
+    atomic_uint_fast64_t hash;              // The hash of the key (compared before the key bytes)
+    _Atomic(void *) value;                  // The value associated to the key
+} Entry;
+
+typedef struct table {
+    size_t capacity;                        // The amount of slots (always a power of two)
+    struct table * next_retired;            // The next table of the retired list (once replaced)
+    size_t retired_epoch;                   // The epoch when the table was replaced
+    Entry entries[];                        // The slots of the table
+} Table;
+
+typedef struct shard {
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t sequence;   // Even if stable, odd while a writer changes the shard
+    _Atomic(Table *) table;                             // The current table of the shard
+    atomic_size_t size;                                 // The amount of keys of the shard
+    size_t used_amount;                                 // The amount of keys plus tombstones (writers only)
+    pthread_mutex_t lock;                               // Serializes the writers of the shard
+    MapKey * retired_keys;                              // The removed keys (maybe still read by readers, newest first)
+    Table * retired_tables;                             // The replaced tables (maybe still read by readers, newest first)
+    size_t retired_amount;                              // The amount of retired keys and tables
+} Shard;
+
+typedef struct reader_slot {
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t active[2];  // The amount of readers inside an epoch of each parity
+} ReaderSlot;
+
+struct sharded_hash_map {
+    Shard * shards;                         // The shards (each one on its own cache lines)
+    size_t shards_amount;                   // The amount of shards (always a power of two)
+    unsigned shard_shift;                   // The shift of the hash high bits picking the shard (plus one)
+    atomic_size_t epoch;                    // The reclamation epoch (only advanced by the writers)
+    ReaderSlot * reader_slots;              // The readers announcements (each one on its own cache line)
+};
+
+// The marker of a removed entry (never dereferenced)
+
+static MapKey tombstone;
+
+// The reader slot of the calling thread (picked on its first lookup, the same one for every map)
+
+static atomic_size_t next_reader_slot = 0;
+static _Thread_local size_t reader_slot = SIZE_MAX;
+
+// Definition (to be able to use methods before declaring them, to follow up the top-bottom code style)
+
+Shard * sharded_hash_map_shard(ShardedHashMap * map, uint64_t hash);
+bool sharded_hash_map_read_optimistic(Shard * shard, uint64_t hash, const char * key, size_t key_length, void ** value, bool * is_found);
+Entry * sharded_hash_map_find_entry(Table * table, uint64_t hash, const char * key, size_t key_length, Entry ** free_entry);
+bool sharded_hash_map_insert_locked(ShardedHashMap * map, Shard * shard, uint64_t hash, const char * key, size_t key_length, void * value);
+Table * sharded_hash_map_table_create(size_t capacity);
+void sharded_hash_map_write_begin(Shard * shard);
+void sharded_hash_map_write_end(Shard * shard);
+atomic_size_t * sharded_hash_map_read_begin(ShardedHashMap * map);
+void sharded_hash_map_read_end(atomic_size_t * counter);
+size_t sharded_hash_map_retire_epoch(ShardedHashMap * map);
+void sharded_hash_map_collect(ShardedHashMap * map, Shard * shard);
+bool sharded_hash_map_validate(ShardedHashMap * map, const char * key, size_t key_length, const char function[]);
+
+// Implementation
+
+ShardedHashMap * sharded_hash_map_create_default() {
+    return sharded_hash_map_create(DEFAULT_SHARDS_AMOUNT);
+}
+
+ShardedHashMap * sharded_hash_map_create(size_t shards_amount) {
+    if (shards_amount == 0 || shards_amount > ((size_t) 1 << 16)) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The shards amount must be between 1 and 65536");
+        return NULL;
+    }
+    unsigned shard_bits = 0;
+    while (((size_t) 1 << shard_bits) < shards_amount) shard_bits++;
+    shards_amount = (size_t) 1 << shard_bits;
+    ShardedHashMap * map = malloc(sizeof(ShardedHashMap));
+    if (map == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'map'");
+        return NULL;
+    }
+    map->reader_slots = aligned_alloc(CACHE_LINE_SIZE, sizeof(ReaderSlot) * READER_SLOTS_AMOUNT);
+    if (map->reader_slots == NULL) {
+        free(map);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'reader_slots'");
+        return NULL;
+    }
+    for (size_t i = 0; i < READER_SLOTS_AMOUNT; i++) {
+        atomic_init(&map->reader_slots[i].active[0], 0);
+        atomic_init(&map->reader_slots[i].active[1], 0);
+    }
+    atomic_init(&map->epoch, 2);
+    map->shards = aligned_alloc(CACHE_LINE_SIZE, sizeof(Shard) * shards_amount);
+    if (map->shards == NULL) {
+        free(map->reader_slots);
+        free(map);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'shards'");
+        return NULL;
+    }
+    size_t initialized_amount = 0;
+    for (; initialized_amount < shards_amount; initialized_amount++) {
+        Shard * shard = &map->shards[initialized_amount];
+        Table * table = sharded_hash_map_table_create(INITIAL_TABLE_CAPACITY);
+        if (table == NULL) break;
+        atomic_init(&shard->sequence, 0);
+        atomic_init(&shard->table, table);
+        atomic_init(&shard->size, 0);
+        shard->used_amount = 0;
+        pthread_mutex_init(&shard->lock, NULL);
+        shard->retired_keys = NULL;
+        shard->retired_tables = NULL;
+        shard->retired_amount = 0;
+    }
+    if (initialized_amount < shards_amount) {
+        for (size_t i = 0; i < initialized_amount; i++) {
+            free(atomic_load(&map->shards[i].table));
+            pthread_mutex_destroy(&map->shards[i].lock);
+        }
+        free(map->shards);
+        free(map->reader_slots);
+        free(map);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'table'");
+        return NULL;
+    }
+    map->shards_amount = shards_amount;
+    // The shift is split in two, so a single shard (zero bits) does not need a full width shift (undefined behavior)
+    map->shard_shift = 63 - shard_bits;
+    return map;
+}
+
+void sharded_hash_map_destroy(ShardedHashMap * map) {
+    if (map == NULL) return;
+    sharded_hash_map_reclaim(map);
+    for (size_t i = 0; i < map->shards_amount; i++) {
+        Shard * shard = &map->shards[i];
+        Table * table = atomic_load(&shard->table);
+        for (size_t j = 0; j < table->capacity; j++) {
+            MapKey * key = atomic_load_explicit(&table->entries[j].key, memory_order_relaxed);
+            if (key != NULL && key != &tombstone) free(key);
+        }
+        free(table);
+        pthread_mutex_destroy(&shard->lock);
+    }
+    free(map->shards);
+    free(map->reader_slots);
+    free(map);
+}
+
+size_t sharded_hash_map_size(ShardedHashMap * map) {
+    if (map == NULL) return 0;
+    size_t size = 0;
+    for (size_t i = 0; i < map->shards_amount; i++) {
+        size += atomic_load_explicit(&map->shards[i].size, memory_order_relaxed);
+    }
+    return size;
+}
+
+bool sharded_hash_map_get(ShardedHashMap * map, const char * key, size_t key_length, void ** value) {
+    if (!sharded_hash_map_validate(map, key, key_length, __func__)) return false;
+    if (value == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to get into a 'NULL' value");
+        return false;
+    }
+    uint64_t hash;
+    hashes_fnv1a_hash64_bytes_into(key, key_length, &hash);
+    Shard * shard = sharded_hash_map_shard(map, hash);
+    // Step 1: Try optimistically (without locking) a bounded amount of times, announced so nothing is freed meanwhile
+    bool is_found = false;
+    bool is_consistent = false;
+    atomic_size_t * counter = sharded_hash_map_read_begin(map);
+    for (size_t attempt = 0; attempt < OPTIMISTIC_ATTEMPTS && !is_consistent; attempt++) {
+        is_consistent = sharded_hash_map_read_optimistic(shard, hash, key, key_length, value, &is_found);
+    }
+    sharded_hash_map_read_end(counter);
+    if (is_consistent) return is_found;
+    // Step 2: Fall back to the shard lock (the writers kept changing the shard)
+    pthread_mutex_lock(&shard->lock);
+    Entry * entry = sharded_hash_map_find_entry(atomic_load_explicit(&shard->table, memory_order_relaxed), hash, key, key_length, NULL);
+    if (entry != NULL) (* value) = atomic_load_explicit(&entry->value, memory_order_relaxed);
+    pthread_mutex_unlock(&shard->lock);
+    return entry != NULL;
+}
+
+bool sharded_hash_map_put(ShardedHashMap * map, const char * key, size_t key_length, void * value, void ** previous_value) {
+    if (!sharded_hash_map_validate(map, key, key_length, __func__)) return false;
+    uint64_t hash;
+    hashes_fnv1a_hash64_bytes_into(key, key_length, &hash);
+    Shard * shard = sharded_hash_map_shard(map, hash);
+    pthread_mutex_lock(&shard->lock);
+    Entry * entry = sharded_hash_map_find_entry(atomic_load_explicit(&shard->table, memory_order_relaxed), hash, key, key_length, NULL);
+    bool is_stored = true;
+    if (entry != NULL) {
+        // Replace the value of the existing key
+        if (previous_value != NULL) (* previous_value) = atomic_load_explicit(&entry->value, memory_order_relaxed);
+        sharded_hash_map_write_begin(shard);
+        atomic_store_explicit(&entry->value, value, memory_order_relaxed);
+        sharded_hash_map_write_end(shard);
+    } else {
+        if (previous_value != NULL) (* previous_value) = NULL;
+        is_stored = sharded_hash_map_insert_locked(map, shard, hash, key, key_length, value);
+    }
+    sharded_hash_map_collect(map, shard);
+    pthread_mutex_unlock(&shard->lock);
+    return is_stored;
+}
+
+void * sharded_hash_map_get_or_compute(ShardedHashMap * map, const char * key, size_t key_length, ShardedHashMapCompute compute, void * context) {
+    if (!sharded_hash_map_validate(map, key, key_length, __func__)) return NULL;
+    if (compute == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to compute with a 'NULL' function");
+        return NULL;
+    }
+    // Step 1: Look the key up without locking (the common case of a cache)
+    void * value = NULL;
+    if (sharded_hash_map_get(map, key, key_length, &value)) return value;
+    // Step 2: Check again under the lock (another writer might have stored it meanwhile)
+    uint64_t hash;
+    hashes_fnv1a_hash64_bytes_into(key, key_length, &hash);
+    Shard * shard = sharded_hash_map_shard(map, hash);
+    pthread_mutex_lock(&shard->lock);
+    Entry * entry = sharded_hash_map_find_entry(atomic_load_explicit(&shard->table, memory_order_relaxed), hash, key, key_length, NULL);
+    if (entry != NULL) {
+        value = atomic_load_explicit(&entry->value, memory_order_relaxed);
+    } else {
+        // Step 3: Compute the value outside of the write section (so the readers are not blocked meanwhile)
+        value = compute(key, key_length, context);
+        if (value != NULL && !sharded_hash_map_insert_locked(map, shard, hash, key, key_length, value)) value = NULL;
+    }
+    sharded_hash_map_collect(map, shard);
+    pthread_mutex_unlock(&shard->lock);
+    return value;
+}
+
+bool sharded_hash_map_remove(ShardedHashMap * map, const char * key, size_t key_length, void ** previous_value) {
+    if (!sharded_hash_map_validate(map, key, key_length, __func__)) return false;
+    uint64_t hash;
+    hashes_fnv1a_hash64_bytes_into(key, key_length, &hash);
+    Shard * shard = sharded_hash_map_shard(map, hash);
+    pthread_mutex_lock(&shard->lock);
+    Entry * entry = sharded_hash_map_find_entry(atomic_load_explicit(&shard->table, memory_order_relaxed), hash, key, key_length, NULL);
+    if (entry != NULL) {
+        if (previous_value != NULL) (* previous_value) = atomic_load_explicit(&entry->value, memory_order_relaxed);
+        MapKey * removed_key = atomic_load_explicit(&entry->key, memory_order_relaxed);
+        sharded_hash_map_write_begin(shard);
+        atomic_store_explicit(&entry->key, &tombstone, memory_order_relaxed);
+        atomic_store_explicit(&entry->value, NULL, memory_order_relaxed);
+        sharded_hash_map_write_end(shard);
+        // The key is retired instead of freed (a reader might still be comparing it)
+        removed_key->retired_epoch = sharded_hash_map_retire_epoch(map);
+        removed_key->next_retired = shard->retired_keys;
+        shard->retired_keys = removed_key;
+        shard->retired_amount++;
+        atomic_fetch_sub_explicit(&shard->size, 1, memory_order_relaxed);
+    }
+    sharded_hash_map_collect(map, shard);
+    pthread_mutex_unlock(&shard->lock);
+    return entry != NULL;
+}
+
+void sharded_hash_map_reclaim(ShardedHashMap * map) {
+    if (map == NULL) return;
+    for (size_t i = 0; i < map->shards_amount; i++) {
+        Shard * shard = &map->shards[i];
+        pthread_mutex_lock(&shard->lock);
+        while (shard->retired_keys != NULL) {
+            MapKey * next = shard->retired_keys->next_retired;
+            free(shard->retired_keys);
+            shard->retired_keys = next;
+        }
+        while (shard->retired_tables != NULL) {
+            Table * next = shard->retired_tables->next_retired;
+            free(shard->retired_tables);
+            shard->retired_tables = next;
+        }
+        shard->retired_amount = 0;
+        pthread_mutex_unlock(&shard->lock);
+    }
+}
+
+size_t sharded_hash_map_retired_amount(ShardedHashMap * map) {
+    if (map == NULL) return 0;
+    size_t retired_amount = 0;
+    for (size_t i = 0; i < map->shards_amount; i++) {
+        Shard * shard = &map->shards[i];
+        pthread_mutex_lock(&shard->lock);
+        retired_amount += shard->retired_amount;
+        pthread_mutex_unlock(&shard->lock);
+    }
+    return retired_amount;
+}
+
+// Utilities
+
+// Picks the shard of a hash by its high bits
+Shard * sharded_hash_map_shard(ShardedHashMap * map, uint64_t hash) {
+    return &map->shards[(hash >> map->shard_shift) >> 1];
+}
+
+// Looks the key up without locking, returning whether the read was consistent (no writer changed the shard meanwhile)
+bool sharded_hash_map_read_optimistic(Shard * shard, uint64_t hash, const char * key, size_t key_length, void ** value, bool * is_found) {
+    size_t start_sequence = atomic_load_explicit(&shard->sequence, memory_order_acquire);
+    if (start_sequence & 1) return false;
+    Table * table = atomic_load_explicit(&shard->table, memory_order_acquire);
+    size_t mask = table->capacity - 1;
+    (* is_found) = false;
+    // The probe is bounded by the capacity (a torn view might not have any empty slot)
+    for (size_t i = 0; i < table->capacity; i++) {
+        Entry * entry = &table->entries[(hash + i) & mask];
+        MapKey * entry_key = atomic_load_explicit(&entry->key, memory_order_acquire);
+        if (entry_key == NULL) break;
+        if (entry_key == &tombstone || atomic_load_explicit(&entry->hash, memory_order_relaxed) != hash) continue;
+        if (entry_key->length == key_length && (key_length == 0 || memcmp(entry_key->bytes, key, key_length) == 0)) {
+            (* value) = atomic_load_explicit(&entry->value, memory_order_relaxed);
+            (* is_found) = true;
+            break;
+        }
+    }
+    // Order the reads above before the second sequence read (pairs with the release fence of the writers)
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&shard->sequence, memory_order_relaxed) == start_sequence;
+}
+
+// Finds the entry of the key (only called by writers, under the shard lock), and optionally the first reusable slot
+Entry * sharded_hash_map_find_entry(Table * table, uint64_t hash, const char * key, size_t key_length, Entry ** free_entry) {
+    size_t mask = table->capacity - 1;
+    if (free_entry != NULL) (* free_entry) = NULL;
+    for (size_t i = 0; i < table->capacity; i++) {
+        Entry * entry = &table->entries[(hash + i) & mask];
+        MapKey * entry_key = atomic_load_explicit(&entry->key, memory_order_relaxed);
+        if (entry_key == NULL || entry_key == &tombstone) {
+            if (free_entry != NULL && (* free_entry) == NULL) (* free_entry) = entry;
+            if (entry_key == NULL) return NULL;
+            continue;
+        }
+        if (atomic_load_explicit(&entry->hash, memory_order_relaxed) != hash) continue;
+        if (entry_key->length == key_length && (key_length == 0 || memcmp(entry_key->bytes, key, key_length) == 0)) return entry;
+    }
+    return NULL;
+}
+
+// Inserts a missing key (under the shard lock), rebuilding the table first if it is half used
+bool sharded_hash_map_insert_locked(ShardedHashMap * map, Shard * shard, uint64_t hash, const char * key, size_t key_length, void * value) {
+    // Step 1: Copy the key (before entering the write section, as it is not visible to the readers yet)
+    MapKey * new_key = malloc(sizeof(MapKey) + key_length);
+    if (new_key == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'key'");
+        return false;
+    }
+    new_key->length = key_length;
+    new_key->next_retired = NULL;
+    if (key_length > 0) memcpy(new_key->bytes, key, key_length);
+    // Step 2: Build a new table if needed (twice the keys, and at least four times the keys after the insertion)
+    Table * table = atomic_load_explicit(&shard->table, memory_order_relaxed);
+    Table * new_table = NULL;
+    if ((shard->used_amount + 1) * 2 > table->capacity) {
+        size_t size = atomic_load_explicit(&shard->size, memory_order_relaxed);
+        size_t capacity = INITIAL_TABLE_CAPACITY;
+        while (capacity < (size + 1) * 4) capacity <<= 1;
+        new_table = sharded_hash_map_table_create(capacity);
+        if (new_table == NULL) {
+            free(new_key);
+            error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'table'");
+            return false;
+        }
+        for (size_t i = 0; i < table->capacity; i++) {
+            Entry * entry = &table->entries[i];
+            MapKey * entry_key = atomic_load_explicit(&entry->key, memory_order_relaxed);
+            if (entry_key == NULL || entry_key == &tombstone) continue;
+            uint64_t entry_hash = atomic_load_explicit(&entry->hash, memory_order_relaxed);
+            Entry * free_entry;
+            sharded_hash_map_find_entry(new_table, entry_hash, entry_key->bytes, entry_key->length, &free_entry);
+            atomic_init(&free_entry->hash, entry_hash);
+            atomic_init(&free_entry->value, atomic_load_explicit(&entry->value, memory_order_relaxed));
+            atomic_init(&free_entry->key, entry_key);
+        }
+    }
+    // Step 3: Publish the new table (if any) and the new entry
+    sharded_hash_map_write_begin(shard);
+    if (new_table != NULL) {
+        atomic_store_explicit(&shard->table, new_table, memory_order_release);
+        table->next_retired = shard->retired_tables;
+        shard->retired_tables = table;
+        shard->retired_amount++;
+        table = new_table;
+        shard->used_amount = atomic_load_explicit(&shard->size, memory_order_relaxed);
+    }
+    Entry * free_entry;
+    sharded_hash_map_find_entry(table, hash, key, key_length, &free_entry);
+    if (atomic_load_explicit(&free_entry->key, memory_order_relaxed) == NULL) shard->used_amount++;
+    atomic_store_explicit(&free_entry->hash, hash, memory_order_relaxed);
+    atomic_store_explicit(&free_entry->value, value, memory_order_relaxed);
+    atomic_store_explicit(&free_entry->key, new_key, memory_order_release);
+    sharded_hash_map_write_end(shard);
+    // The replaced table is tagged once it is unlinked (see "sharded_hash_map_retire_epoch")
+    if (new_table != NULL) shard->retired_tables->retired_epoch = sharded_hash_map_retire_epoch(map);
+    atomic_fetch_add_explicit(&shard->size, 1, memory_order_relaxed);
+    return true;
+}
+
+Table * sharded_hash_map_table_create(size_t capacity) {
+    Table * table = malloc(sizeof(Table) + sizeof(Entry) * capacity);
+    if (table == NULL) return NULL;
+    table->capacity = capacity;
+    table->next_retired = NULL;
+    for (size_t i = 0; i < capacity; i++) {
+        atomic_init(&table->entries[i].key, NULL);
+        atomic_init(&table->entries[i].hash, 0);
+        atomic_init(&table->entries[i].value, NULL);
+    }
+    return table;
+}
+
+// Makes the sequence odd (the following writes are ordered after it by the release fence)
+void sharded_hash_map_write_begin(Shard * shard) {
+    size_t sequence = atomic_load_explicit(&shard->sequence, memory_order_relaxed);
+    atomic_store_explicit(&shard->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+// Makes the sequence even again (publishing all the writes of the section)
+void sharded_hash_map_write_end(Shard * shard) {
+    size_t sequence = atomic_load_explicit(&shard->sequence, memory_order_relaxed);
+    atomic_store_explicit(&shard->sequence, sequence + 1, memory_order_release);
+}
+
+// Announces a lookup in the slot of the calling thread, returning the counter to be decremented once it finishes
+atomic_size_t * sharded_hash_map_read_begin(ShardedHashMap * map) {
+    if (reader_slot == SIZE_MAX) reader_slot = atomic_fetch_add_explicit(&next_reader_slot, 1, memory_order_relaxed) % READER_SLOTS_AMOUNT;
+    ReaderSlot * slot = &map->reader_slots[reader_slot];
+    while (true) {
+        // The acquire load orders the advance of the epoch (if read) before the fence below
+        size_t epoch = atomic_load_explicit(&map->epoch, memory_order_acquire);
+        atomic_size_t * counter = &slot->active[epoch & 1];
+        atomic_fetch_add_explicit(counter, 1, memory_order_relaxed);
+        // Either a writer checking the counters sees the increment, or the epoch check below sees its advance
+        atomic_thread_fence(memory_order_seq_cst);
+        if (atomic_load_explicit(&map->epoch, memory_order_relaxed) == epoch) return counter;
+        atomic_fetch_sub_explicit(counter, 1, memory_order_relaxed);
+    }
+}
+
+// Leaves a lookup (every read of the lookup is ordered before it, so the writers can free after seeing it)
+void sharded_hash_map_read_end(atomic_size_t * counter) {
+    atomic_fetch_sub_explicit(counter, 1, memory_order_release);
+}
+
+// Returns the epoch of the memory just unlinked by a writer (the fence orders the unlinking before the epoch read, so
+// every reader that might still hold that memory entered in the returned epoch or before)
+size_t sharded_hash_map_retire_epoch(ShardedHashMap * map) {
+    atomic_thread_fence(memory_order_seq_cst);
+    return atomic_load_explicit(&map->epoch, memory_order_relaxed);
+}
+
+// Advances the epoch if no reader is left in the previous one, and frees the memory of the shard no reader can reach
+void sharded_hash_map_collect(ShardedHashMap * map, Shard * shard) {
+    if (shard->retired_amount < RECLAIM_THRESHOLD) return;
+    // Step 1: Check the readers of the previous epoch parity (the epoch is read before the fence, so a reader missed by
+    // the counters loads is ordered after the fence, and sees the epoch advanced by another writer, then retries)
+    size_t epoch = atomic_load_explicit(&map->epoch, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    size_t active_amount = 0;
+    for (size_t i = 0; i < READER_SLOTS_AMOUNT; i++) {
+        active_amount += atomic_load_explicit(&map->reader_slots[i].active[(epoch + 1) & 1], memory_order_acquire);
+    }
+    // Step 2: Advance the epoch (if another writer advanced it meanwhile, the newer epoch is used)
+    if (active_amount == 0 && atomic_compare_exchange_strong(&map->epoch, &epoch, epoch + 1)) epoch++;
+    // Step 3: Free the memory retired at least two epochs ago (the lists are newest first, so the tail is freed)
+    MapKey ** key_link = &shard->retired_keys;
+    while ((* key_link) != NULL && (* key_link)->retired_epoch + 2 > epoch) key_link = &(* key_link)->next_retired;
+    while ((* key_link) != NULL) {
+        MapKey * next = (* key_link)->next_retired;
+        free(* key_link);
+        (* key_link) = next;
+        shard->retired_amount--;
+    }
+    Table ** table_link = &shard->retired_tables;
+    while ((* table_link) != NULL && (* table_link)->retired_epoch + 2 > epoch) table_link = &(* table_link)->next_retired;
+    while ((* table_link) != NULL) {
+        Table * next = (* table_link)->next_retired;
+        free(* table_link);
+        (* table_link) = next;
+        shard->retired_amount--;
+    }
+}
+
+bool sharded_hash_map_validate(ShardedHashMap * map, const char * key, size_t key_length, const char function[]) {
+    if (map == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, function, "Trying to use a 'NULL' map");
+        return false;
+    }
+    if (key == NULL && key_length > 0) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, function, "Trying to use a 'NULL' key");
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdbool.h>   // For "true", "false" (boolean constants)
+#include <stddef.h>    // For "size_t" (size type)
+
+/* sharded-hash-map.h */
+#ifndef MAPS_SHARDED_HASH_MAP_H
+#define MAPS_SHARDED_HASH_MAP_H
+
+typedef struct sharded_hash_map ShardedHashMap;
+
+/**
+ * Computes the value of a missing key (called at most once per missing key, while its shard is locked).
+ */
+typedef void * (* ShardedHashMapCompute)(const char * key, size_t key_length, void * context);
+
+/**
+ * Creates a concurrent hash map of string keys (copied into the map) to pointer values (owned by the client), with
+ * the default amount of shards (64).
+ *
+ * The returned map must be freed by the client after its usage.
+ *
+ * @return a new map, or {@code NULL} if an error occurred
+ */
+ShardedHashMap * sharded_hash_map_create_default();
+
+/**
+ * Creates a concurrent hash map of string keys (copied into the map) to pointer values (owned by the client).
+ *
+ * Every shard has its own lock and table, so writers of different shards never contend, and readers never lock.
+ *
+ * The returned map must be freed by the client after its usage.
+ *
+ * @param shards_amount the minimum amount of shards (rounded up to a power of two)
+ *
+ * @return a new map, or {@code NULL} if an error occurred
+ */
+ShardedHashMap * sharded_hash_map_create(size_t shards_amount);
+
+/**
+ * Frees the given map and its keys (the values are not freed).
+ *
+ * @param map the map that is about to be freed
+ *
+ * @note no thread must be using the map during its destruction
+ */
+void sharded_hash_map_destroy(ShardedHashMap * map);
+
+/**
+ * Returns the amount of keys stored in the given map (a snapshot, as other threads might be writing meanwhile).
+ *
+ * @param map the map to be checked
+ *
+ * @return the amount of keys, or '0' if the map is {@code NULL}
+ */
+size_t sharded_hash_map_size(ShardedHashMap * map);
+
+/**
+ * Looks up the value of the given key, without taking any lock (optimistically, retrying if a writer changed the
+ * shard meanwhile, and only falling back to the shard lock under a continuous stream of writes), where the only shared
+ * memory written is the reader slot of the calling thread (announcing the lookup, so its memory is not freed meanwhile).
+ *
+ * @param map the map where the key is to be looked up
+ * @param key the bytes of the key
+ * @param key_length the length of the key (an empty key is valid)
+ * @param value where the value is to be stored (if found)
+ *
+ * @return {@code true} if the key was found, {@code false} otherwise (or if an error occurred)
+ */
+bool sharded_hash_map_get(ShardedHashMap * map, const char * key, size_t key_length, void ** value);
+
+/**
+ * Associates the given value to the given key, replacing the previous value (if any).
+ *
+ * @param map the map where the key is to be stored
+ * @param key the bytes of the key
+ * @param key_length the length of the key (an empty key is valid)
+ * @param value the value to be associated
+ * @param previous_value where the replaced value (or {@code NULL} if the key was missing) is to be stored, can be
+ *                       {@code NULL} if not needed
+ *
+ * @return {@code true} if the value was stored, {@code false} if an error occurred
+ */
+bool sharded_hash_map_put(ShardedHashMap * map, const char * key, size_t key_length, void * value, void ** previous_value);
+
+/**
+ * Returns the value of the given key, computing and storing it first if the key is missing (the lookup is lock-free,
+ * and only a missing key takes the shard lock, where it is checked again, so a value is computed at most once).
+ *
+ * @param map the map where the key is to be looked up (or stored)
+ * @param key the bytes of the key
+ * @param key_length the length of the key (an empty key is valid)
+ * @param compute the function computing the value of a missing key (if it returns {@code NULL}, nothing is stored)
+ * @param context the user pointer passed to the compute function
+ *
+ * @return the existing or computed value, or {@code NULL} if nothing was computed or an error occurred
+ */
+void * sharded_hash_map_get_or_compute(ShardedHashMap * map, const char * key, size_t key_length, ShardedHashMapCompute compute, void * context);
+
+/**
+ * Removes the given key from the given map.
+ *
+ * @param map the map where the key is to be removed from
+ * @param key the bytes of the key
+ * @param key_length the length of the key (an empty key is valid)
+ * @param previous_value where the removed value is to be stored, can be {@code NULL} if not needed
+ *
+ * @return {@code true} if the key was removed, {@code false} if it was missing (or an error occurred)
+ */
+bool sharded_hash_map_remove(ShardedHashMap * map, const char * key, size_t key_length, void ** previous_value);
+
+/**
+ * Frees all the memory retired by the writers (the removed keys and the tables replaced while growing), which is
+ * otherwise freed by the writers themselves, once no lock-free reader can be reading it anymore (so calling this
+ * function is never required, it only releases the last retired memory early).
+ *
+ * @param map the map whose retired memory is to be freed
+ *
+ * @note it must only be called at a quiescent point, when no other thread is using the map
+ */
+void sharded_hash_map_reclaim(ShardedHashMap * map);
+
+/**
+ * Returns the amount of retired allocations (removed keys and replaced tables) not freed yet (a snapshot, as other
+ * threads might be writing meanwhile), which stays bounded while the map is in use.
+ *
+ * @param map the map to be checked
+ *
+ * @return the amount of retired allocations, or '0' if the map is {@code NULL}
+ */
+size_t sharded_hash_map_retired_amount(ShardedHashMap * map);
+
+#endif /* MAPS_SHARDED_HASH_MAP_H */
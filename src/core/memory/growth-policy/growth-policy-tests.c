@@ -0,0 +1,76 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdio.h>          // For "printf", "stderr" (printing errors)
+#include <stdlib.h>         // For "exit"
+#include <stdint.h>
+#include "growth-policy.h"
+
+// Assertion snippet (not abstracted away for piece of code portability)
+void assert(int condition, char message[]) {
+    if (condition != 1) {
+        printf("%s\n", message);
+        exit(1);
+    }
+}
+
+// Unit testing
+
+void growth_policy_sequence_index_test() {
+    printf("*** Running test '%s'\n", __func__);
+    size_t index = growth_policy_sequence_index(GROWTH_POLICY_DEFAULT_CAPACITY);
+    assert(growth_policy_next_capacity(&index, 17) == 26, "The default capacity must grow to '26'");
+    assert(growth_policy_next_capacity(&index, 27) == 40, "The next growth must be to '40'");
+    index = growth_policy_sequence_index(0);
+    assert(growth_policy_next_capacity(&index, 1) == 1, "An empty buffer must grow to '1'");
+    index = growth_policy_sequence_index(1);
+    assert(growth_policy_next_capacity(&index, 2) == 2, "A single element buffer must grow to '2'");
+    index = growth_policy_sequence_index(100);
+    assert(growth_policy_next_capacity(&index, 101) == 139, "A custom capacity must grow to the next sequence value");
+    index = growth_policy_sequence_index(130);
+    assert(growth_policy_next_capacity(&index, 131) == 209, "A barely bigger sequence value must be skipped");
+    index = growth_policy_sequence_index(17);
+    assert(growth_policy_next_capacity(&index, 18) == 26, "A sequence capacity must grow to the next sequence value");
+}
+
+void growth_policy_next_capacity_test() {
+    printf("*** Running test '%s'\n", __func__);
+    // Growing one element at a time must follow the whole sequence
+    size_t expected[] = { 1, 2, 4, 7, 11, 17, 26, 40, 61, 92, 139 };
+    size_t index = growth_policy_sequence_index(0);
+    size_t capacity = 0;
+    for (size_t i = 0; i < sizeof(expected) / sizeof(size_t); i++) {
+        capacity = growth_policy_next_capacity(&index, capacity + 1);
+        assert(capacity == expected[i], "The capacities must follow the growth sequence");
+    }
+    // Growing many elements at once must skip the too small values
+    index = growth_policy_sequence_index(4);
+    assert(growth_policy_next_capacity(&index, 1000) == 1064, "A big growth must skip to the first fitting value");
+    assert(growth_policy_next_capacity(&index, 1065) == 1597, "The next growth must continue from the skipped index");
+    // Beyond the cached values, the recurrence relation must keep growing by ~1.5
+    index = growth_policy_sequence_index(1034394550);
+    size_t big = growth_policy_next_capacity(&index, 1034394551);
+    assert(big == 1551591826, "The first computed value must follow the recurrence");
+    big = growth_policy_next_capacity(&index, (size_t) 5000000000ULL);
+    assert(big >= (size_t) 5000000000ULL && big < (size_t) 7500000001ULL, "A computed value must fit the required capacity");
+    // Near the maximum size, the capacity saturates instead of wrapping around
+    assert(growth_policy_next_capacity(&index, SIZE_MAX - 1) >= SIZE_MAX - 1, "A huge capacity must not wrap around");
+}
+
+// Tests runner
+
+int main() {
+    fclose(stderr);
+    growth_policy_sequence_index_test();
+    growth_policy_next_capacity_test();
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * The Growth Policy Shared By The Growable Containers (golden ratio as resize strategy).
+ *
+ * ### Explanation ###
+ *
+ * Every growable container (i.e., the string builder, the vector) must decide to what "new size" resize its buffer
+ * when it runs out of space. Growing by a constant increment makes appending N elements O(N^2), while growing by a
+ * constant factor makes it amortized O(1), where a factor close to the golden ratio (~1.6) lets the allocator reuse
+ * the previously freed blocks for future growths (which a factor of "2" never allows, as the new block is always
+ * bigger than all the previous blocks together).
+ *
+ * This policy uses the "A006999" sequence ("new_size = floor(old_size * 1.5) + 1"), where the values are precomputed
+ * (so no multiplications are needed on the hot path), and every container only keeps the index of its next sequence
+ * value, moved forward on every growth (a linear walk, which is usually a single step).
+ *
+ * The extended explanation about the strategies (and why the constant increment one is quadratic) lives at the
+ * "string-builder.c" header, where this policy was first tuned.
+ *
+ * ### References ###
+ *
+ * - https://stackoverflow.com/questions/10196942/how-much-to-grow-buffer-in-a-stringbuilder-like-c-module
+ * - https://github.com/facebook/folly/blob/main/folly/docs/FBVector.md
+ * - https://news.ycombinator.com/item?id=8555550
+ * - https://oeis.org/A006999
+ */
+
+// Imports & Headers
+
+#include "growth-policy.h"
+
+// Precomputed (or cached) "A006999" sequence: "new_size = floor(old_size * 1.5) + 1"
+
+static const size_t SEQUENCE[] = { 0, 1, 2, 4, 7, 11, 17, 26, 40, 61, 92, 139, 209, 314, 472, 709, 1064, 1597, 2396, 3595, 5393, 8090, 12136, 18205, 27308, 40963, 61445, 92168, 138253, 207380, 311071, 466607, 699911, 1049867, 1574801, 2362202, 3543304, 5314957, 7972436, 11958655, 17937983, 26906975, 40360463, 60540695, 90811043, 136216565, 204324848, 306487273, 459730910, 689596366, 1034394550 };
+static const size_t SEQUENCE_SIZE = sizeof(SEQUENCE) / sizeof(size_t);
+
+// Implementation
+
+// Searches the index of the next sequence value to which we must resize our buffer (i.e., simple binary search)
+size_t growth_policy_sequence_index(size_t capacity) {
+    // The next resize must really grow the buffer (i.e., from "16" to "26", and not to the close "17"), so the values
+    // not bigger than "capacity * 1.25" are skipped (the next value of a sequence capacity is always ~1.5 times bigger)
+    size_t target = capacity + (capacity >> 2);
+    // Saturate instead of wrapping around (then the recurrence relation is used from the last sequence value)
+    if (target < capacity) return SEQUENCE_SIZE;
+    // Left always ends at the first sequence value which is higher than "target" (i.e., the next resize size)
+    size_t left = 0;
+    size_t right = SEQUENCE_SIZE;
+    while (left < right) {
+        size_t middle = left + (right - left) / 2;
+        if (SEQUENCE[middle] <= target) {
+            left = middle + 1;
+        } else {
+            right = middle;
+        }
+    }
+    return left;
+}
+
+size_t growth_policy_next_capacity(size_t * sequence_index, size_t required_capacity) {
+    // While there are more cached sequence values to be checked, and the sequence value at the given index is not enough
+    while ((* sequence_index) < SEQUENCE_SIZE && SEQUENCE[(* sequence_index)] < required_capacity) {
+        // Move forward the index to the next sequence value
+        (* sequence_index)++;
+    }
+    // If the sequence index has not exceeded the max sequence index (then a cached sequence value can be used)
+    if ((* sequence_index) < SEQUENCE_SIZE) {
+        // Use that sequence value, and also increment the sequence index (for the next computation)
+        return SEQUENCE[(* sequence_index)++];
+    }
+    // Otherwise, use the last sequence value as a starting point for the recurrence relation (as we've run out of cached values)
+    size_t new_capacity = SEQUENCE[SEQUENCE_SIZE - 1];
+    while (new_capacity < required_capacity) {
+        // Same as "new_size = old_size * 1.5" or "new_size = (old_size * 3) / 2", where "1.5" is approximately ~ the golden ratio
+        // See that we add an extra "+1" to prevent getting stuck at size = "1" (because the bit operation truncates decimals)
+        size_t next_capacity = ((new_capacity + (new_capacity << 1)) >> 1) + 1;
+        // Saturate instead of wrapping around (the allocation of such a size fails anyway)
+        if (next_capacity <= new_capacity) return required_capacity;
+        new_capacity = next_capacity;
+    }
+    return new_capacity;
+}
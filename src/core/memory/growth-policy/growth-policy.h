@@ -0,0 +1,50 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stddef.h>    // For "size_t" (size type)
+
+/* growth-policy.h */
+#ifndef MEMORY_GROWTH_POLICY_H
+#define MEMORY_GROWTH_POLICY_H
+
+// The default initial capacity of the growable containers (in elements)
+#define GROWTH_POLICY_DEFAULT_CAPACITY 16
+
+/**
+ * Returns the index of the growth sequence value to which a buffer of the given capacity grows next (i.e., the
+ * index of the first sequence value strictly bigger than 1.25 times the capacity, so a capacity outside the sequence,
+ * like the default "16", grows to "26" instead of a barely bigger "17").
+ *
+ * Every growable container keeps such index next to its capacity, and passes it to "growth_policy_next_capacity"
+ * whenever it runs out of space.
+ *
+ * @param capacity the current capacity of the buffer (in elements)
+ *
+ * @return the index of the next sequence value
+ */
+size_t growth_policy_sequence_index(size_t capacity);
+
+/**
+ * Computes the capacity to which a buffer must grow to hold the required capacity, following the golden ratio
+ * sequence ("new_size = floor(old_size * 1.5) + 1"), and moves the given sequence index past the returned value.
+ *
+ * @param sequence_index the index of the next sequence value (see "growth_policy_sequence_index"), updated in place
+ * @param required_capacity the minimum capacity that the buffer must have (in elements)
+ *
+ * @note the sequence values are cached up to ~1G elements, and bigger capacities are computed with the recurrence
+ *
+ * @return the new capacity (always bigger or equal to the required capacity)
+ */
+size_t growth_policy_next_capacity(size_t * sequence_index, size_t required_capacity);
+
+#endif /* MEMORY_GROWTH_POLICY_H */
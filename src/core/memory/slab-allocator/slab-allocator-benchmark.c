@@ -0,0 +1,146 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L // For "clock_gettime", "CLOCK_MONOTONIC" (monotonic clock)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include "slab-allocator.h"
+
+// Benchmarking snippet (not abstracted away for piece of code portability)
+double elapsed_seconds(struct timespec start, struct timespec stop) {
+    return (double) (stop.tv_sec - start.tv_sec) + (double) (stop.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Every thread keeps a window of live objects and keeps replacing random ones (freeing the old object and allocating
+// a new one), touching every new object as a node would be initialized
+
+#define WINDOW_SIZE 4096
+#define NODE_SIZE 48
+
+typedef enum allocator_kind {
+    ALLOCATOR_MALLOC,                       // The general purpose allocator ("malloc" and "free")
+    ALLOCATOR_SLAB_FIXED,                   // A fixed size slab allocator (a single node size)
+    ALLOCATOR_SLAB_CLASSES                  // A size classes slab allocator (mixed node sizes)
+} AllocatorKind;
+
+typedef struct workload {
+    AllocatorKind kind;
+    SlabAllocator * allocator;
+    size_t operations_per_thread;
+    bool is_mixed;                          // Whether the sizes are mixed (between 16 and 512 bytes) or "NODE_SIZE"
+} Workload;
+
+typedef struct worker_argument {
+    Workload * workload;
+    uint64_t random_state;
+} WorkerArgument;
+
+void * allocate_object(Workload * workload, size_t size) {
+    if (workload->kind == ALLOCATOR_MALLOC) return malloc(size);
+    return slab_allocator_allocate(workload->allocator, size);
+}
+
+void free_object(Workload * workload, void * object, size_t size) {
+    if (workload->kind == ALLOCATOR_MALLOC) free(object); else slab_allocator_free(workload->allocator, object, size);
+}
+
+void * churn_worker(void * argument) {
+    WorkerArgument * worker = argument;
+    Workload * workload = worker->workload;
+    uint64_t random_state = worker->random_state;
+    void ** objects = calloc(WINDOW_SIZE, sizeof(void *));
+    uint16_t * sizes = calloc(WINDOW_SIZE, sizeof(uint16_t));
+    for (size_t i = 0; i < workload->operations_per_thread; i++) {
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 7;
+        random_state ^= random_state << 17;
+        size_t slot = random_state % WINDOW_SIZE;
+        if (objects[slot] != NULL) free_object(workload, objects[slot], sizes[slot]);
+        size_t size = workload->is_mixed ? 16 + (size_t) ((random_state >> 32) % 497) : NODE_SIZE;
+        objects[slot] = allocate_object(workload, size);
+        sizes[slot] = (uint16_t) size;
+        ((uint64_t *) objects[slot])[0] = i;
+    }
+    for (size_t i = 0; i < WINDOW_SIZE; i++) {
+        if (objects[i] != NULL) free_object(workload, objects[i], sizes[i]);
+    }
+    free(objects);
+    free(sizes);
+    return NULL;
+}
+
+double run_churn(Workload * workload, size_t threads_amount) {
+    struct timespec start, stop;
+    pthread_t * threads = malloc(sizeof(pthread_t) * threads_amount);
+    WorkerArgument * arguments = malloc(sizeof(WorkerArgument) * threads_amount);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < threads_amount; i++) {
+        arguments[i].workload = workload;
+        arguments[i].random_state = 0x9e3779b97f4a7c15ULL * (i + 1);
+        pthread_create(&threads[i], NULL, churn_worker, &arguments[i]);
+    }
+    for (size_t i = 0; i < threads_amount; i++) pthread_join(threads[i], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    free(threads);
+    free(arguments);
+    return (double) (workload->operations_per_thread * threads_amount) / elapsed_seconds(start, stop) / 1e6;
+}
+
+// Benchmarks
+
+void slab_allocator_churn_benchmark(const char * name, bool is_mixed, size_t operations, size_t max_threads_amount) {
+    printf("%s churn (%s)\n", name, is_mixed ? "16 to 512 bytes" : "48 bytes");
+    printf("%8s %16s %16s\n", "threads", "malloc Mops/s", "slab Mops/s");
+    for (size_t threads_amount = 1; threads_amount <= max_threads_amount; threads_amount *= 2) {
+        Workload baseline = { ALLOCATOR_MALLOC, NULL, operations / threads_amount, is_mixed };
+        double malloc_throughput = run_churn(&baseline, threads_amount);
+        SlabAllocator * allocator = is_mixed ? slab_allocator_create() : slab_allocator_create_fixed(NODE_SIZE);
+        Workload slab = { is_mixed ? ALLOCATOR_SLAB_CLASSES : ALLOCATOR_SLAB_FIXED, allocator, operations / threads_amount, is_mixed };
+        double slab_throughput = run_churn(&slab, threads_amount);
+        slab_allocator_destroy(allocator);
+        printf("%8zu %16.2f %16.2f\n", threads_amount, malloc_throughput, slab_throughput);
+    }
+}
+
+// Builds a whole structure of nodes and tears it down (one free per node, or destroying the allocator at once)
+void slab_allocator_teardown_benchmark(size_t nodes_amount) {
+    struct timespec start, stop;
+    void ** nodes = malloc(sizeof(void *) * nodes_amount);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < nodes_amount; i++) nodes[i] = malloc(NODE_SIZE);
+    for (size_t i = 0; i < nodes_amount; i++) free(nodes[i]);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    double malloc_seconds = elapsed_seconds(start, stop);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    SlabAllocator * allocator = slab_allocator_create_fixed(NODE_SIZE);
+    for (size_t i = 0; i < nodes_amount; i++) nodes[i] = slab_allocator_allocate(allocator, NODE_SIZE);
+    slab_allocator_destroy(allocator);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    double slab_seconds = elapsed_seconds(start, stop);
+    printf("Build & teardown of %zu nodes: malloc %.3f s, slab (destroy at once) %.3f s\n", nodes_amount, malloc_seconds, slab_seconds);
+    free(nodes);
+}
+
+// Benchmarks runner (the arguments optionally override the amount of operations and the maximum amount of threads)
+
+int main(int argc, char * argv[]) {
+    size_t operations = (argc > 1) ? strtoull(argv[1], NULL, 10) : 16000000;
+    size_t max_threads_amount = (argc > 2) ? strtoull(argv[2], NULL, 10) : 16;
+    slab_allocator_churn_benchmark("Fixed size", false, operations, max_threads_amount);
+    slab_allocator_churn_benchmark("Size classes", true, operations, max_threads_amount);
+    slab_allocator_teardown_benchmark(operations / 4);
+}
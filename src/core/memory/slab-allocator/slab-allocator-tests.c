@@ -0,0 +1,208 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdio.h>          // For "printf", "stderr" (printing errors)
+#include <stdlib.h>         // For "exit"
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include "slab-allocator.h"
+#include "error-reporter.h"
+
+// Assertion snippet (not abstracted away for piece of code portability)
+void assert(int condition, char message[]) {
+    if (condition != 1) {
+        printf("%s\n", message);
+        exit(1);
+    }
+}
+
+// Unit testing
+
+void slab_allocator_fixed_test() {
+    printf("*** Running test '%s'\n", __func__);
+    SlabAllocator * allocator = slab_allocator_create_fixed(40);
+    assert(allocator != NULL, "The 'allocator' must not be null");
+    void * objects[1000];
+    for (size_t i = 0; i < 1000; i++) {
+        objects[i] = slab_allocator_allocate(allocator, 40);
+        assert(objects[i] != NULL, "The object must be allocated");
+        assert((uintptr_t) objects[i] % 16 == 0, "The object must be aligned to 16 bytes");
+        memset(objects[i], (int) (i & 0xff), 40);
+    }
+    // Every object must keep its own contents (no overlaps)
+    for (size_t i = 0; i < 1000; i++) {
+        unsigned char * bytes = objects[i];
+        for (size_t j = 0; j < 40; j++) assert(bytes[j] == (i & 0xff), "The objects must not overlap");
+    }
+    SlabAllocatorStatistics statistics;
+    assert(slab_allocator_statistics(allocator, &statistics), "The statistics must be read");
+    assert(statistics.slabs_amount == 1, "A thousand small objects must fit in a single slab");
+    // A freed object is reused first (the magazines are stacks)
+    slab_allocator_free(allocator, objects[10], 40);
+    assert(slab_allocator_allocate(allocator, 40) == objects[10], "The last freed object must be reused");
+    assert(slab_allocator_allocate(allocator, 49) == NULL, "A size bigger than the (aligned) fixed one must be rejected");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "The error must be an invalid argument");
+    for (size_t i = 0; i < 1000; i++) slab_allocator_free(allocator, objects[i], 40);
+    slab_allocator_free(allocator, NULL, 40);
+    // Reallocating the freed objects must not map new slabs
+    for (size_t i = 0; i < 1000; i++) objects[i] = slab_allocator_allocate(allocator, 40);
+    slab_allocator_statistics(allocator, &statistics);
+    assert(statistics.slabs_amount == 1, "The freed objects must be reused");
+    // The objects that were not freed are released with the allocator
+    slab_allocator_destroy(allocator);
+}
+
+void slab_allocator_size_classes_test() {
+    printf("*** Running test '%s'\n", __func__);
+    SlabAllocator * allocator = slab_allocator_create();
+    size_t sizes[] = { 0, 1, 16, 17, 100, 256, 257, 700, 4096, 4097, 100000 };
+    void * objects[sizeof(sizes) / sizeof(size_t)];
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(size_t); i++) {
+        objects[i] = slab_allocator_allocate(allocator, sizes[i]);
+        assert(objects[i] != NULL, "The object must be allocated");
+        assert((uintptr_t) objects[i] % 16 == 0, "The object must be aligned to 16 bytes");
+        memset(objects[i], 0x5a, sizes[i]);
+    }
+    SlabAllocatorStatistics statistics;
+    slab_allocator_statistics(allocator, &statistics);
+    assert(statistics.large_allocations == 2, "The sizes bigger than the classes must be delegated");
+    assert(statistics.slabs_amount == 7, "Every used size class must have its own slab");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(size_t); i++) slab_allocator_free(allocator, objects[i], sizes[i]);
+    slab_allocator_statistics(allocator, &statistics);
+    assert(statistics.large_allocations == 0, "The delegated objects must be freed");
+    slab_allocator_destroy(allocator);
+}
+
+void slab_allocator_free_bulk_test() {
+    printf("*** Running test '%s'\n", __func__);
+    SlabAllocator * allocator = slab_allocator_create();
+    size_t amount = 5000;
+    void ** objects = malloc(sizeof(void *) * amount);
+    for (size_t i = 0; i < amount; i++) objects[i] = slab_allocator_allocate(allocator, 64);
+    objects[7] = NULL;
+    SlabAllocatorStatistics statistics;
+    slab_allocator_statistics(allocator, &statistics);
+    size_t slabs_amount = statistics.slabs_amount;
+    slab_allocator_free_bulk(allocator, objects, amount, 64);
+    // Every bulk freed object must be reusable without new slabs
+    for (size_t i = 0; i < amount - 1; i++) objects[i] = slab_allocator_allocate(allocator, 64);
+    slab_allocator_statistics(allocator, &statistics);
+    assert(statistics.slabs_amount == slabs_amount, "The bulk freed objects must be reused");
+    free(objects);
+    slab_allocator_destroy(allocator);
+}
+
+void slab_allocator_invalid_arguments_test() {
+    printf("*** Running test '%s'\n", __func__);
+    assert(slab_allocator_create_fixed(0) == NULL, "A zero object size must be rejected");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "The error must be an invalid argument");
+    assert(slab_allocator_allocate(NULL, 16) == NULL, "A 'NULL' allocator must be rejected");
+    assert(error_reporter_last_code() == ERROR_CODE_NULL_ARGUMENT, "The error must be a null argument");
+    SlabAllocatorStatistics statistics;
+    assert(!slab_allocator_statistics(NULL, &statistics), "A 'NULL' allocator must have no statistics");
+    slab_allocator_free(NULL, NULL, 16);
+    slab_allocator_destroy(NULL);
+}
+
+// Every thread allocates objects stamped with its index, keeps a window of them and frees the oldest ones, where every
+// object must keep its stamp until it is freed
+#define THREADS_AMOUNT 8
+#define OBJECTS_PER_THREAD 50000
+#define WINDOW_SIZE 256
+
+typedef struct worker_state {
+    SlabAllocator * allocator;
+    size_t worker_index;
+    bool is_consistent;
+} WorkerState;
+
+void * slab_allocator_worker(void * argument) {
+    WorkerState * worker = argument;
+    uint64_t * window[WINDOW_SIZE] = { NULL };
+    for (size_t i = 0; i < OBJECTS_PER_THREAD; i++) {
+        size_t slot = i % WINDOW_SIZE;
+        if (window[slot] != NULL) {
+            if (window[slot][0] != worker->worker_index || window[slot][5] != i - WINDOW_SIZE) worker->is_consistent = false;
+            slab_allocator_free(worker->allocator, window[slot], 48);
+        }
+        window[slot] = slab_allocator_allocate(worker->allocator, 48);
+        if (window[slot] == NULL) {
+            worker->is_consistent = false;
+            return NULL;
+        }
+        window[slot][0] = worker->worker_index;
+        window[slot][5] = i;
+    }
+    slab_allocator_free_bulk(worker->allocator, (void **) window, WINDOW_SIZE, 48);
+    return NULL;
+}
+
+void slab_allocator_threads_test() {
+    printf("*** Running test '%s'\n", __func__);
+    SlabAllocator * allocators[2] = { slab_allocator_create(), slab_allocator_create_fixed(48) };
+    for (size_t a = 0; a < 2; a++) {
+        pthread_t threads[THREADS_AMOUNT];
+        WorkerState workers[THREADS_AMOUNT];
+        for (size_t i = 0; i < THREADS_AMOUNT; i++) {
+            workers[i].allocator = allocators[a];
+            workers[i].worker_index = i;
+            workers[i].is_consistent = true;
+            pthread_create(&threads[i], NULL, slab_allocator_worker, &workers[i]);
+        }
+        for (size_t i = 0; i < THREADS_AMOUNT; i++) {
+            pthread_join(threads[i], NULL);
+            assert(workers[i].is_consistent, "Every object must keep its contents until it is freed");
+        }
+        slab_allocator_destroy(allocators[a]);
+    }
+}
+
+void * allocate_and_free_worker(void * argument) {
+    SlabAllocator * allocator = argument;
+    void * objects[100];
+    for (size_t i = 0; i < 100; i++) objects[i] = slab_allocator_allocate(allocator, 48);
+    for (size_t i = 0; i < 100; i++) slab_allocator_free(allocator, objects[i], 48);
+    return NULL;
+}
+
+void slab_allocator_thread_exit_test() {
+    printf("*** Running test '%s'\n", __func__);
+    SlabAllocator * allocator = slab_allocator_create_fixed(4000);
+    pthread_t thread;
+    pthread_create(&thread, NULL, allocate_and_free_worker, allocator);
+    pthread_join(thread, NULL);
+    SlabAllocatorStatistics before, after;
+    slab_allocator_statistics(allocator, &before);
+    // The exited thread flushed its magazine, so its objects are reused by this thread
+    void * objects[100];
+    for (size_t i = 0; i < 100; i++) {
+        objects[i] = slab_allocator_allocate(allocator, 48);
+        assert(objects[i] != NULL, "The object must be allocated");
+    }
+    slab_allocator_statistics(allocator, &after);
+    assert(after.slabs_amount == before.slabs_amount, "The objects of an exited thread must be reused");
+    slab_allocator_destroy(allocator);
+}
+
+// Tests runner
+
+int main() {
+    fclose(stderr);
+    slab_allocator_fixed_test();
+    slab_allocator_size_classes_test();
+    slab_allocator_free_bulk_test();
+    slab_allocator_invalid_arguments_test();
+    slab_allocator_threads_test();
+    slab_allocator_thread_exit_test();
+}
@@ -0,0 +1,448 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * A Thread-Safe Slab Allocator Implementation (size classes, with thread-local magazines).
+ *
+ * ### Explanation ###
+ *
+ * Node-based structures (maps, caches, trees) allocate millions of objects of the same size, where a general purpose
+ * allocator pays for what they don't need: a header per object (to remember its size), searching a fitting block, and
+ * the synchronization of a shared heap. A slab allocator serves every size class from its own slabs (big page-backed
+ * blocks split into equally sized objects), so an allocation is just taking an object from a free list.
+ *
+ * ### Layers ###
+ *
+ * 1. Magazines: every thread keeps a small array of free objects per size class (only touched by that thread), so
+ *    most allocations and frees are a push or a pop of that array, without any lock or atomic operation.
+ * 2. Size classes: when a magazine is empty (or full), half a magazine worth of objects is moved from (or to) the
+ *    shared free list of the size class at once, so the lock of the class is taken once per many operations.
+ * 3. Slabs: when the shared free list is empty, the objects are carved (bump allocated) out of the current slab of
+ *    the class, and new slabs are mapped from the system (with "mmap", so they are page aligned and never fragment
+ *    the heap). The pages of a slab are only touched as the objects are carved.
+ *
+ * The free objects are linked through their own first word, so the objects have no headers at all, and the size of an
+ * object is given back on free (as the C++ sized deallocation) to find its size class without any lookup.
+ *
+ * ### Bulk Free ###
+ *
+ * The slabs are only returned to the system when the allocator is destroyed, so freeing a whole structure is just
+ * destroying its allocator (no traversal of the nodes), and many objects can be freed at once with a single lock.
+ *
+ * ### References ###
+ *
+ * - https://www.usenix.org/legacy/publications/library/proceedings/bos94/full_papers/bonwick.a (Bonwick, The Slab Allocator)
+ * - https://www.usenix.org/legacy/event/usenix01/full_papers/bonwick/bonwick.pdf (Bonwick & Adams, Magazines and Vmem)
+ * - https://google.github.io/tcmalloc/design.html (TCMalloc, per-thread caches and size classes)
+ */
+
+// Imports & Headers
+
+#include <stdlib.h>         // For "malloc", "calloc", "free" (memory management)
+#include <stdint.h>         // For "uint64_t", "uintptr_t" (more integer types)
+#include <stdatomic.h>      // For "atomic_size_t" (allocators identifiers and counters)
+#include <pthread.h>        // For "pthread_mutex_t", "pthread_key_t" (classes locks & thread caches destruction)
+#include <sys/mman.h>       // For "mmap", "munmap" (page-backed slabs)
+#include <unistd.h>         // For "sysconf" (page size)
+#include "slab-allocator.h"
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+
+// Default implementation values
+
+#define OBJECT_ALIGNMENT 16                 // The alignment of every object (as "malloc" guarantees)
+#define SLAB_SIZE (64 * 1024)               // The size of a slab (bigger for fixed objects that would fit less than 16)
+#define MIN_OBJECTS_PER_SLAB 16             // The minimum amount of objects of a slab
+#define MAGAZINE_CAPACITY 64                // The amount of free objects a thread caches per size class
+#define MAGAZINE_TRANSFER (MAGAZINE_CAPACITY / 2)   // The amount of objects moved from or to a size class at once
+
+// The size classes (multiples of 16 bytes up to 256, and then roughly 1.5x apart up to the maximum class size)
+static const size_t CLASS_SIZES[] = { 16, 32, 48, 64, 80, 96, 112, 128, 144, 160, 176, 192, 208, 224, 240, 256, 384, 512, 768, 1024, 1536, 2048, 3072, SLAB_ALLOCATOR_MAX_CLASS_SIZE };
+static const size_t CLASSES_AMOUNT = sizeof(CLASS_SIZES) / sizeof(size_t);
+static const size_t SMALL_CLASSES_AMOUNT = 16; // The amount of classes which are multiples of 16 (found by a shift)
+
+// Structures
+
+typedef struct free_object {
+    struct free_object * next;              // The next free object (linked through the object itself)
+} FreeObject;
+
+typedef struct slab {
+    struct slab * next;                     // The next slab of the same size class
+    size_t size;                            // The mapped size of the slab
+} Slab;
+
+typedef struct size_class {
+    pthread_mutex_t lock;                   // Guards the free list and the slabs of the class
+    size_t object_size;                     // The size of every object of the class
+    size_t slab_size;                       // The size of every slab of the class
+    FreeObject * free_objects;              // The shared free list
+    Slab * slabs;                           // The slabs of the class
+    char * carve_cursor;                    // The next object to be carved out of the current slab
+    char * carve_end;                       // The end of the current slab
+    size_t slabs_amount;                    // The amount of slabs of the class
+} SizeClass;
+
+typedef struct magazine {
+    size_t amount;                          // The amount of cached free objects
+    void * objects[MAGAZINE_CAPACITY];      // The cached free objects (a stack, so the hottest objects are reused)
+} Magazine;
+
+typedef struct thread_cache {
+    struct thread_cache * previous;         // The previous thread cache of the allocator
+    struct thread_cache * next;             // The next thread cache of the allocator
+    SlabAllocator * allocator;              // The allocator that owns the cache
+    Magazine magazines[];                   // One magazine per size class
+} ThreadCache;
+
+struct slab_allocator {
+    uint64_t identifier;                    // The unique identifier of the allocator (never reused)
+    bool is_fixed;                          // Whether the allocator serves a single object size
+    size_t classes_amount;                  // The amount of size classes
+    SizeClass * classes;                    // The size classes
+    pthread_key_t thread_cache_key;         // The thread caches (flushed back when their thread exits)
+    pthread_mutex_t thread_caches_lock;     // Guards the list of thread caches
+    ThreadCache * thread_caches;            // The thread caches of all the threads (to be freed on destruction)
+    atomic_size_t large_allocations;        // The amount of live allocations delegated to "malloc"
+};
+
+// The last used thread cache of the current thread (saves a "pthread_getspecific" call, identified by the allocator
+// identifier instead of its address, as the address of a destroyed allocator could be reused by a new one)
+
+typedef struct last_thread_cache {
+    uint64_t identifier;                    // The identifier of the allocator of the cache
+    ThreadCache * cache;                    // The thread cache
+} LastThreadCache;
+
+static _Thread_local LastThreadCache last_thread_cache = { 0, NULL };
+static atomic_uint_fast64_t next_identifier = 1;
+
+// Definition (to be able to use methods before declaring them, to follow up the top-bottom code style)
+
+SlabAllocator * slab_allocator_create_classes(const size_t * object_sizes, size_t classes_amount, bool is_fixed);
+ThreadCache * slab_allocator_thread_cache(SlabAllocator * allocator);
+void slab_allocator_thread_cache_destroy(void * argument);
+void slab_allocator_thread_cache_flush(ThreadCache * cache);
+bool slab_allocator_refill(SizeClass * size_class, Magazine * magazine);
+void slab_allocator_flush(SizeClass * size_class, Magazine * magazine, size_t amount);
+void * slab_allocator_carve(SizeClass * size_class, bool can_map_slab);
+long slab_allocator_class_index(SlabAllocator * allocator, size_t size);
+
+// Implementation
+
+SlabAllocator * slab_allocator_create() {
+    return slab_allocator_create_classes(CLASS_SIZES, CLASSES_AMOUNT, false);
+}
+
+SlabAllocator * slab_allocator_create_fixed(size_t object_size) {
+    if (object_size == 0 || object_size > SLAB_SIZE * 64) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'object_size' must be between 1 and 4 MiB");
+        return NULL;
+    }
+    // Round the size up to the alignment (so every carved object stays aligned)
+    size_t aligned_size = (object_size + OBJECT_ALIGNMENT - 1) & ~((size_t) OBJECT_ALIGNMENT - 1);
+    return slab_allocator_create_classes(&aligned_size, 1, true);
+}
+
+void slab_allocator_destroy(SlabAllocator * allocator) {
+    if (allocator == NULL) return;
+    // The key is deleted first, so the exiting threads no longer flush into the allocator
+    pthread_key_delete(allocator->thread_cache_key);
+    ThreadCache * cache = allocator->thread_caches;
+    while (cache != NULL) {
+        ThreadCache * next = cache->next;
+        free(cache);
+        cache = next;
+    }
+    for (size_t i = 0; i < allocator->classes_amount; i++) {
+        SizeClass * size_class = &allocator->classes[i];
+        Slab * slab = size_class->slabs;
+        while (slab != NULL) {
+            Slab * next = slab->next;
+            munmap(slab, slab->size);
+            slab = next;
+        }
+        pthread_mutex_destroy(&size_class->lock);
+    }
+    pthread_mutex_destroy(&allocator->thread_caches_lock);
+    free(allocator->classes);
+    free(allocator);
+}
+
+void * slab_allocator_allocate(SlabAllocator * allocator, size_t size) {
+    if (allocator == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to allocate from a 'NULL' allocator");
+        return NULL;
+    }
+    long class_index = slab_allocator_class_index(allocator, size);
+    if (class_index < 0) {
+        if (allocator->is_fixed) {
+            error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'size' must not be bigger than the object size");
+            return NULL;
+        }
+        // Bigger than every size class, so delegated to the general purpose allocator
+        void * object = malloc(size);
+        if (object == NULL) {
+            error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'object'");
+            return NULL;
+        }
+        atomic_fetch_add_explicit(&allocator->large_allocations, 1, memory_order_relaxed);
+        return object;
+    }
+    ThreadCache * cache = slab_allocator_thread_cache(allocator);
+    if (cache == NULL) return NULL;
+    Magazine * magazine = &cache->magazines[class_index];
+    // Fast path: pop a cached object, otherwise refill the magazine from the size class (slow path)
+    if (magazine->amount == 0 && !slab_allocator_refill(&allocator->classes[class_index], magazine)) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to map memory for a new slab");
+        return NULL;
+    }
+    return magazine->objects[--magazine->amount];
+}
+
+void slab_allocator_free(SlabAllocator * allocator, void * object, size_t size) {
+    if (allocator == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to free into a 'NULL' allocator");
+        return;
+    }
+    if (object == NULL) return;
+    long class_index = slab_allocator_class_index(allocator, size);
+    if (class_index < 0) {
+        if (!allocator->is_fixed) {
+            atomic_fetch_sub_explicit(&allocator->large_allocations, 1, memory_order_relaxed);
+            free(object);
+        }
+        return;
+    }
+    ThreadCache * cache = slab_allocator_thread_cache(allocator);
+    if (cache == NULL) {
+        // The object can still be returned to its size class (without a magazine)
+        Magazine single = { 1, { object } };
+        slab_allocator_flush(&allocator->classes[class_index], &single, 1);
+        return;
+    }
+    Magazine * magazine = &cache->magazines[class_index];
+    // Fast path: push the object, otherwise give half of the magazine back to the size class first (slow path)
+    if (magazine->amount == MAGAZINE_CAPACITY) {
+        slab_allocator_flush(&allocator->classes[class_index], magazine, MAGAZINE_TRANSFER);
+    }
+    magazine->objects[magazine->amount++] = object;
+}
+
+void slab_allocator_free_bulk(SlabAllocator * allocator, void ** objects, size_t amount, size_t size) {
+    if (allocator == NULL || (objects == NULL && amount > 0)) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to bulk free into a 'NULL' allocator");
+        return;
+    }
+    long class_index = slab_allocator_class_index(allocator, size);
+    if (class_index < 0) {
+        for (size_t i = 0; i < amount; i++) slab_allocator_free(allocator, objects[i], size);
+        return;
+    }
+    // Step 1: Fill the magazine of the current thread (the most likely objects to be reused soon)
+    ThreadCache * cache = slab_allocator_thread_cache(allocator);
+    Magazine * magazine = (cache != NULL) ? &cache->magazines[class_index] : NULL;
+    size_t i = 0;
+    while (magazine != NULL && i < amount && magazine->amount < MAGAZINE_CAPACITY) {
+        if (objects[i] != NULL) magazine->objects[magazine->amount++] = objects[i];
+        i++;
+    }
+    // Step 2: Link the rest of the objects together, and splice them into the shared free list at once
+    FreeObject * first = NULL;
+    FreeObject * last = NULL;
+    for (; i < amount; i++) {
+        if (objects[i] == NULL) continue;
+        FreeObject * object = objects[i];
+        object->next = first;
+        first = object;
+        if (last == NULL) last = object;
+    }
+    if (first == NULL) return;
+    SizeClass * size_class = &allocator->classes[class_index];
+    pthread_mutex_lock(&size_class->lock);
+    last->next = size_class->free_objects;
+    size_class->free_objects = first;
+    pthread_mutex_unlock(&size_class->lock);
+}
+
+bool slab_allocator_statistics(SlabAllocator * allocator, SlabAllocatorStatistics * statistics) {
+    if (allocator == NULL || statistics == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to read the statistics of a 'NULL' allocator");
+        return false;
+    }
+    statistics->slabs_amount = 0;
+    statistics->reserved_bytes = 0;
+    for (size_t i = 0; i < allocator->classes_amount; i++) {
+        SizeClass * size_class = &allocator->classes[i];
+        pthread_mutex_lock(&size_class->lock);
+        statistics->slabs_amount += size_class->slabs_amount;
+        statistics->reserved_bytes += size_class->slabs_amount * size_class->slab_size;
+        pthread_mutex_unlock(&size_class->lock);
+    }
+    statistics->large_allocations = atomic_load_explicit(&allocator->large_allocations, memory_order_relaxed);
+    return true;
+}
+
+// Utilities
+
+SlabAllocator * slab_allocator_create_classes(const size_t * object_sizes, size_t classes_amount, bool is_fixed) {
+    SlabAllocator * allocator = malloc(sizeof(SlabAllocator));
+    if (allocator == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'allocator'");
+        return NULL;
+    }
+    allocator->classes = malloc(sizeof(SizeClass) * classes_amount);
+    if (allocator->classes == NULL) {
+        free(allocator);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'classes'");
+        return NULL;
+    }
+    if (pthread_key_create(&allocator->thread_cache_key, slab_allocator_thread_cache_destroy) != 0) {
+        free(allocator->classes);
+        free(allocator);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to create the thread caches key");
+        return NULL;
+    }
+    long page_size = sysconf(_SC_PAGESIZE);
+    for (size_t i = 0; i < classes_amount; i++) {
+        SizeClass * size_class = &allocator->classes[i];
+        pthread_mutex_init(&size_class->lock, NULL);
+        size_class->object_size = object_sizes[i];
+        // Every slab fits at least a minimum amount of objects (after its header), rounded up to whole pages
+        size_t slab_size = sizeof(Slab) + OBJECT_ALIGNMENT + object_sizes[i] * MIN_OBJECTS_PER_SLAB;
+        if (slab_size < SLAB_SIZE) slab_size = SLAB_SIZE;
+        size_class->slab_size = (slab_size + (size_t) page_size - 1) & ~((size_t) page_size - 1);
+        size_class->free_objects = NULL;
+        size_class->slabs = NULL;
+        size_class->carve_cursor = NULL;
+        size_class->carve_end = NULL;
+        size_class->slabs_amount = 0;
+    }
+    allocator->identifier = atomic_fetch_add(&next_identifier, 1);
+    allocator->is_fixed = is_fixed;
+    allocator->classes_amount = classes_amount;
+    pthread_mutex_init(&allocator->thread_caches_lock, NULL);
+    allocator->thread_caches = NULL;
+    atomic_init(&allocator->large_allocations, 0);
+    return allocator;
+}
+
+// Returns the thread cache of the current thread (creating it on the first usage)
+ThreadCache * slab_allocator_thread_cache(SlabAllocator * allocator) {
+    if (last_thread_cache.identifier == allocator->identifier) return last_thread_cache.cache;
+    ThreadCache * cache = pthread_getspecific(allocator->thread_cache_key);
+    if (cache == NULL) {
+        cache = malloc(sizeof(ThreadCache) + sizeof(Magazine) * allocator->classes_amount);
+        if (cache == NULL) {
+            error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'cache'");
+            return NULL;
+        }
+        cache->allocator = allocator;
+        for (size_t i = 0; i < allocator->classes_amount; i++) cache->magazines[i].amount = 0;
+        pthread_mutex_lock(&allocator->thread_caches_lock);
+        cache->previous = NULL;
+        cache->next = allocator->thread_caches;
+        if (allocator->thread_caches != NULL) allocator->thread_caches->previous = cache;
+        allocator->thread_caches = cache;
+        pthread_mutex_unlock(&allocator->thread_caches_lock);
+        pthread_setspecific(allocator->thread_cache_key, cache);
+    }
+    last_thread_cache.identifier = allocator->identifier;
+    last_thread_cache.cache = cache;
+    return cache;
+}
+
+// Gives the cached objects of an exiting thread back to their size classes (called by "pthread" on thread exit)
+void slab_allocator_thread_cache_destroy(void * argument) {
+    ThreadCache * cache = argument;
+    SlabAllocator * allocator = cache->allocator;
+    slab_allocator_thread_cache_flush(cache);
+    pthread_mutex_lock(&allocator->thread_caches_lock);
+    if (cache->previous != NULL) cache->previous->next = cache->next; else allocator->thread_caches = cache->next;
+    if (cache->next != NULL) cache->next->previous = cache->previous;
+    pthread_mutex_unlock(&allocator->thread_caches_lock);
+    if (last_thread_cache.cache == cache) last_thread_cache.identifier = 0;
+    free(cache);
+}
+
+void slab_allocator_thread_cache_flush(ThreadCache * cache) {
+    for (size_t i = 0; i < cache->allocator->classes_amount; i++) {
+        Magazine * magazine = &cache->magazines[i];
+        if (magazine->amount > 0) slab_allocator_flush(&cache->allocator->classes[i], magazine, magazine->amount);
+    }
+}
+
+// Moves objects from the size class into the (empty) magazine, carving them out of slabs if the free list is empty
+bool slab_allocator_refill(SizeClass * size_class, Magazine * magazine) {
+    pthread_mutex_lock(&size_class->lock);
+    while (magazine->amount < MAGAZINE_TRANSFER && size_class->free_objects != NULL) {
+        FreeObject * object = size_class->free_objects;
+        size_class->free_objects = object->next;
+        magazine->objects[magazine->amount++] = object;
+    }
+    // A new slab is only mapped for an empty magazine (so the big classes don't map slabs just to fill magazines)
+    while (magazine->amount < MAGAZINE_TRANSFER) {
+        void * object = slab_allocator_carve(size_class, magazine->amount == 0);
+        if (object == NULL) break;
+        magazine->objects[magazine->amount++] = object;
+    }
+    pthread_mutex_unlock(&size_class->lock);
+    return magazine->amount > 0;
+}
+
+// Moves the given amount of objects from the top of the magazine into the free list of the size class
+void slab_allocator_flush(SizeClass * size_class, Magazine * magazine, size_t amount) {
+    // Link the objects together outside of the lock, so the lock only guards the splice
+    FreeObject * first = magazine->objects[magazine->amount - amount];
+    FreeObject * last = first;
+    for (size_t i = magazine->amount - amount + 1; i < magazine->amount; i++) {
+        last->next = magazine->objects[i];
+        last = last->next;
+    }
+    magazine->amount -= amount;
+    pthread_mutex_lock(&size_class->lock);
+    last->next = size_class->free_objects;
+    size_class->free_objects = first;
+    pthread_mutex_unlock(&size_class->lock);
+}
+
+// Carves the next object out of the current slab of the size class, mapping a new slab when it is exhausted (if
+// allowed, otherwise returns "NULL"), where the lock of the class must be held
+void * slab_allocator_carve(SizeClass * size_class, bool can_map_slab) {
+    if (size_class->carve_cursor == NULL || size_class->carve_cursor + size_class->object_size > size_class->carve_end) {
+        if (!can_map_slab) return NULL;
+        void * memory = mmap(NULL, size_class->slab_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) return NULL;
+        Slab * slab = memory;
+        slab->size = size_class->slab_size;
+        slab->next = size_class->slabs;
+        size_class->slabs = slab;
+        size_class->slabs_amount++;
+        // The objects start after the slab header (aligned)
+        uintptr_t first_object = ((uintptr_t) (slab + 1) + OBJECT_ALIGNMENT - 1) & ~((uintptr_t) OBJECT_ALIGNMENT - 1);
+        size_class->carve_cursor = (char *) first_object;
+        size_class->carve_end = (char *) memory + size_class->slab_size;
+    }
+    void * object = size_class->carve_cursor;
+    size_class->carve_cursor += size_class->object_size;
+    return object;
+}
+
+// Returns the index of the smallest size class fitting the given size, or "-1" if the size fits no class
+long slab_allocator_class_index(SlabAllocator * allocator, size_t size) {
+    if (allocator->is_fixed) return (size <= allocator->classes[0].object_size) ? 0 : -1;
+    if (size <= CLASS_SIZES[SMALL_CLASSES_AMOUNT - 1]) return (size == 0) ? 0 : (long) ((size - 1) >> 4);
+    for (size_t i = SMALL_CLASSES_AMOUNT; i < CLASSES_AMOUNT; i++) {
+        if (size <= CLASS_SIZES[i]) return (long) i;
+    }
+    return -1;
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdbool.h>   // For "true", "false" (boolean constants)
+#include <stddef.h>    // For "size_t" (size type)
+
+/* slab-allocator.h */
+#ifndef MEMORY_SLAB_ALLOCATOR_H
+#define MEMORY_SLAB_ALLOCATOR_H
+
+// The biggest size served by the size classes (bigger sizes are delegated to "malloc")
+#define SLAB_ALLOCATOR_MAX_CLASS_SIZE 4096
+
+typedef struct slab_allocator SlabAllocator;
+
+/**
+ * Memory usage of a slab allocator.
+ */
+typedef struct slab_allocator_statistics {
+    size_t slabs_amount;            // The amount of slabs (page-backed blocks) reserved from the system
+    size_t reserved_bytes;          // The amount of bytes of those slabs
+    size_t large_allocations;       // The amount of live allocations bigger than the size classes (delegated to "malloc")
+} SlabAllocatorStatistics;
+
+/**
+ * Creates a slab allocator serving every size up to "SLAB_ALLOCATOR_MAX_CLASS_SIZE" from size classes (multiples of
+ * 16 bytes up to 256, and then roughly 1.5x apart), where the bigger sizes are delegated to "malloc".
+ *
+ * Every thread keeps a small cache (a "magazine") of free objects per size class, so most allocations and frees
+ * never lock, and the objects are carved out of page-backed slabs.
+ *
+ * The returned allocator must be freed by the client after its usage.
+ *
+ * @return a new allocator, or {@code NULL} if an error occurred
+ */
+SlabAllocator * slab_allocator_create();
+
+/**
+ * Creates a slab allocator serving a single object size (i.e., the nodes of a map or a tree), which is the fastest
+ * replacement of a "malloc" per node.
+ *
+ * The returned allocator must be freed by the client after its usage.
+ *
+ * @param object_size the size of every object (in bytes)
+ *
+ * @return a new allocator, or {@code NULL} if an error occurred
+ */
+SlabAllocator * slab_allocator_create_fixed(size_t object_size);
+
+/**
+ * Frees the given allocator, and releases all its slabs at once (so the objects that were not freed yet are released
+ * too, which is the fastest way of freeing a whole structure).
+ *
+ * @param allocator the allocator that is about to be freed
+ *
+ * @note no thread must be using the allocator during its destruction (nor exiting after having used it)
+ */
+void slab_allocator_destroy(SlabAllocator * allocator);
+
+/**
+ * Allocates an object of the given size (aligned to 16 bytes, and with garbage contents as "malloc").
+ *
+ * @param allocator the allocator from whom the object is to be allocated
+ * @param size the size of the object (at most the object size of a fixed allocator)
+ *
+ * @return the new object, or {@code NULL} if an error occurred
+ */
+void * slab_allocator_allocate(SlabAllocator * allocator, size_t size);
+
+/**
+ * Frees an object allocated by the given allocator (from any thread).
+ *
+ * @param allocator the allocator from whom the object was allocated
+ * @param object the object that is about to be freed (or {@code NULL} to do nothing)
+ * @param size the size the object was allocated with (so no per object header is needed to find its size class)
+ */
+void slab_allocator_free(SlabAllocator * allocator, void * object, size_t size);
+
+/**
+ * Frees many objects of the same size at once (taking the shared lock of their size class at most once).
+ *
+ * @param allocator the allocator from whom the objects were allocated
+ * @param objects the objects that are about to be freed (the {@code NULL} ones are skipped)
+ * @param amount the amount of objects
+ * @param size the size all the objects were allocated with
+ */
+void slab_allocator_free_bulk(SlabAllocator * allocator, void ** objects, size_t amount, size_t size);
+
+/**
+ * Obtains the memory usage of the given allocator.
+ *
+ * @param allocator the allocator whose statistics are to be obtained
+ * @param statistics where the statistics are written to
+ *
+ * @return {@code true} if the statistics were obtained, {@code false} otherwise
+ */
+bool slab_allocator_statistics(SlabAllocator * allocator, SlabAllocatorStatistics * statistics);
+
+#endif /* MEMORY_SLAB_ALLOCATOR_H */
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L // For "clock_gettime", "CLOCK_MONOTONIC" (monotonic clock)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "string-sort.h"
+
+// Benchmarking snippet (not abstracted away for piece of code portability)
+double elapsed_seconds(struct timespec start, struct timespec stop) {
+    return (double) (stop.tv_sec - start.tv_sec) + (double) (stop.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+int compare_strings(const void * first, const void * second) {
+    return strcmp(* (char * const *) first, * (char * const *) second);
+}
+
+// Generated inputs (the strings are stored in a single arena, and every run sorts a fresh copy of the pointers)
+
+typedef enum input_kind {
+    INPUT_KEYS,     // Shuffled fixed-width keys ("key-00000000042"), sharing a long prefix
+    INPUT_RANDOM,   // Random lowercase strings of random length (mostly distinguished by the first bytes)
+    INPUT_URLS,     // Random paths below a few hosts (long common prefixes, with many duplicates)
+} InputKind;
+
+const char * INPUT_NAMES[] = { "keys", "random", "urls" };
+
+char ** generate_input(InputKind kind, size_t amount, char ** arena) {
+    const size_t MAX_LENGTH = 64;
+    char ** strings = malloc(sizeof(char *) * amount);
+    * arena = malloc(amount * MAX_LENGTH);
+    uint64_t random_state = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < amount; i++) {
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 7;
+        random_state ^= random_state << 17;
+        char * string = * arena + i * MAX_LENGTH;
+        if (kind == INPUT_KEYS) {
+            snprintf(string, MAX_LENGTH, "key-%011zu", i);
+        } else if (kind == INPUT_RANDOM) {
+            size_t length = 1 + random_state % 32;
+            for (size_t j = 0; j < length; j++) string[j] = (char) ('a' + (random_state >> (j % 8 * 8)) % 26);
+            string[length] = '\0';
+        } else {
+            snprintf(string, MAX_LENGTH, "https://host-%u.example.com/items/%u", (unsigned) (random_state % 4), (unsigned) ((random_state >> 8) % (amount / 2 + 1)));
+        }
+        strings[i] = string;
+    }
+    // Shuffle (the keys are generated in order)
+    for (size_t i = amount - 1; i > 0; i--) {
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 7;
+        random_state ^= random_state << 17;
+        size_t j = random_state % (i + 1);
+        char * swapped = strings[i];
+        strings[i] = strings[j];
+        strings[j] = swapped;
+    }
+    return strings;
+}
+
+// Benchmarks
+
+void string_sort_benchmark(InputKind kind, size_t amount, ThreadPool * pool) {
+    char * arena;
+    char ** input = generate_input(kind, amount, &arena);
+    char ** strings = malloc(sizeof(char *) * amount);
+    struct timespec start, stop;
+    double seconds[3];
+    for (size_t i = 0; i < 3; i++) {
+        memcpy(strings, input, sizeof(char *) * amount);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        if (i == 0) qsort(strings, amount, sizeof(char *), compare_strings);
+        else if (i == 1) string_sort(strings, amount);
+        else string_sort_parallel(strings, amount, pool);
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        seconds[i] = elapsed_seconds(start, stop);
+    }
+    printf("%8s %12.1f %12.1f %12.1f %10.2fx %10.2fx\n", INPUT_NAMES[kind], seconds[0] * 1e3, seconds[1] * 1e3, seconds[2] * 1e3,
+           seconds[0] / seconds[1], seconds[0] / seconds[2]);
+    free(strings);
+    free(input);
+    free(arena);
+}
+
+// Benchmarks runner (the arguments optionally override the amount of strings and the amount of threads)
+
+int main(int argc, char * argv[]) {
+    size_t amount = (argc > 1) ? strtoull(argv[1], NULL, 10) : 4000000;
+    size_t threads_amount = (argc > 2) ? strtoull(argv[2], NULL, 10) : 0;
+    ThreadPoolOptions options = { threads_amount, THREAD_POOL_AFFINITY_NONE, NULL, 0 };
+    ThreadPool * pool = thread_pool_create(&options);
+    printf("%zu strings, %zu threads\n", amount, thread_pool_threads_amount(pool));
+    printf("%8s %12s %12s %12s %11s %11s\n", "input", "qsort ms", "radix ms", "parallel ms", "radix", "parallel");
+    for (InputKind kind = INPUT_KEYS; kind <= INPUT_URLS; kind++) string_sort_benchmark(kind, amount, pool);
+    thread_pool_destroy(pool);
+}
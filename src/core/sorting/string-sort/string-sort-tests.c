@@ -0,0 +1,150 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdio.h>          // For "printf", "stderr" (printing errors)
+#include <stdlib.h>         // For "exit"
+#include <stdint.h>
+#include <string.h>
+#include "string-sort.h"
+#include "error-reporter.h"
+
+// Assertion snippet (not abstracted away for piece of code portability)
+void assert(int condition, char message[]) {
+    if (condition != 1) {
+        printf("%s\n", message);
+        exit(1);
+    }
+}
+
+// Utilities (reference sort & generated strings)
+
+int compare_strings(const void * first, const void * second) {
+    return strcmp(* (char * const *) first, * (char * const *) second);
+}
+
+// Checks the sorted strings are the same (as a multiset) and in the same order as the reference sort
+bool matches_reference(char ** strings, char ** reference, size_t amount) {
+    qsort(reference, amount, sizeof(char *), compare_strings);
+    for (size_t i = 0; i < amount; i++) {
+        if (strcmp(strings[i], reference[i]) != 0) return false;
+    }
+    return true;
+}
+
+// Generates strings with the given shared prefix, then a random suffix (of random length, over the given alphabet)
+char ** generate_strings(size_t amount, const char * prefix, unsigned alphabet_size, size_t max_suffix_length, uint64_t seed) {
+    char ** strings = malloc(sizeof(char *) * amount);
+    size_t prefix_length = strlen(prefix);
+    uint64_t random_state = seed;
+    for (size_t i = 0; i < amount; i++) {
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 7;
+        random_state ^= random_state << 17;
+        size_t suffix_length = random_state % (max_suffix_length + 1);
+        strings[i] = malloc(prefix_length + suffix_length + 1);
+        memcpy(strings[i], prefix, prefix_length);
+        for (size_t j = 0; j < suffix_length; j++) {
+            random_state ^= random_state << 13;
+            random_state ^= random_state >> 7;
+            random_state ^= random_state << 17;
+            // Bytes from "a" on (wrapping into the bytes above 127, to check the unsigned order)
+            strings[i][prefix_length + j] = (char) (unsigned char) (97 + random_state % alphabet_size);
+        }
+        strings[i][prefix_length + suffix_length] = '\0';
+    }
+    return strings;
+}
+
+void free_strings(char ** strings, size_t amount) {
+    for (size_t i = 0; i < amount; i++) free(strings[i]);
+    free(strings);
+}
+
+bool check_sort(size_t amount, const char * prefix, unsigned alphabet_size, size_t max_suffix_length, ThreadPool * pool) {
+    char ** strings = generate_strings(amount, prefix, alphabet_size, max_suffix_length, 0x9e3779b97f4a7c15ULL + amount);
+    char ** reference = malloc(sizeof(char *) * amount);
+    memcpy(reference, strings, sizeof(char *) * amount);
+    bool is_sorted = (pool == NULL) ? string_sort(strings, amount) : string_sort_parallel(strings, amount, pool);
+    bool is_correct = is_sorted && matches_reference(strings, reference, amount);
+    free(reference);
+    free_strings(strings, amount);
+    return is_correct;
+}
+
+// Unit testing
+
+void string_sort_small_test() {
+    printf("*** Running test '%s'\n", __func__);
+    char * strings[] = { "pear", "apple", "", "apples", "\xff", "app", "pear", "b", "" };
+    char * expected[] = { "", "", "app", "apple", "apples", "b", "pear", "pear", "\xff" };
+    assert(string_sort(strings, 9), "The strings must be sorted");
+    for (size_t i = 0; i < 9; i++) assert(strcmp(strings[i], expected[i]) == 0, "The strings must be in ascending order");
+    assert(string_sort(strings, 0), "Sorting no strings must succeed");
+    assert(string_sort(strings, 1), "Sorting a single string must succeed");
+}
+
+void string_sort_random_test() {
+    printf("*** Running test '%s'\n", __func__);
+    // From the insertion sort sizes, through the quicksort sizes, to several radix levels
+    size_t amounts[] = { 2, 15, 17, 63, 64, 65, 1000, 20000 };
+    for (size_t i = 0; i < sizeof(amounts) / sizeof(size_t); i++) {
+        assert(check_sort(amounts[i], "", 26, 12, NULL), "The random strings must be sorted");
+        assert(check_sort(amounts[i], "", 200, 6, NULL), "The random binary strings must be sorted");
+        assert(check_sort(amounts[i], "", 2, 30, NULL), "The strings of a tiny alphabet must be sorted");
+    }
+}
+
+void string_sort_common_prefixes_test() {
+    printf("*** Running test '%s'\n", __func__);
+    // Prefixes shorter, equal and longer than the cached bytes (so the caches are refilled at several depths)
+    const char * prefixes[] = { "abc", "abcdefgh", "abcdefghijklmnopq", "https://example.com/some/long/path/" };
+    for (size_t i = 0; i < sizeof(prefixes) / sizeof(char *); i++) {
+        assert(check_sort(30, prefixes[i], 3, 20, NULL), "The small prefixed strings must be sorted");
+        assert(check_sort(5000, prefixes[i], 3, 20, NULL), "The prefixed strings must be sorted");
+        assert(check_sort(5000, prefixes[i], 1, 20, NULL), "The prefixed strings of a single letter must be sorted");
+    }
+    // Only duplicates
+    assert(check_sort(5000, "same string for everybody", 1, 0, NULL), "The duplicated strings must be sorted");
+}
+
+void string_sort_parallel_test() {
+    printf("*** Running test '%s'\n", __func__);
+    ThreadPoolOptions options = { 4, THREAD_POOL_AFFINITY_NONE, NULL, 0 };
+    ThreadPool * pool = thread_pool_create(&options);
+    assert(check_sort(300000, "", 26, 10, pool), "The random strings must be sorted in parallel");
+    assert(check_sort(300000, "", 200, 4, pool), "The random binary strings must be sorted in parallel");
+    assert(check_sort(300000, "common/prefix/", 4, 16, pool), "The prefixed strings must be sorted in parallel");
+    assert(check_sort(100000, "", 1, 40, pool), "The strings of a single letter must be sorted in parallel");
+    assert(check_sort(1000, "", 26, 10, pool), "A small array must be sorted in parallel");
+    thread_pool_destroy(pool);
+}
+
+void string_sort_invalid_arguments_test() {
+    printf("*** Running test '%s'\n", __func__);
+    assert(!string_sort(NULL, 10), "'NULL' strings must be rejected");
+    assert(error_reporter_last_code() == ERROR_CODE_NULL_ARGUMENT, "The error must be a null argument");
+    char * strings[] = { "b", "a" };
+    assert(!string_sort_parallel(strings, 2, NULL), "A 'NULL' pool must be rejected");
+    assert(strcmp(strings[0], "b") == 0, "A failed sort must leave the strings untouched");
+}
+
+// Tests runner
+
+int main() {
+    fclose(stderr); // Prevent printing "expected" errors
+    string_sort_small_test();
+    string_sort_random_test();
+    string_sort_common_prefixes_test();
+    string_sort_parallel_test();
+    string_sort_invalid_arguments_test();
+}
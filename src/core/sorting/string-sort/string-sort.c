@@ -0,0 +1,395 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * A String Sort Implementation (MSD radix sort, with a caching multikey quicksort for the small buckets).
+ *
+ * ### Explanation ###
+ *
+ * Comparison sorts ("qsort" with "strcmp") compare whole strings again and again, where every comparison follows two
+ * pointers to random memory, and re-reads the common prefixes of the strings at every level. String sorts instead
+ * look at every byte of the distinguishing prefixes (roughly) once.
+ *
+ * ### MSD Radix Sort ###
+ *
+ * The most significant digit radix sort distributes the strings into 256 buckets by their first byte, and then sorts
+ * every bucket recursively by the next byte (the bucket of the terminator byte is already sorted, as its strings are
+ * all equal). The distribution is done out of place (counting the bucket sizes first, then copying every string into
+ * its bucket in a temporary array), which streams through the memory instead of swapping in place.
+ *
+ * ### Cached Prefixes ###
+ *
+ * Every string pointer is sorted along with a cache of its next 8 bytes (packed big-endian in an integer, with zeros
+ * after the terminator), so the bytes of 8 levels are read from the array being sorted instead of from the strings,
+ * and the strings are only dereferenced to refill the caches (once every 8 levels).
+ *
+ * ### Multikey Quicksort ###
+ *
+ * Radix sorting a small bucket costs more than the bucket itself (the 256 counters), so the buckets smaller than a
+ * threshold use a multikey quicksort: a three-way partition around a pivot, where the "equal" partition moves to the
+ * next key. Comparing the whole cached words at once makes every partition step consume 8 bytes (instead of one),
+ * and the tiny partitions are finished with an insertion sort.
+ *
+ * ### Parallelism ###
+ *
+ * The distribution of a big array is split in chunks across the workers (every chunk counts its own histogram, then
+ * the chunk offsets are computed, and every chunk scatters its own strings), and then the buckets are sorted as
+ * independent tasks (recursively in parallel while they are still big, so common prefixes don't serialize the sort).
+ *
+ * ### References ###
+ *
+ * - https://www.cs.princeton.edu/~rs/strings/paper.pdf (Bentley & Sedgewick, Fast Algorithms for Sorting and Searching Strings)
+ * - https://arxiv.org/abs/1009.5183 (Kärkkäinen & Rantala, Engineering Radix Sort for Strings)
+ * - https://panthema.net/2013/parallel-string-sorting/ (Bingmann, Parallel String Sorting)
+ */
+
+// Imports & Headers
+
+#include <stdlib.h>         // For "malloc", "free" (memory management)
+#include <stdint.h>         // For "uint64_t" (more integer types)
+#include <string.h>         // For "memcpy", "strcmp" (copying buckets and comparing suffixes)
+#include "string-sort.h"
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+
+// Default implementation values
+
+#define CACHE_BYTES 8                       // The amount of bytes of a cached prefix
+#define ALPHABET_SIZE 256                   // The amount of buckets of a radix step
+#define RADIX_THRESHOLD 64                  // The smallest bucket sorted by the radix sort (smaller ones use the quicksort)
+#define INSERTION_THRESHOLD 16              // The smallest partition sorted by the quicksort (smaller ones use insertions)
+#define PARALLEL_THRESHOLD 65536            // The smallest bucket distributed in parallel
+#define CHUNKS_PER_THREAD 4                 // The amount of distribution chunks per worker
+
+// Structures
+
+typedef struct sort_item {
+    uint64_t cache;                         // The cached bytes of the string (from the cache depth, big-endian)
+    char * string;                          // The string
+} SortItem;
+
+typedef struct parallel_sort {
+    ThreadPool * pool;                      // The pool where the sort is executed
+    SortItem * items;                       // The items to be sorted (where the result is left)
+    SortItem * temp;                        // The temporary items (same size)
+    size_t amount;                          // The amount of items
+    size_t depth;                           // The depth of the distribution byte
+    size_t cache_depth;                     // The depth of the first cached byte
+    size_t chunk_size;                      // The amount of items of every distribution chunk
+    size_t * chunk_offsets;                 // The histogram of every chunk (then, the scatter offset of its buckets)
+    size_t bucket_starts[ALPHABET_SIZE + 1];    // The first item of every bucket (and the amount at the end)
+} ParallelSort;
+
+typedef struct fill_context {
+    char ** strings;                        // The strings to be sorted
+    SortItem * items;                       // The items to be filled (or the items to be written back)
+} FillContext;
+
+// Definition (to be able to use methods before declaring them, to follow up the top-bottom code style)
+
+bool string_sort_validate(char ** strings, const char function[]);
+void string_sort_radix(SortItem * items, SortItem * temp, size_t amount, size_t depth, size_t cache_depth);
+void string_sort_multikey(SortItem * items, size_t amount, size_t depth, size_t cache_depth);
+void string_sort_insertion(SortItem * items, size_t amount, size_t cache_depth);
+int string_sort_compare(const SortItem * first, const SortItem * second, size_t cache_depth);
+void string_sort_refill(SortItem * items, size_t amount, size_t depth);
+uint64_t string_sort_load_cache(const char * string);
+void string_sort_parallel_radix(ThreadPool * pool, SortItem * items, SortItem * temp, size_t amount, size_t depth, size_t cache_depth);
+void string_sort_count_chunk(size_t start, size_t stop, void * context);
+void string_sort_scatter_chunk(size_t start, size_t stop, void * context);
+void string_sort_bucket_range(size_t start, size_t stop, void * context);
+void string_sort_fill_range(size_t start, size_t stop, void * context);
+void string_sort_write_back_range(size_t start, size_t stop, void * context);
+
+// Implementation
+
+bool string_sort(char ** strings, size_t amount) {
+    if (!string_sort_validate(strings, __func__)) return false;
+    if (amount < 2) return true;
+    SortItem * items = malloc(sizeof(SortItem) * amount * 2);
+    if (items == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'items'");
+        return false;
+    }
+    for (size_t i = 0; i < amount; i++) {
+        items[i].string = strings[i];
+        items[i].cache = string_sort_load_cache(strings[i]);
+    }
+    string_sort_radix(items, items + amount, amount, 0, 0);
+    for (size_t i = 0; i < amount; i++) strings[i] = items[i].string;
+    free(items);
+    return true;
+}
+
+bool string_sort_parallel(char ** strings, size_t amount, ThreadPool * pool) {
+    if (!string_sort_validate(strings, __func__)) return false;
+    if (pool == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to sort on a 'NULL' pool");
+        return false;
+    }
+    if (amount < PARALLEL_THRESHOLD) return string_sort(strings, amount);
+    SortItem * items = malloc(sizeof(SortItem) * amount * 2);
+    if (items == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'items'");
+        return false;
+    }
+    // Filling the items (and writing them back) follows a pointer per string, so it is split across the workers too
+    FillContext fill = { strings, items };
+    if (!thread_pool_parallel_for(pool, 0, amount, PARALLEL_THRESHOLD / 4, string_sort_fill_range, &fill)) {
+        free(items);
+        return false;
+    }
+    string_sort_parallel_radix(pool, items, items + amount, amount, 0, 0);
+    // The write back can't fail halfway (the sequential fallback keeps the strings consistent)
+    if (!thread_pool_parallel_for(pool, 0, amount, PARALLEL_THRESHOLD / 4, string_sort_write_back_range, &fill)) {
+        string_sort_write_back_range(0, amount, &fill);
+    }
+    free(items);
+    return true;
+}
+
+// Utilities (sequential sort)
+
+bool string_sort_validate(char ** strings, const char function[]) {
+    if (strings == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, function, "Trying to sort 'NULL' strings");
+        return false;
+    }
+    return true;
+}
+
+// Sorts the items (whose strings share their first "depth" bytes) by their bytes from "depth" on, leaving the result
+// in "items" (the "temp" items are only used for the distributions)
+void string_sort_radix(SortItem * items, SortItem * temp, size_t amount, size_t depth, size_t cache_depth) {
+    while (amount >= RADIX_THRESHOLD) {
+        // Step 1: Refill the caches once all their bytes were consumed
+        if (depth - cache_depth == CACHE_BYTES) {
+            string_sort_refill(items, amount, depth);
+            cache_depth = depth;
+        }
+        // Step 2: Count the bucket sizes (the bucket of a string is its cached byte at the current depth)
+        unsigned shift = 56 - 8 * (unsigned) (depth - cache_depth);
+        size_t counts[ALPHABET_SIZE] = { 0 };
+        for (size_t i = 0; i < amount; i++) counts[(items[i].cache >> shift) & 0xff]++;
+        // Step 3: If all the strings fall in the same bucket (a common prefix), just move to the next byte
+        unsigned first_byte = (items[0].cache >> shift) & 0xff;
+        if (counts[first_byte] == amount) {
+            if (first_byte == 0) return; // All the strings ended (so they are all equal)
+            depth++;
+            continue;
+        }
+        // Step 4: Distribute the items into their buckets, and copy them back
+        size_t offsets[ALPHABET_SIZE];
+        size_t offset = 0;
+        for (size_t i = 0; i < ALPHABET_SIZE; i++) {
+            offsets[i] = offset;
+            offset += counts[i];
+        }
+        for (size_t i = 0; i < amount; i++) temp[offsets[(items[i].cache >> shift) & 0xff]++] = items[i];
+        memcpy(items, temp, sizeof(SortItem) * amount);
+        // Step 5: Sort every bucket by the next byte (except the bucket of the ended strings)
+        offset = counts[0];
+        for (size_t i = 1; i < ALPHABET_SIZE; i++) {
+            if (counts[i] > 1) string_sort_radix(items + offset, temp + offset, counts[i], depth + 1, cache_depth);
+            offset += counts[i];
+        }
+        return;
+    }
+    string_sort_multikey(items, amount, depth, cache_depth);
+}
+
+// Sorts the items (whose strings share their first "depth" bytes) with a multikey quicksort of the cached words
+void string_sort_multikey(SortItem * items, size_t amount, size_t depth, size_t cache_depth) {
+    // Every cached word starts at the cache depth, where the bytes before the depth are equal for all the items (so
+    // comparing whole words is the same as comparing from the depth on), unless they were all consumed
+    if (amount > 1 && depth - cache_depth == CACHE_BYTES) {
+        string_sort_refill(items, amount, depth);
+        cache_depth = depth;
+    }
+    while (amount > INSERTION_THRESHOLD) {
+        // Step 1: Pick the median of three words as the pivot
+        uint64_t first = items[0].cache, middle = items[amount / 2].cache, last = items[amount - 1].cache;
+        uint64_t pivot = (first < middle) ? ((middle < last) ? middle : ((first < last) ? last : first))
+                                          : ((first < last) ? first : ((middle < last) ? last : middle));
+        // Step 2: Three-way partition ("less" at the start, "greater" at the end, "equal" in the middle)
+        size_t less = 0, current = 0, greater = amount;
+        while (current < greater) {
+            if (items[current].cache < pivot) {
+                SortItem swap = items[less];
+                items[less++] = items[current];
+                items[current++] = swap;
+            } else if (items[current].cache > pivot) {
+                SortItem swap = items[--greater];
+                items[greater] = items[current];
+                items[current] = swap;
+            } else {
+                current++;
+            }
+        }
+        // Step 3: Sort the "less" and "greater" partitions by the same word
+        string_sort_multikey(items, less, cache_depth, cache_depth);
+        string_sort_multikey(items + greater, amount - greater, cache_depth, cache_depth);
+        // Step 4: The "equal" partition is done if its strings ended within the word, otherwise continue at the next word
+        if ((pivot & 0xff) == 0) return;
+        items += less;
+        amount = greater - less;
+        cache_depth += CACHE_BYTES;
+        if (amount > 1) string_sort_refill(items, amount, cache_depth);
+    }
+    string_sort_insertion(items, amount, cache_depth);
+}
+
+void string_sort_insertion(SortItem * items, size_t amount, size_t cache_depth) {
+    for (size_t i = 1; i < amount; i++) {
+        SortItem item = items[i];
+        size_t j = i;
+        while (j > 0 && string_sort_compare(&items[j - 1], &item, cache_depth) > 0) {
+            items[j] = items[j - 1];
+            j--;
+        }
+        items[j] = item;
+    }
+}
+
+// Compares two items from the cache depth on (the cached words first, and then the rest of the strings)
+int string_sort_compare(const SortItem * first, const SortItem * second, size_t cache_depth) {
+    if (first->cache != second->cache) return (first->cache < second->cache) ? -1 : 1;
+    // Equal words, where the strings either ended within the word (so they are equal), or continue after it
+    if ((first->cache & 0xff) == 0) return 0;
+    return strcmp(first->string + cache_depth + CACHE_BYTES, second->string + cache_depth + CACHE_BYTES);
+}
+
+void string_sort_refill(SortItem * items, size_t amount, size_t depth) {
+    for (size_t i = 0; i < amount; i++) items[i].cache = string_sort_load_cache(items[i].string + depth);
+}
+
+// Packs the first 8 bytes of the string big-endian (so comparing the words compares the bytes), zero padded after the
+// terminator (which is never read past, as the strings might end at the end of a page)
+uint64_t string_sort_load_cache(const char * string) {
+    uint64_t cache = 0;
+    for (unsigned i = 0; i < CACHE_BYTES; i++) {
+        unsigned char byte = (unsigned char) string[i];
+        if (byte == 0) break;
+        cache |= (uint64_t) byte << (56 - 8 * i);
+    }
+    return cache;
+}
+
+// Utilities (parallel sort)
+
+// Sorts the items as "string_sort_radix", distributing the big arrays in parallel and sorting their buckets as tasks
+void string_sort_parallel_radix(ThreadPool * pool, SortItem * items, SortItem * temp, size_t amount, size_t depth, size_t cache_depth) {
+    size_t chunks_amount = thread_pool_threads_amount(pool) * CHUNKS_PER_THREAD;
+    ParallelSort sort = { pool, items, temp, amount, depth, cache_depth, (amount + chunks_amount - 1) / chunks_amount, NULL, { 0 } };
+    sort.chunk_offsets = (amount < PARALLEL_THRESHOLD) ? NULL : malloc(sizeof(size_t) * ALPHABET_SIZE * chunks_amount);
+    // Small arrays (or no memory for the histograms) are sorted sequentially (which needs no more memory)
+    if (sort.chunk_offsets == NULL) {
+        string_sort_radix(items, temp, amount, depth, cache_depth);
+        return;
+    }
+    chunks_amount = (amount + sort.chunk_size - 1) / sort.chunk_size;
+    while (true) {
+        // Step 1: Count the histogram of every chunk (refilling the caches first, if needed)
+        if (!thread_pool_parallel_for(pool, 0, chunks_amount, 1, string_sort_count_chunk, &sort)) break;
+        if (sort.depth - sort.cache_depth == CACHE_BYTES) sort.cache_depth = sort.depth;
+        // Step 2: Turn the histograms into the scatter offsets of every chunk (bucket by bucket, chunk by chunk)
+        size_t offset = 0;
+        size_t biggest_bucket = 0;
+        size_t biggest_amount = 0;
+        for (size_t bucket = 0; bucket < ALPHABET_SIZE; bucket++) {
+            sort.bucket_starts[bucket] = offset;
+            for (size_t chunk = 0; chunk < chunks_amount; chunk++) {
+                size_t count = sort.chunk_offsets[chunk * ALPHABET_SIZE + bucket];
+                sort.chunk_offsets[chunk * ALPHABET_SIZE + bucket] = offset;
+                offset += count;
+            }
+            if (offset - sort.bucket_starts[bucket] > biggest_amount) {
+                biggest_bucket = bucket;
+                biggest_amount = offset - sort.bucket_starts[bucket];
+            }
+        }
+        sort.bucket_starts[ALPHABET_SIZE] = offset;
+        // Step 3: If all the strings fall in the same bucket (a common prefix), just move to the next byte
+        if (biggest_amount == amount) {
+            if (biggest_bucket == 0) {
+                free(sort.chunk_offsets);
+                return;
+            }
+            sort.depth++;
+            continue;
+        }
+        // Step 4: Scatter every chunk into its buckets, and then sort the buckets concurrently
+        if (!thread_pool_parallel_for(pool, 0, chunks_amount, 1, string_sort_scatter_chunk, &sort)) break;
+        if (!thread_pool_parallel_for(pool, 0, ALPHABET_SIZE, 1, string_sort_bucket_range, &sort)) {
+            // The items are in the temporary array (distributed but unsorted), so bring them back and sort them here
+            memcpy(items, temp, sizeof(SortItem) * amount);
+            string_sort_radix(items, temp, amount, sort.depth, sort.cache_depth);
+        }
+        free(sort.chunk_offsets);
+        return;
+    }
+    // A parallel step failed (before the scatter), so the items are still consistent and are sorted sequentially
+    free(sort.chunk_offsets);
+    string_sort_radix(items, temp, amount, sort.depth, sort.cache_depth);
+}
+
+void string_sort_count_chunk(size_t start, size_t stop, void * context) {
+    ParallelSort * sort = context;
+    for (size_t chunk = start; chunk < stop; chunk++) {
+        size_t * counts = sort->chunk_offsets + chunk * ALPHABET_SIZE;
+        size_t first = chunk * sort->chunk_size;
+        size_t last = (first + sort->chunk_size < sort->amount) ? first + sort->chunk_size : sort->amount;
+        SortItem * items = sort->items;
+        if (sort->depth - sort->cache_depth == CACHE_BYTES) string_sort_refill(items + first, last - first, sort->depth);
+        size_t cache_depth = (sort->depth - sort->cache_depth == CACHE_BYTES) ? sort->depth : sort->cache_depth;
+        unsigned shift = 56 - 8 * (unsigned) (sort->depth - cache_depth);
+        memset(counts, 0, sizeof(size_t) * ALPHABET_SIZE);
+        for (size_t i = first; i < last; i++) counts[(items[i].cache >> shift) & 0xff]++;
+    }
+}
+
+void string_sort_scatter_chunk(size_t start, size_t stop, void * context) {
+    ParallelSort * sort = context;
+    unsigned shift = 56 - 8 * (unsigned) (sort->depth - sort->cache_depth);
+    for (size_t chunk = start; chunk < stop; chunk++) {
+        size_t * offsets = sort->chunk_offsets + chunk * ALPHABET_SIZE;
+        size_t first = chunk * sort->chunk_size;
+        size_t last = (first + sort->chunk_size < sort->amount) ? first + sort->chunk_size : sort->amount;
+        for (size_t i = first; i < last; i++) sort->temp[offsets[(sort->items[i].cache >> shift) & 0xff]++] = sort->items[i];
+    }
+}
+
+// Copies every bucket back from the temporary items and sorts it (in parallel again while it is still big)
+void string_sort_bucket_range(size_t start, size_t stop, void * context) {
+    ParallelSort * sort = context;
+    for (size_t bucket = start; bucket < stop; bucket++) {
+        size_t first = sort->bucket_starts[bucket];
+        size_t amount = sort->bucket_starts[bucket + 1] - first;
+        if (amount == 0) continue;
+        memcpy(sort->items + first, sort->temp + first, sizeof(SortItem) * amount);
+        if (bucket == 0 || amount == 1) continue;
+        string_sort_parallel_radix(sort->pool, sort->items + first, sort->temp + first, amount, sort->depth + 1, sort->cache_depth);
+    }
+}
+
+void string_sort_fill_range(size_t start, size_t stop, void * context) {
+    FillContext * fill = context;
+    for (size_t i = start; i < stop; i++) {
+        fill->items[i].string = fill->strings[i];
+        fill->items[i].cache = string_sort_load_cache(fill->strings[i]);
+    }
+}
+
+void string_sort_write_back_range(size_t start, size_t stop, void * context) {
+    FillContext * fill = context;
+    for (size_t i = start; i < stop; i++) fill->strings[i] = fill->items[i].string;
+}
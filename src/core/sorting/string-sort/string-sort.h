@@ -0,0 +1,54 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdbool.h>        // For "true", "false" (boolean constants)
+#include <stddef.h>         // For "size_t" (size type)
+#include "thread-pool.h"    // For "ThreadPool" (parallel sorting)
+
+/* string-sort.h */
+#ifndef SORTING_STRING_SORT_H
+#define SORTING_STRING_SORT_H
+
+/**
+ * Sorts the given null terminated strings in ascending order (the same order as "strcmp", comparing the bytes as
+ * unsigned characters), where only the pointers are moved (the strings themselves are untouched).
+ *
+ * Uses a most significant digit radix sort, falling back to a multikey quicksort for the small buckets, where every
+ * string pointer is sorted along with a cached copy of its next 8 bytes (so most steps never dereference the strings).
+ *
+ * @param strings the strings to be sorted (none of them can be {@code NULL})
+ * @param amount the amount of strings
+ *
+ * @note needs "32 * amount" bytes of auxiliary memory, and the sort is not stable (equal strings can be reordered)
+ *
+ * @return {@code true} if the strings were sorted, {@code false} if an error occurred (the strings are untouched)
+ */
+bool string_sort(char ** strings, size_t amount);
+
+/**
+ * Sorts the given null terminated strings in ascending order (as "string_sort"), processing the buckets in parallel.
+ *
+ * The distribution of the big buckets (starting with the whole array) is split across the workers, and then the
+ * buckets are sorted concurrently (the work-stealing balances the buckets of really different sizes).
+ *
+ * @param strings the strings to be sorted (none of them can be {@code NULL})
+ * @param amount the amount of strings
+ * @param pool the thread pool where the sort is executed
+ *
+ * @note needs "32 * amount" bytes of auxiliary memory, and the sort is not stable (equal strings can be reordered)
+ *
+ * @return {@code true} if the strings were sorted, {@code false} if an error occurred (the strings are untouched)
+ */
+bool string_sort_parallel(char ** strings, size_t amount, ThreadPool * pool);
+
+#endif /* SORTING_STRING_SORT_H */
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L // For "clock_gettime", "CLOCK_MONOTONIC" (monotonic clock)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include "compact-string-builder.h"
+#include "string-builder.h"
+
+#define REPETITIONS_AMOUNT 5
+
+// Benchmarking snippet (not abstracted away for piece of code portability)
+double elapsed_seconds(struct timespec start, struct timespec stop) {
+    return (double) (stop.tv_sec - start.tv_sec) + (double) (stop.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Benchmarks
+
+// Short-lived builders (i.e., formatting a log line): create, append a few chains, read the result and destroy
+void short_lived_builders_benchmark(size_t builders_amount) {
+    struct timespec start, stop;
+    size_t checksum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < builders_amount; i++) {
+        StringBuilder * string_builder = string_builder_create_default();
+        string_builder_append_all(string_builder, "GET ");
+        string_builder_append_all(string_builder, "/api/v1/items");
+        string_builder_append_all(string_builder, " 200");
+        checksum += (size_t) string_builder_result(string_builder)[i % 21];
+        string_builder_destroy(string_builder);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    double regular_seconds = elapsed_seconds(start, stop);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < builders_amount; i++) {
+        CompactStringBuilder * string_builder = compact_string_builder_create_default();
+        compact_string_builder_append_all(&string_builder, "GET ");
+        compact_string_builder_append_all(&string_builder, "/api/v1/items");
+        compact_string_builder_append_all(&string_builder, " 200");
+        checksum -= (size_t) compact_string_builder_result(string_builder)[i % 21];
+        compact_string_builder_destroy(string_builder);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    double compact_seconds = elapsed_seconds(start, stop);
+    printf("%-32s %10.1f ns %10.1f ns %8.2fx%s\n", "short-lived builders", regular_seconds / builders_amount * 1e9,
+           compact_seconds / builders_amount * 1e9, regular_seconds / compact_seconds, (checksum == 0) ? "" : " (mismatch)");
+}
+
+// Many live builders touched in a random order (i.e., per-connection buffers), so every access is a cold one
+void cold_builders_benchmark(size_t builders_amount, size_t prefill_length) {
+    struct timespec start, stop;
+    StringBuilder ** regular_builders = malloc(sizeof(StringBuilder *) * builders_amount);
+    CompactStringBuilder ** compact_builders = malloc(sizeof(CompactStringBuilder *) * builders_amount);
+    // Each kind is allocated on its own (interleaving them would pack both blocks of a regular builder in one line)
+    for (size_t i = 0; i < builders_amount; i++) regular_builders[i] = string_builder_create_default();
+    for (size_t i = 0; i < builders_amount; i++) compact_builders[i] = compact_string_builder_create_default();
+    // Fill all of them round-robin, so (as in a long running process) the grown regular chains end up far from their builders
+    for (size_t round = 0; round < prefill_length / 10; round++) {
+        for (size_t i = 0; i < builders_amount; i++) {
+            string_builder_append_all(regular_builders[i], "0123456789");
+            compact_string_builder_append_all(&compact_builders[i], "0123456789");
+        }
+    }
+    // The variants alternate, and the best run of each one is kept (a single run is too noisy on a shared machine)
+    double seconds[2] = { 1e9, 1e9 };
+    for (size_t run = 0; run < 2 * REPETITIONS_AMOUNT; run++) {
+        size_t variant = run % 2;
+        uint64_t random_state = 0x9e3779b97f4a7c15ULL + run;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (size_t i = 0; i < builders_amount; i++) {
+            random_state ^= random_state << 13;
+            random_state ^= random_state >> 7;
+            random_state ^= random_state << 17;
+            size_t index = random_state % builders_amount;
+            if (variant == 0) string_builder_append_one(regular_builders[index], 'x');
+            else compact_string_builder_append_one(&compact_builders[index], 'x');
+        }
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        if (elapsed_seconds(start, stop) < seconds[variant]) seconds[variant] = elapsed_seconds(start, stop);
+    }
+    size_t appends_amount = builders_amount;
+    char name[64];
+    snprintf(name, sizeof(name), "cold builders append (%zu chars)", prefill_length);
+    printf("%-32s %10.1f ns %10.1f ns %8.2fx\n", name, seconds[0] / appends_amount * 1e9,
+           seconds[1] / appends_amount * 1e9, seconds[0] / seconds[1]);
+    for (size_t i = 0; i < builders_amount; i++) {
+        string_builder_destroy(regular_builders[i]);
+        compact_string_builder_destroy(compact_builders[i]);
+    }
+    free(regular_builders);
+    free(compact_builders);
+}
+
+// Benchmarks runner (the arguments optionally override the amount of short-lived builders and of live builders)
+
+int main(int argc, char * argv[]) {
+    size_t builders_amount = (argc > 1) ? strtoull(argv[1], NULL, 10) : 10000000;
+    size_t live_builders_amount = (argc > 2) ? strtoull(argv[2], NULL, 10) : 1000000;
+    printf("%-32s %13s %13s %9s\n", "benchmark", "regular", "compact", "speedup");
+    short_lived_builders_benchmark(builders_amount);
+    cold_builders_benchmark(live_builders_amount, 0);
+    cold_builders_benchmark(live_builders_amount, 40);
+}
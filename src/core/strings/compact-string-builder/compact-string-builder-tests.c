@@ -0,0 +1,127 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "compact-string-builder.h"
+#include "error-reporter.h"
+
+// Assertion snippet (not abstracted away for piece of code portability)
+void assert(int condition, char message[]) {
+    if (condition != 1) {
+        printf("%s\n", message);
+        exit(1);
+    }
+}
+
+// Unit testing
+
+void compact_string_builder_create_test() {
+    printf("*** Running test '%s'\n", __func__);
+    CompactStringBuilder * string_builder = compact_string_builder_create_default();
+    assert(string_builder != NULL, "The 'string_builder' must not be null");
+    assert(strcmp(compact_string_builder_result(string_builder), "") == 0, "The result of a new builder must be empty");
+    assert(compact_string_builder_size(string_builder) == 0, "The 'string_builder' size must be equal to zero");
+    assert(compact_string_builder_max_capacity(string_builder) == 16, "The 'string_builder' capacity must be equal to '16'");
+    compact_string_builder_destroy(string_builder);
+    string_builder = compact_string_builder_create(0);
+    assert(compact_string_builder_max_capacity(string_builder) == 1, "A zero capacity must be raised to one");
+    assert(strcmp(compact_string_builder_result(string_builder), "") == 0, "The result of a zero capacity builder must be empty");
+    compact_string_builder_destroy(string_builder);
+}
+
+void compact_string_builder_append_test() {
+    printf("*** Running test '%s'\n", __func__);
+    CompactStringBuilder * string_builder = compact_string_builder_create(1);
+    char expected[1024];
+    for (size_t i = 0; i < 1000; i++) {
+        expected[i] = (char) ('a' + i % 26);
+        // The builder moves while growing, and the handle must always point to its current location
+        assert(compact_string_builder_append_one(&string_builder, expected[i]), "The character must be appended");
+    }
+    expected[1000] = '\0';
+    assert(strcmp(compact_string_builder_result(string_builder), expected) == 0, "The result must match the appended characters");
+    assert(compact_string_builder_size(string_builder) == 1000, "The size must match the amount of appended characters");
+    assert(compact_string_builder_append_all(&string_builder, "Hello"), "The chain must be appended");
+    assert(compact_string_builder_append_bytes(&string_builder, "\0!", 2), "The bytes must be appended");
+    assert(compact_string_builder_append_bytes(&string_builder, NULL, 0), "An empty run of bytes must be appended");
+    assert(compact_string_builder_size(string_builder) == 1007, "The size must include the 'NULL' byte");
+    assert(memcmp(compact_string_builder_result(string_builder) + 1000, "Hello\0!", 8) == 0, "The bytes must be appended verbatim");
+    char * copy = compact_string_builder_result_as_copy(string_builder);
+    assert(memcmp(copy, compact_string_builder_result(string_builder), 1008) == 0, "The copy must match the result");
+    free(copy);
+    compact_string_builder_destroy(string_builder);
+}
+
+void compact_string_builder_remove_test() {
+    printf("*** Running test '%s'\n", __func__);
+    CompactStringBuilder * string_builder = compact_string_builder_create(1);
+    compact_string_builder_append_all(&string_builder, "Hello world, I am a fancy string builder");
+    assert(compact_string_builder_remove(string_builder, 0, 12), "The range must be removed"); // Delete piece "Hello world, "
+    assert(strcmp(compact_string_builder_result(string_builder), "I am a fancy string builder") == 0, "The result must match the expected chain");
+    assert(compact_string_builder_remove(string_builder, 26, 26), "The last character must be removed");
+    assert(strcmp(compact_string_builder_result(string_builder), "I am a fancy string builde") == 0, "The result must match the expected chain");
+    assert(!compact_string_builder_remove(string_builder, 0, 26), "A range past the end must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "Error must be an invalid argument error");
+    assert(!compact_string_builder_remove(string_builder, 3, 2), "A reversed range must fail");
+    assert(compact_string_builder_clear(string_builder), "The builder must be cleared");
+    assert(!compact_string_builder_remove(string_builder, 0, 0), "Removing from an empty builder must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_STATE, "Error must be an invalid state error");
+    compact_string_builder_destroy(string_builder);
+}
+
+void compact_string_builder_clear_shrink_test() {
+    printf("*** Running test '%s'\n", __func__);
+    CompactStringBuilder * string_builder = compact_string_builder_create_default();
+    for (size_t i = 0; i < 100; i++) compact_string_builder_append_all(&string_builder, "0123456789");
+    size_t capacity = compact_string_builder_max_capacity(string_builder);
+    CompactStringBuilder * location = string_builder;
+    assert(compact_string_builder_clear(string_builder), "The builder must be cleared");
+    assert(compact_string_builder_size(string_builder) == 0, "A cleared builder must be empty");
+    assert(compact_string_builder_max_capacity(string_builder) == capacity, "Clearing must keep the capacity");
+    assert(compact_string_builder_append_all(&string_builder, "abc") && string_builder == location, "Appending within the capacity must not move the builder");
+    assert(compact_string_builder_shrink(&string_builder), "The builder must be shrunk");
+    assert(compact_string_builder_max_capacity(string_builder) == 4, "Shrinking must keep only the characters and the terminator");
+    assert(strcmp(compact_string_builder_result(string_builder), "abc") == 0, "Shrinking must keep the characters");
+    assert(compact_string_builder_append_all(&string_builder, "def"), "A shrunk builder must grow again");
+    assert(strcmp(compact_string_builder_result(string_builder), "abcdef") == 0, "The result must match the expected chain");
+    compact_string_builder_destroy(string_builder);
+}
+
+void compact_string_builder_invalid_arguments_test() {
+    printf("*** Running test '%s'\n", __func__);
+    CompactStringBuilder * string_builder = NULL;
+    assert(!compact_string_builder_append_one(NULL, 'a'), "A 'NULL' handle must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_NULL_ARGUMENT, "Error must be a 'NULL' argument error");
+    assert(!compact_string_builder_append_one(&string_builder, 'a'), "A 'NULL' builder must fail");
+    assert(!compact_string_builder_append_all(&string_builder, "a"), "A 'NULL' builder must fail");
+    assert(!compact_string_builder_shrink(&string_builder), "A 'NULL' builder must not be shrunk");
+    assert(compact_string_builder_result(NULL) == NULL, "A 'NULL' builder must have no result");
+    assert(compact_string_builder_size(NULL) == 0, "A 'NULL' builder must have no characters");
+    string_builder = compact_string_builder_create_default();
+    assert(!compact_string_builder_append_all(&string_builder, NULL), "A 'NULL' chain must fail");
+    assert(!compact_string_builder_append_bytes(&string_builder, NULL, 1), "'NULL' bytes must fail");
+    assert(!compact_string_builder_ensure_capacity(&string_builder, 0), "A zero capacity must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "Error must be an invalid argument error");
+    compact_string_builder_destroy(string_builder);
+}
+
+int main() {
+    fclose(stderr); // Prevent printing "expected" errors
+    compact_string_builder_create_test();
+    compact_string_builder_append_test();
+    compact_string_builder_remove_test();
+    compact_string_builder_clear_shrink_test();
+    compact_string_builder_invalid_arguments_test();
+}
@@ -0,0 +1,244 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * A Non Thread-Safe Single Allocation String Builder Implementation (header and characters in one block).
+ *
+ * ### Explanation ###
+ *
+ * The regular string builder is two heap blocks, the structure and the characters it points to, so the first access
+ * to a cold builder misses the cache twice (the structure, and then the characters), and every create or destroy
+ * performs two allocator calls. Here the characters are a flexible array member at the end of the structure, so the
+ * capacity check and the store of an append touch the same block (usually the same cache line for short strings).
+ *
+ * ### Moving Builders ###
+ *
+ * A block can't be resized in place (see "string-builder.c"), so growing reallocates the whole builder, which might
+ * move it. Instead of adding an indirection (which would bring back the second access this layout removes), the
+ * functions that might grow or shrink the builder take the address of the client's pointer and update it. The growth
+ * sequence is the same as the regular builder (see "growth-policy.c"), so both perform the same reallocations.
+ *
+ * A failed reallocation leaves the original block (and the client's pointer) untouched, so the builder stays usable.
+ *
+ * ### References ###
+ *
+ * - https://en.wikipedia.org/wiki/Flexible_array_member
+ * - https://github.com/antirez/sds (Simple Dynamic Strings, a header and characters in a single allocation)
+ */
+
+// Imports & Headers
+
+#include <stdlib.h>         // For "malloc", "realloc", "free" (memory management)
+#include <string.h>         // For "memcpy", "memmove", "strlen" (better memory copy and utils)
+#include <stddef.h>         // For "offsetof" (size of the header)
+#include <stdint.h>         // For "SIZE_MAX" (overflow checks)
+#include "compact-string-builder.h"
+#include "growth-policy.h"  // For "growth_policy_sequence_index", "growth_policy_next_capacity" (resize strategy)
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+
+// Default implementation values
+
+static const size_t DEFAULT_INITIAL_CAPACITY = GROWTH_POLICY_DEFAULT_CAPACITY;
+
+// Structures
+
+struct compact_string_builder {
+    size_t used_capacity;           // The amount of non-garbage used (or appended) characters
+    size_t max_capacity;            // The current maximum capacity (current max chars amount)
+    size_t current_sequence_index;  // The index of the current sequence value to which resize the array
+    char built_chain[];             // The array of characters (including garbage values), right after the header
+};
+
+// Definition (to be able to use methods before declaring them, to follow up the top-bottom code style)
+
+bool compact_string_builder_resize(CompactStringBuilder ** string_builder, size_t new_capacity);
+
+// Implementation
+
+CompactStringBuilder * compact_string_builder_create_default() {
+    return compact_string_builder_create(DEFAULT_INITIAL_CAPACITY);
+}
+
+CompactStringBuilder * compact_string_builder_create(size_t initial_capacity) {
+    // The result is terminated in place (it can't be grown there, as it does not receive the builder address)
+    if (initial_capacity == 0) initial_capacity = 1;
+    if (initial_capacity > SIZE_MAX - sizeof(CompactStringBuilder)) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'initial_capacity' is too big");
+        return NULL;
+    }
+    CompactStringBuilder * string_builder = malloc(sizeof(CompactStringBuilder) + sizeof(char) * initial_capacity);
+    if (string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'string_builder'");
+        return NULL;
+    }
+    string_builder->used_capacity = 0;
+    string_builder->max_capacity = initial_capacity;
+    string_builder->current_sequence_index = growth_policy_sequence_index(initial_capacity);
+    return string_builder;
+}
+
+void compact_string_builder_destroy(CompactStringBuilder * string_builder) {
+    free(string_builder);
+}
+
+bool compact_string_builder_append_one(CompactStringBuilder ** string_builder, char character) {
+    if (string_builder == NULL || * string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to append a character to a 'NULL' builder");
+        return false;
+    }
+    // Fast path: there is room for the character and the 'NULL' terminator, otherwise grow (and maybe move) first
+    if ((* string_builder)->used_capacity + 1 >= (* string_builder)->max_capacity) {
+        if (!compact_string_builder_ensure_capacity(string_builder, 1)) return false;
+    }
+    CompactStringBuilder * builder = * string_builder;
+    builder->built_chain[builder->used_capacity++] = character;
+    return true;
+}
+
+bool compact_string_builder_append_all(CompactStringBuilder ** string_builder, const char * chain) {
+    if (chain == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to append a 'NULL' chain to a builder");
+        return false;
+    }
+    return compact_string_builder_append_bytes(string_builder, chain, strlen(chain));
+}
+
+bool compact_string_builder_append_bytes(CompactStringBuilder ** string_builder, const char * bytes, size_t length) {
+    if (string_builder == NULL || * string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to append bytes to a 'NULL' builder");
+        return false;
+    }
+    if (bytes == NULL && length > 0) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to append 'NULL' bytes to a builder");
+        return false;
+    }
+    if (length == 0) return true;
+    if (!compact_string_builder_ensure_capacity(string_builder, length)) return false;
+    CompactStringBuilder * builder = * string_builder;
+    memcpy(builder->built_chain + builder->used_capacity, bytes, length);
+    builder->used_capacity += length;
+    return true;
+}
+
+bool compact_string_builder_ensure_capacity(CompactStringBuilder ** string_builder, size_t chars_amount) {
+    if (string_builder == NULL || * string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to ensure the capacity of a 'NULL' builder");
+        return false;
+    }
+    if (chars_amount < 1) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'chars_amount' must be an integer bigger or equal to '1'");
+        return false;
+    }
+    CompactStringBuilder * builder = * string_builder;
+    // If there is enough capacity for N more chars (plus the 'NULL' terminator), then there's no need to grow
+    if (builder->used_capacity + chars_amount < builder->max_capacity) return true;
+    if (chars_amount > SIZE_MAX - sizeof(CompactStringBuilder) - builder->used_capacity - 1) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'chars_amount' is too big");
+        return false;
+    }
+    // The sequence index only advances once the reallocation succeeded (a failed growth leaves the builder untouched)
+    size_t sequence_index = builder->current_sequence_index;
+    size_t new_capacity = growth_policy_next_capacity(&sequence_index, builder->used_capacity + chars_amount + 1);
+    if (new_capacity > SIZE_MAX - sizeof(CompactStringBuilder)) new_capacity = builder->used_capacity + chars_amount + 1;
+    if (!compact_string_builder_resize(string_builder, new_capacity)) return false;
+    (* string_builder)->current_sequence_index = sequence_index;
+    return true;
+}
+
+bool compact_string_builder_remove(CompactStringBuilder * string_builder, size_t start_index, size_t stop_index) {
+    if (string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to remove characters from a 'NULL' builder");
+        return false;
+    }
+    if (string_builder->used_capacity == 0) {
+        error_reporter_report(ERROR_CODE_INVALID_STATE, __func__, "Trying to remove characters from a empty builder");
+        return false;
+    }
+    if (start_index > stop_index || stop_index >= string_builder->used_capacity) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The range must be ordered and inside the chain");
+        return false;
+    }
+    // Shift all the right side characters to the left (both ranges might overlap)
+    size_t amount_to_move = string_builder->used_capacity - (stop_index + 1);
+    memmove(string_builder->built_chain + start_index, string_builder->built_chain + stop_index + 1, amount_to_move);
+    string_builder->used_capacity -= (stop_index - start_index) + 1;
+    return true;
+}
+
+bool compact_string_builder_clear(CompactStringBuilder * string_builder) {
+    if (string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to clear a 'NULL' builder");
+        return false;
+    }
+    string_builder->used_capacity = 0;
+    return true;
+}
+
+bool compact_string_builder_shrink(CompactStringBuilder ** string_builder) {
+    if (string_builder == NULL || * string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to shrink a 'NULL' builder");
+        return false;
+    }
+    size_t new_capacity = (* string_builder)->used_capacity + 1;
+    if (new_capacity == (* string_builder)->max_capacity) return true;
+    if (!compact_string_builder_resize(string_builder, new_capacity)) return false;
+    (* string_builder)->current_sequence_index = growth_policy_sequence_index(new_capacity);
+    return true;
+}
+
+size_t compact_string_builder_size(CompactStringBuilder * string_builder) {
+    return (string_builder == NULL) ? 0 : string_builder->used_capacity;
+}
+
+size_t compact_string_builder_max_capacity(CompactStringBuilder * string_builder) {
+    return (string_builder == NULL) ? 0 : string_builder->max_capacity;
+}
+
+const char * compact_string_builder_result(CompactStringBuilder * string_builder) {
+    if (string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to get the result of a 'NULL' builder");
+        return NULL;
+    }
+    // There is always room for the terminator (the capacity is kept strictly bigger than the used capacity)
+    string_builder->built_chain[string_builder->used_capacity] = '\0';
+    return string_builder->built_chain;
+}
+
+char * compact_string_builder_result_as_copy(CompactStringBuilder * string_builder) {
+    if (string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to get a copy of the result of a 'NULL' builder");
+        return NULL;
+    }
+    char * copied_chain = malloc(sizeof(char) * (string_builder->used_capacity + 1));
+    if (copied_chain == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'copied_chain'");
+        return NULL;
+    }
+    memcpy(copied_chain, string_builder->built_chain, string_builder->used_capacity);
+    copied_chain[string_builder->used_capacity] = '\0';
+    return copied_chain;
+}
+
+// Utilities
+
+// Reallocates the whole block (header included), updating the client's pointer only if the reallocation succeeded
+bool compact_string_builder_resize(CompactStringBuilder ** string_builder, size_t new_capacity) {
+    CompactStringBuilder * resized_builder = realloc(* string_builder, sizeof(CompactStringBuilder) + sizeof(char) * new_capacity);
+    if (resized_builder == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to reallocate memory for 'resized_builder'");
+        return false;
+    }
+    resized_builder->max_capacity = new_capacity;
+    * string_builder = resized_builder;
+    return true;
+}
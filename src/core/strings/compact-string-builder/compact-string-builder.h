@@ -0,0 +1,168 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdbool.h>   // For "true", "false" (boolean constants)
+#include <stddef.h>    // For "size_t" (size type)
+
+/* compact-string-builder.h */
+#ifndef STRINGS_COMPACT_STRING_BUILDER_H
+#define STRINGS_COMPACT_STRING_BUILDER_H
+
+/**
+ * A string builder whose header and characters share a single allocation (so a cold builder costs one cache miss
+ * instead of two, and creating or destroying it costs one allocator round trip instead of two).
+ *
+ * Growing reallocates the whole block, so the builder itself might move: the functions that might grow it take the
+ * address of the client's builder pointer, and update it in place. Any other copy of the old pointer (and any
+ * pointer into its characters) is invalidated by those functions.
+ */
+typedef struct compact_string_builder CompactStringBuilder;
+
+/**
+ * Creates a compact string builder with the default initial capacity.
+ *
+ * The returned builder must be freed by the client after its usage.
+ *
+ * @return a new compact string builder, or {@code NULL} if an allocation error occurred
+ */
+CompactStringBuilder * compact_string_builder_create_default();
+
+/**
+ * Creates a compact string builder with the provided initial capacity.
+ *
+ * The returned builder must be freed by the client after its usage.
+ *
+ * @param initial_capacity the initial amount of characters allocated along with the builder (raised to one if zero,
+ *                         as the 'NULL' terminator always has a place)
+ *
+ * @return a new compact string builder, or {@code NULL} if an allocation error occurred
+ */
+CompactStringBuilder * compact_string_builder_create(size_t initial_capacity);
+
+/**
+ * Frees the compact string builder (and its characters, as both are a single block).
+ *
+ * @param string_builder the compact string builder that is about to be freed
+ */
+void compact_string_builder_destroy(CompactStringBuilder * string_builder);
+
+/**
+ * Appends one character to the given compact string builder.
+ *
+ * @param string_builder the address of the builder pointer (updated if the builder moves while growing)
+ * @param character the character to be appended
+ *
+ * @note the append operation can only fail if there was a reallocation error (the builder is kept untouched then)
+ *
+ * @return {@code true} if the append operation was successful, {@code false} otherwise
+ */
+bool compact_string_builder_append_one(CompactStringBuilder ** string_builder, char character);
+
+/**
+ * Appends an array of characters to the given compact string builder.
+ *
+ * @param string_builder the address of the builder pointer (updated if the builder moves while growing)
+ * @param chain the 'NULL' terminated array of characters to be appended
+ *
+ * @note the append operation can only fail if there was a reallocation error (the builder is kept untouched then)
+ *
+ * @return {@code true} if the append operation was successful, {@code false} otherwise
+ */
+bool compact_string_builder_append_all(CompactStringBuilder ** string_builder, const char * chain);
+
+/**
+ * Appends the given amount of bytes to the given compact string builder (the bytes might contain 'NULL' characters).
+ *
+ * @param string_builder the address of the builder pointer (updated if the builder moves while growing)
+ * @param bytes the bytes to be appended (only allowed to be {@code NULL} if the "length" is zero)
+ * @param length the amount of bytes to be appended
+ *
+ * @return {@code true} if the append operation was successful, {@code false} otherwise
+ */
+bool compact_string_builder_append_bytes(CompactStringBuilder ** string_builder, const char * bytes, size_t length);
+
+/**
+ * Ensures there is enough capacity for N more characters (plus the 'NULL' terminator), otherwise grows the builder.
+ *
+ * @param string_builder the address of the builder pointer (updated if the builder moves while growing)
+ * @param chars_amount the amount of characters that are about to be appended
+ *
+ * @return {@code true} if the capacity was ensured, {@code false} otherwise
+ */
+bool compact_string_builder_ensure_capacity(CompactStringBuilder ** string_builder, size_t chars_amount);
+
+/**
+ * Removes all the characters between the start index (inclusive) and stop index (inclusive) from the given builder.
+ *
+ * @param string_builder the compact string builder from whom the chain in the given range is to be removed
+ * @param start_index the start inclusive index
+ * @param stop_index the stop inclusive index
+ *
+ * @return {@code true} if the remove operation was successful, {@code false} otherwise
+ */
+bool compact_string_builder_remove(CompactStringBuilder * string_builder, size_t start_index, size_t stop_index);
+
+/**
+ * Clears the builder contents (keeping its capacity, so the builder never moves while clearing).
+ *
+ * @param string_builder the compact string builder that is to be cleared
+ *
+ * @return {@code true} if the clearing the builder was successful, {@code false} otherwise
+ */
+bool compact_string_builder_clear(CompactStringBuilder * string_builder);
+
+/**
+ * Shrinks the builder to its exact size (plus the 'NULL' terminator), releasing the unused capacity.
+ *
+ * @param string_builder the address of the builder pointer (updated if the builder moves while shrinking)
+ *
+ * @return {@code true} if the builder was shrunk, {@code false} otherwise
+ */
+bool compact_string_builder_shrink(CompactStringBuilder ** string_builder);
+
+/**
+ * Returns the amount of characters present in the given compact string builder.
+ *
+ * @return the size of the builder, or '0' if the builder is {@code NULL}
+ */
+size_t compact_string_builder_size(CompactStringBuilder * string_builder);
+
+/**
+ * Returns the current maximum capacity of the given compact string builder.
+ *
+ * @return the current max capacity of the builder, or '0' if the builder is {@code NULL}
+ */
+size_t compact_string_builder_max_capacity(CompactStringBuilder * string_builder);
+
+/**
+ * Returns a pointer to the built chain, which lives inside the builder (so it is never shrunk, and it is valid only
+ * until the builder is grown, shrunk or destroyed).
+ *
+ * @param string_builder the compact string builder from whom the built chain pointer is to be returned
+ *
+ * @return a pointer to the 'NULL' terminated built chain, or {@code NULL} if an error occurred
+ */
+const char * compact_string_builder_result(CompactStringBuilder * string_builder);
+
+/**
+ * Returns a copy of the given builder's constructed string.
+ *
+ * The returned chain must be freed by the client after its usage.
+ *
+ * @param string_builder the compact string builder from whom a built chain copy is to be created
+ *
+ * @return a copy of the constructed string, or {@code NULL} if an allocation error occurred
+ */
+char * compact_string_builder_result_as_copy(CompactStringBuilder * string_builder);
+
+#endif /* STRINGS_COMPACT_STRING_BUILDER_H */
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L // For "clock_gettime", "CLOCK_MONOTONIC" (monotonic clock)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+#include "concurrent-string-builder.h"
+#include "string-builder.h"
+
+// Benchmarking snippet (not abstracted away for piece of code portability)
+double elapsed_seconds(struct timespec start, struct timespec stop) {
+    return (double) (stop.tv_sec - start.tv_sec) + (double) (stop.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Every writer appends its share of the fragments, either to the concurrent builder or to a mutex guarded builder
+
+static char FRAGMENT[] = "GET /index.html HTTP/1.1 200 ";
+
+typedef struct writer_argument {
+    ConcurrentStringBuilder * concurrent_builder;
+    StringBuilder * string_builder;
+    pthread_mutex_t * lock;
+    size_t fragments_amount;
+} WriterArgument;
+
+void * concurrent_writer(void * argument) {
+    WriterArgument * writer = argument;
+    for (size_t i = 0; i < writer->fragments_amount; i++) {
+        concurrent_string_builder_append_sized(writer->concurrent_builder, FRAGMENT, sizeof(FRAGMENT) - 1);
+    }
+    return NULL;
+}
+
+void * mutex_writer(void * argument) {
+    WriterArgument * writer = argument;
+    for (size_t i = 0; i < writer->fragments_amount; i++) {
+        pthread_mutex_lock(writer->lock);
+        string_builder_append_all(writer->string_builder, FRAGMENT);
+        pthread_mutex_unlock(writer->lock);
+    }
+    return NULL;
+}
+
+double run_writers(void * (* writer)(void *), WriterArgument * argument, size_t threads_amount) {
+    struct timespec start, stop;
+    pthread_t * threads = malloc(sizeof(pthread_t) * threads_amount);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < threads_amount; i++) {
+        pthread_create(&threads[i], NULL, writer, argument);
+    }
+    for (size_t i = 0; i < threads_amount; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    free(threads);
+    return elapsed_seconds(start, stop);
+}
+
+// Benchmarks
+
+void concurrent_string_builder_scaling_benchmark(size_t total_fragments) {
+    printf("%8s %16s %16s %10s\n", "threads", "concurrent Mf/s", "mutex Mf/s", "speedup");
+    for (size_t threads_amount = 1; threads_amount <= 64; threads_amount *= 2) {
+        pthread_mutex_t lock;
+        pthread_mutex_init(&lock, NULL);
+        WriterArgument argument;
+        argument.concurrent_builder = concurrent_string_builder_create_default();
+        argument.string_builder = string_builder_create_default();
+        argument.lock = &lock;
+        argument.fragments_amount = total_fragments / threads_amount;
+        size_t fragments_amount = argument.fragments_amount * threads_amount;
+        double concurrent_seconds = run_writers(concurrent_writer, &argument, threads_amount);
+        double mutex_seconds = run_writers(mutex_writer, &argument, threads_amount);
+        printf("%8zu %16.2f %16.2f %9.2fx\n", threads_amount, fragments_amount / concurrent_seconds / 1e6, fragments_amount / mutex_seconds / 1e6, mutex_seconds / concurrent_seconds);
+        concurrent_string_builder_destroy(argument.concurrent_builder);
+        string_builder_destroy(argument.string_builder);
+        pthread_mutex_destroy(&lock);
+    }
+}
+
+// Benchmarks runner (the first argument optionally overrides the total amount of appended fragments)
+
+int main(int argc, char * argv[]) {
+    size_t total_fragments = (argc > 1) ? strtoull(argv[1], NULL, 10) : 4000000;
+    concurrent_string_builder_scaling_benchmark(total_fragments);
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "concurrent-string-builder.h"
+
+// Assertion snippet (not abstracted away for piece of code portability)
+void assert(int condition, char message[]) {
+    if (condition != 1) {
+        printf("%s\n", message);
+        exit(1);
+    }
+}
+
+// Unit testing
+
+void concurrent_string_builder_create_default_test() {
+    printf("*** Running test '%s'\n", __func__);
+    ConcurrentStringBuilder * builder = concurrent_string_builder_create_default();
+    assert(builder != NULL, "The 'builder' must not be null");
+    assert(concurrent_string_builder_size(builder) == 0, "The 'builder' size must be equal to zero");
+    char * given = concurrent_string_builder_result_as_copy(builder);
+    assert(strcmp(given, "") == 0, "The 'builder' result chain must be empty");
+    free(given);
+    concurrent_string_builder_destroy(builder);
+    assert(concurrent_string_builder_create(0) == NULL, "A zero initial capacity must be rejected");
+}
+
+void concurrent_string_builder_append_test() {
+    printf("*** Running test '%s'\n", __func__);
+    char expected[] = "John Smith";
+    ConcurrentStringBuilder * builder = concurrent_string_builder_create(1);
+    assert(concurrent_string_builder_append_all(builder, "John"), "The append all operation must be successful");
+    assert(concurrent_string_builder_append_one(builder, ' '), "The append one operation must be successful");
+    assert(concurrent_string_builder_append_sized(builder, "Smithereens", 5), "The append sized operation must be successful");
+    assert(concurrent_string_builder_size(builder) == strlen(expected), "The 'builder' size must be equal to '10'");
+    char * given = concurrent_string_builder_result_as_copy(builder);
+    assert(strcmp(given, expected) == 0, "The 'builder' result chain must match the expected chain");
+    free(given);
+    concurrent_string_builder_destroy(builder);
+}
+
+void concurrent_string_builder_append_larger_than_segment_test() {
+    printf("*** Running test '%s'\n", __func__);
+    char expected[] = "ABThis chain does not fit in any of the segments";
+    ConcurrentStringBuilder * builder = concurrent_string_builder_create(3);
+    concurrent_string_builder_append_all(builder, "AB");
+    concurrent_string_builder_append_all(builder, "This chain does not fit in any of the segments");
+    char * given = concurrent_string_builder_result_as_copy(builder);
+    assert(strcmp(given, expected) == 0, "The 'builder' result chain must match the expected chain");
+    free(given);
+    concurrent_string_builder_destroy(builder);
+}
+
+void concurrent_string_builder_append_null_test() {
+    printf("*** Running test '%s'\n", __func__);
+    ConcurrentStringBuilder * builder = concurrent_string_builder_create_default();
+    assert(!concurrent_string_builder_append_all(NULL, "A"), "Appending to a 'NULL' builder must fail");
+    assert(!concurrent_string_builder_append_all(builder, NULL), "Appending a 'NULL' chain must fail");
+    assert(concurrent_string_builder_append_sized(builder, "", 0), "Appending zero characters must be successful");
+    assert(concurrent_string_builder_size(builder) == 0, "The 'builder' size must be equal to zero");
+    concurrent_string_builder_destroy(builder);
+}
+
+// Each writer appends the "<letter>0123456789;" fragment (12 chars) many times
+#define WRITERS_AMOUNT 8
+#define FRAGMENTS_PER_WRITER 20000
+
+typedef struct writer_argument {
+    ConcurrentStringBuilder * builder;
+    char letter;
+} WriterArgument;
+
+void * concurrent_string_builder_writer(void * argument) {
+    WriterArgument * writer = argument;
+    char fragment[] = "?0123456789;";
+    fragment[0] = writer->letter;
+    for (size_t i = 0; i < FRAGMENTS_PER_WRITER; i++) {
+        concurrent_string_builder_append_all(writer->builder, fragment);
+    }
+    return NULL;
+}
+
+void concurrent_string_builder_concurrent_append_test() {
+    printf("*** Running test '%s'\n", __func__);
+    ConcurrentStringBuilder * builder = concurrent_string_builder_create(7);
+    pthread_t threads[WRITERS_AMOUNT];
+    WriterArgument arguments[WRITERS_AMOUNT];
+    for (size_t i = 0; i < WRITERS_AMOUNT; i++) {
+        arguments[i].builder = builder;
+        arguments[i].letter = (char) ('A' + i);
+        pthread_create(&threads[i], NULL, concurrent_string_builder_writer, &arguments[i]);
+    }
+    for (size_t i = 0; i < WRITERS_AMOUNT; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    size_t expected_size = WRITERS_AMOUNT * FRAGMENTS_PER_WRITER * 12;
+    assert(concurrent_string_builder_size(builder) == expected_size, "The 'builder' size must match all the appended fragments");
+    char * given = concurrent_string_builder_result_as_copy(builder);
+    assert(strlen(given) == expected_size, "The 'builder' result length must match all the appended fragments");
+    // Every fragment must be intact, and every writer must have all its fragments present
+    size_t fragments_amount[WRITERS_AMOUNT];
+    memset(fragments_amount, 0, sizeof(fragments_amount));
+    for (size_t offset = 0; offset < expected_size; offset += 12) {
+        size_t writer_index = (size_t) (given[offset] - 'A');
+        assert(writer_index < WRITERS_AMOUNT, "The fragment writer letter must be valid");
+        assert(strncmp(given + offset + 1, "0123456789;", 11) == 0, "The fragment must not be interleaved");
+        fragments_amount[writer_index]++;
+    }
+    for (size_t i = 0; i < WRITERS_AMOUNT; i++) {
+        assert(fragments_amount[i] == FRAGMENTS_PER_WRITER, "Every writer must have all its fragments present");
+    }
+    free(given);
+    concurrent_string_builder_destroy(builder);
+}
+
+// Tests runner
+
+int main() {
+    fclose(stderr); // Prevent printing "expected" errors
+    concurrent_string_builder_create_default_test();
+    concurrent_string_builder_append_test();
+    concurrent_string_builder_append_larger_than_segment_test();
+    concurrent_string_builder_append_null_test();
+    concurrent_string_builder_concurrent_append_test();
+}
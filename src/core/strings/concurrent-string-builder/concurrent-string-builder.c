@@ -0,0 +1,241 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * A Thread-Safe Concurrent String Builder Implementation (with chunk-linked segments as growth strategy).
+ *
+ * ### Explanation ###
+ *
+ * When many threads contribute fragments to one shared output, a regular string builder needs an external mutex
+ * around every append, so all the writers end up serialized (and copying while holding the lock).
+ *
+ * This builder stores the characters in a linked list of segments, and the writers reserve space in the current
+ * segment with a single atomic "fetch-add" on its reservation cursor, then copy their characters without any lock.
+ *
+ * ### Segments Are Never Moved ###
+ *
+ * A contiguous buffer can't be reallocated while other writers might still be copying into it, that's why a full
+ * segment is never resized, instead a new (twice larger) segment is linked after it, and the contiguous result is only
+ * produced when finalizing (concatenating the segments in order, once all the writers finished).
+ *
+ * ### Sealing A Full Segment ###
+ *
+ * Since the reservations are handed out in increasing order, exactly one writer reserves the range that crosses the
+ * end of a segment (its offset fits, but its last character doesn't), that writer "seals" the segment by storing its
+ * offset as the segment size, so the trailing unused space is skipped when finalizing. Every writer whose reservation
+ * didn't fit takes the growth lock, links a new segment (unless another writer already did it) and retries there.
+ *
+ * ### References ###
+ *
+ * - https://en.cppreference.com/w/c/atomic/atomic_fetch_add
+ * - https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue (reservation by "fetch-add" idea)
+ */
+
+// Imports & Headers
+
+#include <stdlib.h>         // For "malloc", "free" (memory management)
+#include <string.h>         // For "memcpy", "strlen" (better memory copy and utils)
+#include <stdint.h>         // For "SIZE_MAX" (unsealed segment marker)
+#include <stdatomic.h>      // For "atomic_size_t", "atomic_fetch_add_explicit" (lock-free reservations)
+#include <pthread.h>        // For "pthread_mutex_t" (growth lock)
+#include "concurrent-string-builder.h"
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+
+// Structures
+
+struct segment {
+    struct segment * next;          // The next segment (linked under the growth lock, read when finalizing)
+    size_t capacity;                // The amount of characters that fit in this segment
+    atomic_size_t reserved;         // The reservation cursor (it might exceed the capacity, when the segment is full)
+    atomic_size_t sealed_size;      // The final size of the segment, or "SIZE_MAX" if it was not sealed (yet)
+    char chain[];                   // The array of characters
+};
+
+struct concurrent_string_builder {
+    _Atomic(struct segment *) current;  // The segment where the reservations are currently being performed
+    struct segment * first;             // The first segment (where the finalization starts)
+    size_t next_segment_capacity;       // The capacity of the next segment to be linked (under the growth lock)
+    pthread_mutex_t growth_lock;        // Serializes the linking of new segments (only taken when a segment is full)
+};
+
+// Definition (to be able to use methods before declaring them, to follow up the top-bottom code style)
+
+struct segment * concurrent_string_builder_segment_create(size_t capacity);
+bool concurrent_string_builder_grow(ConcurrentStringBuilder * builder, struct segment * full_segment, size_t length);
+size_t concurrent_string_builder_segment_size(struct segment * segment);
+
+// Default implementation values
+
+static const size_t DEFAULT_INITIAL_CAPACITY = 4096;
+
+ConcurrentStringBuilder * concurrent_string_builder_create_default() {
+    return concurrent_string_builder_create(DEFAULT_INITIAL_CAPACITY);
+}
+
+ConcurrentStringBuilder * concurrent_string_builder_create(size_t initial_capacity) {
+    if (initial_capacity < 1) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'initial_capacity' must be an integer bigger or equal to '1'");
+        return NULL;
+    }
+    struct segment * first = concurrent_string_builder_segment_create(initial_capacity);
+    if (first == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'first'");
+        return NULL;
+    }
+    ConcurrentStringBuilder * builder = malloc(sizeof(ConcurrentStringBuilder));
+    if (builder == NULL) {
+        free(first);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'builder'");
+        return NULL;
+    }
+    if (pthread_mutex_init(&builder->growth_lock, NULL) != 0) {
+        free(first);
+        free(builder);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to initialize the 'growth_lock'");
+        return NULL;
+    }
+    atomic_init(&builder->current, first);
+    builder->first = first;
+    builder->next_segment_capacity = initial_capacity * 2;
+    // Return the new builder
+    return builder;
+}
+
+struct segment * concurrent_string_builder_segment_create(size_t capacity) {
+    struct segment * segment = malloc(sizeof(struct segment) + sizeof(char) * capacity);
+    if (segment == NULL) return NULL;
+    segment->next = NULL;
+    segment->capacity = capacity;
+    atomic_init(&segment->reserved, 0);
+    atomic_init(&segment->sealed_size, SIZE_MAX);
+    return segment;
+}
+
+bool concurrent_string_builder_append_one(ConcurrentStringBuilder * builder, char character) {
+    return concurrent_string_builder_append_sized(builder, &character, 1);
+}
+
+bool concurrent_string_builder_append_all(ConcurrentStringBuilder * builder, const char * chain) {
+    if (chain == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to append a 'NULL' chain to a builder");
+        return false;
+    }
+    return concurrent_string_builder_append_sized(builder, chain, strlen(chain));
+}
+
+bool concurrent_string_builder_append_sized(ConcurrentStringBuilder * builder, const char * chars, size_t length) {
+    if (builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to append characters to a 'NULL' builder");
+        return false;
+    }
+    if (chars == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to append 'NULL' characters to a builder");
+        return false;
+    }
+    // Nothing to be reserved nor copied
+    if (length == 0) return true;
+    while (true) {
+        struct segment * segment = atomic_load_explicit(&builder->current, memory_order_acquire);
+        // Reserve the range "[offset, offset + length)" of the current segment (a single atomic operation)
+        size_t offset = atomic_fetch_add_explicit(&segment->reserved, length, memory_order_relaxed);
+        // If the reserved range fits, then copy the characters without any lock
+        if (offset + length <= segment->capacity) {
+            memcpy(segment->chain + offset, chars, length);
+            return true;
+        }
+        // Otherwise, if our range is the one crossing the end of the segment, then we seal the segment at our offset
+        if (offset <= segment->capacity) {
+            atomic_store_explicit(&segment->sealed_size, offset, memory_order_relaxed);
+        }
+        // Link a new segment (unless someone else already did it) and retry the reservation there
+        if (!concurrent_string_builder_grow(builder, segment, length)) return false;
+    }
+}
+
+bool concurrent_string_builder_grow(ConcurrentStringBuilder * builder, struct segment * full_segment, size_t length) {
+    pthread_mutex_lock(&builder->growth_lock);
+    // If the full segment is still the current one, then nobody linked a new segment yet
+    if (atomic_load_explicit(&builder->current, memory_order_relaxed) == full_segment) {
+        // The new segment must at least fit the characters that didn't fit in the full one
+        size_t capacity = builder->next_segment_capacity;
+        if (capacity < length) capacity = length;
+        struct segment * segment = concurrent_string_builder_segment_create(capacity);
+        if (segment == NULL) {
+            pthread_mutex_unlock(&builder->growth_lock);
+            error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'segment'");
+            return false;
+        }
+        full_segment->next = segment;
+        builder->next_segment_capacity = capacity * 2;
+        // Publish the new segment (its initialization happens before any writer reserving in it)
+        atomic_store_explicit(&builder->current, segment, memory_order_release);
+    }
+    pthread_mutex_unlock(&builder->growth_lock);
+    return true;
+}
+
+size_t concurrent_string_builder_segment_size(struct segment * segment) {
+    // A sealed segment ends where the crossing reservation started, otherwise all the reserved range was written
+    size_t sealed_size = atomic_load_explicit(&segment->sealed_size, memory_order_relaxed);
+    if (sealed_size != SIZE_MAX) return sealed_size;
+    return atomic_load_explicit(&segment->reserved, memory_order_relaxed);
+}
+
+size_t concurrent_string_builder_size(ConcurrentStringBuilder * builder) {
+    if (builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to get the size of a 'NULL' builder");
+        return 0;
+    }
+    size_t size = 0;
+    for (struct segment * segment = builder->first; segment != NULL; segment = segment->next) {
+        size += concurrent_string_builder_segment_size(segment);
+    }
+    return size;
+}
+
+char * concurrent_string_builder_result_as_copy(ConcurrentStringBuilder * builder) {
+    if (builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to get a copy of the result of a 'NULL' builder");
+        return NULL;
+    }
+    size_t size = concurrent_string_builder_size(builder);
+    char * copied_chain = malloc(sizeof(char) * (size + 1));
+    if (copied_chain == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'copied_chain'");
+        return NULL;
+    }
+    // Concatenate all the segments in order
+    char * to = copied_chain;
+    for (struct segment * segment = builder->first; segment != NULL; segment = segment->next) {
+        size_t segment_size = concurrent_string_builder_segment_size(segment);
+        memcpy(to, segment->chain, segment_size);
+        to += segment_size;
+    }
+    // Append the 'NULL' terminator at the last extra character
+    (* to) = '\0';
+    // Return the copied chain
+    return copied_chain;
+}
+
+void concurrent_string_builder_destroy(ConcurrentStringBuilder * builder) {
+    if (builder != NULL) {
+        struct segment * segment = builder->first;
+        while (segment != NULL) {
+            struct segment * next = segment->next;
+            free(segment);
+            segment = next;
+        }
+        pthread_mutex_destroy(&builder->growth_lock);
+        free(builder);
+    }
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdbool.h>   // For "true", "false" (boolean constants)
+#include <stddef.h>    // For "size_t" (size type)
+
+/* concurrent-string-builder.h */
+#ifndef STRINGS_CONCURRENT_STRING_BUILDER_H
+#define STRINGS_CONCURRENT_STRING_BUILDER_H
+
+typedef struct concurrent_string_builder ConcurrentStringBuilder;
+
+/**
+ * Creates a concurrent string builder with the default initial segment capacity.
+ *
+ * The returned builder must be freed by the client after its usage.
+ *
+ * @return a new concurrent string builder, or {@code NULL} if an allocation error occurred
+ */
+ConcurrentStringBuilder * concurrent_string_builder_create_default();
+
+/**
+ * Creates a concurrent string builder with the provided initial segment capacity.
+ *
+ * The returned builder must be freed by the client after its usage.
+ *
+ * @param initial_capacity the amount of characters that fit in the first segment (must be greater than zero)
+ *
+ * @return a new concurrent string builder, or {@code NULL} if an allocation error occurred
+ */
+ConcurrentStringBuilder * concurrent_string_builder_create(size_t initial_capacity);
+
+/**
+ * Frees the concurrent string builder structure and all its segments.
+ *
+ * @param builder the concurrent string builder that is about to be freed
+ *
+ * @note no writer must be using the builder anymore
+ */
+void concurrent_string_builder_destroy(ConcurrentStringBuilder * builder);
+
+/**
+ * Appends one character to the given builder (safe to be called concurrently by any amount of threads).
+ *
+ * @param builder the concurrent string builder to whom the character must be appended to
+ * @param character the character to be appended
+ *
+ * @note the append operation can only fail if there was an allocation error
+ *
+ * @return {@code true} if the append operation was successful, {@code false} otherwise
+ */
+bool concurrent_string_builder_append_one(ConcurrentStringBuilder * builder, char character);
+
+/**
+ * Appends an array of characters to the given builder (safe to be called concurrently by any amount of threads).
+ *
+ * The characters of one call are always stored contiguously, but there is no order between the appends performed by
+ * different threads at the same time.
+ *
+ * @param builder the concurrent string builder to whom the array of characters must be appended to
+ * @param chain the array of characters to be appended
+ *
+ * @note the append operation can only fail if there was an allocation error
+ *
+ * @return {@code true} if the append operation was successful, {@code false} otherwise
+ */
+bool concurrent_string_builder_append_all(ConcurrentStringBuilder * builder, const char * chain);
+
+/**
+ * Appends the given amount of characters to the given builder (safe to be called concurrently by any amount of threads).
+ *
+ * @param builder the concurrent string builder to whom the characters must be appended to
+ * @param chars the characters to be appended (not necessarily 'NULL' terminated)
+ * @param length the amount of characters to be appended
+ *
+ * @note the append operation can only fail if there was an allocation error
+ *
+ * @return {@code true} if the append operation was successful, {@code false} otherwise
+ */
+bool concurrent_string_builder_append_sized(ConcurrentStringBuilder * builder, const char * chars, size_t length);
+
+/**
+ * Returns the amount of characters present in the given builder.
+ *
+ * @param builder the concurrent string builder whose size is to be returned
+ *
+ * @note it must only be called once all the writers finished (i.e., after joining them)
+ *
+ * @return the size of the builder
+ */
+size_t concurrent_string_builder_size(ConcurrentStringBuilder * builder);
+
+/**
+ * Returns a contiguous copy of the given builder's constructed string (the segments are concatenated in order).
+ *
+ * The returned chain must be freed by the client after its usage.
+ *
+ * @param builder the concurrent string builder from whom a built chain copy is to be created
+ *
+ * @note it must only be called once all the writers finished (i.e., after joining them)
+ *
+ * @return a copy of the constructed string, or {@code NULL} if an allocation error occurred
+ */
+char * concurrent_string_builder_result_as_copy(ConcurrentStringBuilder * builder);
+
+#endif /* STRINGS_CONCURRENT_STRING_BUILDER_H */
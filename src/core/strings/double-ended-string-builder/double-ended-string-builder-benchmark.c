@@ -0,0 +1,91 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L // For "clock_gettime", "CLOCK_MONOTONIC" (monotonic clock)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "double-ended-string-builder.h"
+#include "string-builder.h"
+
+// Benchmarking snippet (not abstracted away for piece of code portability)
+double elapsed_seconds(struct timespec start, struct timespec stop) {
+    return (double) (stop.tv_sec - start.tv_sec) + (double) (stop.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Benchmarks
+
+// Frames messages whose length prefix is only known after their body is built
+void framing_benchmark(size_t messages_amount, size_t body_chunks_amount) {
+    struct timespec start, stop;
+    char chunk[] = "\"The quick brown fox jumps over the lazy dog\",";
+    char header[32];
+    size_t checksum = 0;
+    // Regular builder: build the body, then copy it after the header into a second builder
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    StringBuilder * body = string_builder_create_default();
+    for (size_t i = 0; i < messages_amount; i++) {
+        string_builder_clear(body);
+        for (size_t j = 0; j < body_chunks_amount; j++) string_builder_append_all(body, chunk);
+        StringBuilder * message = string_builder_create_default();
+        snprintf(header, sizeof(header), "%zu:", string_builder_size(body));
+        string_builder_append_all(message, header);
+        string_builder_append_all(message, string_builder_result(body));
+        checksum += string_builder_size(message);
+        string_builder_destroy(message);
+    }
+    string_builder_destroy(body);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    double regular_seconds = elapsed_seconds(start, stop);
+    // Double-ended builder: build the body after some headroom, then prepend the header in place
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    DoubleEndedStringBuilder * framed = double_ended_string_builder_create_default();
+    for (size_t i = 0; i < messages_amount; i++) {
+        double_ended_string_builder_clear(framed);
+        for (size_t j = 0; j < body_chunks_amount; j++) double_ended_string_builder_append_all(framed, chunk);
+        int header_length = snprintf(header, sizeof(header), "%zu:", double_ended_string_builder_size(framed));
+        double_ended_string_builder_prepend_bytes(framed, header, (size_t) header_length);
+        checksum -= double_ended_string_builder_size(framed);
+    }
+    double_ended_string_builder_destroy(framed);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    double double_ended_seconds = elapsed_seconds(start, stop);
+    printf("%-36s %8zu bytes %10.1f ns %10.1f ns %8.2fx%s\n", "framing (regular vs double-ended)", body_chunks_amount * strlen(chunk),
+           regular_seconds / messages_amount * 1e9, double_ended_seconds / messages_amount * 1e9,
+           regular_seconds / double_ended_seconds, (checksum == 0) ? "" : " (mismatch)");
+}
+
+// Prepends one character at a time (amortized constant time, while a regular builder would copy the whole chain)
+void prepend_one_benchmark(size_t chars_amount) {
+    struct timespec start, stop;
+    DoubleEndedStringBuilder * string_builder = double_ended_string_builder_create(0, 0);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < chars_amount; i++) double_ended_string_builder_prepend_one(string_builder, (char) ('a' + i % 26));
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    double seconds = elapsed_seconds(start, stop);
+    printf("%-36s %12zu chars %10.1f Mchars/s\n", "prepend one", chars_amount, chars_amount / seconds / 1e6);
+    double_ended_string_builder_destroy(string_builder);
+}
+
+// Benchmarks runner (the arguments optionally override the amount of messages and of prepended characters)
+
+int main(int argc, char * argv[]) {
+    size_t messages_amount = (argc > 1) ? strtoull(argv[1], NULL, 10) : 1000000;
+    size_t chars_amount = (argc > 2) ? strtoull(argv[2], NULL, 10) : 50000000;
+    framing_benchmark(messages_amount, 4);
+    framing_benchmark(messages_amount / 10, 64);
+    framing_benchmark(messages_amount / 100, 1024);
+    prepend_one_benchmark(chars_amount);
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "double-ended-string-builder.h"
+#include "error-reporter.h"
+
+// Assertion snippet (not abstracted away for piece of code portability)
+void assert(int condition, char message[]) {
+    if (condition != 1) {
+        printf("%s\n", message);
+        exit(1);
+    }
+}
+
+// Unit testing
+
+void double_ended_string_builder_create_test() {
+    printf("*** Running test '%s'\n", __func__);
+    DoubleEndedStringBuilder * string_builder = double_ended_string_builder_create(8, 32);
+    assert(string_builder != NULL, "The 'string_builder' must not be null");
+    assert(double_ended_string_builder_size(string_builder) == 0, "The 'string_builder' size must be equal to zero");
+    assert(double_ended_string_builder_headroom(string_builder) == 8, "The 'string_builder' headroom must be equal to '8'");
+    assert(double_ended_string_builder_tailroom(string_builder) == 32, "The 'string_builder' tailroom must be equal to '32'");
+    assert(strcmp(double_ended_string_builder_result(string_builder), "") == 0, "The result of a new builder must be empty");
+    double_ended_string_builder_destroy(string_builder);
+}
+
+void double_ended_string_builder_framing_test() {
+    printf("*** Running test '%s'\n", __func__);
+    DoubleEndedStringBuilder * string_builder = double_ended_string_builder_create(8, 64);
+    double_ended_string_builder_append_all(string_builder, "{\"id\":42}");
+    const char * body = double_ended_string_builder_result(string_builder);
+    // The header fits in the headroom, so it is written in place (the body is not moved)
+    char header[8];
+    int header_length = snprintf(header, sizeof(header), "%zu:", double_ended_string_builder_size(string_builder));
+    assert(double_ended_string_builder_prepend_bytes(string_builder, header, (size_t) header_length), "The header must be prepended");
+    assert(double_ended_string_builder_result(string_builder) + header_length == body, "Prepending into the headroom must not move the chain");
+    assert(strcmp(double_ended_string_builder_result(string_builder), "9:{\"id\":42}") == 0, "The framed chain must match the expected chain");
+    assert(double_ended_string_builder_prepend_one(string_builder, '<'), "The character must be prepended");
+    assert(double_ended_string_builder_append_one(string_builder, '>'), "The character must be appended");
+    assert(strcmp(double_ended_string_builder_result(string_builder), "<9:{\"id\":42}>") == 0, "The chain must match the expected chain");
+    double_ended_string_builder_destroy(string_builder);
+}
+
+void double_ended_string_builder_growth_test() {
+    printf("*** Running test '%s'\n", __func__);
+    // Starting without any room, mixing prepends and appends must keep the exact order (checked against a reference)
+    DoubleEndedStringBuilder * string_builder = double_ended_string_builder_create(0, 0);
+    const size_t OPERATIONS_AMOUNT = 20000;
+    char * expected = malloc(2 * OPERATIONS_AMOUNT + 1);
+    size_t expected_head = OPERATIONS_AMOUNT;
+    size_t expected_tail = OPERATIONS_AMOUNT;
+    for (size_t i = 0; i < OPERATIONS_AMOUNT; i++) {
+        char character = (char) ('a' + i % 26);
+        // Phases of prepends and appends, so both sides run out of room over and over
+        if ((i / 1000) % 3 == 0) {
+            assert(double_ended_string_builder_prepend_one(string_builder, character), "The character must be prepended");
+            expected[--expected_head] = character;
+        } else {
+            assert(double_ended_string_builder_append_one(string_builder, character), "The character must be appended");
+            expected[expected_tail++] = character;
+        }
+    }
+    expected[expected_tail] = '\0';
+    assert(double_ended_string_builder_size(string_builder) == OPERATIONS_AMOUNT, "The size must match the amount of characters");
+    assert(strcmp(double_ended_string_builder_result(string_builder), expected + expected_head) == 0, "The chain must match the reference");
+    char * copy = double_ended_string_builder_result_as_copy(string_builder);
+    assert(strcmp(copy, expected + expected_head) == 0, "The copy must match the reference");
+    free(copy);
+    assert(double_ended_string_builder_prepend_all(string_builder, "head:"), "The chain must be prepended");
+    assert(double_ended_string_builder_append_all(string_builder, ":tail"), "The chain must be appended");
+    const char * result = double_ended_string_builder_result(string_builder);
+    assert(strncmp(result, "head:", 5) == 0 && strcmp(result + 5 + OPERATIONS_AMOUNT, ":tail") == 0, "Both ends must match");
+    free(expected);
+    double_ended_string_builder_destroy(string_builder);
+}
+
+void double_ended_string_builder_clear_test() {
+    printf("*** Running test '%s'\n", __func__);
+    DoubleEndedStringBuilder * string_builder = double_ended_string_builder_create(4, 4);
+    for (size_t i = 0; i < 100; i++) double_ended_string_builder_prepend_all(string_builder, "0123456789");
+    assert(double_ended_string_builder_clear(string_builder), "The builder must be cleared");
+    assert(double_ended_string_builder_size(string_builder) == 0, "A cleared builder must be empty");
+    assert(double_ended_string_builder_headroom(string_builder) == 4, "A cleared builder must restore the creation headroom");
+    assert(double_ended_string_builder_tailroom(string_builder) > 900, "A cleared builder must keep its buffer");
+    double_ended_string_builder_append_all(string_builder, "again");
+    assert(strcmp(double_ended_string_builder_result(string_builder), "again") == 0, "A cleared builder must be reusable");
+    double_ended_string_builder_destroy(string_builder);
+}
+
+void double_ended_string_builder_invalid_arguments_test() {
+    printf("*** Running test '%s'\n", __func__);
+    assert(!double_ended_string_builder_prepend_one(NULL, 'a'), "A 'NULL' builder must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_NULL_ARGUMENT, "Error must be a 'NULL' argument error");
+    assert(!double_ended_string_builder_append_one(NULL, 'a'), "A 'NULL' builder must fail");
+    assert(double_ended_string_builder_result(NULL) == NULL, "A 'NULL' builder must have no result");
+    assert(double_ended_string_builder_size(NULL) == 0, "A 'NULL' builder must have no characters");
+    DoubleEndedStringBuilder * string_builder = double_ended_string_builder_create_default();
+    assert(!double_ended_string_builder_prepend_all(string_builder, NULL), "A 'NULL' chain must fail");
+    assert(!double_ended_string_builder_append_bytes(string_builder, NULL, 1), "'NULL' bytes must fail");
+    assert(double_ended_string_builder_prepend_bytes(string_builder, NULL, 0), "An empty run of bytes must be prepended");
+    assert(double_ended_string_builder_create((size_t) -1, 0) == NULL, "A too big headroom must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "Error must be an invalid argument error");
+    double_ended_string_builder_destroy(string_builder);
+}
+
+int main() {
+    fclose(stderr); // Prevent printing "expected" errors
+    double_ended_string_builder_create_test();
+    double_ended_string_builder_framing_test();
+    double_ended_string_builder_growth_test();
+    double_ended_string_builder_clear_test();
+    double_ended_string_builder_invalid_arguments_test();
+}
@@ -0,0 +1,274 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * A Non Thread-Safe Double-Ended String Builder Implementation (with headroom at the front of the buffer).
+ *
+ * ### Explanation ###
+ *
+ * Protocol encoders often learn their header (a length prefix, a checksum, a frame) only once the body is built, and
+ * a regular builder can only prepend by copying the whole body. Here the chain lives in the middle of its buffer,
+ * between a free "headroom" at the front and a free "tailroom" at the back, so both ends grow the same way: writing
+ * into the free room in constant time, and making more room only when that side runs out.
+ *
+ * ### Making Room ###
+ *
+ * When a side runs out of room, the chain is placed again (with a single copy) leaving spare room at both sides:
+ *
+ * 1. If the buffer is at least twice the required size (the chain plus the requested rooms), the chain is simply
+ *    moved inside the same buffer (i.e., a front-heavy usage after a back-heavy one), otherwise a new buffer is
+ *    allocated, following the golden ratio sequence (see "growth-policy.c") up to twice the required size.
+ * 2. The spare room (at least the required size) goes to the side that ran out, while the other side keeps the free
+ *    room it already had (but never more than half of the spare), or half of it if both sides ran out.
+ *
+ * Every placement copies the chain once, but leaves room for at least half that many characters at the side that
+ * ran out, so both prepending and appending are amortized constant time, whatever their mix.
+ *
+ * ### References ###
+ *
+ * - https://www.kernel.org/doc/html/latest/networking/skbuff.html (Linux, "struct sk_buff" headroom and tailroom)
+ * - https://en.wikipedia.org/wiki/Double-ended_queue
+ */
+
+// Imports & Headers
+
+#include <stdlib.h>         // For "malloc", "free" (memory management)
+#include <string.h>         // For "memcpy", "memmove", "strlen" (better memory copy and utils)
+#include <stdint.h>         // For "SIZE_MAX" (overflow checks)
+#include "double-ended-string-builder.h"
+#include "growth-policy.h"  // For "growth_policy_sequence_index", "growth_policy_next_capacity" (resize strategy)
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+
+// Default implementation values
+
+static const size_t DEFAULT_HEADROOM = 16;
+static const size_t DEFAULT_INITIAL_CAPACITY = GROWTH_POLICY_DEFAULT_CAPACITY;
+
+// Structures
+
+struct double_ended_string_builder {
+    char * buffer;                  // The array of characters (the chain lives between the headroom and the tailroom)
+    size_t head;                    // The index of the first character of the chain (the headroom)
+    size_t tail;                    // The index past the last character of the chain (always less than the capacity)
+    size_t capacity;                // The size of the buffer
+    size_t current_sequence_index;  // The index of the current sequence value to which resize the buffer
+    size_t initial_headroom;        // The headroom requested on creation (restored when cleared)
+};
+
+// Definition (to be able to use methods before declaring them, to follow up the top-bottom code style)
+
+bool double_ended_string_builder_make_room(DoubleEndedStringBuilder * string_builder, size_t front_amount, size_t back_amount);
+
+// Implementation
+
+DoubleEndedStringBuilder * double_ended_string_builder_create_default() {
+    return double_ended_string_builder_create(DEFAULT_HEADROOM, DEFAULT_INITIAL_CAPACITY);
+}
+
+DoubleEndedStringBuilder * double_ended_string_builder_create(size_t headroom, size_t initial_capacity) {
+    if (headroom > SIZE_MAX / 4 || initial_capacity > SIZE_MAX / 4) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'headroom' and 'initial_capacity' are too big");
+        return NULL;
+    }
+    DoubleEndedStringBuilder * string_builder = malloc(sizeof(DoubleEndedStringBuilder));
+    if (string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'string_builder'");
+        return NULL;
+    }
+    // Always one extra spot for the string 'NULL' terminator
+    size_t capacity = headroom + initial_capacity + 1;
+    string_builder->buffer = malloc(sizeof(char) * capacity);
+    if (string_builder->buffer == NULL) {
+        free(string_builder);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'buffer'");
+        return NULL;
+    }
+    string_builder->head = headroom;
+    string_builder->tail = headroom;
+    string_builder->capacity = capacity;
+    string_builder->current_sequence_index = growth_policy_sequence_index(capacity);
+    string_builder->initial_headroom = headroom;
+    return string_builder;
+}
+
+void double_ended_string_builder_destroy(DoubleEndedStringBuilder * string_builder) {
+    if (string_builder == NULL) return;
+    free(string_builder->buffer);
+    free(string_builder);
+}
+
+bool double_ended_string_builder_append_one(DoubleEndedStringBuilder * string_builder, char character) {
+    if (string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to append a character to a 'NULL' builder");
+        return false;
+    }
+    // Fast path: there is room for the character and the 'NULL' terminator, otherwise make room first (slow path)
+    if (string_builder->tail + 1 >= string_builder->capacity) {
+        if (!double_ended_string_builder_make_room(string_builder, 0, 1)) return false;
+    }
+    string_builder->buffer[string_builder->tail++] = character;
+    return true;
+}
+
+bool double_ended_string_builder_append_all(DoubleEndedStringBuilder * string_builder, const char * chain) {
+    if (chain == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to append a 'NULL' chain to a builder");
+        return false;
+    }
+    return double_ended_string_builder_append_bytes(string_builder, chain, strlen(chain));
+}
+
+bool double_ended_string_builder_append_bytes(DoubleEndedStringBuilder * string_builder, const char * bytes, size_t length) {
+    if (string_builder == NULL || (bytes == NULL && length > 0)) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to append using 'NULL' arguments");
+        return false;
+    }
+    if (length == 0) return true;
+    if (!double_ended_string_builder_make_room(string_builder, 0, length)) return false;
+    memcpy(string_builder->buffer + string_builder->tail, bytes, length);
+    string_builder->tail += length;
+    return true;
+}
+
+bool double_ended_string_builder_prepend_one(DoubleEndedStringBuilder * string_builder, char character) {
+    if (string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to prepend a character to a 'NULL' builder");
+        return false;
+    }
+    // Fast path: there is headroom for the character, otherwise make room first (slow path)
+    if (string_builder->head == 0) {
+        if (!double_ended_string_builder_make_room(string_builder, 1, 0)) return false;
+    }
+    string_builder->buffer[--string_builder->head] = character;
+    return true;
+}
+
+bool double_ended_string_builder_prepend_all(DoubleEndedStringBuilder * string_builder, const char * chain) {
+    if (chain == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to prepend a 'NULL' chain to a builder");
+        return false;
+    }
+    return double_ended_string_builder_prepend_bytes(string_builder, chain, strlen(chain));
+}
+
+bool double_ended_string_builder_prepend_bytes(DoubleEndedStringBuilder * string_builder, const char * bytes, size_t length) {
+    if (string_builder == NULL || (bytes == NULL && length > 0)) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to prepend using 'NULL' arguments");
+        return false;
+    }
+    if (length == 0) return true;
+    if (!double_ended_string_builder_make_room(string_builder, length, 0)) return false;
+    string_builder->head -= length;
+    memcpy(string_builder->buffer + string_builder->head, bytes, length);
+    return true;
+}
+
+bool double_ended_string_builder_clear(DoubleEndedStringBuilder * string_builder) {
+    if (string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to clear a 'NULL' builder");
+        return false;
+    }
+    size_t headroom = string_builder->initial_headroom;
+    if (headroom >= string_builder->capacity) headroom = string_builder->capacity - 1;
+    string_builder->head = headroom;
+    string_builder->tail = headroom;
+    return true;
+}
+
+size_t double_ended_string_builder_size(DoubleEndedStringBuilder * string_builder) {
+    return (string_builder == NULL) ? 0 : string_builder->tail - string_builder->head;
+}
+
+size_t double_ended_string_builder_headroom(DoubleEndedStringBuilder * string_builder) {
+    return (string_builder == NULL) ? 0 : string_builder->head;
+}
+
+size_t double_ended_string_builder_tailroom(DoubleEndedStringBuilder * string_builder) {
+    // The last spot is reserved for the 'NULL' terminator
+    return (string_builder == NULL) ? 0 : string_builder->capacity - string_builder->tail - 1;
+}
+
+const char * double_ended_string_builder_result(DoubleEndedStringBuilder * string_builder) {
+    if (string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to get the result of a 'NULL' builder");
+        return NULL;
+    }
+    string_builder->buffer[string_builder->tail] = '\0';
+    return string_builder->buffer + string_builder->head;
+}
+
+char * double_ended_string_builder_result_as_copy(DoubleEndedStringBuilder * string_builder) {
+    if (string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to get a copy of the result of a 'NULL' builder");
+        return NULL;
+    }
+    size_t size = string_builder->tail - string_builder->head;
+    char * copied_chain = malloc(sizeof(char) * (size + 1));
+    if (copied_chain == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'copied_chain'");
+        return NULL;
+    }
+    memcpy(copied_chain, string_builder->buffer + string_builder->head, size);
+    copied_chain[size] = '\0';
+    return copied_chain;
+}
+
+// Utilities
+
+// Ensures the given rooms at the front and at the back (plus the 'NULL' terminator), placing the chain again if needed
+bool double_ended_string_builder_make_room(DoubleEndedStringBuilder * string_builder, size_t front_amount, size_t back_amount) {
+    size_t front_room = string_builder->head;
+    size_t back_room = string_builder->capacity - string_builder->tail - 1;
+    bool is_front_short = front_room < front_amount;
+    bool is_back_short = back_room < back_amount;
+    if (!is_front_short && !is_back_short) return true;
+    size_t size = string_builder->tail - string_builder->head;
+    if (front_amount > SIZE_MAX / 4 - size || back_amount > SIZE_MAX / 4 - size - front_amount) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The requested room is too big");
+        return false;
+    }
+    size_t required = size + front_amount + back_amount + 1;
+    // Step 1: Move the chain inside the same buffer if it is big enough, otherwise grow it
+    size_t new_capacity = string_builder->capacity;
+    size_t sequence_index = string_builder->current_sequence_index;
+    if (new_capacity < 2 * required) new_capacity = growth_policy_next_capacity(&sequence_index, 2 * required);
+    // Step 2: Split the spare room, giving it to the side that ran out (the other side keeps its own free room)
+    size_t spare = new_capacity - required;
+    size_t front_spare = spare / 2;
+    if (is_front_short && !is_back_short) {
+        size_t kept_back_room = back_room - back_amount;
+        front_spare = spare - ((kept_back_room < spare / 2) ? kept_back_room : spare / 2);
+    } else if (!is_front_short && is_back_short) {
+        size_t kept_front_room = front_room - front_amount;
+        front_spare = (kept_front_room < spare / 2) ? kept_front_room : spare / 2;
+    }
+    size_t new_head = front_amount + front_spare;
+    // Step 3: Place the chain at its new position
+    if (new_capacity == string_builder->capacity) {
+        memmove(string_builder->buffer + new_head, string_builder->buffer + string_builder->head, size);
+    } else {
+        char * new_buffer = malloc(sizeof(char) * new_capacity);
+        if (new_buffer == NULL) {
+            error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'new_buffer'");
+            return false;
+        }
+        memcpy(new_buffer + new_head, string_builder->buffer + string_builder->head, size);
+        free(string_builder->buffer);
+        string_builder->buffer = new_buffer;
+        string_builder->capacity = new_capacity;
+        string_builder->current_sequence_index = sequence_index;
+    }
+    string_builder->head = new_head;
+    string_builder->tail = new_head + size;
+    return true;
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdbool.h>   // For "true", "false" (boolean constants)
+#include <stddef.h>    // For "size_t" (size type)
+
+/* double-ended-string-builder.h */
+#ifndef STRINGS_DOUBLE_ENDED_STRING_BUILDER_H
+#define STRINGS_DOUBLE_ENDED_STRING_BUILDER_H
+
+typedef struct double_ended_string_builder DoubleEndedStringBuilder;
+
+/**
+ * Creates a double-ended string builder with the default headroom and initial capacity.
+ *
+ * The returned builder must be freed by the client after its usage.
+ *
+ * @return a new double-ended string builder, or {@code NULL} if an allocation error occurred
+ */
+DoubleEndedStringBuilder * double_ended_string_builder_create_default();
+
+/**
+ * Creates a double-ended string builder, whose chain starts after the given headroom (so that many characters can be
+ * prepended without moving the chain, i.e., a framing header learnt once the body is built).
+ *
+ * The returned builder must be freed by the client after its usage.
+ *
+ * @param headroom the amount of characters reserved at the front
+ * @param initial_capacity the amount of characters that can be appended without growing
+ *
+ * @return a new double-ended string builder, or {@code NULL} if an allocation error occurred
+ */
+DoubleEndedStringBuilder * double_ended_string_builder_create(size_t headroom, size_t initial_capacity);
+
+/**
+ * Frees the double-ended string builder structure and its buffer.
+ *
+ * @param string_builder the double-ended string builder that is about to be freed
+ */
+void double_ended_string_builder_destroy(DoubleEndedStringBuilder * string_builder);
+
+/**
+ * Appends one character to the end of the given double-ended string builder.
+ *
+ * @param string_builder the double-ended string builder to whom the character must be appended to
+ * @param character the character to be appended
+ *
+ * @note the append operation can only fail if there was an allocation error
+ *
+ * @return {@code true} if the append operation was successful, {@code false} otherwise
+ */
+bool double_ended_string_builder_append_one(DoubleEndedStringBuilder * string_builder, char character);
+
+/**
+ * Appends an array of characters to the end of the given double-ended string builder.
+ *
+ * @param string_builder the double-ended string builder to whom the array of characters must be appended to
+ * @param chain the 'NULL' terminated array of characters to be appended
+ *
+ * @return {@code true} if the append operation was successful, {@code false} otherwise
+ */
+bool double_ended_string_builder_append_all(DoubleEndedStringBuilder * string_builder, const char * chain);
+
+/**
+ * Appends the given amount of bytes to the end of the given double-ended string builder.
+ *
+ * @param string_builder the double-ended string builder to whom the bytes must be appended to
+ * @param bytes the bytes to be appended (only allowed to be {@code NULL} if the "length" is zero)
+ * @param length the amount of bytes to be appended
+ *
+ * @return {@code true} if the append operation was successful, {@code false} otherwise
+ */
+bool double_ended_string_builder_append_bytes(DoubleEndedStringBuilder * string_builder, const char * bytes, size_t length);
+
+/**
+ * Prepends one character to the front of the given double-ended string builder (amortized constant time).
+ *
+ * @param string_builder the double-ended string builder to whom the character must be prepended to
+ * @param character the character to be prepended
+ *
+ * @note the prepend operation can only fail if there was an allocation error
+ *
+ * @return {@code true} if the prepend operation was successful, {@code false} otherwise
+ */
+bool double_ended_string_builder_prepend_one(DoubleEndedStringBuilder * string_builder, char character);
+
+/**
+ * Prepends an array of characters to the front of the given double-ended string builder (keeping their order, so
+ * prepending "ab" to "cd" results in "abcd").
+ *
+ * @param string_builder the double-ended string builder to whom the array of characters must be prepended to
+ * @param chain the 'NULL' terminated array of characters to be prepended
+ *
+ * @return {@code true} if the prepend operation was successful, {@code false} otherwise
+ */
+bool double_ended_string_builder_prepend_all(DoubleEndedStringBuilder * string_builder, const char * chain);
+
+/**
+ * Prepends the given amount of bytes to the front of the given double-ended string builder (keeping their order).
+ *
+ * @param string_builder the double-ended string builder to whom the bytes must be prepended to
+ * @param bytes the bytes to be prepended (only allowed to be {@code NULL} if the "length" is zero)
+ * @param length the amount of bytes to be prepended
+ *
+ * @return {@code true} if the prepend operation was successful, {@code false} otherwise
+ */
+bool double_ended_string_builder_prepend_bytes(DoubleEndedStringBuilder * string_builder, const char * bytes, size_t length);
+
+/**
+ * Clears the builder contents, keeping its buffer (the chain starts again after the creation headroom, if it fits).
+ *
+ * @param string_builder the double-ended string builder that is to be cleared
+ *
+ * @return {@code true} if the clearing the builder was successful, {@code false} otherwise
+ */
+bool double_ended_string_builder_clear(DoubleEndedStringBuilder * string_builder);
+
+/**
+ * Returns the amount of characters present in the given double-ended string builder.
+ *
+ * @return the size of the builder, or '0' if the builder is {@code NULL}
+ */
+size_t double_ended_string_builder_size(DoubleEndedStringBuilder * string_builder);
+
+/**
+ * Returns the amount of characters that can be prepended to the given builder without moving its chain.
+ *
+ * @return the headroom of the builder, or '0' if the builder is {@code NULL}
+ */
+size_t double_ended_string_builder_headroom(DoubleEndedStringBuilder * string_builder);
+
+/**
+ * Returns the amount of characters that can be appended to the given builder without moving its chain.
+ *
+ * @return the tailroom of the builder, or '0' if the builder is {@code NULL}
+ */
+size_t double_ended_string_builder_tailroom(DoubleEndedStringBuilder * string_builder);
+
+/**
+ * Returns a pointer to the built chain, which lives inside the buffer of the builder (so it is valid only until the
+ * builder is modified or destroyed).
+ *
+ * @param string_builder the double-ended string builder from whom the built chain pointer is to be returned
+ *
+ * @return a pointer to the 'NULL' terminated built chain, or {@code NULL} if an error occurred
+ */
+const char * double_ended_string_builder_result(DoubleEndedStringBuilder * string_builder);
+
+/**
+ * Returns a copy of the given builder's constructed string.
+ *
+ * The returned chain must be freed by the client after its usage.
+ *
+ * @param string_builder the double-ended string builder from whom a built chain copy is to be created
+ *
+ * @return a copy of the constructed string, or {@code NULL} if an allocation error occurred
+ */
+char * double_ended_string_builder_result_as_copy(DoubleEndedStringBuilder * string_builder);
+
+#endif /* STRINGS_DOUBLE_ENDED_STRING_BUILDER_H */
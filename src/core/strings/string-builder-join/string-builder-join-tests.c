@@ -0,0 +1,144 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "string-builder.h"
+#include "string-builder-join.h"
+#include "thread-pool.h"
+
+// Assertion snippet (not abstracted away for piece of code portability)
+void assert(int condition, char message[]) {
+    if (condition != 1) {
+        printf("%s\n", message);
+        exit(1);
+    }
+}
+
+// Unit testing
+
+void string_builder_join_parallel_test() {
+    printf("*** Running test '%s'\n", __func__);
+    char expected[] = "Hello world, I am a fancy string builder";
+    StringBuilder * builders[3];
+    builders[0] = string_builder_create_default();
+    builders[1] = string_builder_create(1);
+    builders[2] = string_builder_create_default();
+    string_builder_append_all(builders[0], "Hello world, ");
+    string_builder_append_all(builders[1], "I am a fancy");
+    string_builder_append_all(builders[2], " string builder");
+    StringBuilder * joined = string_builder_join_parallel(builders, 3, 4);
+    assert(joined != NULL, "The 'joined' builder must not be null");
+    assert(string_builder_size(joined) == strlen(expected), "The 'joined' builder size must match the parts sizes sum");
+    assert(strcmp(string_builder_result(joined), expected) == 0, "The 'joined' result chain must match the expected chain");
+    assert(strcmp(string_builder_result(builders[1]), "I am a fancy") == 0, "The joined parts must be left untouched");
+    for (size_t i = 0; i < 3; i++) string_builder_destroy(builders[i]);
+    string_builder_destroy(joined);
+}
+
+void string_builder_join_parallel_empty_parts_test() {
+    printf("*** Running test '%s'\n", __func__);
+    StringBuilder * builders[3];
+    builders[0] = string_builder_create_default();
+    builders[1] = string_builder_create_default();
+    builders[2] = string_builder_create_default();
+    string_builder_append_all(builders[1], "Spiderman");
+    StringBuilder * joined = string_builder_join_parallel(builders, 3, 2);
+    assert(strcmp(string_builder_result(joined), "Spiderman") == 0, "The empty parts must be skipped");
+    string_builder_destroy(joined);
+    joined = string_builder_join_parallel(builders, 0, 1);
+    assert(strcmp(string_builder_result(joined), "") == 0, "Joining no builders must result in an empty builder");
+    string_builder_destroy(joined);
+    for (size_t i = 0; i < 3; i++) string_builder_destroy(builders[i]);
+}
+
+void string_builder_join_parallel_large_parts_test() {
+    printf("*** Running test '%s'\n", __func__);
+    // Unbalanced parts (the biggest one is split among several threads)
+    size_t sizes[] = { 3000000, 17, 0, 1200000, 5, 900001 };
+    size_t parts_amount = sizeof(sizes) / sizeof(size_t);
+    StringBuilder * builders[sizeof(sizes) / sizeof(size_t)];
+    StringBuilder * expected = string_builder_create_default();
+    for (size_t i = 0; i < parts_amount; i++) {
+        builders[i] = string_builder_create_default();
+        for (size_t j = 0; j < sizes[i]; j++) {
+            char character = (char) ('a' + (i * 7 + j) % 26);
+            string_builder_append_one(builders[i], character);
+            string_builder_append_one(expected, character);
+        }
+    }
+    StringBuilder * joined = string_builder_join_parallel(builders, parts_amount, 8);
+    assert(string_builder_size(joined) == string_builder_size(expected), "The 'joined' builder size must match the parts sizes sum");
+    assert(strcmp(string_builder_result(joined), string_builder_result(expected)) == 0, "The 'joined' result chain must match the sequential join");
+    for (size_t i = 0; i < parts_amount; i++) string_builder_destroy(builders[i]);
+    string_builder_destroy(expected);
+    string_builder_destroy(joined);
+}
+
+void string_builder_join_parallel_pool_test() {
+    printf("*** Running test '%s'\n", __func__);
+    ThreadPoolOptions options = { 4, THREAD_POOL_AFFINITY_NONE, NULL, 0 };
+    ThreadPool * pool = thread_pool_create(&options);
+    // Unbalanced parts (the biggest one is split among several workers), and a small join copied by the caller
+    size_t sizes[] = { 2500000, 3, 0, 700000, 1100001 };
+    size_t parts_amount = sizeof(sizes) / sizeof(size_t);
+    StringBuilder * builders[sizeof(sizes) / sizeof(size_t)];
+    StringBuilder * expected = string_builder_create_default();
+    for (size_t i = 0; i < parts_amount; i++) {
+        builders[i] = string_builder_create_default();
+        for (size_t j = 0; j < sizes[i]; j++) {
+            char character = (char) ('a' + (i * 5 + j) % 26);
+            string_builder_append_one(builders[i], character);
+            string_builder_append_one(expected, character);
+        }
+    }
+    // The pool is reused by consecutive joins
+    for (size_t round = 0; round < 3; round++) {
+        StringBuilder * joined = string_builder_join_parallel_pool(builders, parts_amount, pool);
+        assert(string_builder_size(joined) == string_builder_size(expected), "The 'joined' builder size must match the parts sizes sum");
+        assert(strcmp(string_builder_result(joined), string_builder_result(expected)) == 0, "The 'joined' result chain must match the sequential join");
+        string_builder_destroy(joined);
+    }
+    StringBuilder * joined = string_builder_join_parallel_pool(&builders[1], 1, pool);
+    assert(strcmp(string_builder_result(joined), "fgh") == 0, "A small join must match the part");
+    string_builder_destroy(joined);
+    joined = string_builder_join_parallel_pool(builders, 0, pool);
+    assert(strcmp(string_builder_result(joined), "") == 0, "Joining no builders must result in an empty builder");
+    string_builder_destroy(joined);
+    assert(string_builder_join_parallel_pool(builders, parts_amount, NULL) == NULL, "Joining with a 'NULL' pool must fail");
+    assert(string_builder_join_parallel_pool(NULL, parts_amount, pool) == NULL, "Joining a 'NULL' array must fail");
+    for (size_t i = 0; i < parts_amount; i++) string_builder_destroy(builders[i]);
+    string_builder_destroy(expected);
+    thread_pool_destroy(pool);
+}
+
+void string_builder_join_parallel_invalid_test() {
+    printf("*** Running test '%s'\n", __func__);
+    StringBuilder * builders[2] = { string_builder_create_default(), NULL };
+    assert(string_builder_join_parallel(NULL, 2, 1) == NULL, "Joining a 'NULL' array must fail");
+    assert(string_builder_join_parallel(builders, 2, 1) == NULL, "Joining a 'NULL' builder must fail");
+    assert(string_builder_join_parallel(builders, 1, 0) == NULL, "Joining with zero threads must fail");
+    string_builder_destroy(builders[0]);
+}
+
+// Tests runner
+
+int main() {
+    fclose(stderr); // Prevent printing "expected" errors
+    string_builder_join_parallel_test();
+    string_builder_join_parallel_empty_parts_test();
+    string_builder_join_parallel_large_parts_test();
+    string_builder_join_parallel_pool_test();
+    string_builder_join_parallel_invalid_test();
+}
@@ -0,0 +1,221 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * A Parallel Ordered Join Implementation (for per-thread built parts).
+ *
+ * ### Explanation ###
+ *
+ * A common pattern is splitting the work across threads, where every thread builds its part in its own builder, and
+ * then joining all the parts in order. Appending the parts one by one into a builder regrows the output several times
+ * and copies everything with a single thread.
+ *
+ * Instead, the prefix offsets of the parts are computed first (the offset where every part starts in the output), so
+ * the output is allocated once with the exact size, and then the output byte range is split in equally sized slices,
+ * one per thread, where every thread binary searches the part containing its first byte and copies until its slice is
+ * full. This way every thread copies the same amount of bytes (even if the parts sizes are really unbalanced), and the
+ * memory bandwidth becomes the only limit.
+ *
+ * Threads are only spawned when every one of them has at least "MIN_BYTES_PER_THREAD" bytes to copy, otherwise the
+ * thread creation costs more than the copy itself.
+ *
+ * The pool variant ("string_builder_join_parallel_pool") splits the same byte range with "thread_pool_parallel_for"
+ * instead, so repeated joins reuse the pool workers rather than spawning and joining threads on every call.
+ */
+
+// Imports & Headers
+
+#include <stdlib.h>         // For "malloc", "free" (memory management)
+#include <string.h>         // For "memcpy" (better memory copy)
+#include <pthread.h>        // For "pthread_create", "pthread_join" (copying threads)
+#include "string-builder-join.h"
+#include "string-builder-inline.h"
+#include "thread-pool.h"    // For "thread_pool_parallel_for", "thread_pool_threads_amount" (pooled copying)
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+
+// Structures
+
+typedef struct join_slice {
+    StringBuilder ** builders;      // The ordered array of builders that are being joined
+    size_t * offsets;               // The offset where every part starts in the output (plus the total size at the end)
+    size_t builders_amount;         // The amount of builders being joined
+    char * output;                  // The output chain
+    size_t start;                   // The first output byte to be copied by this slice (inclusive)
+    size_t stop;                    // The last output byte to be copied by this slice (exclusive)
+    pthread_t thread;               // The thread copying this slice
+    bool is_spawned;                // Whether the slice is being copied by its own thread
+} JoinSlice;
+
+// Definition (to be able to use methods before declaring them, to follow up the top-bottom code style)
+
+StringBuilder * string_builder_join_prepare(StringBuilder ** builders, size_t builders_amount, size_t ** offsets);
+void * string_builder_join_copy_slice(void * argument);
+void string_builder_join_copy_range(size_t start, size_t stop, void * context);
+
+// Default implementation values
+
+static const size_t MIN_BYTES_PER_THREAD = 256 * 1024;
+
+StringBuilder * string_builder_join_parallel(StringBuilder ** builders, size_t builders_amount, size_t threads_amount) {
+    if (builders == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to join a 'NULL' array of builders");
+        return NULL;
+    }
+    if (threads_amount < 1) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'threads_amount' must be an integer bigger or equal to '1'");
+        return NULL;
+    }
+    size_t * offsets;
+    StringBuilder * joined = string_builder_join_prepare(builders, builders_amount, &offsets);
+    if (joined == NULL) return NULL;
+    size_t total_size = offsets[builders_amount];
+    // Do not spawn threads that would copy less than the minimum amount of bytes
+    if (threads_amount > total_size / MIN_BYTES_PER_THREAD) threads_amount = total_size / MIN_BYTES_PER_THREAD;
+    if (threads_amount < 1) threads_amount = 1;
+    JoinSlice * slices = malloc(sizeof(JoinSlice) * threads_amount);
+    if (slices == NULL) {
+        free(offsets);
+        string_builder_destroy(joined);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'slices'");
+        return NULL;
+    }
+    // Split the output in equally sized slices (one per thread)
+    for (size_t i = 0; i < threads_amount; i++) {
+        slices[i].builders = builders;
+        slices[i].offsets = offsets;
+        slices[i].builders_amount = builders_amount;
+        slices[i].output = joined->built_chain;
+        slices[i].start = total_size / threads_amount * i;
+        slices[i].stop = (i == threads_amount - 1) ? total_size : total_size / threads_amount * (i + 1);
+    }
+    // Spawn the helper threads (if spawning one fails, then the calling thread copies its slice)
+    for (size_t i = 1; i < threads_amount; i++) {
+        slices[i].is_spawned = pthread_create(&slices[i].thread, NULL, string_builder_join_copy_slice, &slices[i]) == 0;
+        if (!slices[i].is_spawned) string_builder_join_copy_slice(&slices[i]);
+    }
+    // The calling thread always copies the first slice
+    string_builder_join_copy_slice(&slices[0]);
+    for (size_t i = 1; i < threads_amount; i++) {
+        if (slices[i].is_spawned) pthread_join(slices[i].thread, NULL);
+    }
+    joined->used_capacity = total_size;
+    free(slices);
+    free(offsets);
+    // Return the joined builder
+    return joined;
+}
+
+StringBuilder * string_builder_join_parallel_pool(StringBuilder ** builders, size_t builders_amount, ThreadPool * pool) {
+    if (builders == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to join a 'NULL' array of builders");
+        return NULL;
+    }
+    if (pool == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to join builders with a 'NULL' pool");
+        return NULL;
+    }
+    size_t * offsets;
+    StringBuilder * joined = string_builder_join_prepare(builders, builders_amount, &offsets);
+    if (joined == NULL) return NULL;
+    size_t total_size = offsets[builders_amount];
+    // Every sub-range copies at least the minimum amount of bytes, and there are a few sub-ranges per worker to steal
+    size_t grain_size = total_size / (thread_pool_threads_amount(pool) * 4);
+    if (grain_size < MIN_BYTES_PER_THREAD) grain_size = MIN_BYTES_PER_THREAD;
+    JoinSlice range;
+    range.builders = builders;
+    range.offsets = offsets;
+    range.builders_amount = builders_amount;
+    range.output = joined->built_chain;
+    range.start = 0;
+    range.stop = total_size;
+    range.is_spawned = false;
+    bool is_copied;
+    if (total_size <= grain_size) {
+        // A single sub-range is copied by the calling thread (no need to go through the pool)
+        string_builder_join_copy_slice(&range);
+        is_copied = true;
+    } else {
+        is_copied = thread_pool_parallel_for(pool, 0, total_size, grain_size, string_builder_join_copy_range, &range);
+    }
+    free(offsets);
+    if (!is_copied) {
+        string_builder_destroy(joined);
+        return NULL;
+    }
+    joined->used_capacity = total_size;
+    // Return the joined builder
+    return joined;
+}
+
+StringBuilder * string_builder_join_prepare(StringBuilder ** builders, size_t builders_amount, size_t ** offsets) {
+    size_t * prefix_offsets = malloc(sizeof(size_t) * (builders_amount + 1));
+    if (prefix_offsets == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'offsets'");
+        return NULL;
+    }
+    // Compute the prefix offsets (where every part starts in the output)
+    size_t total_size = 0;
+    for (size_t i = 0; i < builders_amount; i++) {
+        if (builders[i] == NULL) {
+            free(prefix_offsets);
+            error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to join a 'NULL' builder");
+            return NULL;
+        }
+        prefix_offsets[i] = total_size;
+        total_size += string_builder_inline_size(builders[i]);
+    }
+    prefix_offsets[builders_amount] = total_size;
+    // Allocate the output once (with an extra spot for the 'NULL' terminator)
+    StringBuilder * joined = string_builder_create(total_size + 1);
+    if (joined == NULL) {
+        free(prefix_offsets);
+        return NULL;
+    }
+    (* offsets) = prefix_offsets;
+    return joined;
+}
+
+void string_builder_join_copy_range(size_t start, size_t stop, void * context) {
+    // Every sub-range copies its own bytes, so it works on a private copy of the shared range
+    JoinSlice slice = * (JoinSlice *) context;
+    slice.start = start;
+    slice.stop = stop;
+    string_builder_join_copy_slice(&slice);
+}
+
+void * string_builder_join_copy_slice(void * argument) {
+    JoinSlice * slice = argument;
+    if (slice->start == slice->stop) return NULL;
+    // Binary search the last part starting at (or before) the first byte of the slice
+    size_t left = 0;
+    size_t right = slice->builders_amount - 1;
+    while (left < right) {
+        size_t middle = left + (right - left + 1) / 2;
+        if (slice->offsets[middle] <= slice->start) {
+            left = middle;
+        } else {
+            right = middle - 1;
+        }
+    }
+    // Copy part by part until the slice is full
+    size_t position = slice->start;
+    for (size_t i = left; i < slice->builders_amount && position < slice->stop; i++) {
+        size_t part_stop = slice->offsets[i + 1];
+        if (part_stop > slice->stop) part_stop = slice->stop;
+        if (part_stop <= position) continue;
+        char * from = slice->builders[i]->built_chain + (position - slice->offsets[i]);
+        memcpy(slice->output + position, from, part_stop - position);
+        position = part_stop;
+    }
+    return NULL;
+}
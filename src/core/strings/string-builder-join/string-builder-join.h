@@ -0,0 +1,56 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stddef.h>    // For "size_t" (size type)
+#include "string-builder.h"
+#include "thread-pool.h"     // For "ThreadPool" (pooled copying)
+
+/* string-builder-join.h */
+#ifndef STRINGS_STRING_BUILDER_JOIN_H
+#define STRINGS_STRING_BUILDER_JOIN_H
+
+/**
+ * Joins (in order) the contents of the given builders into a new builder, copying the parts concurrently.
+ *
+ * The output is allocated only once (with the exact required capacity), and the copy is split in equally sized byte
+ * ranges among the threads (so a single huge part is also copied by several threads).
+ *
+ * The returned builder must be freed by the client after its usage, the given builders are left untouched.
+ *
+ * @param builders the ordered array of builders whose contents are to be joined
+ * @param builders_amount the amount of builders in the array
+ * @param threads_amount the maximum amount of threads copying (including the calling one, must be at least '1')
+ *
+ * @note no other thread must be modifying the given builders while joining them
+ *
+ * @return a new builder with the joined contents, or {@code NULL} if an error occurred
+ */
+StringBuilder * string_builder_join_parallel(StringBuilder ** builders, size_t builders_amount, size_t threads_amount);
+
+/**
+ * Joins (in order) the contents of the given builders into a new builder, copying the parts in the given pool (see
+ * "string_builder_join_parallel", but without spawning threads on every call).
+ *
+ * The returned builder must be freed by the client after its usage, the given builders are left untouched.
+ *
+ * @param builders the ordered array of builders whose contents are to be joined
+ * @param builders_amount the amount of builders in the array
+ * @param pool the thread pool whose workers copy the parts (small joins are copied by the calling thread)
+ *
+ * @note no other thread must be modifying the given builders while joining them
+ *
+ * @return a new builder with the joined contents, or {@code NULL} if an error occurred
+ */
+StringBuilder * string_builder_join_parallel_pool(StringBuilder ** builders, size_t builders_amount, ThreadPool * pool);
+
+#endif /* STRINGS_STRING_BUILDER_JOIN_H */
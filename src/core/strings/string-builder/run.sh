@@ -5,7 +5,7 @@ rm -rf main
 rm -rf report.txt
 
 # Compile and run with valgrind
-gcc -O0 -g -o main string-builder-tests.c string-builder.c
+gcc -O0 -g -DSTRING_BUILDER_STATISTICS -I../../tracing/usdt -I../../errors/error-reporter -I../../memory/growth-policy -o main string-builder-tests.c string-builder.c ../../memory/growth-policy/growth-policy.c ../../errors/error-reporter/error-reporter.c
 valgrind --leak-check=full \
          --show-leak-kinds=all \
          --track-origins=yes \
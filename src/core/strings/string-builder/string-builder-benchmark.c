@@ -0,0 +1,101 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L // For "clock_gettime", "CLOCK_MONOTONIC" (monotonic clock)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include "string-builder.h"
+#include "string-builder-inline.h"
+
+// Benchmarking snippet (not abstracted away for piece of code portability)
+double elapsed_seconds(struct timespec start, struct timespec stop) {
+    return (double) (stop.tv_sec - start.tv_sec) + (double) (stop.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Benchmarks
+
+void string_builder_append_one_benchmark(size_t chars_amount) {
+    struct timespec start, stop;
+    StringBuilder * string_builder = string_builder_create_default();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < chars_amount; i++) {
+        string_builder_append_one(string_builder, (char) ('a' + i % 26));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    double seconds = elapsed_seconds(start, stop);
+    printf("%-44s %12zu chars %10.3f ms %10.1f Mchars/s\n", __func__, chars_amount, seconds * 1e3, chars_amount / seconds / 1e6);
+    string_builder_destroy(string_builder);
+}
+
+void string_builder_inline_append_one_benchmark(size_t chars_amount) {
+    struct timespec start, stop;
+    StringBuilder * string_builder = string_builder_create_default();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < chars_amount; i++) {
+        string_builder_inline_append_one(string_builder, (char) ('a' + i % 26));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    double seconds = elapsed_seconds(start, stop);
+    printf("%-44s %12zu chars %10.3f ms %10.1f Mchars/s\n", __func__, chars_amount, seconds * 1e3, chars_amount / seconds / 1e6);
+    string_builder_destroy(string_builder);
+}
+
+void string_builder_append_all_benchmark(size_t chains_amount) {
+    struct timespec start, stop;
+    char chain[] = "The quick brown fox jumps over the lazy dog";
+    StringBuilder * string_builder = string_builder_create_default();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < chains_amount; i++) {
+        string_builder_append_all(string_builder, chain);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    double seconds = elapsed_seconds(start, stop);
+    printf("%-44s %12zu chains %9.3f ms %10.1f Mchains/s\n", __func__, chains_amount, seconds * 1e3, chains_amount / seconds / 1e6);
+    string_builder_destroy(string_builder);
+}
+
+// A nested serializer: every child is built in its own builder, and then concatenated onto its parent
+void string_builder_append_builder_benchmark(size_t children_amount) {
+    struct timespec start, stop;
+    char chain[] = "{\"id\":42,\"name\":\"The quick brown fox jumps over the lazy dog\"}";
+    double seconds[3];
+    for (size_t variant = 0; variant < 3; variant++) {
+        StringBuilder * parent = string_builder_create_default();
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (size_t i = 0; i < children_amount; i++) {
+            StringBuilder * child = string_builder_create_default();
+            string_builder_append_all(child, chain);
+            if (variant == 0) string_builder_append_all(parent, string_builder_result(child));
+            else if (variant == 1) string_builder_append_builder(parent, child);
+            else string_builder_append_builder_move(parent, child);
+            string_builder_destroy(child);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        seconds[variant] = elapsed_seconds(start, stop);
+        string_builder_destroy(parent);
+    }
+    printf("%-44s %12zu children %7.3f ms (result + append all: %.3f ms, append builder: %.3f ms)\n", __func__,
+           children_amount, seconds[2] * 1e3, seconds[0] * 1e3, seconds[1] * 1e3);
+}
+
+// Benchmarks runner (the first argument optionally overrides the amount of appended characters)
+
+int main(int argc, char * argv[]) {
+    size_t chars_amount = (argc > 1) ? strtoull(argv[1], NULL, 10) : 50000000;
+    string_builder_append_one_benchmark(chars_amount);
+    string_builder_inline_append_one_benchmark(chars_amount);
+    string_builder_append_all_benchmark(chars_amount / 40);
+    string_builder_append_builder_benchmark(chars_amount / 50);
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * Inlinable fast paths of the string builder.
+ *
+ * The regular functions live in "string-builder.c", so appending one character per call (i.e., tokenizers, escapers)
+ * always pays for an out-of-line call that can't be inlined across translation units. This header exposes the builder
+ * structure and provides "static inline" versions of the hot paths, where only the capacity check and the store are
+ * inlined, while the growth (the slow path) remains out of line in "string_builder_ensure_capacity".
+ *
+ * There are two ways of using it:
+ * - Include this header and call the "string_builder_inline_*" functions explicitly.
+ * - Define "STRING_BUILDER_INLINE" before including "string-builder.h" (or when compiling), then the regular
+ *   "string_builder_append_one", "string_builder_size" and "string_builder_max_capacity" calls are redirected here.
+ *
+ * Note: the structure layout depends on "STRING_BUILDER_STATISTICS", so the client and the kit must agree on it.
+ */
+
+#include <stdbool.h>        // For "true", "false" (boolean constants)
+#include <stddef.h>         // For "size_t" (size type)
+#include "string-builder.h"
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+
+/* string-builder-inline.h */
+#ifndef STRINGS_STRING_BUILDER_INLINE_H
+#define STRINGS_STRING_BUILDER_INLINE_H
+
+// Structures
+
+struct string_builder {
+    char * built_chain;             // The array of characters (including garbage values)
+    size_t used_capacity;           // The amount of non-garbage used (or appended) characters
+    size_t max_capacity;            // The current maximum capacity (current max chars amount)
+    size_t current_sequence_index;  // The index of the current sequence value to which resize the array
+#ifdef STRING_BUILDER_STATISTICS
+    size_t reallocations_amount;    // The amount of growth reallocations performed while ensuring the capacity
+    size_t copied_bytes_amount;     // The amount of bytes that the growth reallocations might have copied
+    size_t peak_capacity;           // The highest capacity ever reached
+    size_t shrinks_amount;          // The amount of shrink reallocations performed while obtaining the result
+#endif
+};
+
+/**
+ * Ensures there is enough capacity for N more characters (plus the 'NULL' terminator), otherwise resizes the chain.
+ *
+ * @param string_builder the string builder whose capacity is to be ensured
+ * @param chars_amount the amount of characters that are about to be appended
+ *
+ * @return {@code true} if the capacity was ensured, {@code false} otherwise
+ */
+bool string_builder_ensure_capacity(StringBuilder * string_builder, size_t chars_amount);
+
+/**
+ * Appends one character to the given string builder (inlinable version of "string_builder_append_one").
+ *
+ * @param string_builder the string builder to whom the character must be appended to
+ * @param character the character to be appended
+ *
+ * @return {@code true} if the append operation was successful, {@code false} otherwise
+ */
+static inline bool string_builder_inline_append_one(StringBuilder * string_builder, char character) {
+    if (string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to append a character to a 'NULL' builder");
+        return false;
+    }
+    // Fast path: there is room for the character and the 'NULL' terminator, otherwise grow out of line (slow path)
+    if (string_builder->used_capacity + 1 >= string_builder->max_capacity) {
+        if (!string_builder_ensure_capacity(string_builder, 1)) return false;
+    }
+    string_builder->built_chain[string_builder->used_capacity++] = character;
+    return true;
+}
+
+/**
+ * Returns the amount of characters present in the given string builder (inlinable version of "string_builder_size").
+ *
+ * @return the size of the builder
+ */
+static inline size_t string_builder_inline_size(StringBuilder * string_builder) {
+    return string_builder->used_capacity;
+}
+
+/**
+ * Returns the current maximum capacity of the given builder (inlinable version of "string_builder_max_capacity").
+ *
+ * @return the current max capacity of the builder
+ */
+static inline size_t string_builder_inline_max_capacity(StringBuilder * string_builder) {
+    return string_builder->max_capacity;
+}
+
+// Redirect the regular hot path calls (except in the implementation itself, which defines the out-of-line versions)
+
+#if defined(STRING_BUILDER_INLINE) && !defined(STRING_BUILDER_IMPLEMENTATION)
+#define string_builder_append_one(string_builder, character) string_builder_inline_append_one(string_builder, character)
+#define string_builder_size(string_builder) string_builder_inline_size(string_builder)
+#define string_builder_max_capacity(string_builder) string_builder_inline_max_capacity(string_builder)
+#endif
+
+#endif /* STRINGS_STRING_BUILDER_INLINE_H */
@@ -15,6 +15,8 @@
 #include <stdio.h>
 #include <string.h>
 #include "string-builder.h"
+#include "string-builder-inline.h"
+#include "error-reporter.h"
 
 // Assertion snippet (not abstracted away for piece of code portability)
 void assert(int condition, char message[]) {
@@ -31,9 +33,10 @@ void string_builder_create_default_test() {
     StringBuilder * string_builder = string_builder_create_default();
     if (string_builder == NULL) exit(1);
     assert(string_builder != NULL, "The 'string_builder' must not be null");
+    // The capacity is checked before the result (which shrinks the buffer, and its capacity, to the built chain)
+    assert(string_builder_max_capacity(string_builder) == 16, "The 'string_builder' capacity must be equal to '16'");
     assert(string_builder_result(string_builder) != NULL, "The 'string_builder' result must not be null");
     assert(string_builder_size(string_builder) == 0, "The 'string_builder' size must be equal to zero");
-    assert(string_builder_max_capacity(string_builder) == 16, "The 'string_builder' capacity must be equal to '16'");
     string_builder_destroy(string_builder);
 }
 
@@ -41,9 +44,10 @@ void string_builder_create_with_custom_capacity_test() {
     printf("*** Running test '%s'\n", __func__);
     StringBuilder * string_builder = string_builder_create(0);
     assert(string_builder != NULL, "The 'string_builder' must not be null");
+    // The capacity is checked before the result (which shrinks the buffer, and its capacity, to the built chain)
+    assert(string_builder_max_capacity(string_builder) == 0, "The 'string_builder' capacity must be equal to zero");
     assert(string_builder_result(string_builder) != NULL, "The 'string_builder' result must not be null");
     assert(string_builder_size(string_builder) == 0, "The 'string_builder' size must be equal to zero");
-    assert(string_builder_max_capacity(string_builder) == 0, "The 'string_builder' capacity must be equal to zero");
     string_builder_destroy(string_builder);
 }
 
@@ -65,6 +69,7 @@ void string_builder_remove_from_empty_test() {
     StringBuilder * string_builder = string_builder_create_default();
     bool success = string_builder_remove(string_builder, 0, 0);
     assert(success == false, "The remove operation must throw an error");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_STATE, "The last error must be an invalid state error");
     string_builder_destroy(string_builder);
 }
 
@@ -100,10 +105,11 @@ void string_builder_ensure_capacity_test() {
     char input[] = "AAAAAAAAAAAAAAA";
     StringBuilder * string_builder = string_builder_create(1);
     string_builder_append_all(string_builder, input);
+    assert(string_builder_max_capacity(string_builder) == 17, "The 'string_builder' capacity must be equal to '17'"); // Resizes: 2, 4, 7, 11, [17], 26, 40, 61
     char * given = string_builder_result(string_builder);
     assert(strcmp(given, input) == 0, "The 'string_builder' result chain must match the expected chain");
     assert(string_builder_size(string_builder) == strlen(input), "The 'string_builder' size must be equal to '15'");
-    assert(string_builder_max_capacity(string_builder) == 17, "The 'string_builder' capacity must be equal to '17'"); // Resizes: 2, 4, 7, 11, [17], 26, 40, 61
+    assert(string_builder_max_capacity(string_builder) == 16, "The 'string_builder' capacity must be shrunk to '16'");
     string_builder_destroy(string_builder);
 }
 
@@ -119,6 +125,60 @@ void string_builder_append_test() {
     string_builder_destroy(string_builder);
 }
 
+void string_builder_append_builder_test() {
+    printf("*** Running test '%s'\n", __func__);
+    StringBuilder * destination = string_builder_create(1);
+    StringBuilder * source = string_builder_create_default();
+    string_builder_append_all(destination, "Hello");
+    string_builder_append_all(source, ", world");
+    assert(string_builder_append_builder(destination, source), "The append builder operation must be successful");
+    assert(strcmp(string_builder_result(destination), "Hello, world") == 0, "The destination chain must match the expected chain");
+    assert(strcmp(string_builder_result(source), ", world") == 0, "The source chain must be kept untouched");
+    assert(string_builder_append_builder(destination, destination), "Appending a builder to itself must be successful");
+    assert(strcmp(string_builder_result(destination), "Hello, worldHello, world") == 0, "The doubled chain must match the expected chain");
+    assert(!string_builder_append_builder(destination, NULL), "Appending a 'NULL' builder must fail");
+    string_builder_destroy(destination);
+    string_builder_destroy(source);
+}
+
+void string_builder_append_builder_move_test() {
+    printf("*** Running test '%s'\n", __func__);
+    StringBuilder * destination = string_builder_create_default();
+    StringBuilder * source = string_builder_create(64);
+    string_builder_append_all(source, "stolen");
+    char * source_chain = source->built_chain; // The structure is exposed by "string-builder-inline.h"
+    // An empty destination steals the chain (the very same buffer, without copies)
+    assert(string_builder_append_builder_move(destination, source), "The move operation must be successful");
+    assert(destination->built_chain == source_chain, "An empty destination must steal the source chain");
+    assert(string_builder_size(source) == 0, "The moved source must be empty");
+    assert(string_builder_max_capacity(destination) == 64, "The stolen chain must keep its capacity");
+    // A non-empty destination copies the characters, and the source keeps its capacity
+    string_builder_append_all(source, " chain");
+    size_t source_capacity = string_builder_max_capacity(source);
+    assert(string_builder_append_builder_move(destination, source), "The move operation must be successful");
+    assert(strcmp(string_builder_result(destination), "stolen chain") == 0, "The destination chain must match the expected chain");
+    assert(string_builder_size(source) == 0 && string_builder_max_capacity(source) == source_capacity, "The source must be emptied, keeping its capacity");
+    assert(string_builder_append_all(source, "reused") && strcmp(string_builder_result(source), "reused") == 0, "The moved source must still be usable");
+    assert(!string_builder_append_builder_move(destination, destination), "Moving a builder into itself must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "The last error must be an invalid argument error");
+    string_builder_destroy(destination);
+    string_builder_destroy(source);
+}
+
+void string_builder_swap_test() {
+    printf("*** Running test '%s'\n", __func__);
+    StringBuilder * first_builder = string_builder_create_default();
+    StringBuilder * second_builder = string_builder_create(100);
+    string_builder_append_all(first_builder, "first");
+    string_builder_append_all(second_builder, "second");
+    assert(string_builder_swap(first_builder, second_builder), "The swap operation must be successful");
+    assert(strcmp(string_builder_result(first_builder), "second") == 0, "The first builder must hold the second chain");
+    assert(strcmp(string_builder_result(second_builder), "first") == 0, "The second builder must hold the first chain");
+    assert(!string_builder_swap(first_builder, NULL), "Swapping with a 'NULL' builder must fail");
+    string_builder_destroy(first_builder);
+    string_builder_destroy(second_builder);
+}
+
 void string_builder_clear_test() {
     printf("*** Running test '%s'\n", __func__);
     char input[] = "Don't think you will forgive you";
@@ -167,6 +227,109 @@ void string_builder_destroy_except_chain_test() {
     free(given); // We need to free it explicitly after usage (that's the drawback of this destroy method)
 }
 
+void string_builder_adopt_test() {
+    printf("*** Running test '%s'\n", __func__);
+    char * buffer = malloc(8);
+    memcpy(buffer, "Hello", 5);
+    StringBuilder * string_builder = string_builder_adopt(buffer, 5, 8);
+    assert(string_builder != NULL, "The 'string_builder' must not be null");
+    assert(string_builder_size(string_builder) == 5, "The 'string_builder' size must be equal to the adopted length");
+    assert(string_builder_max_capacity(string_builder) == 8, "The 'string_builder' capacity must be equal to the adopted capacity");
+    string_builder_append_all(string_builder, ", world");
+    assert(strcmp(string_builder_result(string_builder), "Hello, world") == 0, "The 'string_builder' result chain must match the expected chain");
+    string_builder_destroy(string_builder);
+    // A full buffer (no room for the 'NULL' terminator) must grow when its result is obtained
+    buffer = malloc(3);
+    memcpy(buffer, "abc", 3);
+    string_builder = string_builder_adopt(buffer, 3, 3);
+    assert(strcmp(string_builder_result(string_builder), "abc") == 0, "The 'string_builder' result chain must match the expected chain");
+    string_builder_destroy(string_builder);
+    buffer = malloc(1);
+    assert(string_builder_adopt(buffer, 2, 1) == NULL, "A length greater than the capacity must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "The last error must be an invalid argument error");
+    free(buffer); // A failed adoption leaves the buffer with the client
+    assert(string_builder_adopt(NULL, 0, 0) == NULL, "A 'NULL' buffer must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_NULL_ARGUMENT, "The last error must be a 'NULL' argument error");
+}
+
+void string_builder_detach_test() {
+    printf("*** Running test '%s'\n", __func__);
+    StringBuilder * string_builder = string_builder_create(32);
+    string_builder_append_all(string_builder, "Detached");
+    size_t length = 0;
+    size_t capacity = 0;
+    char * chain = string_builder_detach(string_builder, &length, &capacity);
+    assert(chain != NULL, "The detached chain must not be null");
+    assert(length == 8 && capacity == 32, "The detached length and capacity must not be shrunk");
+    assert(strcmp(chain, "Detached") == 0, "The detached chain must be terminated");
+    // Adopting the detached chain again must keep the very same buffer (no copies in either direction)
+    string_builder = string_builder_adopt(chain, length, capacity);
+    string_builder_append_one(string_builder, '!');
+    assert(string_builder_detach(string_builder, NULL, NULL) == chain, "The chain must travel without being copied");
+    assert(strcmp(chain, "Detached!") == 0, "The detached chain must match the expected chain");
+    free(chain);
+    // Detaching after the result must report the shrunk capacity (so appending past the old length grows the buffer)
+    string_builder = string_builder_create(64);
+    string_builder_append_all(string_builder, "Shrunk");
+    string_builder_result(string_builder);
+    assert(string_builder_max_capacity(string_builder) == 7, "The capacity must follow the shrunk buffer");
+    chain = string_builder_detach(string_builder, &length, &capacity);
+    assert(length == 6 && capacity == 7, "The detached capacity must be the shrunk one");
+    string_builder = string_builder_adopt(chain, length, capacity);
+    for (size_t i = 0; i < 100; i++) string_builder_append_one(string_builder, '!');
+    chain = string_builder_result(string_builder);
+    assert(strlen(chain) == 106 && strncmp(chain, "Shrunk!!!", 9) == 0, "Appending past the shrunk length must grow the buffer");
+    string_builder_destroy(string_builder);
+    assert(string_builder_detach(NULL, &length, &capacity) == NULL, "Detaching from a 'NULL' builder must fail");
+}
+
+void string_builder_statistics_test() {
+    printf("*** Running test '%s'\n", __func__);
+    char input[] = "AAAAAAAAAAAAAAA";
+    StringBuilderStatistics statistics;
+    StringBuilderGlobalStatistics global_statistics;
+    string_builder_global_statistics_reset();
+    StringBuilder * string_builder = string_builder_create(1);
+    string_builder_append_all(string_builder, input); // Resizes from '1' to '17' in a single reallocation
+    string_builder_result(string_builder); // Shrinks from '17' to '16'
+#ifdef STRING_BUILDER_STATISTICS
+    assert(string_builder_statistics(string_builder, &statistics), "The 'string_builder' statistics must be obtained");
+    assert(statistics.reallocations_amount == 1, "The 'string_builder' reallocations amount must be equal to '1'");
+    assert(statistics.copied_bytes_amount == 1, "The 'string_builder' copied bytes amount must be equal to '1'");
+    assert(statistics.peak_capacity == 17, "The 'string_builder' peak capacity must be equal to '17'");
+    assert(statistics.shrinks_amount == 1, "The 'string_builder' shrinks amount must be equal to '1'");
+    string_builder_destroy(string_builder);
+    assert(string_builder_global_statistics(&global_statistics), "The global statistics must be obtained");
+    assert(global_statistics.created_amount == 1, "The global created amount must be equal to '1'");
+    assert(global_statistics.destroyed_amount == 1, "The global destroyed amount must be equal to '1'");
+    assert(global_statistics.reallocations_amount == 1, "The global reallocations amount must be equal to '1'");
+    assert(global_statistics.shrinks_amount == 1, "The global shrinks amount must be equal to '1'");
+    assert(global_statistics.peak_capacity == 17, "The global peak capacity must be equal to '17'");
+    assert(global_statistics.peak_capacity_histogram[4] == 1, "The '[16, 31]' histogram bucket must be equal to '1'");
+    FILE * stream = tmpfile();
+    assert(string_builder_global_statistics_dump(stream), "The global statistics must be dumped");
+    fclose(stream);
+#else
+    assert(!string_builder_statistics(string_builder, &statistics), "The statistics must be disabled");
+    assert(!string_builder_global_statistics(&global_statistics), "The global statistics must be disabled");
+    string_builder_destroy(string_builder);
+#endif
+}
+
+void string_builder_inline_append_one_test() {
+    printf("*** Running test '%s'\n", __func__);
+    char expected[] = "Hello";
+    StringBuilder * string_builder = string_builder_create(0);
+    for (size_t i = 0; i < strlen(expected); i++) {
+        assert(string_builder_inline_append_one(string_builder, expected[i]), "The inline append operation must be successful");
+    }
+    assert(string_builder_inline_size(string_builder) == strlen(expected), "The 'string_builder' size must be equal to '5'");
+    assert(string_builder_inline_max_capacity(string_builder) > strlen(expected), "The 'string_builder' capacity must fit the 'NULL' terminator");
+    assert(strcmp(string_builder_result(string_builder), expected) == 0, "The 'string_builder' result chain must match the expected chain");
+    assert(!string_builder_inline_append_one(NULL, 'A'), "The inline append operation on a 'NULL' builder must fail");
+    string_builder_destroy(string_builder);
+}
+
 // Tests runner
 
 int main() {
@@ -179,8 +342,15 @@ int main() {
     string_builder_remove_from_empty_test();
     string_builder_remove_edge_case_test();
     string_builder_remove_multiple_times_test();
+    string_builder_append_builder_test();
+    string_builder_append_builder_move_test();
+    string_builder_swap_test();
     string_builder_clear_test();
     string_builder_result_test();
     string_builder_result_as_copy_test();
     string_builder_destroy_except_chain_test();
+    string_builder_adopt_test();
+    string_builder_detach_test();
+    string_builder_statistics_test();
+    string_builder_inline_append_one_test();
 }
@@ -75,11 +75,22 @@
  * often similar to the golden mean (~1.6) but a little bit smaller, most implementations use the 1.5 value and this
  * works great in practice.
  *
+ * The precomputed sequence of sizes lives at "growth-policy.c" (shared with the other growable containers of the kit),
+ * and the builder only keeps the index of its next sequence value.
+ *
  * ### Other Strategies ###
  *
  * - Usage of a "double when full" strategy instead of defining a constant resize increment.
  * - Using a "linked list of blocks" (prevents the amortized complexity of reallocation, but poor locality & construction).
  *
+ * ### Statistics ###
+ *
+ * When compiled with "STRING_BUILDER_STATISTICS" defined, every builder counts its growth reallocations, the bytes
+ * those reallocations might have copied, its peak capacity and its shrinks, and the same counters are aggregated
+ * process-wide (with relaxed atomics) along with a power of two histogram of the peak capacities of the destroyed
+ * builders, which tells whether the initial capacities used in production are well sized. When not defined, none of
+ * the counters exist and the statistics functions simply fail.
+ *
  * ### References ###
  *
  * - https://stackoverflow.com/questions/10196942/how-much-to-grow-buffer-in-a-stringbuilder-like-c-module
@@ -92,35 +103,47 @@
 
 // Imports & Headers
 
+#define STRING_BUILDER_IMPLEMENTATION // Prevents redirecting the regular functions to their inline versions
+
 #include <stdlib.h>         // For "malloc", "realloc", "free" (memory management)
-#include <stdio.h>          // For "printf", "stderr" (printing errors)
+#include <stdio.h>          // For "fprintf", "fputc" (printing the statistics)
 #include <string.h>         // For "memcpy", "strlen" (better memory copy and utils)
+#ifdef STRING_BUILDER_STATISTICS
+#include <stdatomic.h>      // For "atomic_size_t", "atomic_fetch_add_explicit" (process-wide counters)
+#endif
 #include "string-builder.h"
+#include "string-builder-inline.h"
+#include "growth-policy.h"  // For "growth_policy_sequence_index", "growth_policy_next_capacity" (resize strategy)
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+#include "usdt.h"           // For "USDT_PROBE2", "USDT_PROBE3" (optional static tracing probes)
 
 // Definition (to be able to use methods before declaring them, to follow up the top-bottom code style)
 
-int string_builder_compute_next_best_sequence_value_index(size_t capacity);
-bool string_builder_ensure_capacity(StringBuilder * string_builder, size_t chars_amount);
 size_t string_builder_compute_new_size(StringBuilder * string_builder, size_t chars_amount);
+#ifdef STRING_BUILDER_STATISTICS
+void string_builder_statistics_record_capacity(StringBuilder * string_builder);
+void string_builder_statistics_record_destroy(StringBuilder * string_builder);
+#endif
 
-// Structures
+// Structures (the "string_builder" structure is defined at "string-builder-inline.h")
 
-struct string_builder {
-    char * built_chain;             // The array of characters (including garbage values)
-    size_t used_capacity;           // The amount of non-garbage used (or appended) characters
-    size_t max_capacity;            // The current maximum capacity (current max chars amount)
-    size_t current_sequence_index;  // The index of the current sequence value to which resize the array
-};
+#ifdef STRING_BUILDER_STATISTICS
 
-// Default implementation values
+// Process-wide statistics (updated with relaxed atomics, as they are only counters and not synchronization points)
+
+static atomic_size_t global_created_amount;
+static atomic_size_t global_destroyed_amount;
+static atomic_size_t global_reallocations_amount;
+static atomic_size_t global_copied_bytes_amount;
+static atomic_size_t global_shrinks_amount;
+static atomic_size_t global_peak_capacity;
+static atomic_size_t global_peak_capacity_histogram[STRING_BUILDER_STATISTICS_HISTOGRAM_SIZE];
 
-static const size_t DEFAULT_INITIAL_CAPACITY = 16;
+#endif
 
-// Precomputed (or cached) "A006999" sequence: "new_size = floor(old_size * 1.5) + 1"
+// Default implementation values
 
-static const size_t SEQUENCE[] = { 0, 1, 2, 4, 7, 11, 17, 26, 40, 61, 92, 139, 209, 314, 472, 709, 1064, 1597, 2396, 3595, 5393, 8090, 12136, 18205, 27308, 40963, 61445, 92168, 138253, 207380, 311071, 466607, 699911, 1049867, 1574801, 2362202, 3543304, 5314957, 7972436, 11958655, 17937983, 26906975, 40360463, 60540695, 90811043, 136216565, 204324848, 306487273, 459730910, 689596366, 1034394550 };
-static const int SEQUENCE_SIZE = sizeof(SEQUENCE) / sizeof(size_t);
-static const size_t SEQUENCE_INIT_NEXT_INDEX = 7; // Best next sequence value index (for initial capacity = "16")
+static const size_t DEFAULT_INITIAL_CAPACITY = GROWTH_POLICY_DEFAULT_CAPACITY;
 
 StringBuilder * string_builder_create_default() {
     return string_builder_create(DEFAULT_INITIAL_CAPACITY);
@@ -128,74 +151,80 @@ StringBuilder * string_builder_create_default() {
 
 StringBuilder * string_builder_create(size_t initial_capacity) {
     if (initial_capacity < 0) {
-        fprintf(stderr, "The 'initial_capacity' must be an integer bigger or equal to '0' at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'initial_capacity' must be an integer bigger or equal to '0'");
         return NULL;
     }
     char * built_chain = malloc(sizeof(char) * initial_capacity);
     if (built_chain == NULL) {
-        fprintf(stderr, "Unable to allocate memory for 'built_chain' at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'built_chain'");
         return NULL;
     }
     StringBuilder * string_builder = malloc(sizeof(StringBuilder));
     if (string_builder == NULL) {
         free(built_chain);
-        fprintf(stderr, "Unable to allocate memory for 'string_builder' at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'string_builder'");
         return NULL;
     }
     string_builder->built_chain = built_chain;
     string_builder->used_capacity = 0;
     string_builder->max_capacity = initial_capacity;
-    string_builder->current_sequence_index = string_builder_compute_next_best_sequence_value_index(initial_capacity);
+    string_builder->current_sequence_index = growth_policy_sequence_index(initial_capacity);
+#ifdef STRING_BUILDER_STATISTICS
+    string_builder->reallocations_amount = 0;
+    string_builder->copied_bytes_amount = 0;
+    string_builder->peak_capacity = 0;
+    string_builder->shrinks_amount = 0;
+    atomic_fetch_add_explicit(&global_created_amount, 1, memory_order_relaxed);
+    string_builder_statistics_record_capacity(string_builder);
+#endif
+    USDT_PROBE2(string_builder_create, string_builder, initial_capacity);
     // Return the new builder
     return string_builder;
 }
 
-// Searches the index of the next sequence value to which we must resize our buffer (i.e., simple binary search)
-int string_builder_compute_next_best_sequence_value_index(size_t capacity) {
-    // If default capacity provided, then the best is to resize the buffer from "16" to "26" chars (located at sequence index "7")
-    // Otherwise, if custom initial size is provided, then find the next best in log(N) time (binary searching the sequence values)
-    if (capacity == DEFAULT_INITIAL_CAPACITY) return SEQUENCE_INIT_NEXT_INDEX;
-    int left = 0;
-    int right = SEQUENCE_SIZE - 1;
-    // Middle always contains a sequence value which is higher than "capacity" provided parameter (i.e., the next resize size)
-    int middle = 0;
-    while (left <= right) {
-        middle = left + (right - left) / 2;
-        if (SEQUENCE[middle] <= capacity) {
-            left = middle + 1;
-        } else {
-            right = middle - 1;
-        }
+StringBuilder * string_builder_adopt(char * buffer, size_t length, size_t capacity) {
+    if (buffer == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to adopt a 'NULL' buffer");
+        return NULL;
+    }
+    if (length > capacity) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'length' must not be greater than the 'capacity'");
+        return NULL;
+    }
+    StringBuilder * string_builder = malloc(sizeof(StringBuilder));
+    if (string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'string_builder'");
+        return NULL;
     }
-    return middle;
+    // The buffer is used as is (a full buffer simply grows on the next append, or when its result is obtained)
+    string_builder->built_chain = buffer;
+    string_builder->used_capacity = length;
+    string_builder->max_capacity = capacity;
+    string_builder->current_sequence_index = growth_policy_sequence_index(capacity);
+#ifdef STRING_BUILDER_STATISTICS
+    string_builder->reallocations_amount = 0;
+    string_builder->copied_bytes_amount = 0;
+    string_builder->peak_capacity = 0;
+    string_builder->shrinks_amount = 0;
+    atomic_fetch_add_explicit(&global_created_amount, 1, memory_order_relaxed);
+    string_builder_statistics_record_capacity(string_builder);
+#endif
+    USDT_PROBE2(string_builder_create, string_builder, capacity);
+    return string_builder;
 }
 
 bool string_builder_append_one(StringBuilder * string_builder, char character) {
-    if (string_builder == NULL) {
-        fprintf(stderr, "Trying to append a character to a 'NULL' builder at '%s'\n", __func__);
-        return false;
-    }
-    // Ensure there is size for one more character to be appended, otherwise resize the chain
-    bool is_capacity_ensured = string_builder_ensure_capacity(string_builder, 1);
-    // If ensuring the capacity wasn't possible, then the "append operation" failed
-    if (!is_capacity_ensured) return false;
-    // Get the last unused character position, which is where the new character is to be appended
-    char * last_unused = string_builder->built_chain + string_builder->used_capacity;
-    // Assign the character value
-    (* last_unused) = character;
-    // Increase the amount of used characters
-    string_builder->used_capacity++;
-    // Return a successful result
-    return true;
+    // Same implementation as the inlinable version (the capacity check and store, growing out of line if needed)
+    return string_builder_inline_append_one(string_builder, character);
 }
 
 bool string_builder_append_all(StringBuilder * string_builder, char * chain) {
     if (string_builder == NULL) {
-        fprintf(stderr, "Trying to append a character to a 'NULL' builder at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to append a character to a 'NULL' builder");
         return false;
     }
     if (chain == NULL) {
-        fprintf(stderr, "Trying to append a 'NULL' chain to a builder at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to append a 'NULL' chain to a builder");
         return false;
     }
     // Obtain the size of the chain to be appended
@@ -214,17 +243,77 @@ bool string_builder_append_all(StringBuilder * string_builder, char * chain) {
     return true;
 }
 
+bool string_builder_append_builder(StringBuilder * destination, StringBuilder * source) {
+    if (destination == NULL || source == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to append using 'NULL' builders");
+        return false;
+    }
+    // The size is known, so there is no need to terminate (nor shrink) the source, and measure it with "strlen"
+    size_t chain_size = source->used_capacity;
+    if (chain_size == 0) return true;
+    if (!string_builder_ensure_capacity(destination, chain_size)) return false;
+    // The chain is read after ensuring the capacity (if the source is the destination, it might have been moved)
+    memcpy(destination->built_chain + destination->used_capacity, source->built_chain, chain_size);
+    destination->used_capacity += chain_size;
+    return true;
+}
+
+bool string_builder_append_builder_move(StringBuilder * destination, StringBuilder * source) {
+    if (destination == NULL || source == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to move using 'NULL' builders");
+        return false;
+    }
+    if (destination == source) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "Trying to move a builder into itself");
+        return false;
+    }
+    // An empty destination steals the whole chain (and hands its own empty chain over to the source)
+    if (destination->used_capacity == 0) {
+        string_builder_swap(destination, source);
+        source->used_capacity = 0;
+        return true;
+    }
+    if (!string_builder_append_builder(destination, source)) return false;
+    source->used_capacity = 0;
+    return true;
+}
+
+bool string_builder_swap(StringBuilder * first_builder, StringBuilder * second_builder) {
+    if (first_builder == NULL || second_builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to swap 'NULL' builders");
+        return false;
+    }
+    // Only the contents are swapped (the statistics keep describing the builder they were collected by)
+    char * built_chain = first_builder->built_chain;
+    size_t used_capacity = first_builder->used_capacity;
+    size_t max_capacity = first_builder->max_capacity;
+    size_t current_sequence_index = first_builder->current_sequence_index;
+    first_builder->built_chain = second_builder->built_chain;
+    first_builder->used_capacity = second_builder->used_capacity;
+    first_builder->max_capacity = second_builder->max_capacity;
+    first_builder->current_sequence_index = second_builder->current_sequence_index;
+    second_builder->built_chain = built_chain;
+    second_builder->used_capacity = used_capacity;
+    second_builder->max_capacity = max_capacity;
+    second_builder->current_sequence_index = current_sequence_index;
+#ifdef STRING_BUILDER_STATISTICS
+    string_builder_statistics_record_capacity(first_builder);
+    string_builder_statistics_record_capacity(second_builder);
+#endif
+    return true;
+}
+
 bool string_builder_ensure_capacity(StringBuilder * string_builder, size_t chars_amount) {
     if (string_builder == NULL) {
-        fprintf(stderr, "Trying to ensure the capacity of a 'NULL' builder at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to ensure the capacity of a 'NULL' builder");
         return false;
     }
     if (chars_amount < 1) {
-        fprintf(stderr, "The 'chars_amount' must be an integer bigger or equal to '1' at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'chars_amount' must be an integer bigger or equal to '1'");
         return false;
     }
-    // If there is enough capacity for N more chars, then there's no need to resize the chain
-    if (string_builder->max_capacity - 1 >= string_builder->used_capacity + chars_amount) {
+    // If there is enough capacity for N more chars (plus the 'NULL' terminator), then there's no need to resize the chain
+    if (string_builder->used_capacity + chars_amount < string_builder->max_capacity) {
         return true;
     }
     // Otherwise, we pre-compute the new size for our chain according to our chosen strategy
@@ -232,61 +321,51 @@ bool string_builder_ensure_capacity(StringBuilder * string_builder, size_t chars
     // Resize the chain according to the previously pre-computed new size
     char * resized_chain = realloc(string_builder->built_chain, sizeof(char) * new_size);
     if (resized_chain == NULL) {
-        fprintf(stderr, "Unable to reallocate memory for 'resized_chain' at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to reallocate memory for 'resized_chain'");
         return false;
     }
+#ifdef STRING_BUILDER_STATISTICS
+    // The reallocation might have copied the whole old block (unless it was extended in place)
+    string_builder->reallocations_amount++;
+    string_builder->copied_bytes_amount += string_builder->max_capacity;
+    atomic_fetch_add_explicit(&global_reallocations_amount, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&global_copied_bytes_amount, string_builder->max_capacity, memory_order_relaxed);
+#endif
+    USDT_PROBE3(string_builder_grow, string_builder, string_builder->max_capacity, new_size);
     // Assign the new chain and new capacity values
     string_builder->built_chain = resized_chain;
     string_builder->max_capacity = new_size;
+#ifdef STRING_BUILDER_STATISTICS
+    string_builder_statistics_record_capacity(string_builder);
+#endif
     // Return a successful result
     return true;
 }
 
 size_t string_builder_compute_new_size(StringBuilder * string_builder, size_t chars_amount) {
-    // While there are more cached sequence values to be checked, and the sequence value at the given index is not enough to fit the required amount of chars
-    while (string_builder->current_sequence_index < SEQUENCE_SIZE && SEQUENCE[string_builder->current_sequence_index] - 1 < string_builder->used_capacity + chars_amount) {
-        // Move forward the index to the next sequence value
-        string_builder->current_sequence_index++;
-    }
-    size_t new_size;
-    // If the sequence index has not exceeded the max sequence index (then a cached sequence value can be used as the new resize size)
-    if (string_builder->current_sequence_index < SEQUENCE_SIZE) {
-        // If the desired size (to fit the required chars) was found, use that sequence value, and also increment the sequence index (for the next computation)
-        new_size = SEQUENCE[string_builder->current_sequence_index++];
-    } else {
-        // Otherwise, use the last sequence value as a starting point for the recurrence relation (to compute the next sequence value) as we've run out of cached values
-        new_size = SEQUENCE[SEQUENCE_SIZE - 1];
-        // Always ensure one extra spot for the string 'NULL' terminator
-        // Pre-compute the required size before performing a "reallocation" to prevent "overhead"
-        while (new_size - 1 < string_builder->used_capacity + chars_amount) {
-            // Same as "new_size = old_size * 1.5" or "new_size = (old_size * 3) / 2", where "1.5" is approximately ~ the golden ratio
-            // See that we add an extra "+1" to prevent getting stuck at size = "1" (because the bit operation truncates decimals)
-            new_size = ((new_size + (new_size << 1)) >> 1) + 1;
-        }
-    }
-    // Return the new size
-    return new_size;
+    // Always ensure one extra spot for the string 'NULL' terminator
+    return growth_policy_next_capacity(&string_builder->current_sequence_index, string_builder->used_capacity + chars_amount + 1);
 }
 
 bool string_builder_remove(StringBuilder * string_builder, size_t start_index, size_t stop_index) {
     if (string_builder == NULL) {
-        fprintf(stderr, "Trying to remove characters from a 'NULL' builder at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to remove characters from a 'NULL' builder");
         return false;
     }
     if (string_builder->used_capacity == 0) {
-        fprintf(stderr, "Trying to remove characters from a empty builder at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_INVALID_STATE, __func__, "Trying to remove characters from a empty builder");
         return false;
     }
     if (start_index < 0) {
-        fprintf(stderr, "The 'start_index' must not be less than '1' at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'start_index' must not be less than '1'");
         return false;
     }
     if (stop_index < 0) {
-        fprintf(stderr, "The 'stop_index' must not be less than '1' at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'stop_index' must not be less than '1'");
         return false;
     }
     if (stop_index >= string_builder->used_capacity) {
-        fprintf(stderr, "The 'stop_index' must not be greater than the chain size at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'stop_index' must not be greater than the chain size");
         return false;
     }
     // Start index (inclusive)
@@ -305,12 +384,12 @@ bool string_builder_remove(StringBuilder * string_builder, size_t start_index, s
 
 bool string_builder_clear(StringBuilder * string_builder) {
     if (string_builder == NULL) {
-        fprintf(stderr, "Trying to clear a 'NULL' builder at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to clear a 'NULL' builder");
         return false;
     }
     char * new_chain = malloc(sizeof(char) * 1);
     if (new_chain == NULL) {
-        fprintf(stderr, "Unable to allocate memory for 'new_chain' at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'new_chain'");
         return false;
     }
     // Append the 'NULL' terminator
@@ -320,14 +399,14 @@ bool string_builder_clear(StringBuilder * string_builder) {
     // Reset properties to their default values
     string_builder->built_chain = new_chain;
     string_builder->used_capacity = 0;
-    string_builder->current_sequence_index = 2;
+    string_builder->current_sequence_index = growth_policy_sequence_index(1);
     string_builder->max_capacity = 1;
     return true;
 }
 
 char * string_builder_result(StringBuilder * string_builder) {
     if (string_builder == NULL) {
-        fprintf(stderr, "Trying to get the result of a 'NULL' builder at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to get the result of a 'NULL' builder");
         return false;
     }
     // If the chain has extra (garbage/unused characters), then resize the buffer to match the exact required size
@@ -337,10 +416,18 @@ char * string_builder_result(StringBuilder * string_builder) {
         // Attempt to resize to the used capacity
         char * resized_chain = realloc(string_builder->built_chain, sizeof(char) * new_size);
         if (resized_chain == NULL) {
-            fprintf(stderr, "Unable to reallocate memory for 'resized_chain' at '%s'\n", __func__);
+            error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to reallocate memory for 'resized_chain'");
             return NULL;
         }
+        USDT_PROBE3(string_builder_shrink, string_builder, string_builder->max_capacity, new_size);
+        // The capacity follows the buffer (otherwise later appends, or a detach, would trust the old capacity)
         string_builder->built_chain = resized_chain;
+        string_builder->max_capacity = new_size;
+        string_builder->current_sequence_index = growth_policy_sequence_index(new_size);
+#ifdef STRING_BUILDER_STATISTICS
+        string_builder->shrinks_amount++;
+        atomic_fetch_add_explicit(&global_shrinks_amount, 1, memory_order_relaxed);
+#endif
     }
     char * last_free_position = string_builder->built_chain + string_builder->used_capacity;
     // Append the 'NULL' terminator at the last extra character of our buffer
@@ -351,12 +438,12 @@ char * string_builder_result(StringBuilder * string_builder) {
 
 char * string_builder_result_as_copy(StringBuilder * string_builder) {
     if (string_builder == NULL) {
-        fprintf(stderr, "Trying to get a copy of the result of a 'NULL' builder at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to get a copy of the result of a 'NULL' builder");
         return false;
     }
     char * copied_chain = malloc(sizeof(char) * (string_builder->used_capacity + 1));
     if (copied_chain == NULL) {
-        fprintf(stderr, "Unable to allocate memory for 'copied_chain' at '%s'\n", __func__);
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'copied_chain'");
         return NULL;
     }
     char * copy = copied_chain;
@@ -371,15 +458,19 @@ char * string_builder_result_as_copy(StringBuilder * string_builder) {
 }
 
 size_t string_builder_size(StringBuilder * string_builder) {
-    return string_builder->used_capacity;
+    return string_builder_inline_size(string_builder);
 }
 
 size_t string_builder_max_capacity(StringBuilder * string_builder) {
-    return string_builder->max_capacity;
+    return string_builder_inline_max_capacity(string_builder);
 }
 
 void string_builder_destroy(StringBuilder * string_builder) {
     if (string_builder != NULL) {
+#ifdef STRING_BUILDER_STATISTICS
+        string_builder_statistics_record_destroy(string_builder);
+#endif
+        USDT_PROBE2(string_builder_destroy, string_builder, string_builder->max_capacity);
         if (string_builder->built_chain != NULL) {
             free(string_builder->built_chain);
         }
@@ -389,6 +480,158 @@ void string_builder_destroy(StringBuilder * string_builder) {
 
 void string_builder_destroy_except_chain(StringBuilder * string_builder) {
     if (string_builder != NULL) {
+#ifdef STRING_BUILDER_STATISTICS
+        string_builder_statistics_record_destroy(string_builder);
+#endif
+        USDT_PROBE2(string_builder_destroy, string_builder, string_builder->max_capacity);
         free(string_builder);
     }
 }
+
+char * string_builder_detach(StringBuilder * string_builder, size_t * length, size_t * capacity) {
+    if (string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to detach the chain of a 'NULL' builder");
+        return NULL;
+    }
+    char * built_chain = string_builder->built_chain;
+    // Terminate the chain if there is room for it (never reallocating, so the client gets the very same buffer)
+    if (built_chain != NULL && string_builder->used_capacity < string_builder->max_capacity) {
+        built_chain[string_builder->used_capacity] = '\0';
+    }
+    if (length != NULL) (* length) = string_builder->used_capacity;
+    if (capacity != NULL) (* capacity) = string_builder->max_capacity;
+    string_builder_destroy_except_chain(string_builder);
+    return built_chain;
+}
+
+#ifdef STRING_BUILDER_STATISTICS
+
+// Updates the builder and the process-wide peak capacities with the current capacity of the given builder
+void string_builder_statistics_record_capacity(StringBuilder * string_builder) {
+    if (string_builder->max_capacity > string_builder->peak_capacity) {
+        string_builder->peak_capacity = string_builder->max_capacity;
+    }
+    size_t global_peak = atomic_load_explicit(&global_peak_capacity, memory_order_relaxed);
+    // Retry until our capacity is stored or some other builder already stored a higher one
+    while (string_builder->max_capacity > global_peak) {
+        bool is_stored = atomic_compare_exchange_weak_explicit(&global_peak_capacity, &global_peak, string_builder->max_capacity, memory_order_relaxed, memory_order_relaxed);
+        if (is_stored) break;
+    }
+}
+
+// Adds the peak capacity of the given (about to be destroyed) builder to the process-wide histogram
+void string_builder_statistics_record_destroy(StringBuilder * string_builder) {
+    // The bucket index is the position of the highest set bit (i.e., "floor(log2(peak_capacity))")
+    size_t bucket_index = 0;
+    size_t remaining = string_builder->peak_capacity;
+    while (remaining > 1) {
+        remaining >>= 1;
+        bucket_index++;
+    }
+    atomic_fetch_add_explicit(&global_peak_capacity_histogram[bucket_index], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&global_destroyed_amount, 1, memory_order_relaxed);
+}
+
+bool string_builder_statistics(StringBuilder * string_builder, StringBuilderStatistics * statistics) {
+    if (string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to get the statistics of a 'NULL' builder");
+        return false;
+    }
+    if (statistics == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to copy the statistics to a 'NULL' structure");
+        return false;
+    }
+    statistics->reallocations_amount = string_builder->reallocations_amount;
+    statistics->copied_bytes_amount = string_builder->copied_bytes_amount;
+    statistics->peak_capacity = string_builder->peak_capacity;
+    statistics->shrinks_amount = string_builder->shrinks_amount;
+    return true;
+}
+
+bool string_builder_global_statistics(StringBuilderGlobalStatistics * statistics) {
+    if (statistics == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to copy the global statistics to a 'NULL' structure");
+        return false;
+    }
+    statistics->created_amount = atomic_load_explicit(&global_created_amount, memory_order_relaxed);
+    statistics->destroyed_amount = atomic_load_explicit(&global_destroyed_amount, memory_order_relaxed);
+    statistics->reallocations_amount = atomic_load_explicit(&global_reallocations_amount, memory_order_relaxed);
+    statistics->copied_bytes_amount = atomic_load_explicit(&global_copied_bytes_amount, memory_order_relaxed);
+    statistics->shrinks_amount = atomic_load_explicit(&global_shrinks_amount, memory_order_relaxed);
+    statistics->peak_capacity = atomic_load_explicit(&global_peak_capacity, memory_order_relaxed);
+    for (size_t i = 0; i < STRING_BUILDER_STATISTICS_HISTOGRAM_SIZE; i++) {
+        statistics->peak_capacity_histogram[i] = atomic_load_explicit(&global_peak_capacity_histogram[i], memory_order_relaxed);
+    }
+    return true;
+}
+
+void string_builder_global_statistics_reset() {
+    atomic_store_explicit(&global_created_amount, 0, memory_order_relaxed);
+    atomic_store_explicit(&global_destroyed_amount, 0, memory_order_relaxed);
+    atomic_store_explicit(&global_reallocations_amount, 0, memory_order_relaxed);
+    atomic_store_explicit(&global_copied_bytes_amount, 0, memory_order_relaxed);
+    atomic_store_explicit(&global_shrinks_amount, 0, memory_order_relaxed);
+    atomic_store_explicit(&global_peak_capacity, 0, memory_order_relaxed);
+    for (size_t i = 0; i < STRING_BUILDER_STATISTICS_HISTOGRAM_SIZE; i++) {
+        atomic_store_explicit(&global_peak_capacity_histogram[i], 0, memory_order_relaxed);
+    }
+}
+
+bool string_builder_global_statistics_dump(FILE * stream) {
+    if (stream == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to dump the global statistics to a 'NULL' stream");
+        return false;
+    }
+    StringBuilderGlobalStatistics statistics;
+    string_builder_global_statistics(&statistics);
+    fprintf(stream, "String builder statistics\n");
+    fprintf(stream, "  created: %zu, destroyed: %zu\n", statistics.created_amount, statistics.destroyed_amount);
+    fprintf(stream, "  reallocations: %zu, copied bytes: %zu\n", statistics.reallocations_amount, statistics.copied_bytes_amount);
+    fprintf(stream, "  shrinks: %zu, peak capacity: %zu\n", statistics.shrinks_amount, statistics.peak_capacity);
+    fprintf(stream, "Peak capacity histogram (destroyed builders)\n");
+    // The bars are scaled against the most populated bucket (so the widest bar is always 50 characters long)
+    size_t max_bucket_amount = 0;
+    for (size_t i = 0; i < STRING_BUILDER_STATISTICS_HISTOGRAM_SIZE; i++) {
+        if (statistics.peak_capacity_histogram[i] > max_bucket_amount) {
+            max_bucket_amount = statistics.peak_capacity_histogram[i];
+        }
+    }
+    for (size_t i = 0; i < STRING_BUILDER_STATISTICS_HISTOGRAM_SIZE; i++) {
+        size_t bucket_amount = statistics.peak_capacity_histogram[i];
+        if (bucket_amount == 0) continue;
+        size_t lower_bound = (i == 0) ? 0 : ((size_t) 1 << i);
+        size_t upper_bound = ((size_t) 1 << i) * 2 - 1;
+        size_t bar_length = (bucket_amount * 50 + max_bucket_amount - 1) / max_bucket_amount;
+        fprintf(stream, "  [%12zu, %12zu] ", lower_bound, upper_bound);
+        for (size_t j = 0; j < bar_length; j++) fputc('#', stream);
+        fprintf(stream, " %zu\n", bucket_amount);
+    }
+    return true;
+}
+
+#else
+
+bool string_builder_statistics(StringBuilder * string_builder, StringBuilderStatistics * statistics) {
+    (void) string_builder;
+    (void) statistics;
+    error_reporter_report(ERROR_CODE_UNSUPPORTED, __func__, "The statistics are disabled (define 'STRING_BUILDER_STATISTICS' to enable them)");
+    return false;
+}
+
+bool string_builder_global_statistics(StringBuilderGlobalStatistics * statistics) {
+    (void) statistics;
+    error_reporter_report(ERROR_CODE_UNSUPPORTED, __func__, "The statistics are disabled (define 'STRING_BUILDER_STATISTICS' to enable them)");
+    return false;
+}
+
+void string_builder_global_statistics_reset() {
+    // Nothing to reset as no statistics are collected
+}
+
+bool string_builder_global_statistics_dump(FILE * stream) {
+    (void) stream;
+    error_reporter_report(ERROR_CODE_UNSUPPORTED, __func__, "The statistics are disabled (define 'STRING_BUILDER_STATISTICS' to enable them)");
+    return false;
+}
+
+#endif
@@ -13,6 +13,7 @@
 
 #include <stdbool.h>   // For "true", "false" (boolean constants)
 #include <stddef.h>    // For "size_t" (size type)
+#include <stdio.h>     // For "FILE" (statistics dump stream)
 
 /* string-builder.h */
 #ifndef STRINGS_STRING_BUILDER_H
@@ -20,6 +21,32 @@
 
 typedef struct string_builder StringBuilder;
 
+/**
+ * Allocation statistics of a single string builder (only collected when "STRING_BUILDER_STATISTICS" is defined).
+ */
+typedef struct string_builder_statistics {
+    size_t reallocations_amount;    // The amount of growth reallocations performed while ensuring the capacity
+    size_t copied_bytes_amount;     // The amount of bytes that the growth reallocations might have copied (worst case)
+    size_t peak_capacity;           // The highest capacity ever reached by the builder
+    size_t shrinks_amount;          // The amount of shrink reallocations performed while obtaining the result
+} StringBuilderStatistics;
+
+// The amount of power of two buckets of the peak capacity histogram (bucket "i" holds capacities in "[2^i, 2^(i+1))")
+#define STRING_BUILDER_STATISTICS_HISTOGRAM_SIZE 64
+
+/**
+ * Process-wide aggregated allocation statistics (only collected when "STRING_BUILDER_STATISTICS" is defined).
+ */
+typedef struct string_builder_global_statistics {
+    size_t created_amount;          // The amount of created builders
+    size_t destroyed_amount;        // The amount of destroyed builders
+    size_t reallocations_amount;    // The amount of growth reallocations performed by all the builders
+    size_t copied_bytes_amount;     // The amount of bytes that the growth reallocations might have copied (worst case)
+    size_t shrinks_amount;          // The amount of shrink reallocations performed by all the builders
+    size_t peak_capacity;           // The highest capacity ever reached by any builder
+    size_t peak_capacity_histogram[STRING_BUILDER_STATISTICS_HISTOGRAM_SIZE]; // Peak capacities of destroyed builders
+} StringBuilderGlobalStatistics;
+
 /**
  * Creates a string builder with the default initial capacity and resize increment.
  *
@@ -40,6 +67,22 @@ StringBuilder * string_builder_create_default();
  */
 StringBuilder * string_builder_create(size_t initial_capacity);
 
+/**
+ * Creates a string builder that takes the ownership of an existing buffer (without copying it), i.e., one filled by
+ * "read" or returned by a third-party library.
+ *
+ * The returned builder must be freed by the client after its usage (and the buffer is then freed along with it).
+ *
+ * @param buffer the buffer to be adopted (it must be allocated with "malloc", as the builder reallocates and frees it)
+ * @param length the amount of characters of the buffer that are already used
+ * @param capacity the allocated size of the buffer (at least the length)
+ *
+ * @note if the creation fails, the buffer is not adopted, and it still belongs to the client
+ *
+ * @return a new string builder owning the buffer, or {@code NULL} if an error occurred
+ */
+StringBuilder * string_builder_adopt(char * buffer, size_t length, size_t capacity);
+
 /**
  * Frees the string builder structure and the dynamically allocated chain.
  *
@@ -56,6 +99,22 @@ void string_builder_destroy(StringBuilder * string_builder);
  */
 void string_builder_destroy_except_chain(StringBuilder * string_builder);
 
+/**
+ * Frees the string builder structure and hands its chain over to the client, without shrinking it (the inverse of
+ * "string_builder_adopt", so a buffer can travel between the kit and the client without any copy).
+ *
+ * The returned chain must be freed by the client after its usage.
+ *
+ * @param string_builder the string builder whose chain is to be detached (freed, even if the chain is {@code NULL})
+ * @param length where the amount of used characters is to be stored, can be {@code NULL} if not needed
+ * @param capacity where the allocated size of the chain is to be stored, can be {@code NULL} if not needed
+ *
+ * @note the chain is 'NULL' terminated whenever there is room for it (the length is less than the capacity)
+ *
+ * @return the chain of the builder, or {@code NULL} if the builder is {@code NULL}
+ */
+char * string_builder_detach(StringBuilder * string_builder, size_t * length, size_t * capacity);
+
 /**
  * Appends one character to the given string builder.
  *
@@ -80,6 +139,44 @@ bool string_builder_append_one(StringBuilder * string_builder, char character);
  */
 bool string_builder_append_all(StringBuilder * string_builder, char * chain);
 
+/**
+ * Appends the characters of the source builder to the destination builder, with a single sized copy (the source is
+ * neither measured with "strlen" nor shrunk, and it is kept untouched).
+ *
+ * @param destination the string builder to whom the characters must be appended to
+ * @param source the string builder whose characters are to be appended (it might be the destination itself)
+ *
+ * @note the append operation can only fail if there was a reallocation error
+ *
+ * @return {@code true} if the append operation was successful, {@code false} otherwise
+ */
+bool string_builder_append_builder(StringBuilder * destination, StringBuilder * source);
+
+/**
+ * Moves the characters of the source builder to the end of the destination builder, leaving the source empty (but
+ * still usable). If the destination is empty, it steals the chain of the source without copying anything (the source
+ * gets the old chain of the destination, so no allocation is needed either), otherwise the characters are appended
+ * with a single sized copy, and the source keeps its capacity.
+ *
+ * @param destination the string builder to whom the characters must be moved to
+ * @param source the string builder whose characters are to be moved (it must not be the destination itself)
+ *
+ * @note the move operation can only fail if there was a reallocation error (then both builders are kept untouched)
+ *
+ * @return {@code true} if the move operation was successful, {@code false} otherwise
+ */
+bool string_builder_append_builder_move(StringBuilder * destination, StringBuilder * source);
+
+/**
+ * Swaps the contents (the chains, the sizes and the capacities) of the given builders, without copying anything.
+ *
+ * @param first_builder the first string builder to be swapped
+ * @param second_builder the second string builder to be swapped
+ *
+ * @return {@code true} if the swap operation was successful, {@code false} otherwise
+ */
+bool string_builder_swap(StringBuilder * first_builder, StringBuilder * second_builder);
+
 /**
  * Removes all the characters between the start index (inclusive) and stop index (inclusive) from the given builder.
  *
@@ -136,4 +233,48 @@ char * string_builder_result(StringBuilder * string_builder);
  */
 char * string_builder_result_as_copy(StringBuilder * string_builder);
 
+/**
+ * Copies the allocation statistics of the given builder into the provided statistics structure.
+ *
+ * @param string_builder the string builder whose statistics are to be obtained
+ * @param statistics the structure where the statistics are to be copied to
+ *
+ * @note it always fails if the kit was not compiled with "STRING_BUILDER_STATISTICS" defined
+ *
+ * @return {@code true} if the statistics were copied, {@code false} otherwise
+ */
+bool string_builder_statistics(StringBuilder * string_builder, StringBuilderStatistics * statistics);
+
+/**
+ * Copies the process-wide aggregated allocation statistics into the provided statistics structure.
+ *
+ * @param statistics the structure where the global statistics are to be copied to
+ *
+ * @note it always fails if the kit was not compiled with "STRING_BUILDER_STATISTICS" defined
+ *
+ * @return {@code true} if the statistics were copied, {@code false} otherwise
+ */
+bool string_builder_global_statistics(StringBuilderGlobalStatistics * statistics);
+
+/**
+ * Resets all the process-wide aggregated allocation statistics to zero.
+ */
+void string_builder_global_statistics_reset();
+
+/**
+ * Prints the process-wide aggregated allocation statistics (and the peak capacity histogram) to the given stream.
+ *
+ * @param stream the stream where the statistics are to be printed to
+ *
+ * @note it always fails if the kit was not compiled with "STRING_BUILDER_STATISTICS" defined
+ *
+ * @return {@code true} if the statistics were printed, {@code false} otherwise
+ */
+bool string_builder_global_statistics_dump(FILE * stream);
+
+// Inlinable hot paths (see "string-builder-inline.h")
+#ifdef STRING_BUILDER_INLINE
+#include "string-builder-inline.h"
+#endif
+
 #endif /* STRINGS_STRING_BUILDER_H */
\ No newline at end of file
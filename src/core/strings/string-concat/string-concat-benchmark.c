@@ -0,0 +1,128 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L // For "clock_gettime", "CLOCK_MONOTONIC" (monotonic clock)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include "string-concat.h"
+#include "string-builder.h"
+
+#define REPETITIONS_AMOUNT 5
+
+// Benchmarking snippet (not abstracted away for piece of code portability)
+double elapsed_seconds(struct timespec start, struct timespec stop) {
+    return (double) (stop.tv_sec - start.tv_sec) + (double) (stop.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Benchmarks
+
+// Builds messages of "pieces_amount" pieces of "piece_length" characters (i.e., the lines of a response body), appending
+// them one by one to a default builder, or recording them in a concatenation that is built with the exact size
+void string_concat_pieces_benchmark(size_t messages_amount, size_t pieces_amount, size_t piece_length) {
+    char * words[8];
+    const size_t WORDS_AMOUNT = sizeof(words) / sizeof(words[0]);
+    for (size_t i = 0; i < WORDS_AMOUNT; i++) {
+        // The pieces lengths vary around the given one (between a half and one and a half times it)
+        size_t length = piece_length / 2 + (piece_length * i) / WORDS_AMOUNT + 1;
+        words[i] = malloc(length + 1);
+        for (size_t j = 0; j < length; j++) words[i][j] = (char) ('a' + (i + j) % 26);
+        words[i][length] = '\0';
+    }
+    // The variants alternate, and the best run of each one is kept (a single run is too noisy on a shared machine)
+    double seconds[2] = { 1e9, 1e9 };
+    size_t checksums[2] = { 0, 0 };
+    for (size_t run = 0; run < 2 * REPETITIONS_AMOUNT; run++) {
+        size_t variant = run % 2;
+        size_t checksum = 0;
+        struct timespec start, stop;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (size_t i = 0; i < messages_amount; i++) {
+            StringBuilder * string_builder;
+            if (variant == 0) {
+                string_builder = string_builder_create_default();
+                for (size_t j = 0; j < pieces_amount; j++) string_builder_append_all(string_builder, words[(i + j) % WORDS_AMOUNT]);
+            } else {
+                StringConcat concat;
+                string_concat_init(&concat);
+                for (size_t j = 0; j < pieces_amount; j++) string_concat_add_chain(&concat, words[(i + j) % WORDS_AMOUNT]);
+                string_builder = string_concat_build(&concat);
+                string_concat_release(&concat);
+            }
+            checksum += string_builder_size(string_builder) + (size_t) string_builder_result(string_builder)[i % pieces_amount];
+            string_builder_destroy(string_builder);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        if (elapsed_seconds(start, stop) < seconds[variant]) seconds[variant] = elapsed_seconds(start, stop);
+        checksums[variant] = checksum;
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "%zu pieces of ~%zu chars", pieces_amount, piece_length);
+    printf("%-32s %10.1f ns %10.1f ns %8.2fx%s\n", name, seconds[0] / messages_amount * 1e9, seconds[1] / messages_amount * 1e9,
+           seconds[0] / seconds[1], (checksums[0] == checksums[1]) ? "" : " (mismatch)");
+    for (size_t i = 0; i < WORDS_AMOUNT; i++) free(words[i]);
+}
+
+// Formats a line out of literals and builders in a single expression, appending them one by one, or with the macro
+void string_concat_macro_benchmark(size_t messages_amount) {
+    StringBuilder * method = string_builder_create_default();
+    StringBuilder * path = string_builder_create_default();
+    string_builder_append_all(method, "GET");
+    string_builder_append_all(path, "/api/v1/items/42");
+    double seconds[2] = { 1e9, 1e9 };
+    size_t checksums[2] = { 0, 0 };
+    for (size_t run = 0; run < 2 * REPETITIONS_AMOUNT; run++) {
+        size_t variant = run % 2;
+        size_t checksum = 0;
+        struct timespec start, stop;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (size_t i = 0; i < messages_amount; i++) {
+            StringBuilder * string_builder;
+            if (variant == 0) {
+                string_builder = string_builder_create_default();
+                string_builder_append_all(string_builder, "[access] ");
+                string_builder_append_builder(string_builder, method);
+                string_builder_append_all(string_builder, " ");
+                string_builder_append_builder(string_builder, path);
+                string_builder_append_all(string_builder, " HTTP/1.1 -> ");
+                string_builder_append_all(string_builder, "200 OK");
+            } else {
+                string_builder = STRING_CONCAT_BUILD("[access] ", method, " ", path, " HTTP/1.1 -> ", "200 OK");
+            }
+            checksum += string_builder_size(string_builder) + (size_t) string_builder_result(string_builder)[i % 40];
+            string_builder_destroy(string_builder);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        if (elapsed_seconds(start, stop) < seconds[variant]) seconds[variant] = elapsed_seconds(start, stop);
+        checksums[variant] = checksum;
+    }
+    printf("%-32s %10.1f ns %10.1f ns %8.2fx%s\n", "macro access log line", seconds[0] / messages_amount * 1e9,
+           seconds[1] / messages_amount * 1e9, seconds[0] / seconds[1], (checksums[0] == checksums[1]) ? "" : " (mismatch)");
+    string_builder_destroy(method);
+    string_builder_destroy(path);
+}
+
+// Benchmarks runner (the arguments optionally override the amount of messages per run)
+
+int main(int argc, char * argv[]) {
+    size_t messages_amount = (argc > 1) ? strtoull(argv[1], NULL, 10) : 1000000;
+    printf("%-32s %13s %13s %9s\n", "benchmark", "appends", "concat", "speedup");
+    size_t pieces_amounts[] = { 5, 20, 50 };
+    for (size_t i = 0; i < sizeof(pieces_amounts) / sizeof(size_t); i++) {
+        string_concat_pieces_benchmark(messages_amount, pieces_amounts[i], 4);
+        string_concat_pieces_benchmark(messages_amount, pieces_amounts[i], 64);
+    }
+    string_concat_macro_benchmark(messages_amount);
+}
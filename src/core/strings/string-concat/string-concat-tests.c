@@ -0,0 +1,188 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "string-concat.h"
+#include "string-builder.h"
+#include "error-reporter.h"
+
+// Assertion snippet (not abstracted away for piece of code portability)
+void assert(int condition, char message[]) {
+    if (condition != 1) {
+        printf("%s\n", message);
+        exit(1);
+    }
+}
+
+// Unit testing
+
+void string_concat_build_test() {
+    printf("*** Running test '%s'\n", __func__);
+    StringConcat concat;
+    assert(string_concat_init(&concat), "The concatenation must be initialized");
+    assert(string_concat_length(&concat) == 0, "A new concatenation must be empty");
+    assert(string_concat_add_chain(&concat, "GET "), "The chain must be added");
+    assert(string_concat_add_bytes(&concat, "/index.html?query", 11), "The bytes must be added");
+    assert(string_concat_add_chain(&concat, ""), "The empty chain must be added");
+    assert(string_concat_add_chain(&concat, " HTTP/1.1"), "The chain must be added");
+    assert(string_concat_length(&concat) == 24, "The length must be the sum of the pieces lengths");
+    StringBuilder * string_builder = string_concat_build(&concat);
+    assert(string_builder != NULL, "The concatenation must be built");
+    assert(string_builder_max_capacity(string_builder) == 25, "The builder must be allocated with the exact length");
+    assert(strcmp(string_builder_result(string_builder), "GET /index.html HTTP/1.1") == 0, "The result must match the expected chain");
+    string_builder_destroy(string_builder);
+    string_concat_release(&concat);
+}
+
+void string_concat_append_to_test() {
+    printf("*** Running test '%s'\n", __func__);
+    StringBuilder * name = string_builder_create_default();
+    string_builder_append_all(name, "world");
+    StringBuilder * string_builder = string_builder_create(4);
+    string_builder_append_all(string_builder, ">");
+    StringConcat concat;
+    string_concat_init(&concat);
+    string_concat_add_chain(&concat, "hello, ");
+    string_concat_add_builder(&concat, name);
+    string_concat_add_chain(&concat, "!");
+    assert(string_concat_append_to(&concat, string_builder), "The concatenation must be appended");
+    assert(string_builder_size(string_builder) == 14, "The builder size must include the concatenation");
+    assert(strcmp(string_builder_result(string_builder), ">hello, world!") == 0, "The result must match the expected chain");
+    // The concatenation only references its pieces, so it can be evaluated again
+    char buffer[32];
+    assert(string_concat_write(&concat, buffer, sizeof(buffer)) == 13, "The written length must be the total length");
+    assert(strcmp(buffer, "hello, world!") == 0, "The buffer must match the expected chain");
+    string_concat_release(&concat);
+    string_builder_destroy(string_builder);
+    string_builder_destroy(name);
+}
+
+void string_concat_write_test() {
+    printf("*** Running test '%s'\n", __func__);
+    StringConcat concat;
+    string_concat_init(&concat);
+    string_concat_add_chain(&concat, "0123");
+    string_concat_add_chain(&concat, "4567");
+    // The buffer is left untouched if the concatenation doesn't fit, but the required length is returned anyway
+    char buffer[8] = "unused!";
+    assert(string_concat_write(&concat, NULL, 0) == 8, "Measuring must return the total length");
+    assert(string_concat_write(&concat, buffer, sizeof(buffer)) == 8, "A short buffer must return the total length");
+    assert(strcmp(buffer, "unused!") == 0, "A short buffer must not be modified");
+    char exact_buffer[9];
+    assert(string_concat_write(&concat, exact_buffer, sizeof(exact_buffer)) == 8, "An exact buffer must return the total length");
+    assert(strcmp(exact_buffer, "01234567") == 0, "The buffer must match the expected chain");
+    string_concat_release(&concat);
+}
+
+void string_concat_many_pieces_test() {
+    printf("*** Running test '%s'\n", __func__);
+    // More pieces than the inline ones, so the pieces move to a heap array
+    const char * digits[] = { "0", "1", "2", "3", "4", "5", "6", "7", "8", "9" };
+    StringConcat concat;
+    string_concat_init(&concat);
+    for (size_t i = 0; i < 1000; i++) assert(string_concat_add_chain(&concat, digits[i % 10]), "The chain must be added");
+    assert(string_concat_length(&concat) == 1000, "The length must be the amount of pieces");
+    StringBuilder * string_builder = string_concat_build(&concat);
+    char * result = string_builder_result(string_builder);
+    for (size_t i = 0; i < 1000; i++) assert(result[i] == (char) ('0' + i % 10), "The result must keep the order of the pieces");
+    assert(result[1000] == '\0', "The result must be 'NULL' terminated");
+    string_builder_destroy(string_builder);
+    // A released concatenation can be reused
+    string_concat_release(&concat);
+    assert(string_concat_length(&concat) == 0, "A released concatenation must be empty");
+    string_concat_add_chain(&concat, "again");
+    string_builder = string_concat_build(&concat);
+    assert(strcmp(string_builder_result(string_builder), "again") == 0, "A reused concatenation must be built");
+    string_builder_destroy(string_builder);
+    string_concat_release(&concat);
+}
+
+void string_concat_macros_test() {
+    printf("*** Running test '%s'\n", __func__);
+    StringBuilder * tag = string_builder_create_default();
+    string_builder_append_all(tag, "b");
+    char body[] = "bold text";
+    const char * suffix = "!";
+    StringBuilder * string_builder = STRING_CONCAT_BUILD("<", tag, ">", body, STRING_CONCAT_BYTES(suffix, 1), "</", tag, ">");
+    assert(string_builder != NULL, "The arguments must be built");
+    assert(string_builder_max_capacity(string_builder) == 18, "The builder must be allocated with the exact length");
+    assert(strcmp(string_builder_result(string_builder), "<b>bold text!</b>") == 0, "The result must match the expected chain");
+    assert(STRING_CONCAT_APPEND(string_builder, "\n"), "A single argument must be appended");
+    assert(STRING_CONCAT_APPEND(string_builder, "a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k", "l", "m", "n", "o", "p",
+                                "q", "r", "s", "t", "u", "v", "w", "x", "y", "z"), "Many arguments must be appended");
+    assert(strcmp(string_builder_result(string_builder), "<b>bold text!</b>\nabcdefghijklmnopqrstuvwxyz") == 0, "The result must match the expected chain");
+    string_builder_destroy(string_builder);
+    string_builder_destroy(tag);
+}
+
+void string_concat_self_reference_test() {
+    printf("*** Running test '%s'\n", __func__);
+    // The destination grows while appending itself, so its pieces must be read from the moved chain
+    StringBuilder * string_builder = string_builder_create(4);
+    string_builder_append_all(string_builder, "abc");
+    assert(STRING_CONCAT_APPEND(string_builder, string_builder, "-", STRING_CONCAT_BYTES(string_builder_result(string_builder) + 1, 2)),
+           "The builder must be appended to itself");
+    assert(strcmp(string_builder_result(string_builder), "abcabc-bc") == 0, "The result must match the expected chain");
+    StringConcat concat;
+    string_concat_init(&concat);
+    for (size_t i = 0; i < 20; i++) string_concat_add_builder(&concat, string_builder);
+    assert(string_concat_append_to(&concat, string_builder), "The concatenation must be appended to its own piece");
+    assert(string_builder_size(string_builder) == 9 * 21, "The builder size must include every piece");
+    char * result = string_builder_result(string_builder);
+    for (size_t i = 0; i < 21; i++) assert(memcmp(result + i * 9, "abcabc-bc", 9) == 0, "Every piece must be copied from the moved chain");
+    string_concat_release(&concat);
+    string_builder_destroy(string_builder);
+}
+
+void string_concat_invalid_arguments_test() {
+    printf("*** Running test '%s'\n", __func__);
+    StringConcat concat;
+    assert(!string_concat_init(NULL), "Initializing a 'NULL' concatenation must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_NULL_ARGUMENT, "Error must be a 'NULL' argument error");
+    string_concat_init(&concat);
+    assert(string_concat_add_bytes(&concat, NULL, 0), "Adding zero 'NULL' bytes must succeed");
+    assert(!string_concat_add_chain(&concat, NULL), "Adding a 'NULL' chain must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_NULL_ARGUMENT, "Error must be a 'NULL' argument error");
+    // A failed piece is remembered, so the evaluation fails too
+    assert(string_concat_build(&concat) == NULL, "Building a failed concatenation must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_STATE, "Error must be an invalid state error");
+    char buffer[8];
+    assert(string_concat_write(&concat, buffer, sizeof(buffer)) == SIZE_MAX, "Writing a failed concatenation must fail");
+    string_concat_release(&concat);
+    assert(string_concat_add_chain(&concat, "abc"), "A released concatenation must be reusable");
+    assert(string_concat_write(&concat, NULL, 1) == SIZE_MAX, "Writing to a 'NULL' buffer must fail");
+    assert(!string_concat_append_to(&concat, NULL), "Appending to a 'NULL' builder must fail");
+    assert(!string_concat_add_bytes(&concat, "x", SIZE_MAX), "Overflowing the total length must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "Error must be an invalid argument error");
+    string_concat_release(&concat);
+    StringBuilder * missing = NULL;
+    char * missing_chain = NULL;
+    assert(STRING_CONCAT_BUILD("a", missing) == NULL, "Building a 'NULL' builder argument must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_NULL_ARGUMENT, "Error must be a 'NULL' argument error");
+    assert(STRING_CONCAT_BUILD(missing_chain, "a") == NULL, "Building a 'NULL' chain argument must fail");
+    assert(!string_concat_pieces_append_to(NULL, NULL, 0), "Appending pieces to a 'NULL' builder must fail");
+}
+
+int main() {
+    fclose(stderr); // Prevent printing "expected" errors
+    string_concat_build_test();
+    string_concat_append_to_test();
+    string_concat_write_test();
+    string_concat_many_pieces_test();
+    string_concat_macros_test();
+    string_concat_self_reference_test();
+    string_concat_invalid_arguments_test();
+}
@@ -0,0 +1,275 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * A Non Thread-Safe Deferred Concatenation Implementation (evaluated with an exact size).
+ *
+ * ### Explanation ###
+ *
+ * Building a message out of many small pieces (i.e., "key", "=", value, "&", ...) by appending them one by one to a
+ * builder measures, checks the capacity of and maybe grows the builder once per piece, and the growth might copy the
+ * already appended pieces several times. Here the pieces are only recorded (as a reference to their bytes and their
+ * length) while the total length is summed, so the evaluation knows the exact size before touching any byte:
+ *
+ * 1. Recording a piece stores its pointer and length (the first 16 pieces in the concatenation itself, so the usual
+ *    small concatenations placed in the stack never allocate, and the rest in a heap array).
+ * 2. Evaluating the concatenation ensures the capacity of the destination once (a builder created with the exact
+ *    size, an existing builder grown at most once, or a buffer provided by the client), and copies every piece once.
+ *
+ * The "STRING_CONCAT_APPEND" and "STRING_CONCAT_BUILD" macros record their arguments in a compound literal array (in
+ * the stack of the caller), so the chains, literals and builders of a single expression are concatenated without
+ * any intermediate allocation.
+ *
+ * ### Self References ###
+ *
+ * A piece might reference the destination builder itself (i.e., appending a builder twice to itself), and growing
+ * the destination moves its chain, so the pieces pointing inside the old chain are copied from the same offset of the
+ * new chain. Only the used part is referenced, while the copies go past it, so the source and destination never
+ * overlap.
+ *
+ * ### References ###
+ *
+ * - https://docs.oracle.com/javase/8/docs/api/java/util/StringJoiner.html (Java, "StringJoiner")
+ * - https://abseil.io/docs/cpp/guides/strings#abslstrcat (Abseil, "StrCat" computes the size before copying)
+ * - https://en.wikipedia.org/wiki/Rope_(data_structure)
+ */
+
+// Imports & Headers
+
+#include <stdlib.h>         // For "malloc", "realloc", "free" (memory management)
+#include <string.h>         // For "memcpy", "strlen" (better memory copy and utils)
+#include <stdint.h>         // For "SIZE_MAX", "uintptr_t" (overflow checks and self references)
+#include "string-concat.h"
+#include "growth-policy.h"  // For "growth_policy_sequence_index", "growth_policy_next_capacity" (resize strategy)
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+
+// Definition (to be able to use methods before declaring them, to follow up the top-bottom code style)
+
+bool string_concat_ensure_pieces_capacity(StringConcat * concat);
+bool string_concat_copy_pieces(StringBuilder * string_builder, const StringConcatPiece * pieces, size_t pieces_amount, size_t total_length);
+bool string_concat_pieces_length(const StringConcatPiece * pieces, size_t pieces_amount, size_t * total_length);
+
+// Implementation
+
+bool string_concat_init(StringConcat * concat) {
+    if (concat == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to initialize a 'NULL' concatenation");
+        return false;
+    }
+    concat->pieces = concat->inline_pieces;
+    concat->pieces_amount = 0;
+    concat->pieces_capacity = STRING_CONCAT_INLINE_PIECES_AMOUNT;
+    concat->sequence_index = growth_policy_sequence_index(STRING_CONCAT_INLINE_PIECES_AMOUNT);
+    concat->total_length = 0;
+    concat->is_failed = false;
+    return true;
+}
+
+void string_concat_release(StringConcat * concat) {
+    if (concat == NULL) return;
+    if (concat->pieces != concat->inline_pieces) free(concat->pieces);
+    string_concat_init(concat);
+}
+
+bool string_concat_add_bytes(StringConcat * concat, const char * bytes, size_t length) {
+    if (concat == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to add a piece to a 'NULL' concatenation");
+        return false;
+    }
+    if (bytes == NULL && length > 0) {
+        concat->is_failed = true;
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to add 'NULL' bytes to a concatenation");
+        return false;
+    }
+    if (length > SIZE_MAX - 1 - concat->total_length) {
+        concat->is_failed = true;
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The total length of the concatenation is too big");
+        return false;
+    }
+    // Empty pieces are not recorded, as they don't contribute any byte
+    if (length == 0) return true;
+    if (concat->pieces_amount == concat->pieces_capacity && !string_concat_ensure_pieces_capacity(concat)) {
+        concat->is_failed = true;
+        return false;
+    }
+    concat->pieces[concat->pieces_amount].bytes = bytes;
+    concat->pieces[concat->pieces_amount].length = length;
+    concat->pieces_amount++;
+    concat->total_length += length;
+    return true;
+}
+
+bool string_concat_add_chain(StringConcat * concat, const char * chain) {
+    if (chain == NULL) {
+        if (concat != NULL) concat->is_failed = true;
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to add a 'NULL' chain to a concatenation");
+        return false;
+    }
+    return string_concat_add_bytes(concat, chain, strlen(chain));
+}
+
+bool string_concat_add_builder(StringConcat * concat, StringBuilder * string_builder) {
+    if (string_builder == NULL) {
+        if (concat != NULL) concat->is_failed = true;
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to add a 'NULL' builder to a concatenation");
+        return false;
+    }
+    return string_concat_add_bytes(concat, string_builder->built_chain, string_builder->used_capacity);
+}
+
+size_t string_concat_length(StringConcat * concat) {
+    if (concat == NULL) return 0;
+    return concat->total_length;
+}
+
+bool string_concat_append_to(StringConcat * concat, StringBuilder * string_builder) {
+    if (concat == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to append a 'NULL' concatenation");
+        return false;
+    }
+    if (string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to append a concatenation to a 'NULL' builder");
+        return false;
+    }
+    if (concat->is_failed) {
+        error_reporter_report(ERROR_CODE_INVALID_STATE, __func__, "Trying to append a concatenation with a failed piece");
+        return false;
+    }
+    return string_concat_copy_pieces(string_builder, concat->pieces, concat->pieces_amount, concat->total_length);
+}
+
+StringBuilder * string_concat_build(StringConcat * concat) {
+    if (concat == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to build a 'NULL' concatenation");
+        return NULL;
+    }
+    if (concat->is_failed) {
+        error_reporter_report(ERROR_CODE_INVALID_STATE, __func__, "Trying to build a concatenation with a failed piece");
+        return NULL;
+    }
+    return string_concat_pieces_build(concat->pieces, concat->pieces_amount);
+}
+
+size_t string_concat_write(StringConcat * concat, char * buffer, size_t buffer_size) {
+    if (concat == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to write a 'NULL' concatenation");
+        return SIZE_MAX;
+    }
+    if (buffer == NULL && buffer_size > 0) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to write a concatenation to a 'NULL' buffer");
+        return SIZE_MAX;
+    }
+    if (concat->is_failed) {
+        error_reporter_report(ERROR_CODE_INVALID_STATE, __func__, "Trying to write a concatenation with a failed piece");
+        return SIZE_MAX;
+    }
+    // If the concatenation (plus the 'NULL' terminator) doesn't fit, only its length is returned
+    if (concat->total_length >= buffer_size) return concat->total_length;
+    char * to = buffer;
+    for (size_t i = 0; i < concat->pieces_amount; i++) {
+        memcpy(to, concat->pieces[i].bytes, concat->pieces[i].length);
+        to += concat->pieces[i].length;
+    }
+    (* to) = '\0';
+    return concat->total_length;
+}
+
+bool string_concat_pieces_append_to(StringBuilder * string_builder, const StringConcatPiece * pieces, size_t pieces_amount) {
+    if (string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to append pieces to a 'NULL' builder");
+        return false;
+    }
+    size_t total_length;
+    if (!string_concat_pieces_length(pieces, pieces_amount, &total_length)) return false;
+    return string_concat_copy_pieces(string_builder, pieces, pieces_amount, total_length);
+}
+
+StringBuilder * string_concat_pieces_build(const StringConcatPiece * pieces, size_t pieces_amount) {
+    size_t total_length;
+    if (!string_concat_pieces_length(pieces, pieces_amount, &total_length)) return NULL;
+    // Exactly the total length, plus the 'NULL' terminator
+    StringBuilder * string_builder = string_builder_create(total_length + 1);
+    if (string_builder == NULL) return NULL;
+    string_concat_copy_pieces(string_builder, pieces, pieces_amount, total_length);
+    return string_builder;
+}
+
+// Utilities
+
+bool string_concat_ensure_pieces_capacity(StringConcat * concat) {
+    // Step 1: Compute the next capacity of the pieces array (checking the size in bytes doesn't overflow)
+    size_t new_capacity = growth_policy_next_capacity(&concat->sequence_index, concat->pieces_amount + 1);
+    if (new_capacity > SIZE_MAX / sizeof(StringConcatPiece)) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "The pieces array is too big to be allocated");
+        return false;
+    }
+    // Step 2: Move the inline pieces to a new heap array, or resize the existing heap array
+    StringConcatPiece * new_pieces;
+    if (concat->pieces == concat->inline_pieces) {
+        new_pieces = malloc(sizeof(StringConcatPiece) * new_capacity);
+        if (new_pieces != NULL) memcpy(new_pieces, concat->inline_pieces, sizeof(StringConcatPiece) * concat->pieces_amount);
+    } else {
+        new_pieces = realloc(concat->pieces, sizeof(StringConcatPiece) * new_capacity);
+    }
+    if (new_pieces == NULL) {
+        error_reporter_report(ERROR_CODE_OUT_OF_MEMORY, __func__, "Unable to allocate memory for 'new_pieces'");
+        return false;
+    }
+    concat->pieces = new_pieces;
+    concat->pieces_capacity = new_capacity;
+    return true;
+}
+
+bool string_concat_pieces_length(const StringConcatPiece * pieces, size_t pieces_amount, size_t * total_length) {
+    if (pieces == NULL && pieces_amount > 0) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to concatenate a 'NULL' pieces array");
+        return false;
+    }
+    size_t length = 0;
+    for (size_t i = 0; i < pieces_amount; i++) {
+        if (pieces[i].bytes == NULL && pieces[i].length > 0) {
+            error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to concatenate a 'NULL' piece");
+            return false;
+        }
+        if (pieces[i].length > SIZE_MAX - 1 - length) {
+            error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The total length of the pieces is too big");
+            return false;
+        }
+        length += pieces[i].length;
+    }
+    (* total_length) = length;
+    return true;
+}
+
+bool string_concat_copy_pieces(StringBuilder * string_builder, const StringConcatPiece * pieces, size_t pieces_amount, size_t total_length) {
+    if (total_length == 0) return true;
+    // Step 1: Remember where the used part of the chain is (as plain numbers, because the old chain might be freed)
+    uintptr_t old_start = (uintptr_t) string_builder->built_chain;
+    uintptr_t old_stop = old_start + string_builder->used_capacity;
+    // Step 2: Grow the builder at most once, to fit the exact total length
+    if (!string_builder_ensure_capacity(string_builder, total_length)) return false;
+    char * new_start = string_builder->built_chain;
+    bool is_moved = (uintptr_t) new_start != old_start;
+    // Step 3: Copy every piece once (the pieces inside the old chain are copied from the same offset of the new one)
+    char * to = string_builder->built_chain + string_builder->used_capacity;
+    for (size_t i = 0; i < pieces_amount; i++) {
+        if (pieces[i].length == 0) continue;
+        const char * from = pieces[i].bytes;
+        uintptr_t address = (uintptr_t) from;
+        if (is_moved && address >= old_start && address < old_stop) from = new_start + (address - old_start);
+        memcpy(to, from, pieces[i].length);
+        to += pieces[i].length;
+    }
+    string_builder->used_capacity += total_length;
+    return true;
+}
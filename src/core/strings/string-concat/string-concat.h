@@ -0,0 +1,313 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdbool.h>   // For "true", "false" (boolean constants)
+#include <stddef.h>    // For "size_t" (size type)
+#include <stdint.h>    // For "SIZE_MAX" (length of the 'NULL' pieces)
+#include <string.h>    // For "strlen" (length of the chain pieces)
+#include "string-builder.h"
+#include "string-builder-inline.h" // For "struct string_builder" (the chain and size of the builder pieces)
+
+/* string-concat.h */
+#ifndef STRINGS_STRING_CONCAT_H
+#define STRINGS_STRING_CONCAT_H
+
+// The amount of pieces stored inside the concatenation itself (more pieces are stored in a heap array)
+#define STRING_CONCAT_INLINE_PIECES_AMOUNT 16
+
+/**
+ * A reference to the bytes of a piece (the bytes are never copied until the concatenation is evaluated).
+ */
+typedef struct string_concat_piece {
+    const char * bytes;             // The first byte of the piece
+    size_t length;                  // The amount of bytes of the piece
+} StringConcatPiece;
+
+/**
+ * A deferred concatenation, exposed only so it can be placed in the stack (its fields must not be accessed directly,
+ * and it must not be copied, because the pieces might point to its own inline array).
+ */
+typedef struct string_concat {
+    StringConcatPiece * pieces;     // The recorded pieces (the inline ones, or a heap array once they don't fit)
+    size_t pieces_amount;           // The amount of recorded pieces
+    size_t pieces_capacity;         // The amount of pieces that fit in the current array
+    size_t sequence_index;          // The index of the growth sequence value of the heap array
+    size_t total_length;            // The sum of the lengths of the pieces (known before copying anything)
+    bool is_failed;                 // Whether recording a piece failed (so the evaluation must fail too)
+    StringConcatPiece inline_pieces[STRING_CONCAT_INLINE_PIECES_AMOUNT]; // The first pieces (no allocation)
+} StringConcat;
+
+/**
+ * Initializes an empty concatenation.
+ *
+ * @param concat the concatenation to be initialized
+ *
+ * @return {@code true} if the concatenation was initialized, {@code false} otherwise
+ */
+bool string_concat_init(StringConcat * concat);
+
+/**
+ * Frees the heap array of the given concatenation (if its pieces did not fit inline), but not the pieces bytes.
+ *
+ * @param concat the concatenation that is about to be released (left empty, so it can be reused)
+ */
+void string_concat_release(StringConcat * concat);
+
+/**
+ * Records the given bytes as the next piece (only the reference, so the bytes must stay valid and unmodified until
+ * the concatenation is evaluated).
+ *
+ * @param concat the concatenation where the piece is to be recorded
+ * @param bytes the bytes of the piece (only allowed to be {@code NULL} if the "length" is zero)
+ * @param length the amount of bytes of the piece
+ *
+ * @note a failure is remembered, so the whole concatenation can be checked once, when it is evaluated
+ *
+ * @return {@code true} if the piece was recorded, {@code false} otherwise
+ */
+bool string_concat_add_bytes(StringConcat * concat, const char * bytes, size_t length);
+
+/**
+ * Records the given 'NULL' terminated chain as the next piece (see "string_concat_add_bytes").
+ *
+ * @param concat the concatenation where the piece is to be recorded
+ * @param chain the chain of the piece
+ *
+ * @return {@code true} if the piece was recorded, {@code false} otherwise
+ */
+bool string_concat_add_chain(StringConcat * concat, const char * chain);
+
+/**
+ * Records the current contents of the given builder as the next piece (see "string_concat_add_bytes"), without
+ * terminating nor shrinking it (so the builder must not be modified until the concatenation is evaluated).
+ *
+ * @param concat the concatenation where the piece is to be recorded
+ * @param string_builder the builder whose contents are the piece
+ *
+ * @return {@code true} if the piece was recorded, {@code false} otherwise
+ */
+bool string_concat_add_builder(StringConcat * concat, StringBuilder * string_builder);
+
+/**
+ * Returns the exact length of the concatenation (the sum of the lengths of its pieces).
+ *
+ * @param concat the concatenation to be measured
+ *
+ * @return the total length, or '0' if the concatenation is {@code NULL}
+ */
+size_t string_concat_length(StringConcat * concat);
+
+/**
+ * Appends the concatenation to the given builder, growing it at most once (to fit the exact total length) and
+ * copying every piece once.
+ *
+ * @param concat the concatenation to be evaluated
+ * @param string_builder the builder where the concatenation is to be appended (a piece might reference its chain)
+ *
+ * @return {@code true} if the concatenation was appended, {@code false} otherwise
+ */
+bool string_concat_append_to(StringConcat * concat, StringBuilder * string_builder);
+
+/**
+ * Creates a builder holding the concatenation, allocated with the exact total length (plus the 'NULL' terminator).
+ *
+ * The returned builder must be freed by the client after its usage.
+ *
+ * @param concat the concatenation to be evaluated
+ *
+ * @return a new string builder, or {@code NULL} if an error occurred
+ */
+StringBuilder * string_concat_build(StringConcat * concat);
+
+/**
+ * Writes the concatenation into the given buffer, with the "snprintf" semantics: the buffer is only filled (and
+ * 'NULL' terminated) if the whole concatenation fits, otherwise it is left untouched, and the required length is
+ * returned anyway (so the client can allocate it and call again).
+ *
+ * @param concat the concatenation to be evaluated
+ * @param buffer the buffer where the concatenation is to be written (only allowed to be {@code NULL} if its size is '0')
+ * @param buffer_size the size of the buffer (it fits if it is greater than the total length)
+ *
+ * @return the total length of the concatenation (without the 'NULL' terminator), or "SIZE_MAX" if an error occurred
+ */
+size_t string_concat_write(StringConcat * concat, char * buffer, size_t buffer_size);
+
+/**
+ * Appends the given pieces to the given builder, growing it at most once (the function behind "STRING_CONCAT_APPEND").
+ *
+ * @param string_builder the builder where the pieces are to be appended
+ * @param pieces the pieces to be appended
+ * @param pieces_amount the amount of pieces
+ *
+ * @return {@code true} if the pieces were appended, {@code false} otherwise
+ */
+bool string_concat_pieces_append_to(StringBuilder * string_builder, const StringConcatPiece * pieces, size_t pieces_amount);
+
+/**
+ * Creates a builder holding the given pieces, allocated with their exact total length (the function behind
+ * "STRING_CONCAT_BUILD").
+ *
+ * The returned builder must be freed by the client after its usage.
+ *
+ * @param pieces the pieces to be concatenated
+ * @param pieces_amount the amount of pieces
+ *
+ * @return a new string builder, or {@code NULL} if an error occurred
+ */
+StringBuilder * string_concat_pieces_build(const StringConcatPiece * pieces, size_t pieces_amount);
+
+// Pieces of the variadic macros (a chain is measured here, so the length of a literal is computed at compile time)
+// A 'NULL' argument becomes a 'NULL' piece of "SIZE_MAX" bytes, so it is reported when the pieces are evaluated
+
+static inline StringConcatPiece string_concat_piece_of_chain(const char * chain) {
+    StringConcatPiece piece = { chain, (chain == NULL) ? SIZE_MAX : strlen(chain) };
+    return piece;
+}
+
+static inline StringConcatPiece string_concat_piece_of_builder(StringBuilder * string_builder) {
+    StringConcatPiece piece = { NULL, SIZE_MAX };
+    if (string_builder != NULL) {
+        piece.bytes = string_builder->built_chain;
+        piece.length = string_builder->used_capacity;
+    }
+    return piece;
+}
+
+static inline StringConcatPiece string_concat_piece_of_piece(StringConcatPiece piece) {
+    return piece;
+}
+
+/**
+ * A piece of the given bytes and length (for the variadic macros, i.e., a slice of a bigger buffer).
+ */
+#define STRING_CONCAT_BYTES(bytes, length) ((StringConcatPiece) { (bytes), (length) })
+
+/**
+ * Converts an argument of the variadic macros into a piece: a chain (i.e., a literal), a builder, or a piece.
+ */
+#define STRING_CONCAT_PIECE(argument) _Generic((argument), \
+        StringBuilder *: string_concat_piece_of_builder, \
+        char *: string_concat_piece_of_chain, \
+        const char *: string_concat_piece_of_chain, \
+        StringConcatPiece: string_concat_piece_of_piece)(argument)
+
+/**
+ * Appends all the arguments (up to 64 chains, literals, builders or pieces) to the given builder, growing it at most
+ * once, i.e., "STRING_CONCAT_APPEND(output, "<", tag, ">", body, "</", tag, ">")".
+ *
+ * Every argument is evaluated once, and the result is a {@code bool} (see "string_concat_pieces_append_to").
+ */
+#define STRING_CONCAT_APPEND(string_builder, ...) string_concat_pieces_append_to((string_builder), \
+        (StringConcatPiece[]) { STRING_CONCAT_MAP(__VA_ARGS__) }, \
+        sizeof((StringConcatPiece[]) { STRING_CONCAT_MAP(__VA_ARGS__) }) / sizeof(StringConcatPiece))
+
+/**
+ * Creates a builder holding all the arguments (up to 64 chains, literals, builders or pieces), allocated with their
+ * exact total length, i.e., "STRING_CONCAT_BUILD(scheme, "://", host, path)".
+ *
+ * Every argument is evaluated once, and the result is a new builder (see "string_concat_pieces_build").
+ */
+#define STRING_CONCAT_BUILD(...) string_concat_pieces_build( \
+        (StringConcatPiece[]) { STRING_CONCAT_MAP(__VA_ARGS__) }, \
+        sizeof((StringConcatPiece[]) { STRING_CONCAT_MAP(__VA_ARGS__) }) / sizeof(StringConcatPiece))
+
+// Applies "STRING_CONCAT_PIECE" to every argument (the amount of arguments picks the right expansion)
+
+#define STRING_CONCAT_SELECT( \
+        _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, \
+        _24, _25, _26, _27, _28, _29, _30, _31, _32, _33, _34, _35, _36, _37, _38, _39, _40, _41, _42, _43, _44, \
+        _45, _46, _47, _48, _49, _50, _51, _52, _53, _54, _55, _56, _57, _58, _59, _60, _61, _62, _63, _64, name, \
+        ...) name
+#define STRING_CONCAT_MAP(...) STRING_CONCAT_SELECT(__VA_ARGS__, \
+        STRING_CONCAT_MAP_64, STRING_CONCAT_MAP_63, STRING_CONCAT_MAP_62, STRING_CONCAT_MAP_61, \
+        STRING_CONCAT_MAP_60, STRING_CONCAT_MAP_59, STRING_CONCAT_MAP_58, STRING_CONCAT_MAP_57, \
+        STRING_CONCAT_MAP_56, STRING_CONCAT_MAP_55, STRING_CONCAT_MAP_54, STRING_CONCAT_MAP_53, \
+        STRING_CONCAT_MAP_52, STRING_CONCAT_MAP_51, STRING_CONCAT_MAP_50, STRING_CONCAT_MAP_49, \
+        STRING_CONCAT_MAP_48, STRING_CONCAT_MAP_47, STRING_CONCAT_MAP_46, STRING_CONCAT_MAP_45, \
+        STRING_CONCAT_MAP_44, STRING_CONCAT_MAP_43, STRING_CONCAT_MAP_42, STRING_CONCAT_MAP_41, \
+        STRING_CONCAT_MAP_40, STRING_CONCAT_MAP_39, STRING_CONCAT_MAP_38, STRING_CONCAT_MAP_37, \
+        STRING_CONCAT_MAP_36, STRING_CONCAT_MAP_35, STRING_CONCAT_MAP_34, STRING_CONCAT_MAP_33, \
+        STRING_CONCAT_MAP_32, STRING_CONCAT_MAP_31, STRING_CONCAT_MAP_30, STRING_CONCAT_MAP_29, \
+        STRING_CONCAT_MAP_28, STRING_CONCAT_MAP_27, STRING_CONCAT_MAP_26, STRING_CONCAT_MAP_25, \
+        STRING_CONCAT_MAP_24, STRING_CONCAT_MAP_23, STRING_CONCAT_MAP_22, STRING_CONCAT_MAP_21, \
+        STRING_CONCAT_MAP_20, STRING_CONCAT_MAP_19, STRING_CONCAT_MAP_18, STRING_CONCAT_MAP_17, \
+        STRING_CONCAT_MAP_16, STRING_CONCAT_MAP_15, STRING_CONCAT_MAP_14, STRING_CONCAT_MAP_13, \
+        STRING_CONCAT_MAP_12, STRING_CONCAT_MAP_11, STRING_CONCAT_MAP_10, STRING_CONCAT_MAP_9, STRING_CONCAT_MAP_8, \
+        STRING_CONCAT_MAP_7, STRING_CONCAT_MAP_6, STRING_CONCAT_MAP_5, STRING_CONCAT_MAP_4, STRING_CONCAT_MAP_3, \
+        STRING_CONCAT_MAP_2, STRING_CONCAT_MAP_1)(__VA_ARGS__)
+#define STRING_CONCAT_MAP_1(x) STRING_CONCAT_PIECE(x)
+#define STRING_CONCAT_MAP_2(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_1(__VA_ARGS__)
+#define STRING_CONCAT_MAP_3(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_2(__VA_ARGS__)
+#define STRING_CONCAT_MAP_4(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_3(__VA_ARGS__)
+#define STRING_CONCAT_MAP_5(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_4(__VA_ARGS__)
+#define STRING_CONCAT_MAP_6(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_5(__VA_ARGS__)
+#define STRING_CONCAT_MAP_7(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_6(__VA_ARGS__)
+#define STRING_CONCAT_MAP_8(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_7(__VA_ARGS__)
+#define STRING_CONCAT_MAP_9(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_8(__VA_ARGS__)
+#define STRING_CONCAT_MAP_10(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_9(__VA_ARGS__)
+#define STRING_CONCAT_MAP_11(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_10(__VA_ARGS__)
+#define STRING_CONCAT_MAP_12(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_11(__VA_ARGS__)
+#define STRING_CONCAT_MAP_13(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_12(__VA_ARGS__)
+#define STRING_CONCAT_MAP_14(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_13(__VA_ARGS__)
+#define STRING_CONCAT_MAP_15(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_14(__VA_ARGS__)
+#define STRING_CONCAT_MAP_16(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_15(__VA_ARGS__)
+#define STRING_CONCAT_MAP_17(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_16(__VA_ARGS__)
+#define STRING_CONCAT_MAP_18(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_17(__VA_ARGS__)
+#define STRING_CONCAT_MAP_19(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_18(__VA_ARGS__)
+#define STRING_CONCAT_MAP_20(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_19(__VA_ARGS__)
+#define STRING_CONCAT_MAP_21(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_20(__VA_ARGS__)
+#define STRING_CONCAT_MAP_22(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_21(__VA_ARGS__)
+#define STRING_CONCAT_MAP_23(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_22(__VA_ARGS__)
+#define STRING_CONCAT_MAP_24(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_23(__VA_ARGS__)
+#define STRING_CONCAT_MAP_25(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_24(__VA_ARGS__)
+#define STRING_CONCAT_MAP_26(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_25(__VA_ARGS__)
+#define STRING_CONCAT_MAP_27(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_26(__VA_ARGS__)
+#define STRING_CONCAT_MAP_28(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_27(__VA_ARGS__)
+#define STRING_CONCAT_MAP_29(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_28(__VA_ARGS__)
+#define STRING_CONCAT_MAP_30(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_29(__VA_ARGS__)
+#define STRING_CONCAT_MAP_31(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_30(__VA_ARGS__)
+#define STRING_CONCAT_MAP_32(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_31(__VA_ARGS__)
+#define STRING_CONCAT_MAP_33(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_32(__VA_ARGS__)
+#define STRING_CONCAT_MAP_34(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_33(__VA_ARGS__)
+#define STRING_CONCAT_MAP_35(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_34(__VA_ARGS__)
+#define STRING_CONCAT_MAP_36(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_35(__VA_ARGS__)
+#define STRING_CONCAT_MAP_37(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_36(__VA_ARGS__)
+#define STRING_CONCAT_MAP_38(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_37(__VA_ARGS__)
+#define STRING_CONCAT_MAP_39(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_38(__VA_ARGS__)
+#define STRING_CONCAT_MAP_40(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_39(__VA_ARGS__)
+#define STRING_CONCAT_MAP_41(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_40(__VA_ARGS__)
+#define STRING_CONCAT_MAP_42(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_41(__VA_ARGS__)
+#define STRING_CONCAT_MAP_43(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_42(__VA_ARGS__)
+#define STRING_CONCAT_MAP_44(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_43(__VA_ARGS__)
+#define STRING_CONCAT_MAP_45(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_44(__VA_ARGS__)
+#define STRING_CONCAT_MAP_46(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_45(__VA_ARGS__)
+#define STRING_CONCAT_MAP_47(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_46(__VA_ARGS__)
+#define STRING_CONCAT_MAP_48(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_47(__VA_ARGS__)
+#define STRING_CONCAT_MAP_49(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_48(__VA_ARGS__)
+#define STRING_CONCAT_MAP_50(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_49(__VA_ARGS__)
+#define STRING_CONCAT_MAP_51(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_50(__VA_ARGS__)
+#define STRING_CONCAT_MAP_52(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_51(__VA_ARGS__)
+#define STRING_CONCAT_MAP_53(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_52(__VA_ARGS__)
+#define STRING_CONCAT_MAP_54(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_53(__VA_ARGS__)
+#define STRING_CONCAT_MAP_55(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_54(__VA_ARGS__)
+#define STRING_CONCAT_MAP_56(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_55(__VA_ARGS__)
+#define STRING_CONCAT_MAP_57(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_56(__VA_ARGS__)
+#define STRING_CONCAT_MAP_58(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_57(__VA_ARGS__)
+#define STRING_CONCAT_MAP_59(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_58(__VA_ARGS__)
+#define STRING_CONCAT_MAP_60(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_59(__VA_ARGS__)
+#define STRING_CONCAT_MAP_61(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_60(__VA_ARGS__)
+#define STRING_CONCAT_MAP_62(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_61(__VA_ARGS__)
+#define STRING_CONCAT_MAP_63(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_62(__VA_ARGS__)
+#define STRING_CONCAT_MAP_64(x, ...) STRING_CONCAT_PIECE(x), STRING_CONCAT_MAP_63(__VA_ARGS__)
+
+#endif /* STRINGS_STRING_CONCAT_H */
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L // For "clock_gettime", "CLOCK_MONOTONIC" (monotonic clock), "strtok_r"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "string-builder.h"
+#include "string-tokenizer.h"
+
+// Benchmarking snippet (not abstracted away for piece of code portability)
+double elapsed_seconds(struct timespec start, struct timespec stop) {
+    return (double) (stop.tv_sec - start.tv_sec) + (double) (stop.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Benchmarks
+
+// Splits a copy of the contents into lines and then fields with "strtok_r" (the replaced approach)
+size_t strtok_fields(StringBuilder * builder) {
+    char * copy = string_builder_result_as_copy(builder);
+    size_t fields_amount = 0;
+    char * line_state;
+    for (char * line = strtok_r(copy, "\n", &line_state); line != NULL; line = strtok_r(NULL, "\n", &line_state)) {
+        char * field_state;
+        for (char * field = strtok_r(line, ",", &field_state); field != NULL; field = strtok_r(NULL, ",", &field_state)) {
+            fields_amount++;
+        }
+    }
+    free(copy);
+    return fields_amount;
+}
+
+size_t tokenizer_fields(StringBuilder * builder, StringTokenizerMode mode, StringTokenizerScanner scanner) {
+    StringTokenizer tokenizer;
+    string_tokenizer_init_builder(&tokenizer, builder, mode, ',');
+    if (!string_tokenizer_set_scanner(&tokenizer, scanner)) return 0;
+    StringToken token;
+    size_t fields_amount = 0;
+    while (string_tokenizer_next(&tokenizer, &token)) fields_amount++;
+    return fields_amount;
+}
+
+void string_tokenizer_benchmark(size_t rows_amount, size_t repetitions) {
+    StringBuilder * builder = string_builder_create_default();
+    char row[256];
+    for (size_t i = 0; i < rows_amount; i++) {
+        snprintf(row, sizeof(row), "%zu,customer-%zu,%zu.%02zu,a longer free text description of the row number %zu\n", i, i * 7 % 1000, i % 5000, i % 100, i);
+        string_builder_append_all(builder, row);
+    }
+    double megabytes = (double) string_builder_size(builder) * (double) repetitions / 1e6;
+    printf("%zu rows (%.1f MB), %zu repetitions\n", rows_amount, (double) string_builder_size(builder) / 1e6, repetitions);
+    printf("%-24s %10s %12s\n", "implementation", "MB/s", "fields");
+    const char * names[] = { "strtok_r (copy)", "fields (scalar)", "fields (sse2)", "fields (avx2)", "csv (scalar)", "csv (avx2)" };
+    StringTokenizerMode modes[] = { 0, STRING_TOKENIZER_MODE_FIELDS, STRING_TOKENIZER_MODE_FIELDS, STRING_TOKENIZER_MODE_FIELDS, STRING_TOKENIZER_MODE_CSV, STRING_TOKENIZER_MODE_CSV };
+    StringTokenizerScanner scanners[] = { 0, STRING_TOKENIZER_SCANNER_SCALAR, STRING_TOKENIZER_SCANNER_SSE2, STRING_TOKENIZER_SCANNER_AVX2, STRING_TOKENIZER_SCANNER_SCALAR, STRING_TOKENIZER_SCANNER_AVX2 };
+    for (size_t i = 0; i < sizeof(names) / sizeof(char *); i++) {
+        struct timespec start, stop;
+        size_t fields_amount = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (size_t j = 0; j < repetitions; j++) {
+            fields_amount = (i == 0) ? strtok_fields(builder) : tokenizer_fields(builder, modes[i], scanners[i]);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        if (fields_amount == 0) {
+            printf("%-24s %10s\n", names[i], "unsupported");
+            continue;
+        }
+        printf("%-24s %10.1f %12zu\n", names[i], megabytes / elapsed_seconds(start, stop), fields_amount);
+    }
+    string_builder_destroy(builder);
+}
+
+// Benchmarks runner (the arguments optionally override the amount of rows and the amount of repetitions)
+
+int main(int argc, char * argv[]) {
+    size_t rows_amount = (argc > 1) ? strtoull(argv[1], NULL, 10) : 1000000;
+    size_t repetitions = (argc > 2) ? strtoull(argv[2], NULL, 10) : 10;
+    string_tokenizer_benchmark(rows_amount, repetitions);
+}
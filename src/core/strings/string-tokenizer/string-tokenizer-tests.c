@@ -0,0 +1,215 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "string-builder.h"
+#include "string-tokenizer.h"
+#include "error-reporter.h"
+
+// Assertion snippet (not abstracted away for piece of code portability)
+void assert(int condition, char message[]) {
+    if (condition != 1) {
+        printf("%s\n", message);
+        exit(1);
+    }
+}
+
+// Utilities
+
+// Checks the next token has the expected contents (and record end flag)
+bool next_matches(StringTokenizer * tokenizer, const char * expected, bool is_record_end) {
+    StringToken token;
+    if (!string_tokenizer_next(tokenizer, &token)) return false;
+    char unescaped[256];
+    size_t length = string_tokenizer_unescape(&token, unescaped);
+    return length == strlen(expected) && memcmp(unescaped, expected, length) == 0 && token.is_record_end == is_record_end;
+}
+
+// Unit testing
+
+void string_tokenizer_lines_test() {
+    printf("*** Running test '%s'\n", __func__);
+    StringTokenizer tokenizer;
+    const char * text = "first line\r\nsecond, line\n\nlast line";
+    assert(string_tokenizer_init(&tokenizer, text, strlen(text), STRING_TOKENIZER_MODE_LINES, 0), "Tokenizer must be initialized");
+    assert(next_matches(&tokenizer, "first line", true), "First line must drop the carriage return");
+    assert(next_matches(&tokenizer, "second, line", true), "Second line must not be split by commas");
+    assert(next_matches(&tokenizer, "", true), "Empty line must be a token");
+    assert(next_matches(&tokenizer, "last line", true), "Last line must not require a new line");
+    StringToken token;
+    assert(!string_tokenizer_next(&tokenizer, &token), "There must be no more lines");
+    // A trailing new line does not produce an empty line, and no bytes produce no lines
+    assert(string_tokenizer_init(&tokenizer, "one\n", 4, STRING_TOKENIZER_MODE_LINES, 0), "Tokenizer must be initialized");
+    assert(next_matches(&tokenizer, "one", true), "Single line must be obtained");
+    assert(!string_tokenizer_next(&tokenizer, &token), "Trailing new line must not produce a line");
+    assert(string_tokenizer_init(&tokenizer, NULL, 0, STRING_TOKENIZER_MODE_LINES, 0), "Empty tokenizer must be initialized");
+    assert(!string_tokenizer_next(&tokenizer, &token), "Empty bytes must produce no lines");
+    // The last CRLF line drops its carriage return even without a final new line (also its last field)
+    assert(string_tokenizer_init(&tokenizer, "one\r\ntwo\r", 9, STRING_TOKENIZER_MODE_LINES, 0), "Tokenizer must be initialized");
+    assert(next_matches(&tokenizer, "one", true), "First CRLF line must drop the carriage return");
+    assert(next_matches(&tokenizer, "two", true), "Last CRLF line must drop the carriage return");
+    assert(!string_tokenizer_next(&tokenizer, &token), "There must be no more CRLF lines");
+    assert(string_tokenizer_init(&tokenizer, "a,b\r", 4, STRING_TOKENIZER_MODE_FIELDS, ','), "Tokenizer must be initialized");
+    assert(next_matches(&tokenizer, "a", false), "First field must be obtained");
+    assert(next_matches(&tokenizer, "b", true), "Last field must drop the carriage return");
+}
+
+void string_tokenizer_fields_test() {
+    printf("*** Running test '%s'\n", __func__);
+    StringTokenizer tokenizer;
+    const char * text = "a,b,,\"c\"\n\nd,\ne,f,";
+    assert(string_tokenizer_init(&tokenizer, text, strlen(text), STRING_TOKENIZER_MODE_FIELDS, ','), "Tokenizer must be initialized");
+    assert(next_matches(&tokenizer, "a", false), "Field 'a' must be obtained");
+    assert(next_matches(&tokenizer, "b", false), "Field 'b' must be obtained");
+    assert(next_matches(&tokenizer, "", false), "Empty field must be obtained");
+    assert(next_matches(&tokenizer, "\"c\"", true), "Quotes must be kept when not using the CSV mode");
+    assert(next_matches(&tokenizer, "", true), "Empty line must be a single empty field");
+    assert(next_matches(&tokenizer, "d", false), "Field 'd' must be obtained");
+    assert(next_matches(&tokenizer, "", true), "Empty field before the new line must be obtained");
+    assert(next_matches(&tokenizer, "e", false), "Field 'e' must be obtained");
+    assert(next_matches(&tokenizer, "f", false), "Field 'f' must be obtained");
+    assert(next_matches(&tokenizer, "", true), "Trailing delimiter must be followed by an empty field");
+    StringToken token;
+    assert(!string_tokenizer_next(&tokenizer, &token), "There must be no more fields");
+}
+
+void string_tokenizer_csv_test() {
+    printf("*** Running test '%s'\n", __func__);
+    StringTokenizer tokenizer;
+    const char * text = "id;\"name; with \"\"quotes\"\"\";\"multi\nline\"\r\n2;\"\";plain \"quote\"\n\"last\"";
+    assert(string_tokenizer_init(&tokenizer, text, strlen(text), STRING_TOKENIZER_MODE_CSV, ';'), "Tokenizer must be initialized");
+    assert(next_matches(&tokenizer, "id", false), "Field 'id' must be obtained");
+    assert(next_matches(&tokenizer, "name; with \"quotes\"", false), "Quoted field must be unescaped");
+    assert(next_matches(&tokenizer, "multi\nline", true), "Quoted field must contain the new line");
+    assert(next_matches(&tokenizer, "2", false), "Field '2' must be obtained");
+    assert(next_matches(&tokenizer, "", false), "Empty quoted field must be obtained");
+    assert(next_matches(&tokenizer, "plain \"quote\"", true), "Quotes in unquoted fields must be literal");
+    assert(next_matches(&tokenizer, "last", true), "Quoted field at the end must be obtained");
+    StringToken token;
+    assert(!string_tokenizer_next(&tokenizer, &token), "There must be no more fields");
+    assert(!string_tokenizer_is_malformed(&tokenizer), "Tokenizer must not be malformed");
+    // The tokens point into the bytes (no copies)
+    assert(string_tokenizer_init(&tokenizer, text, strlen(text), STRING_TOKENIZER_MODE_CSV, ';'), "Tokenizer must be initialized");
+    assert(string_tokenizer_next(&tokenizer, &token) && token.start == text, "Token must point into the bytes");
+    assert(string_tokenizer_next(&tokenizer, &token) && token.start == text + 4 && token.has_escaped_quotes, "Quoted token must point after the quote");
+}
+
+void string_tokenizer_malformed_csv_test() {
+    printf("*** Running test '%s'\n", __func__);
+    StringTokenizer tokenizer;
+    StringToken token;
+    const char * unterminated = "a,\"b,c\nd";
+    assert(string_tokenizer_init(&tokenizer, unterminated, strlen(unterminated), STRING_TOKENIZER_MODE_CSV, ','), "Tokenizer must be initialized");
+    assert(next_matches(&tokenizer, "a", false), "Field before the malformed one must be obtained");
+    assert(!string_tokenizer_next(&tokenizer, &token), "Unterminated quoted field must fail");
+    assert(string_tokenizer_is_malformed(&tokenizer), "Tokenizer must be malformed");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "Error must be an invalid argument error");
+    assert(!string_tokenizer_next(&tokenizer, &token), "Malformed tokenizer must stop");
+    const char * trailing = "\"a\"b,c";
+    assert(string_tokenizer_init(&tokenizer, trailing, strlen(trailing), STRING_TOKENIZER_MODE_CSV, ','), "Tokenizer must be initialized");
+    assert(!string_tokenizer_next(&tokenizer, &token), "Bytes after the closing quote must fail");
+    assert(string_tokenizer_is_malformed(&tokenizer), "Tokenizer must be malformed");
+}
+
+void string_tokenizer_builder_test() {
+    printf("*** Running test '%s'\n", __func__);
+    StringBuilder * builder = string_builder_create_default();
+    // Long fields, so the tokens cross several scanned blocks
+    for (size_t i = 0; i < 100; i++) {
+        char line[128];
+        snprintf(line, sizeof(line), "%zu,%0100zu,x\n", i, i);
+        string_builder_append_all(builder, line);
+    }
+    StringTokenizer tokenizer;
+    assert(string_tokenizer_init_builder(&tokenizer, builder, STRING_TOKENIZER_MODE_CSV, ','), "Tokenizer must be initialized");
+    for (size_t i = 0; i < 100; i++) {
+        char expected[128];
+        snprintf(expected, sizeof(expected), "%zu", i);
+        assert(next_matches(&tokenizer, expected, false), "Index field must be obtained");
+        snprintf(expected, sizeof(expected), "%0100zu", i);
+        assert(next_matches(&tokenizer, expected, false), "Long field must be obtained");
+        assert(next_matches(&tokenizer, "x", true), "Last field must be obtained");
+    }
+    StringToken token;
+    assert(!string_tokenizer_next(&tokenizer, &token), "There must be no more fields");
+    string_builder_destroy(builder);
+}
+
+void string_tokenizer_scanners_test() {
+    printf("*** Running test '%s'\n", __func__);
+    // Random bytes dense in structural characters, every scanner must produce the same tokens
+    const size_t LENGTH = 10000;
+    char * text = malloc(LENGTH);
+    const char alphabet[] = "ab,\n\"\r";
+    uint64_t random_state = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < LENGTH; i++) {
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 7;
+        random_state ^= random_state << 17;
+        text[i] = alphabet[random_state % 6];
+    }
+    StringTokenizerScanner scanners[] = { STRING_TOKENIZER_SCANNER_SSE2, STRING_TOKENIZER_SCANNER_AVX2 };
+    StringTokenizerMode modes[] = { STRING_TOKENIZER_MODE_LINES, STRING_TOKENIZER_MODE_FIELDS, STRING_TOKENIZER_MODE_CSV };
+    for (size_t i = 0; i < 3; i++) {
+        for (size_t j = 0; j < 2; j++) {
+            StringTokenizer reference, tokenizer;
+            string_tokenizer_init(&reference, text, LENGTH, modes[i], ',');
+            string_tokenizer_init(&tokenizer, text, LENGTH, modes[i], ',');
+            assert(string_tokenizer_set_scanner(&reference, STRING_TOKENIZER_SCANNER_SCALAR), "Scalar scanner must be available");
+            if (!string_tokenizer_set_scanner(&tokenizer, scanners[j])) {
+                assert(error_reporter_last_code() == ERROR_CODE_UNSUPPORTED, "Missing scanner must be unsupported");
+                continue;
+            }
+            StringToken expected, token;
+            size_t tokens_amount = 0;
+            while (string_tokenizer_next(&reference, &expected)) {
+                assert(string_tokenizer_next(&tokenizer, &token), "Scanner must obtain the same amount of tokens");
+                assert(token.start == expected.start && token.length == expected.length, "Scanner must obtain the same tokens");
+                assert(token.is_record_end == expected.is_record_end, "Scanner must obtain the same record ends");
+                tokens_amount++;
+            }
+            assert(!string_tokenizer_next(&tokenizer, &token), "Scanner must stop at the same token");
+            assert(string_tokenizer_is_malformed(&tokenizer) == string_tokenizer_is_malformed(&reference), "Scanner must fail the same way");
+            assert(tokens_amount > 0, "Random bytes must produce tokens");
+        }
+    }
+    free(text);
+}
+
+void string_tokenizer_invalid_arguments_test() {
+    printf("*** Running test '%s'\n", __func__);
+    StringTokenizer tokenizer;
+    StringToken token;
+    assert(!string_tokenizer_init(NULL, "a", 1, STRING_TOKENIZER_MODE_LINES, 0), "'NULL' tokenizer must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_NULL_ARGUMENT, "Error must be a 'NULL' argument error");
+    assert(!string_tokenizer_init(&tokenizer, NULL, 1, STRING_TOKENIZER_MODE_LINES, 0), "'NULL' bytes must fail");
+    assert(!string_tokenizer_init(&tokenizer, "a", 1, STRING_TOKENIZER_MODE_CSV, '"'), "Quote delimiter must fail");
+    assert(error_reporter_last_code() == ERROR_CODE_INVALID_ARGUMENT, "Error must be an invalid argument error");
+    assert(!string_tokenizer_init(&tokenizer, "a", 1, STRING_TOKENIZER_MODE_FIELDS, '\n'), "New line delimiter must fail");
+    assert(!string_tokenizer_init_builder(&tokenizer, NULL, STRING_TOKENIZER_MODE_LINES, 0), "'NULL' builder must fail");
+    assert(!string_tokenizer_next(NULL, &token), "'NULL' tokenizer must not obtain tokens");
+}
+
+int main() {
+    fclose(stderr); // Prevent printing "expected" errors
+    string_tokenizer_lines_test();
+    string_tokenizer_fields_test();
+    string_tokenizer_csv_test();
+    string_tokenizer_malformed_csv_test();
+    string_tokenizer_builder_test();
+    string_tokenizer_scanners_test();
+    string_tokenizer_invalid_arguments_test();
+}
@@ -0,0 +1,343 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * A Zero-Copy Lines & Fields Tokenizer Implementation (with SIMD delimiter scanning).
+ *
+ * ### Explanation ###
+ *
+ * Splitting with "strtok" requires a mutable copy of the contents (as it writes the 'NULL' terminators), and it looks
+ * for the delimiters one byte at a time. Instead, the tokens are returned as "(start, length)" slices pointing into
+ * the original bytes, so nothing is copied nor allocated, and the tokenizer itself can live in the stack.
+ *
+ * ### Structural characters ###
+ *
+ * Only three characters matter to find the tokens boundaries: the delimiter, the new line and (in the CSV mode) the
+ * quote. The bytes are scanned in blocks of 64, where every block produces a 64 bits mask with one bit set for every
+ * structural character found in it. Then the tokens are found by popping the lowest set bit of the mask (a "count
+ * trailing zeros" instruction), and a new block is only scanned once all the bits of the current one were consumed.
+ *
+ * The blocks are scanned with SSE2 (four 16 bytes comparisons) or AVX2 (two 32 bytes comparisons), where every
+ * comparison against the three characters produces a byte mask, which is compressed into bits with "movemask". The
+ * widest implementation supported by the running CPU is chosen when initializing the tokenizer (so the kit does not
+ * need to be compiled with "-mavx2"), and the last block (shorter than 64 bytes) is copied into a padded buffer.
+ *
+ * ### CSV ###
+ *
+ * A field starting with a quote ends at the next single quote (a doubled quote is an escaped quote), so the delimiters
+ * and new lines popped meanwhile are skipped. The quotes are not part of the token, and the escaped quotes are not
+ * collapsed (that would require a copy), instead the token is flagged so the client can unescape it on demand. A quote
+ * found in the middle of an unquoted field is considered a literal character (like most CSV parsers do).
+ *
+ * ### References ###
+ *
+ * - https://www.rfc-editor.org/rfc/rfc4180
+ * - https://arxiv.org/abs/1902.08318 (Parsing Gigabytes of JSON per Second)
+ * - https://www.intel.com/content/www/us/en/docs/intrinsics-guide/index.html
+ */
+
+// Imports & Headers
+
+#include <string.h>         // For "memcpy", "memset" (padding the last block)
+#include "string-tokenizer.h"
+#include "string-builder-inline.h"
+#include "error-reporter.h"  // For "error_reporter_report" (reporting errors)
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STRING_TOKENIZER_X86
+#include <immintrin.h>      // For "_mm_cmpeq_epi8", "_mm256_cmpeq_epi8" (SIMD comparisons)
+#endif
+
+// Default implementation values
+
+#define BLOCK_SIZE 64
+
+// Definition (to be able to use methods before declaring them, to follow up the top-bottom code style)
+
+bool string_tokenizer_next_quoted(StringTokenizer * tokenizer, StringToken * token);
+size_t string_tokenizer_next_structural(StringTokenizer * tokenizer);
+void string_tokenizer_load_block(StringTokenizer * tokenizer, size_t block_start);
+bool string_tokenizer_fail(StringTokenizer * tokenizer, const char * function, const char * message);
+uint64_t string_tokenizer_scan_scalar(const char * block, char first, char second, char third);
+#ifdef STRING_TOKENIZER_X86
+uint64_t string_tokenizer_scan_sse2(const char * block, char first, char second, char third);
+uint64_t string_tokenizer_scan_avx2(const char * block, char first, char second, char third);
+#endif
+
+// Implementation
+
+bool string_tokenizer_init(StringTokenizer * tokenizer, const char * bytes, size_t length, StringTokenizerMode mode, char delimiter) {
+    if (tokenizer == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to initialize a 'NULL' tokenizer");
+        return false;
+    }
+    if (bytes == NULL && length > 0) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to tokenize 'NULL' bytes");
+        return false;
+    }
+    if (mode != STRING_TOKENIZER_MODE_LINES && mode != STRING_TOKENIZER_MODE_FIELDS && mode != STRING_TOKENIZER_MODE_CSV) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'mode' must be one of the tokenizer modes");
+        return false;
+    }
+    if (mode != STRING_TOKENIZER_MODE_LINES && (delimiter == '\n' || delimiter == '\r' || delimiter == '"')) {
+        error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, __func__, "The 'delimiter' must not be a new line nor a quote");
+        return false;
+    }
+    tokenizer->bytes = bytes;
+    tokenizer->length = length;
+    tokenizer->position = 0;
+    tokenizer->delimiter = (mode == STRING_TOKENIZER_MODE_LINES) ? '\n' : delimiter;
+    tokenizer->mode = mode;
+    tokenizer->is_field_pending = false;
+    tokenizer->is_malformed = false;
+    string_tokenizer_set_scanner(tokenizer, STRING_TOKENIZER_SCANNER_AUTO);
+    return true;
+}
+
+bool string_tokenizer_init_builder(StringTokenizer * tokenizer, StringBuilder * string_builder, StringTokenizerMode mode, char delimiter) {
+    if (string_builder == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to tokenize a 'NULL' builder");
+        return false;
+    }
+    return string_tokenizer_init(tokenizer, string_builder->built_chain, string_builder->used_capacity, mode, delimiter);
+}
+
+bool string_tokenizer_set_scanner(StringTokenizer * tokenizer, StringTokenizerScanner scanner) {
+    if (tokenizer == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to set the scanner of a 'NULL' tokenizer");
+        return false;
+    }
+    switch (scanner) {
+        case STRING_TOKENIZER_SCANNER_AUTO:
+#ifdef STRING_TOKENIZER_X86
+            if (__builtin_cpu_supports("avx2")) tokenizer->scan = string_tokenizer_scan_avx2;
+            else if (__builtin_cpu_supports("sse2")) tokenizer->scan = string_tokenizer_scan_sse2;
+            else tokenizer->scan = string_tokenizer_scan_scalar;
+#else
+            tokenizer->scan = string_tokenizer_scan_scalar;
+#endif
+            break;
+        case STRING_TOKENIZER_SCANNER_SCALAR:
+            tokenizer->scan = string_tokenizer_scan_scalar;
+            break;
+#ifdef STRING_TOKENIZER_X86
+        case STRING_TOKENIZER_SCANNER_SSE2:
+            if (!__builtin_cpu_supports("sse2")) {
+                error_reporter_report(ERROR_CODE_UNSUPPORTED, __func__, "The CPU does not support SSE2");
+                return false;
+            }
+            tokenizer->scan = string_tokenizer_scan_sse2;
+            break;
+        case STRING_TOKENIZER_SCANNER_AVX2:
+            if (!__builtin_cpu_supports("avx2")) {
+                error_reporter_report(ERROR_CODE_UNSUPPORTED, __func__, "The CPU does not support AVX2");
+                return false;
+            }
+            tokenizer->scan = string_tokenizer_scan_avx2;
+            break;
+#endif
+        default:
+            error_reporter_report(ERROR_CODE_UNSUPPORTED, __func__, "The scanner is not available in this build");
+            return false;
+    }
+    // The first block is scanned again with the chosen scanner
+    string_tokenizer_load_block(tokenizer, 0);
+    return true;
+}
+
+bool string_tokenizer_next(StringTokenizer * tokenizer, StringToken * token) {
+    if (tokenizer == NULL || token == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to obtain a token using 'NULL' arguments");
+        return false;
+    }
+    if (tokenizer->is_malformed) return false;
+    // A delimiter at the very end is followed by an empty field, while a new line at the very end is not followed by
+    // an empty line (so there are no more tokens only if there are no bytes left and no pending field)
+    if (tokenizer->position >= tokenizer->length && !tokenizer->is_field_pending) return false;
+    size_t start = tokenizer->position;
+    const char * bytes = tokenizer->bytes;
+    if (tokenizer->mode == STRING_TOKENIZER_MODE_CSV && start < tokenizer->length && bytes[start] == '"') {
+        return string_tokenizer_next_quoted(tokenizer, token);
+    }
+    // Step 1: find the first delimiter or new line (the quotes inside unquoted fields are literal characters)
+    size_t stop;
+    do {
+        stop = string_tokenizer_next_structural(tokenizer);
+    } while (stop < tokenizer->length && bytes[stop] == '"');
+    // Step 2: a delimiter means another field follows, otherwise it is the end of a record (new line or end of bytes)
+    bool is_delimiter = stop < tokenizer->length && bytes[stop] != '\n';
+    token->start = bytes + start;
+    token->length = stop - start;
+    token->is_record_end = !is_delimiter;
+    token->has_escaped_quotes = false;
+    // The end of a record drops its '\r' (also the last record, even if the bytes do not end with a new line)
+    if (!is_delimiter && token->length > 0 && bytes[stop - 1] == '\r') token->length--;
+    tokenizer->is_field_pending = is_delimiter;
+    tokenizer->position = (stop < tokenizer->length) ? stop + 1 : tokenizer->length;
+    return true;
+}
+
+bool string_tokenizer_is_malformed(const StringTokenizer * tokenizer) {
+    if (tokenizer == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to check a 'NULL' tokenizer");
+        return false;
+    }
+    return tokenizer->is_malformed;
+}
+
+size_t string_tokenizer_unescape(const StringToken * token, char * output) {
+    if (token == NULL || output == NULL) {
+        error_reporter_report(ERROR_CODE_NULL_ARGUMENT, __func__, "Trying to unescape using 'NULL' arguments");
+        return 0;
+    }
+    if (!token->has_escaped_quotes) {
+        memcpy(output, token->start, token->length);
+        return token->length;
+    }
+    size_t output_length = 0;
+    for (size_t i = 0; i < token->length; i++) {
+        output[output_length++] = token->start[i];
+        // Skip the second quote of every doubled quote
+        if (token->start[i] == '"' && i + 1 < token->length && token->start[i + 1] == '"') i++;
+    }
+    return output_length;
+}
+
+// Utilities
+
+/**
+ * Obtains the next token when it is a quoted CSV field (the tokenizer position is the opening quote).
+ */
+bool string_tokenizer_next_quoted(StringTokenizer * tokenizer, StringToken * token) {
+    const char * bytes = tokenizer->bytes;
+    size_t length = tokenizer->length;
+    size_t start = tokenizer->position + 1;
+    // Step 1: consume the opening quote, then find the closing quote (skipping the doubled ones)
+    string_tokenizer_next_structural(tokenizer);
+    bool has_escaped_quotes = false;
+    size_t quote;
+    while (true) {
+        quote = string_tokenizer_next_structural(tokenizer);
+        if (quote == length) return string_tokenizer_fail(tokenizer, __func__, "Unterminated quoted field");
+        if (bytes[quote] != '"') continue;
+        if (quote + 1 < length && bytes[quote + 1] == '"') {
+            string_tokenizer_next_structural(tokenizer);
+            has_escaped_quotes = true;
+            continue;
+        }
+        break;
+    }
+    // Step 2: the closing quote must be followed by a delimiter, a new line (optionally after a '\r'), or the end
+    size_t after = quote + 1;
+    bool is_delimiter = false;
+    if (after < length) {
+        size_t next = string_tokenizer_next_structural(tokenizer);
+        bool is_carriage_return = after + 1 == next && bytes[after] == '\r';
+        if (next == after && bytes[next] == tokenizer->delimiter) {
+            is_delimiter = true;
+        } else if ((next == after || is_carriage_return) && (next == length || bytes[next] == '\n')) {
+            is_delimiter = false;
+        } else {
+            return string_tokenizer_fail(tokenizer, __func__, "Unexpected bytes after a closing quote");
+        }
+        after = (next < length) ? next + 1 : length;
+    }
+    token->start = bytes + start;
+    token->length = quote - start;
+    token->is_record_end = !is_delimiter;
+    token->has_escaped_quotes = has_escaped_quotes;
+    tokenizer->is_field_pending = is_delimiter;
+    tokenizer->position = after;
+    return true;
+}
+
+/**
+ * Pops the position of the next structural character, or returns the length if there are none left.
+ */
+size_t string_tokenizer_next_structural(StringTokenizer * tokenizer) {
+    while (tokenizer->block_mask == 0) {
+        if (tokenizer->block_start + BLOCK_SIZE >= tokenizer->length) return tokenizer->length;
+        string_tokenizer_load_block(tokenizer, tokenizer->block_start + BLOCK_SIZE);
+    }
+    size_t position = tokenizer->block_start + (size_t) __builtin_ctzll(tokenizer->block_mask);
+    tokenizer->block_mask &= tokenizer->block_mask - 1;
+    return position;
+}
+
+/**
+ * Scans the block starting at the given offset (the last block is copied into a padded buffer, so reading 64 bytes is
+ * always safe, and the bits of the padding are cleared).
+ */
+void string_tokenizer_load_block(StringTokenizer * tokenizer, size_t block_start) {
+    tokenizer->block_start = block_start;
+    tokenizer->block_mask = 0;
+    if (block_start >= tokenizer->length) return;
+    char first = tokenizer->delimiter;
+    char third = (tokenizer->mode == STRING_TOKENIZER_MODE_CSV) ? '"' : '\n';
+    size_t remaining = tokenizer->length - block_start;
+    if (remaining >= BLOCK_SIZE) {
+        tokenizer->block_mask = tokenizer->scan(tokenizer->bytes + block_start, first, '\n', third);
+    } else {
+        char padded[BLOCK_SIZE];
+        memcpy(padded, tokenizer->bytes + block_start, remaining);
+        memset(padded + remaining, 0, BLOCK_SIZE - remaining);
+        tokenizer->block_mask = tokenizer->scan(padded, first, '\n', third) & ((UINT64_C(1) << remaining) - 1);
+    }
+}
+
+bool string_tokenizer_fail(StringTokenizer * tokenizer, const char * function, const char * message) {
+    error_reporter_report(ERROR_CODE_INVALID_ARGUMENT, function, message);
+    tokenizer->is_malformed = true;
+    return false;
+}
+
+uint64_t string_tokenizer_scan_scalar(const char * block, char first, char second, char third) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < BLOCK_SIZE; i++) {
+        char character = block[i];
+        if (character == first || character == second || character == third) mask |= UINT64_C(1) << i;
+    }
+    return mask;
+}
+
+#ifdef STRING_TOKENIZER_X86
+
+__attribute__((target("sse2")))
+uint64_t string_tokenizer_scan_sse2(const char * block, char first, char second, char third) {
+    __m128i firsts = _mm_set1_epi8(first);
+    __m128i seconds = _mm_set1_epi8(second);
+    __m128i thirds = _mm_set1_epi8(third);
+    uint64_t mask = 0;
+    for (size_t i = 0; i < BLOCK_SIZE; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i *) (block + i));
+        __m128i matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, firsts), _mm_cmpeq_epi8(bytes, seconds)), _mm_cmpeq_epi8(bytes, thirds));
+        mask |= (uint64_t) (uint32_t) _mm_movemask_epi8(matches) << i;
+    }
+    return mask;
+}
+
+__attribute__((target("avx2")))
+uint64_t string_tokenizer_scan_avx2(const char * block, char first, char second, char third) {
+    __m256i firsts = _mm256_set1_epi8(first);
+    __m256i seconds = _mm256_set1_epi8(second);
+    __m256i thirds = _mm256_set1_epi8(third);
+    uint64_t mask = 0;
+    for (size_t i = 0; i < BLOCK_SIZE; i += 32) {
+        __m256i bytes = _mm256_loadu_si256((const __m256i *) (block + i));
+        __m256i matches = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, firsts), _mm256_cmpeq_epi8(bytes, seconds)), _mm256_cmpeq_epi8(bytes, thirds));
+        mask |= (uint64_t) (uint32_t) _mm256_movemask_epi8(matches) << i;
+    }
+    return mask;
+}
+
+#endif /* STRING_TOKENIZER_X86 */
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdbool.h>        // For "true", "false" (boolean constants)
+#include <stddef.h>         // For "size_t" (size type)
+#include <stdint.h>         // For "uint64_t" (structural characters bitmask)
+#include "string-builder.h"
+
+/* string-tokenizer.h */
+#ifndef STRINGS_STRING_TOKENIZER_H
+#define STRINGS_STRING_TOKENIZER_H
+
+/**
+ * How the bytes are split into tokens.
+ */
+typedef enum string_tokenizer_mode {
+    STRING_TOKENIZER_MODE_LINES = 0,    // Every line is a token (split on '\n', a trailing '\r' is dropped)
+    STRING_TOKENIZER_MODE_FIELDS,       // Every delimiter-separated field of every line is a token (no quoting)
+    STRING_TOKENIZER_MODE_CSV,          // Like the fields mode, but the fields might be quoted (RFC 4180)
+} StringTokenizerMode;
+
+/**
+ * Which implementation scans the bytes looking for the delimiters.
+ */
+typedef enum string_tokenizer_scanner {
+    STRING_TOKENIZER_SCANNER_AUTO = 0,  // The widest implementation supported by the running CPU
+    STRING_TOKENIZER_SCANNER_SCALAR,    // One byte at a time (always available)
+    STRING_TOKENIZER_SCANNER_SSE2,      // 16 bytes at a time (only available on x86)
+    STRING_TOKENIZER_SCANNER_AVX2,      // 32 bytes at a time (only available on x86 CPUs supporting AVX2)
+} StringTokenizerScanner;
+
+/**
+ * A token, which points into the tokenized bytes (it is never copied, so it is not 'NULL' terminated).
+ */
+typedef struct string_token {
+    const char * start;             // The first byte of the token (without the CSV quotes)
+    size_t length;                  // The amount of bytes of the token
+    bool is_record_end;             // Whether it is the last field of its line (always true in the lines mode)
+    bool has_escaped_quotes;        // Whether the quoted CSV field contains doubled quotes (see "string_tokenizer_unescape")
+} StringToken;
+
+/**
+ * The tokenizer state, exposed only so it can be placed in the stack (its fields must not be accessed directly).
+ */
+typedef struct string_tokenizer {
+    const char * bytes;             // The tokenized bytes
+    size_t length;                  // The amount of tokenized bytes
+    size_t position;                // Where the next token starts
+    char delimiter;                 // The fields delimiter (the new line in the lines mode)
+    StringTokenizerMode mode;       // How the bytes are split into tokens
+    bool is_field_pending;          // Whether a delimiter was just consumed (so a field follows, even if empty)
+    bool is_malformed;              // Whether malformed CSV was found (the tokenization is stopped)
+    uint64_t (* scan)(const char * block, char first, char second, char third); // The 64 bytes block scanner
+    size_t block_start;             // The offset of the currently scanned block
+    uint64_t block_mask;            // The not yet consumed structural characters of the current block (bit per byte)
+} StringTokenizer;
+
+/**
+ * Initializes a tokenizer over the given bytes, which must not be modified (nor freed) while tokenizing.
+ *
+ * @param tokenizer the tokenizer to be initialized
+ * @param bytes the bytes to be tokenized (might be {@code NULL} if the length is '0')
+ * @param length the amount of bytes to be tokenized
+ * @param mode how the bytes are split into tokens
+ * @param delimiter the fields delimiter (ignored in the lines mode, must not be '\n', '\r' nor '"')
+ *
+ * @return {@code true} if the tokenizer was initialized, {@code false} otherwise
+ */
+bool string_tokenizer_init(StringTokenizer * tokenizer, const char * bytes, size_t length, StringTokenizerMode mode, char delimiter);
+
+/**
+ * Initializes a tokenizer over the contents of the given builder (without copying them).
+ *
+ * @param tokenizer the tokenizer to be initialized
+ * @param string_builder the builder whose contents are to be tokenized
+ * @param mode how the contents are split into tokens
+ * @param delimiter the fields delimiter (ignored in the lines mode, must not be '\n', '\r' nor '"')
+ *
+ * @note the builder must not be modified (nor destroyed) while tokenizing, as the tokens point into its chain
+ *
+ * @return {@code true} if the tokenizer was initialized, {@code false} otherwise
+ */
+bool string_tokenizer_init_builder(StringTokenizer * tokenizer, StringBuilder * string_builder, StringTokenizerMode mode, char delimiter);
+
+/**
+ * Chooses the implementation used to scan the bytes (must be called before obtaining the first token).
+ *
+ * @param tokenizer the tokenizer whose scanner is to be chosen
+ * @param scanner the scanner implementation
+ *
+ * @return {@code true} if the scanner was chosen, {@code false} if it is not supported by this CPU (or build)
+ */
+bool string_tokenizer_set_scanner(StringTokenizer * tokenizer, StringTokenizerScanner scanner);
+
+/**
+ * Obtains the next token, no memory is allocated.
+ *
+ * @param tokenizer the tokenizer from where the token is obtained
+ * @param token where the next token is to be stored
+ *
+ * @return {@code true} if a token was obtained, {@code false} if there are no more tokens (or the CSV is malformed,
+ *         see "string_tokenizer_is_malformed")
+ */
+bool string_tokenizer_next(StringTokenizer * tokenizer, StringToken * token);
+
+/**
+ * Returns whether the tokenization stopped because of malformed CSV (an unterminated quoted field, or bytes between
+ * the closing quote and the next delimiter).
+ *
+ * @param tokenizer the tokenizer to be checked
+ *
+ * @return {@code true} if malformed CSV was found, {@code false} otherwise
+ */
+bool string_tokenizer_is_malformed(const StringTokenizer * tokenizer);
+
+/**
+ * Copies the given token into the output replacing the doubled quotes with single ones.
+ *
+ * @param token the token to be unescaped
+ * @param output where the unescaped token is stored (it must have room for "token->length" bytes, it is not 'NULL'
+ *        terminated)
+ *
+ * @return the length of the unescaped token
+ */
+size_t string_tokenizer_unescape(const StringToken * token, char * output);
+
+#endif /* STRINGS_STRING_TOKENIZER_H */
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2022 Serghei Sergheev
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+/*
+ * ### Introduction ###
+ *
+ * User Statically-Defined Tracing (or USDT) probes are markers placed in the code that can be attached to at runtime
+ * by tracers such as "bpftrace", "perf" or "systemtap", which allows inspecting live processes without recompiling.
+ *
+ * ### Implementation ###
+ *
+ * When "CDK_USDT" is defined, the probes expand to the "sys/sdt.h" macros (provided by "systemtap-sdt-dev" on Debian
+ * based systems), which only emit a "nop" instruction plus an ELF note describing where the arguments live, so they
+ * cost nothing until a tracer attaches to them. When "CDK_USDT" is not defined, the probes expand to nothing at all
+ * (their arguments are not even evaluated).
+ *
+ * All the kit probes use the "cdk" provider, for example, to list them: "bpftrace -l 'usdt:./main:cdk:*'".
+ *
+ * ### References ###
+ *
+ * - https://sourceware.org/systemtap/wiki/AddingUserSpaceProbingToApps
+ * - https://github.com/iovisor/bpftrace/blob/master/man/adoc/bpftrace.adoc#usdt
+ */
+
+/* usdt.h */
+#ifndef TRACING_USDT_H
+#define TRACING_USDT_H
+
+#ifdef CDK_USDT
+
+#if defined(__has_include)
+#if !__has_include(<sys/sdt.h>)
+#error "The 'CDK_USDT' probes require the 'sys/sdt.h' header (i.e., install 'systemtap-sdt-dev')"
+#endif
+#endif
+
+#include <sys/sdt.h>        // For "DTRACE_PROBE1", "DTRACE_PROBE2", "DTRACE_PROBE3" (static probes)
+
+#define USDT_PROBE1(name, first) DTRACE_PROBE1(cdk, name, first)
+#define USDT_PROBE2(name, first, second) DTRACE_PROBE2(cdk, name, first, second)
+#define USDT_PROBE3(name, first, second, third) DTRACE_PROBE3(cdk, name, first, second, third)
+
+#else
+
+#define USDT_PROBE1(name, first) ((void) 0)
+#define USDT_PROBE2(name, first, second) ((void) 0)
+#define USDT_PROBE3(name, first, second, third) ((void) 0)
+
+#endif /* CDK_USDT */
+
+#endif /* TRACING_USDT_H */
@@ -0,0 +1,21 @@
+#!/bin/bash
+
+# Builds the kit with profile guided optimization: an instrumented build is trained on the benchmark suite and then
+# the same build directory is rebuilt using the collected profiles (extra "cmake" arguments are forwarded, i.e., LTO)
+
+BUILD_DIRECTORY="cmake-build-pgo"
+
+# Cleanup old profiles
+rm -rf "$BUILD_DIRECTORY/pgo-profiles"
+
+# Instrumented build & training run
+cmake -S . -B "$BUILD_DIRECTORY" -DCMAKE_BUILD_TYPE=Release -DCDK_PGO=GENERATE "$@" || exit 1
+cmake --build "$BUILD_DIRECTORY" -j"$(nproc)" || exit 1
+cmake --build "$BUILD_DIRECTORY" --target cdk-pgo-train || exit 1
+
+# Optimized build (the objects are rebuilt as the compile flags changed)
+cmake -S . -B "$BUILD_DIRECTORY" -DCMAKE_BUILD_TYPE=Release -DCDK_PGO=USE "$@" || exit 1
+cmake --build "$BUILD_DIRECTORY" -j"$(nproc)" || exit 1
+
+# Goodbye
+echo "All done! The optimized libraries are at '$BUILD_DIRECTORY'"